@@ -44,9 +44,9 @@ void svLog (const char * strIn, gboolean skipStdOut)
   char * nowStr = g_date_time_format(now, "%Y-%m-%d-%H:%M:%S");  //  <<<--- NO const char *
 
   // print to stdout if we aren't skipping or app->debugMode is true
+  // (stderr in a batch run, which may be writing its report to stdout)
   if (!skipStdOut || app->debugMode)
-    // print to stdout
-    printf("SpiritVNC-GTK: %s - %s\n", nowStr, strIn);
+    fprintf(app->batchMode ? stderr : stdout, "SpiritVNC-GTK: %s - %s\n", nowStr, strIn);
 
   // only log to file if set in options
   if (app->logToFile)
@@ -129,6 +129,32 @@ Connection * svConnectionFromVNCObj (const GtkWidget * vncObj)
 }
 
 
+/* return connection with the passed name (NULL if none) */
+Connection * svConnectionFromName (const char * name)
+{
+  if (!name)
+    return NULL;
+
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+  Connection * found = NULL;
+
+  for (GList * l = rows; l && !found; l = l->next)
+  {
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
+    if (!box)
+      continue;
+
+    Connection * con = g_object_get_data(G_OBJECT(box), "con");
+    if (con && strcmp(con->name->str, name) == 0)
+      found = con;
+  }
+
+  g_list_free(rows);
+
+  return found;
+}
+
+
 /* return a zero (0) or one (1) from a gboolean */
 /* (justification: some systems don't always return a '1' for true and '0' for false) */
 guint svIntFromBool (gboolean boolIn)
@@ -210,9 +236,89 @@ void svInitAppVars ()
 
   //# flags, states and stuff
   app->listenMode = false;
-  app->listenPort = 5500;
+  app->listenPorts = g_string_new("5500");
+  app->listenBacklog = 128;
+  app->listeners = g_ptr_array_new_with_free_func(svListenClose);
+
+  // reverse connection admission
+  app->reverseMax = 100;
+  app->reverseRatePerMin = 10;
+  app->reverseAllowText = g_string_new(NULL);
+  app->reverseAllow = g_ptr_array_new_with_free_func(g_object_unref);
+  app->reverseBuckets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  app->reverseCount = 0;
+  app->reverseRejected = 0;
   app->scanTimerSource = 0;
 
+  // clipboard history
+  app->clipHistory = g_queue_new();
+  app->clipStore = g_hash_table_new(svClipTextHash, svClipTextEqual);
+  app->clipBytes = 0;
+  app->clipHistoryKB = 4096;
+
+  // reachability probes
+  app->probeInterval = 0;
+  app->probeConcurrency = 8;
+  app->probeReadBanner = true;
+  app->probeTimerSource = 0;
+  app->probeQueue = g_queue_new();
+  app->probeActive = 0;
+
+  // shared host name lookups
+  app->dnsCache = g_hash_table_new(g_str_hash, g_str_equal);
+  app->dnsCacheSecs = 60;
+
+  // pre-connecting
+  app->preconnect = false;
+  app->warmHoverCon = NULL;
+  app->warmHoverSource = 0;
+
+  // framebuffer memory budget
+  app->fbBudgetMB = 0;
+
+  // idle disconnect
+  app->idleMinutes = 0;
+  app->idleReconnect = true;
+
+  // automation control socket
+  app->controlSocket = false;
+  app->controlSock = NULL;
+  app->controlSource = NULL;
+  app->controlClients = NULL;
+  app->controlWaiters = NULL;
+
+  // command-line screenshots taken by a process started just for them
+  app->shotOnly = false;
+  app->shotsPending = 0;
+  app->shotStatus = 0;
+
+  // headless batch mode
+  app->batchMode = false;
+  app->batchStatus = 0;
+  app->batchCmdLine = NULL;
+
+  // shared memory screen export
+  app->shmExport = false;
+
+  // tile view
+  app->tileCount = 0;
+  app->tileGrid = NULL;
+  app->tiles = NULL;
+  app->tileFocus = NULL;
+  app->tileSource = 0;
+  app->tileLayoutSource = 0;
+
+  // viewer processes
+  app->helperViewers = false;
+  app->helperChild = false;
+  app->helperHeld = false;
+  app->helperEndSource = 0;
+
+  // last-known screen previews (off unless asked for, since they're pictures of remote desktops kept on disk)
+  app->savePreviews = false;
+  app->previewArea = NULL;
+  app->previewCon = NULL;
+
   // hash tables for child windows and their children
   //m_appOptions = g_hash_table_new(NULL, NULL);
 
@@ -229,6 +335,14 @@ void svInitAppVars ()
   // app log file
   app->appLogFile = g_string_new(app->appConfigDir->str);
   g_string_append(app->appLogFile, "/spiritvnc-gtk.log");
+
+  // automation control socket
+  app->controlPath = g_string_new(app->appConfigDir->str);
+  g_string_append(app->controlPath, "/control.sock");
+
+  // last-known screen previews
+  app->previewDir = g_string_new(app->appConfigDir->str);
+  g_string_append(app->previewDir, "/previews");
 }
 
 
@@ -254,11 +368,18 @@ void svInitConnObject (Connection * con)
   con->lossyEncoding = false;
   con->showRemoteCursor = true;
   con->quality = SV_QUAL_DEFAULT;
+  con->clipboardSync = SV_CLIP_SYNC_MANUAL;
+  con->pasteMode = SV_PASTE_KEYSTROKES;
+  con->pasteKeys = g_string_new("CTRL+V");
   con->sshPort = g_string_new(NULL);
   con->sshPrivKeyfile = g_string_new(NULL);
   con->sshUser = g_string_new(NULL);
   con->sshPass = g_string_new(NULL);
   con->f12Macro = g_string_new(NULL);
+  con->f12Program = g_array_new(false, true, sizeof(MacroStep));
+  con->macroProgram = NULL;
+  con->macroStep = 0;
+  con->macroSource = 0;
   con->quickNote = g_string_new(NULL);
   con->customCmd1Enabled = false;
   con->customCmd1Label = g_string_new(NULL);
@@ -277,8 +398,70 @@ void svInitConnObject (Connection * con)
   con->sshMonitorThread = NULL;
   con->sshContinue = false;
   con->sshStdIn = -1;
-  con->clipboard = g_string_new(NULL);
+  con->clipLastSent = NULL;
   con->viewOnly = false;
+  con->probeState = SV_PROBE_UNKNOWN;
+  con->probeRtt = 0;
+  con->probeVersion = g_string_new(NULL);
+  con->probeTime = g_string_new(NULL);
+  con->probeJob = NULL;
+  con->probeQueued = false;
+  con->autoReconnect = false;
+  con->reconnectMaxTries = 10;
+  con->reconnectTries = 0;
+  con->reconnectSource = 0;
+  con->reconnectAt = 0;
+  con->liveTimeout = 0;
+  con->connectJob = NULL;
+  con->watchdogSource = 0;
+  con->lastActivity = 0;
+  con->fbBytes = 0;
+  con->lastViewed = 0;
+  con->idleMinutes = -1;
+  con->resolveTime = -1;
+  con->warmJob = NULL;
+  con->warmSock = NULL;
+  con->warmSource = 0;
+  con->repeaterId = g_string_new(NULL);
+  con->repeaterJob = NULL;
+  con->shotFile = g_string_new(NULL);
+  con->shotCmdLine = NULL;
+  con->shotSource = 0;
+  con->controlState = SV_STATE_DISCONNECTED;
+  con->batchItem = NULL;
+  con->matchWaits = NULL;
+  con->matchSource = 0;
+  con->matchLast = 0;
+  con->shm = NULL;
+  con->helper = NULL;
+  con->detachWin = NULL;
+  con->detachScale = false;
+  con->detachRate = 0;
+  con->detachSource = 0;
+  con->detachDrawHandler = 0;
+  con->tileBox = NULL;
+  con->tileScale = true;
+  con->tileMuted = false;
+  con->tileSnap = NULL;
+  con->tileSnapTime = 0;
+  con->tileDrawHandler = 0;
+  con->remoteResize = false;
+  con->coalescePointer = false;
+  con->pointerX = 0;
+  con->pointerY = 0;
+  con->pointerMask = 0;
+  con->pointerPending = false;
+  con->pointerSource = 0;
+  con->rttEstimate = 0;
+  con->rttProbeSent = 0;
+  con->rttProbeLast = 0;
+  con->preview = NULL;
+  con->previewTip = NULL;
+  con->previewLoaded = false;
+  con->previewSaved = 0;
+  con->resizeSource = 0;
+  con->resizeWidth = 0;
+  con->resizeHeight = 0;
 }
 
 
@@ -310,10 +493,29 @@ void svSetHostlistItemsTooltips ()
         typeStr = "VNC";
       else if (con->type == SV_TYPE_VNC_OVER_SSH)
         typeStr = "VNC over SSH";
+      else if (con->type == SV_TYPE_VNC_REPEATER)
+        typeStr = "VNC via repeater";
 
       g_string_printf(tipStr, "<b>%s</b>\nType: %s\nAddress: %s\nLast connected: %s",
         con->name->str, typeStr, con->address->str, con->lastConnectTime->str);
 
+      // reachability, if checked
+      if (con->probeState == SV_PROBE_REACHABLE)
+      {
+        g_string_append_printf(tipStr, "\nReachable: yes, %li ms", (long)(con->probeRtt / 1000));
+
+        if (con->probeVersion->len > 0)
+          g_string_append_printf(tipStr, ", RFB %s", con->probeVersion->str);
+
+        g_string_append_printf(tipStr, " (checked %s)", con->probeTime->str);
+      }
+      else if (con->probeState == SV_PROBE_UNREACHABLE)
+        g_string_append_printf(tipStr, "\nReachable: no (checked %s)", con->probeTime->str);
+
+      // last name lookup time (cached answers show as 0)
+      if (con->resolveTime >= 0)
+        g_string_append_printf(tipStr, "\nName lookup: %li ms", (long)(con->resolveTime / 1000));
+
       gtk_widget_set_tooltip_markup(rowBox, tipStr->str);
     }
     else
@@ -338,1057 +540,2476 @@ void svSetTooltip(GtkWidget * widget, const char * text)
 }
 
 
-/* handle send entered keystrokes window buttons */
-void svHandleSendEnteredKeystrokesButtons (GtkButton * button, gpointer userData)
+/* return the keyval for a macro key name like 'ENTER', 'F5' or 'T' (0 if unknown) */
+guint svMacroKeyvalFromName (const char * name)
 {
-  // hash table for pointers to child window and its children
-  GHashTable * ht = (GHashTable *)userData;
-  if (!ht)
-    return;
+  static const struct
+  {
+    const char * name;
+    guint keyval;
+  } keyNames[] = {
+    {"ENTER", GDK_KEY_Return},
+    {"RETURN", GDK_KEY_Return},
+    {"TAB", GDK_KEY_Tab},
+    {"ESC", GDK_KEY_Escape},
+    {"ESCAPE", GDK_KEY_Escape},
+    {"BACKSPACE", GDK_KEY_BackSpace},
+    {"BS", GDK_KEY_BackSpace},
+    {"DELETE", GDK_KEY_Delete},
+    {"DEL", GDK_KEY_Delete},
+    {"INSERT", GDK_KEY_Insert},
+    {"INS", GDK_KEY_Insert},
+    {"HOME", GDK_KEY_Home},
+    {"END", GDK_KEY_End},
+    {"PGUP", GDK_KEY_Page_Up},
+    {"PAGEUP", GDK_KEY_Page_Up},
+    {"PGDN", GDK_KEY_Page_Down},
+    {"PAGEDOWN", GDK_KEY_Page_Down},
+    {"UP", GDK_KEY_Up},
+    {"DOWN", GDK_KEY_Down},
+    {"LEFT", GDK_KEY_Left},
+    {"RIGHT", GDK_KEY_Right},
+    {"SPACE", GDK_KEY_space},
+    {"MENU", GDK_KEY_Menu},
+    {"PRINT", GDK_KEY_Print},
+    {"PAUSE", GDK_KEY_Pause},
+    {"LBRACE", GDK_KEY_braceleft},
+    {"RBRACE", GDK_KEY_braceright},
+    {"CTRL", GDK_KEY_Control_L},
+    {"CONTROL", GDK_KEY_Control_L},
+    {"ALT", GDK_KEY_Alt_L},
+    {"ALTGR", GDK_KEY_ISO_Level3_Shift},
+    {"SHIFT", GDK_KEY_Shift_L},
+    {"WIN", GDK_KEY_Super_L},
+    {"SUPER", GDK_KEY_Super_L},
+    {"META", GDK_KEY_Meta_L}
+  };
 
-  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
-  if (!win)
-    return;
+  if (!name || name[0] == '\0')
+    return 0;
 
-  // handle cancel button
-  if ((GtkWidget *)button == (GtkWidget *)g_hash_table_lookup(ht, "btnCancel"))
+  for (guint i = 0; i < G_N_ELEMENTS(keyNames); i++)
   {
-    gtk_widget_destroy(win);
+    if (g_ascii_strcasecmp(name, keyNames[i].name) == 0)
+      return keyNames[i].keyval;
+  }
 
-    gtk_window_present(GTK_WINDOW(app->mainWin));
+  // function keys F1 - F24 (their keyvals are consecutive)
+  if ((name[0] == 'F' || name[0] == 'f') && g_ascii_isdigit(name[1]))
+  {
+    char * end = NULL;
+    guint64 num = g_ascii_strtoull(name + 1, &end, 10);
 
-    g_hash_table_destroy(ht);
+    if (end && *end == '\0' && num >= 1 && num <= 24)
+      return GDK_KEY_F1 + (guint)num - 1;
 
-    return;
+    return 0;
   }
 
-  const Connection * con = (Connection *)g_hash_table_lookup(ht, "con");
-  if (!con || !con->vncObj || con->state != SV_STATE_CONNECTED)
-    return;
+  // a single character, as in the 'T' of {CTRL+ALT+T} (lower-case, or we'd imply shift)
+  if (g_utf8_strlen(name, -1) == 1)
+    return gdk_unicode_to_keyval(g_unichar_tolower(g_utf8_get_char(name)));
 
-  const char * skType = (char *)g_hash_table_lookup(ht, "type");
-  GString * skTextToSend = (GString *)g_hash_table_lookup(ht, "textToSend");
-  GtkWidget * skTextView = (GtkWidget *)g_hash_table_lookup(ht, "textView");
+  return 0;
+}
 
-  char * text = NULL;
 
-  // we're sending keys from the send keys window
-  if (skType == SV_SENDKEYS_TYPE_ENTRY)
-  {
-    if (!skTextView)
-      return;
+/* compile one '{...}' macro token into program steps */
+/* (returns false if the token isn't valid) */
+gboolean svMacroCompileToken (const char * token, GArray * program)
+{
+  MacroStep step;
+  memset(&step, 0, sizeof(step));
 
-    GtkTextBuffer * tb = gtk_text_view_get_buffer(GTK_TEXT_VIEW(skTextView));
+  // {WAITFOR image.png [x,y] [secs]} - wait for the screen to show an image
+  if (g_ascii_strncasecmp(token, "WAITFOR ", 8) == 0)
+  {
+    char ** parts = g_strsplit(token + 8, " ", -1);  // <<<--- do NOT make const char **
+    guint nParts = g_strv_length(parts);
+    guint secs = SV_MATCH_WAIT_SECS;
+    gint fixedX = -1;
+    gint fixedY = -1;
 
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(tb, &start);
-    gtk_text_buffer_get_end_iter(tb, &end);
+    // trailing seconds
+    char * end = NULL;
 
-    text = gtk_text_buffer_get_text(tb, &start, &end, false);  //  <<<--- NO const char *
-    if (text[0] == '\0')
+    if (nParts > 1)
     {
-      g_free(text);
-      return;
-    }
-  }
-  // we're sending keys directly from another function
-  else
-  {
-    if (!skTextToSend || skTextToSend->len == 0)
-      return;
+      guint64 value = g_ascii_strtoull(parts[nParts - 1], &end, 10);
 
-    // set text
-    text = g_strdup(skTextToSend->str);
+      if (end != parts[nParts - 1] && *end == '\0' && value > 0 && value <= 86400)
+      {
+        secs = (guint)value;
+        nParts--;
+      }
+    }
 
-    // free up gstring
-    g_string_free(skTextToSend, true);
-  }
+    // then an optional position
+    if (nParts > 1 && sscanf(parts[nParts - 1], "%d,%d", &fixedX, &fixedY) == 2 && fixedX >= 0 && fixedY >= 0)
+      nParts--;
+    else
+      fixedX = fixedY = -1;
 
-  size_t len = strlen(text);
+    // whatever's left is the file (which may have spaces)
+    GString * path = g_string_new(NULL);
 
-  guint keys[len];
+    for (guint i = 0; i < nParts; i++)
+      g_string_append_printf(path, "%s%s", i > 0 ? " " : "", parts[i]);
 
-  for (size_t i = 0; i < len; i++)
-    keys[i] = gdk_unicode_to_keyval(text[i]);
+    g_strfreev(parts);
 
-  vnc_display_send_keys(VNC_DISPLAY(con->vncObj), keys, len);
+    GString * errStr = g_string_new(NULL);
+    MatchTemplate * tmpl = path->len > 0 ? svMatchTemplateLoad(path->str, fixedX, fixedY, errStr) : NULL;
 
-  g_free(text);
+    if (errStr->len > 0)
+      svLog(errStr->str, false);
 
-  if (win)
-    gtk_widget_destroy(win);
+    g_string_free(errStr, true);
+    g_string_free(path, true);
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
+    if (!tmpl)
+      return false;
 
-  g_hash_table_destroy(ht);
-}
+    step.type = SV_MACRO_WAITFOR;
+    step.match = tmpl;
+    step.delay = secs;
+    g_array_append_val(program, step);
 
+    return true;
+  }
 
-/* handle custom command output window 'ok' button */
-void svHandleCommandOutputOk (GtkButton * self, gpointer userData)
-{
-  GtkWidget * outWin = (GtkWidget *)userData;
-  if (!outWin)
-    return;
+  // {WAIT 500} - pause in milliseconds
+  if (g_ascii_strncasecmp(token, "WAIT", 4) == 0)
+  {
+    const char * num = token + 4;
 
-  // destroy the command output window
-  gtk_widget_destroy(outWin);
+    while (*num == ' ')
+      num++;
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
-}
+    char * end = NULL;
+    guint64 delay = g_ascii_strtoull(num, &end, 10);
 
+    if (num[0] == '\0' || !end || *end != '\0' || delay > 600000)
+      return false;
 
-/* handle the app options 'save' button */
-void svHandleAppOptionsButtons (GtkButton * button, gpointer userData)
-{
-  GHashTable * ht = (GHashTable *)userData;
-  if (!ht)
-    return;
+    step.type = SV_MACRO_WAIT;
+    step.delay = (guint)delay;
+    g_array_append_val(program, step);
 
-  const GtkWidget * btnCancel = (GtkWidget *)g_hash_table_lookup(ht, "btnCancel");
-  if (!btnCancel)
-    return;
+    return true;
+  }
 
-  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
-  if (!win)
-    return;
+  // optional repeat count, as in {TAB 3}
+  guint repeat = 1;
+  char * keyPart = g_strdup(token);
+  char * space = strchr(keyPart, ' ');
 
-  // handle cancel
-  if ((GtkWidget *)button == btnCancel)
+  if (space)
   {
-    // log
-    svLog("Canceled app options editing", true);
+    *space = '\0';
 
-    // destroy the app options window
-    gtk_widget_destroy(win);
+    char * end = NULL;
+    guint64 count = g_ascii_strtoull(space + 1, &end, 10);
 
-    gtk_window_present(GTK_WINDOW(app->mainWin));
+    if (space[1] == '\0' || !end || *end != '\0' || count < 1 || count > 1000)
+    {
+      g_free(keyPart);
+      return false;
+    }
 
-    return;
+    repeat = (guint)count;
   }
 
-  // *** save stuff ***
+  // single key or chord like CTRL+ALT+T
+  char ** names = g_strsplit(keyPart, "+", -1);
 
-  // log
-  svLog("Saving app options", true);
+  g_free(keyPart);
 
-  // -------------------------------------------
+  step.type = SV_MACRO_KEYS;
 
-  // show tooltips
-  GtkWidget * chkShowTooltips = (GtkWidget *)g_hash_table_lookup(ht, "chkShowTooltips");
-  if (chkShowTooltips)
-    app->showTooltips = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkShowTooltips));
+  gboolean okay = true;
 
-  // log to file
-  GtkWidget * chkLogToFile = (GtkWidget *)g_hash_table_lookup(ht, "chkLogToFile");
-  if (chkLogToFile)
-    app->logToFile = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkLogToFile));
+  for (char ** name = names; *name != NULL; name++)
+  {
+    guint keyval = svMacroKeyvalFromName(*name);
 
-  // scan timeout
-  GtkWidget * entScanTimeout = (GtkWidget *)g_hash_table_lookup(ht, "entScanTimeout");
-  if (entScanTimeout)
-    app->scanTimeout = atoi(gtk_entry_get_text(GTK_ENTRY(entScanTimeout)));
+    if (keyval == 0 || step.nKeys >= SV_MACRO_MAX_CHORD)
+    {
+      okay = false;
+      break;
+    }
 
-  // vnc connect wait time
-  GtkWidget * entVncWaitTime = (GtkWidget *)g_hash_table_lookup(ht, "entVncWaitTime");
-  if (entVncWaitTime)
-    app->vncConnectWaitTime = atoi(gtk_entry_get_text(GTK_ENTRY(entVncWaitTime)));
+    step.keys[step.nKeys++] = keyval;
+  }
 
-  // ssh connect wait time
-  GtkWidget * entSSHWaitTime = (GtkWidget *)g_hash_table_lookup(ht, "entSSHWaitTime");
-  if (entSSHWaitTime)
-    app->sshConnectWaitTime = atoi(gtk_entry_get_text(GTK_ENTRY(entSSHWaitTime)));
+  g_strfreev(names);
 
-  // ssh command
-  GtkWidget * entSSHCommand = (GtkWidget *)g_hash_table_lookup(ht, "entSSHCommand");
-  if (entSSHCommand)
-    g_string_assign(app->sshCommand, gtk_entry_get_text(GTK_ENTRY(entSSHCommand)));
+  if (!okay || step.nKeys == 0)
+    return false;
 
-  // -------------------------------------------
+  for (guint i = 0; i < repeat; i++)
+    g_array_append_val(program, step);
 
-  // set or unset tooltips
-  svSetMenuItemTooltips();
-  svSetHostlistItemsTooltips();
-  svSetTooltip(app->listenImage, "Toggle listen mode");
-  svSetTooltip(app->scanImage, "Toggle scan mode");
-  svSetTooltip(app->addConnectionImage, "Add a new connection");
+  return true;
+}
 
-  // write out our config
-  svConfigWrite();
 
-  g_hash_table_destroy(ht);
+/* compile f12 macro text into a keyval / delay program */
+/* (any problems are appended to errStr, which may be NULL) */
+GArray * svMacroCompile (const char * macroText, GString * errStr)
+{
+  GArray * program = g_array_new(false, true, sizeof(MacroStep));
+  g_array_set_clear_func(program, svMacroStepClear);
 
-  // destroy options window
-  gtk_widget_destroy(win);
+  if (!macroText)
+    return program;
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
-}
+  const char * p = macroText;
 
+  while (*p != '\0')
+  {
+    MacroStep step;
+    memset(&step, 0, sizeof(step));
+    step.type = SV_MACRO_KEYS;
+    step.nKeys = 1;
 
-/* handle the connection edit 'save' button */
-void svHandleConnectionEditButtons (GtkButton * button, gpointer userData)
-{
-  // hash table contains pointers to child window, its controls and data
-  GHashTable * ht = (GHashTable *)userData;
-  if (!ht)
-    return;
+    // '{{' is a literal '{'
+    if (p[0] == '{' && p[1] == '{')
+    {
+      step.keys[0] = GDK_KEY_braceleft;
+      g_array_append_val(program, step);
+      p += 2;
+      continue;
+    }
 
-  // set con object
-  Connection * con = (Connection *)g_hash_table_lookup(ht, "con");
-  if (!con)
-    return;
+    // special key, chord or pause
+    if (p[0] == '{')
+    {
+      const char * close = strchr(p, '}');
 
-  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
-  if (!win)
-    return;
+      if (!close)
+      {
+        if (errStr)
+          g_string_append_printf(errStr, "Missing '}' after '%s'\n", p);
 
-  // handle cancel button
-  if ((GtkWidget *)button == (GtkWidget *)g_hash_table_lookup(ht, "btnCancel"))
-  {
-    app->addNewConnection = false;
+        break;
+      }
 
-    g_hash_table_destroy(ht);
+      char * token = g_strndup(p + 1, close - p - 1);
+      g_strstrip(token);
 
-    gtk_widget_destroy(win);
+      if (!svMacroCompileToken(token, program) && errStr)
+        g_string_append_printf(errStr, "Unknown macro key '{%s}'\n", token);
 
-    gtk_window_present(GTK_WINDOW(app->mainWin));
-    return;
-  }
+      g_free(token);
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Saving settings for '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+      p = close + 1;
+      continue;
+    }
 
-  // connection name
-  const char * oldVal = (const char *)con->name->str;
-  const char * nameVal = (const char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "connectionName")));
-  const char * addressVal = (const char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "remoteAddress")));
+    // plain character
+    gunichar ch = g_utf8_get_char_validated(p, -1);
 
-  // **===== validate stuff first =====**
+    if (ch == (gunichar)-1 || ch == (gunichar)-2)
+    {
+      p++;
+      continue;
+    }
 
-  // if no connection name, warn user
-  if (nameVal[0] == '\0')
-  {
-    svShowMessageDialog("<b>'Connection name' cannot be empty</b>\n\nPlease enter a "
-                                      "connection name then try saving again");
+    if (ch == '\n')
+      step.keys[0] = GDK_KEY_Return;
+    else if (ch == '\t')
+      step.keys[0] = GDK_KEY_Tab;
+    else
+      step.keys[0] = gdk_unicode_to_keyval(ch);
 
-    gtk_window_present(GTK_WINDOW(win));
+    g_array_append_val(program, step);
+
+    p = g_utf8_next_char(p);
+  }
+
+  return program;
+}
 
-    // focus remote address
-    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "connectionName"));
 
+/* set a connection's f12 macro text and its compiled program */
+void svSetF12Macro (Connection * con, const char * macroText)
+{
+  if (!con || !macroText)
     return;
-  }
 
-  // if no host address, warn user (if not a reverse / listening connection)
-  if (addressVal[0] == '\0' && con->type != SV_TYPE_VNC_REVERSE)
-  {
-    svShowMessageDialog("<b>'Remote Address' cannot be empty</b>\n\nPlease enter a "
-                                      "valid remote address then try saving again");
+  // (a running macro holds its own reference to the old program)
+  g_string_assign(con->f12Macro, macroText);
 
-    gtk_window_present(GTK_WINDOW(win));
+  if (con->f12Program)
+    g_array_unref(con->f12Program);
 
-    // focus remote address
-    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "remoteAddress"));
+  GString * errStr = g_string_new(NULL);
 
-    return;
-  }
+  con->f12Program = svMacroCompile(macroText, errStr);
 
-  // check for duplicate name if this is a new connection
-  if (app->addNewConnection)
+  // log any problems
+  if (errStr->len > 0)
   {
-    // check if a connection exists with the same name
-    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
-
-    for (GList * l = rows; l; l = l->next)
-    {
-      GtkListBoxRow * row = l->data;
-      GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
-
-      const Connection * conTemp = g_object_get_data(G_OBJECT(box), "con");
-      if (!conTemp)
-          continue;
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "F12 macro problems for '%s':\n%s", con->name->str, errStr->str);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+  }
 
-      // if a connection exists with this name, warn user
-      if (strcmp(conTemp->name->str, nameVal) == 0)
-      {
-        GtkWidget * dialog = gtk_message_dialog_new_with_markup(GTK_WINDOW(win),
-                                          GTK_DIALOG_DESTROY_WITH_PARENT,
-                                          GTK_MESSAGE_ERROR,
-                                          GTK_BUTTONS_CLOSE,
-                                          "<b>Error: Connection name already exists</b>\n\nPlease change the "
-                                            "connection's name then try saving again");
-        gtk_window_set_title(GTK_WINDOW(dialog), "Name already exists - SpiritVNC");
-        gtk_dialog_run(GTK_DIALOG(dialog));
-        gtk_widget_destroy(dialog);
+  g_string_free(errStr, true);
+}
 
-        gtk_window_present(GTK_WINDOW(win));
 
-        // focus the connection name
-        gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "connectionName"));
+/* play the next steps of a connection's running macro */
+/* (scheduled on the main loop so waits never block) */
+gboolean svMacroPlayNext (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con)
+    return G_SOURCE_REMOVE;
 
-        return;
-      }
-    }
+  // this source is finished either way
+  con->macroSource = 0;
 
-    g_list_free(rows);
+  // stop if the connection went away
+  if (!con->macroProgram || !svConnectionScreen(con) || con->state != SV_STATE_CONNECTED)
+  {
+    svMacroStop(con);
+    return G_SOURCE_REMOVE;
   }
 
-  // set new name
-  g_string_assign(con->name, nameVal);
+  guint sent = 0;
 
-  // update existing list item
-  // if value changed, find server list row with old name and update
-  if (strcmp(oldVal, nameVal) != 0)
+  while (con->macroStep < con->macroProgram->len)
   {
-    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+    const MacroStep * step = &g_array_index(con->macroProgram, MacroStep, con->macroStep);
+    con->macroStep++;
 
-    // loop through each row
-    for (GList * l = rows; l != NULL; l = l->next)
+    // pause, then come back for the rest
+    if (step->type == SV_MACRO_WAIT)
     {
-      GtkWidget * row = GTK_WIDGET(l->data);
-
-      // get box that holds status image and label
-      GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
-      if (!rowBox)
-        continue;
-
-      // get box's children
-      GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
-
-      GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+      con->macroSource = g_timeout_add(step->delay, svMacroPlayNext, con);
+      return G_SOURCE_REMOVE;
+    }
 
-      g_list_free(boxChildren);
+    // wait for the screen to show something, then come back for the rest
+    if (step->type == SV_MACRO_WAITFOR)
+    {
+      svMatchWaitAdd(con, step->match, step->delay, svMacroMatched, NULL);
+      return G_SOURCE_REMOVE;
+    }
 
-      // get label's text
-      if (label && GTK_IS_LABEL(label))
-      {
-        const char * text = gtk_label_get_text(GTK_LABEL(label));
+    svConnectionSendKeys(con, step->keys, step->nKeys);
 
-        // if label's text matches this edited connection's old
-        // name, update it
-        if (strcmp(text, oldVal) == 0)
-        {
-          gtk_label_set_text(GTK_LABEL(label), nameVal);
-          break;
-        }
-      }
+    // give the main loop a turn on long macros
+    if (++sent >= SV_MACRO_STEPS_PER_TICK && con->macroStep < con->macroProgram->len)
+    {
+      con->macroSource = g_idle_add(svMacroPlayNext, con);
+      return G_SOURCE_REMOVE;
     }
-
-    // Free the list
-    g_list_free(rows);
   }
 
-  // connection group
-  const char * groupVal = (char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "connectionGroup")));
+  // all done
+  svMacroStop(con);
 
-  // set new value
-  if (groupVal[0] != '\0')
-    g_string_assign(con->group, groupVal);
-  else
-    g_string_assign(con->group, "General");
+  return G_SOURCE_REMOVE;
+}
 
-  // connection address
-  // set new value
-  g_string_assign(con->address, addressVal);
 
-  // connection f12 macro
-  g_string_assign(con->f12Macro, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "f12Macro"))));
+/* start playing a compiled macro program on a connection */
+void svMacroPlayProgram (Connection * con, GArray * program)
+{
+  if (!con || !program || program->len == 0 || con->state != SV_STATE_CONNECTED)
+    return;
 
-  // don't change type for reverse vnc connections
-  if (con->type != SV_TYPE_VNC_REVERSE)
+  // already playing (or waiting on the screen)
+  if (con->macroSource > 0 || con->macroProgram)
   {
-    // vnc choice radio button
-    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "vncChoice"))))
-      con->type = SV_TYPE_VNC;
-
-    // vnc-over-ssh choice radio button
-    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "svncChoice"))))
-      con->type = SV_TYPE_VNC_OVER_SSH;
+    svLog("A macro is already playing", true);
+    return;
   }
 
-  // vnc port
-  const char * vPortVal = (char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncPort")));
+  con->macroProgram = g_array_ref(program);
+  con->macroStep = 0;
 
-  // set new value
-  g_string_assign(con->vncPort, vPortVal);
+  svMacroPlayNext(con);
+}
 
-  // vnc password
-  const char * vPassVal = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncPassword")));
 
-  char * vPassDecoded = g_base64_encode((const unsigned char *)vPassVal, strlen(vPassVal));
-  g_string_assign(con->vncPass, vPassDecoded);
-  g_free(vPassDecoded);
+/* start playing a connection's f12 macro */
+void svMacroPlay (Connection * con)
+{
+  if (!con)
+    return;
 
-  // vnc 'login' username
-  g_string_assign(con->vncLoginUser, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncLoginUsername"))));
+  svMacroPlayProgram(con, con->f12Program);
+}
 
-  // vnc 'login' password
-  const char * vLoginPassVal = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncLoginPassword")));
 
-  char * vLoginPassDecoded = g_base64_encode((const unsigned char *)vLoginPassVal, strlen(vLoginPassVal));
-  g_string_assign(con->vncLoginPass, vLoginPassDecoded);
-  g_free(vLoginPassDecoded);
+/* stop a connection's running macro, if any */
+void svMacroStop (Connection * con)
+{
+  if (!con)
+    return;
 
-  // vnc image quality
-  con->quality = gtk_combo_box_get_active(GTK_COMBO_BOX((GtkWidget *)g_hash_table_lookup(ht, "vncQuality")));
+  if (con->macroSource > 0)
+  {
+    g_source_remove(con->macroSource);
+    con->macroSource = 0;
+  }
 
-  // vnc lossy encoding
-  con->lossyEncoding = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "vncLossyEncoding")));
+  // (quietly - the macro is what's ending)
+  svMatchWaitCancel(con, svMacroMatched, NULL, NULL);
 
-  // vnc scaling
-  con->scale = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "vncScaling")));
+  if (con->macroProgram)
+  {
+    g_array_unref(con->macroProgram);
+    con->macroProgram = NULL;
+  }
 
-  // ssh username
-  g_string_assign(con->sshUser, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "sshUsername"))));
+  con->macroStep = 0;
+}
 
-  // ssh port
-  g_string_assign(con->sshPort, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "sshPort"))));
 
-  // ssh private key file
-  g_string_assign(con->sshPrivKeyfile, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "sshPrivateKey"))));
+/* make a gray (luma) copy of a pixbuf, one byte per pixel */
+guchar * svMatchGray (GdkPixbuf * pic, guint * width, guint * height)
+{
+  const guint w = gdk_pixbuf_get_width(pic);
+  const guint h = gdk_pixbuf_get_height(pic);
+  const guint channels = gdk_pixbuf_get_n_channels(pic);
+  const guint stride = gdk_pixbuf_get_rowstride(pic);
+  const guchar * pixels = gdk_pixbuf_get_pixels(pic);
 
-  // custom command 1 enabled
-  con->customCmd1Enabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "cmd1Enabled")));
+  guchar * gray = g_malloc((gsize)w * h);
 
-  // custom command 1 label
-  g_string_assign(con->customCmd1Label, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd1Label"))));
+  for (guint y = 0; y < h; y++)
+  {
+    const guchar * p = pixels + (gsize)y * stride;
+    guchar * g = gray + (gsize)y * w;
 
-  // custom command 1
-  g_string_assign(con->customCmd1, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd1"))));
+    for (guint x = 0; x < w; x++, p += channels)
+      g[x] = (guchar)((77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8);
+  }
 
-  // custom command 2 enabled
-  con->customCmd2Enabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "cmd2Enabled")));
+  *width = w;
+  *height = h;
 
-  // custom command 2 label
-  g_string_assign(con->customCmd2Label, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd2Label"))));
+  return gray;
+}
 
-  // custom command 2
-  g_string_assign(con->customCmd2, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd2"))));
 
-  // custom command 3 enabled
-  con->customCmd3Enabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "cmd3Enabled")));
+/* shrink a gray image by SV_MATCH_COARSE in each direction, averaging each block */
+guchar * svMatchShrink (const guchar * gray, guint w, guint h, guint * cw, guint * ch)
+{
+  const guint s = SV_MATCH_COARSE;
 
-  // custom command 3 label
-  g_string_assign(con->customCmd3Label, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd3Label"))));
+  *cw = w / s;
+  *ch = h / s;
 
-  // custom command 3
-  g_string_assign(con->customCmd3, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd3"))));
+  if (*cw == 0 || *ch == 0)
+    return NULL;
 
-  // write out the settings
-  svConfigWrite();
+  guchar * small = g_malloc((gsize)*cw * *ch);
 
-  // ========= add to the hostlist and connections if this is a new connection =========
-  if (app->addNewConnection)
+  for (guint y = 0; y < *ch; y++)
   {
-    // get all rows from host list
-    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
-
-    gint rowIdx = -1;
-
-    const char * lastGroup = NULL;
-    gboolean myGroupFound = false;
-
-    // go through connections glist and find last of this group
-    for (GList * l = rows; l; l = l->next)
+    for (guint x = 0; x < *cw; x++)
     {
-      GtkListBoxRow * row = l->data;
-      GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+      guint sum = 0;
 
-      Connection * conTemp = g_object_get_data(G_OBJECT(box), "con");
+      for (guint by = 0; by < s; by++)
+        for (guint bx = 0; bx < s; bx++)
+          sum += gray[(gsize)(y * s + by) * w + x * s + bx];
 
-      // break if we are at the end of this new connection's group
-      if (conTemp)
-      {
-        // checking if we need to add an empty row before our new connection
-        if (conTemp->group->len > 0 && strcmp(conTemp->group->str, con->group->str) == 0)
-          myGroupFound = true;
+      small[(gsize)y * *cw + x] = (guchar)(sum / (s * s));
+    }
+  }
 
-        // get out of loop if we just left our group into another
-        if (lastGroup && strcmp(conTemp->group->str, lastGroup) != 0 &&
-          strcmp(lastGroup, con->group->str) == 0)
-          break;
+  return small;
+}
 
-        lastGroup = conTemp->group->str;
-      }
 
-      rowIdx++;
-    }
+/* sum of absolute differences between two gray blocks (gives up once past limit) */
+guint64 svMatchSad (const guchar * a, gsize aStride, const guchar * b, gsize bStride,
+  guint w, guint h, guint64 limit)
+{
+  guint64 sum = 0;
 
-    g_list_free(rows);
+  for (guint y = 0; y < h; y++)
+  {
+    const guchar * pa = a + y * aStride;
+    const guchar * pb = b + y * bStride;
+    guint x = 0;
 
-    // insert into connections list at currently selected location or
-    // the end of the list if rowIdx is -1
+    #ifdef __SSE2__
+    // 16 pixels at a time
+    __m128i acc = _mm_setzero_si128();
 
-    // insert empty row before new connection (with new group)
-    if (!myGroupFound)
-      svInsertHostListRow("", rowIdx, NULL);
+    for (; x + 16 <= w; x += 16)
+      acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(pa + x)),
+        _mm_loadu_si128((const __m128i *)(pb + x))));
 
-    // insert new connection
-    svInsertHostListRow(con->name->str, rowIdx, con);
+    sum += (guint)_mm_cvtsi128_si32(acc) + (guint)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+    #endif
 
-    app->addNewConnection = false;
+    for (; x < w; x++)
+      sum += (pa[x] > pb[x]) ? pa[x] - pb[x] : pb[x] - pa[x];
 
-    svSetHostlistItemsTooltips();
+    // (checked per row - most wrong spots are obvious early)
+    if (sum > limit)
+      return sum;
   }
 
-  // destroy the connection settings window
-  gtk_widget_destroy(win);
+  return sum;
+}
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
 
-  // free the g_new'd settings
-  g_hash_table_destroy(ht);
+/* look for a template near a spot on the screen at full size, keeping the best found so far */
+void svMatchRefine (const MatchTemplate * tmpl, const MatchScreen * scr, gint cx, gint cy, gint radius,
+  guint64 * best, gint * bestX, gint * bestY)
+{
+  const gint maxX = (gint)(scr->width - tmpl->width);
+  const gint maxY = (gint)(scr->height - tmpl->height);
 
-  // update stuff if connected
-  if (con->state == SV_STATE_CONNECTED)
+  for (gint y = MAX(cy - radius, 0); y <= MIN(cy + radius, maxY); y++)
   {
-    // set image quality
-    switch (con->quality)
+    for (gint x = MAX(cx - radius, 0); x <= MIN(cx + radius, maxX); x++)
     {
-      case SV_QUAL_LOW:
-        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_LOW);
-        break;
-      case SV_QUAL_MEDIUM:
-        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_MEDIUM);
-        break;
-      case SV_QUAL_FULL:
-        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_FULL);
-        break;
-      default:
-        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_DEFAULT);
-    }
-
-    // set lossy encoding
-    vnc_display_set_lossy_encoding(VNC_DISPLAY(con->vncObj), con->lossyEncoding);
+      const guint64 sad = svMatchSad(scr->gray + (gsize)y * scr->width + x, scr->width,
+        tmpl->gray, tmpl->width, tmpl->width, tmpl->height, *best);
 
-    // set scaling
-    vnc_display_set_scaling(VNC_DISPLAY(con->vncObj), con->scale);
-    vnc_display_set_keep_aspect_ratio(VNC_DISPLAY(con->vncObj), TRUE);
+      if (sad < *best)
+      {
+        *best = sad;
+        *bestX = x;
+        *bestY = y;
+      }
+    }
   }
 }
 
 
-/* handles the 'choose private key' button in the connection editor */
-void svHandleConnectionSSHPrivKey (GtkButton * self, gpointer userData)
+/* find a template on the screen - a shrunken pass picks a few likely spots, */
+/* then each is checked at full size (false if nothing is close enough) */
+gboolean svMatchFind (const MatchTemplate * tmpl, const MatchScreen * scr, gint * foundX, gint * foundY)
 {
-  // hash table has pointers to child window and its controls
-  GHashTable * ht = (GHashTable *)userData;
-  if (!ht)
-    return;
+  if (tmpl->width > scr->width || tmpl->height > scr->height)
+    return false;
 
-  GtkWidget * entry = (GtkWidget *)g_hash_table_lookup(ht, "sshPrivateKey");
-  if (!entry || !GTK_IS_ENTRY(entry))
-    return;
+  const guint64 limit = (guint64)tmpl->width * tmpl->height * SV_MATCH_MAX_DIFF;
 
-  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
-  if (!win)
-    return;
-
-  GtkWidget * dialog;
-  GtkFileChooserAction action = GTK_FILE_CHOOSER_ACTION_OPEN;
-  gint res;
+  guint64 best = limit + 1;
+  gint bestX = -1;
+  gint bestY = -1;
 
-  dialog = gtk_file_chooser_dialog_new("Choose a private key",
-                                        GTK_WINDOW(win),
-                                        action,
-                                        ("_Cancel"),
-                                        GTK_RESPONSE_CANCEL,
-                                        ("_Open"),
-                                        GTK_RESPONSE_ACCEPT,
-                                        NULL);
+  // a template with a position only needs checking there (give or take a little)
+  if (tmpl->fixedX >= 0)
+    svMatchRefine(tmpl, scr, tmpl->fixedX, tmpl->fixedY, SV_MATCH_SLACK, &best, &bestX, &bestY);
 
-  res = gtk_dialog_run(GTK_DIALOG (dialog));
+  // too small to shrink, so look everywhere at full size
+  else if (!tmpl->coarse || !scr->coarse || tmpl->cw > scr->cw || tmpl->ch > scr->ch)
+    svMatchRefine(tmpl, scr, 0, 0, MAX(scr->width, scr->height), &best, &bestX, &bestY);
 
-  if (res == GTK_RESPONSE_ACCEPT)
+  else
   {
-    char * filename;  //  <<<-- NO const char *
-    GtkFileChooser * chooser = GTK_FILE_CHOOSER(dialog);
-    filename = gtk_file_chooser_get_filename(chooser);
-    gtk_entry_set_text(GTK_ENTRY(entry), filename);
-    g_free(filename);
-  }
+    // (the shrunken pass is more forgiving, since blocks don't line up exactly)
+    const guint64 coarseLimit = (guint64)tmpl->cw * tmpl->ch * SV_MATCH_MAX_DIFF * 2;
 
-  // destroy the dialog window
-  gtk_widget_destroy(dialog);
+    guint64 candScore[SV_MATCH_CANDIDATES];
+    gint candX[SV_MATCH_CANDIDATES];
+    gint candY[SV_MATCH_CANDIDATES];
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
-}
+    for (guint i = 0; i < SV_MATCH_CANDIDATES; i++)
+    {
+      candScore[i] = coarseLimit + 1;
+      candX[i] = candY[i] = -1;
+    }
 
+    guint worst = 0;
 
-/* create and display connection edit window */
-void svShowAppOptionsWindow ()
-{
-  GHashTable * htAppOptions = g_hash_table_new(NULL, NULL);
-  if (!htAppOptions)
-    return;
+    for (guint y = 0; y + tmpl->ch <= scr->ch; y++)
+    {
+      for (guint x = 0; x + tmpl->cw <= scr->cw; x++)
+      {
+        const guint64 sad = svMatchSad(scr->coarse + (gsize)y * scr->cw + x, scr->cw,
+          tmpl->coarse, tmpl->cw, tmpl->cw, tmpl->ch, candScore[worst]);
 
-  // log
-  svLog("Editing app options", true);
+        if (sad >= candScore[worst])
+          continue;
 
-  // create edit window
-  GtkWidget * win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-  //opts->optionsWin = win;
-  g_hash_table_insert(htAppOptions, "win", win);
+        candScore[worst] = sad;
+        candX[worst] = x;
+        candY[worst] = y;
 
-  // set window title
-  gtk_window_set_title(GTK_WINDOW(win), "SpiritVNC App Options");
-  gtk_window_set_modal(GTK_WINDOW(win), true);
-  gtk_window_set_resizable(GTK_WINDOW(win), false);
-  gtk_window_set_transient_for(GTK_WINDOW(win), GTK_WINDOW(app->mainWin));
-  gtk_window_set_position(GTK_WINDOW(win), GTK_WIN_POS_CENTER_ON_PARENT);
+        // the next one to beat is the worst of the rest
+        for (guint i = 0; i < SV_MATCH_CANDIDATES; i++)
+          if (candScore[i] > candScore[worst])
+            worst = i;
+      }
+    }
 
-  // parent box
-  GtkWidget * boxOptsParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
-  gtk_container_set_border_width(GTK_CONTAINER(boxOptsParent), 5);
-  gtk_container_add(GTK_CONTAINER(win), boxOptsParent);
+    for (guint i = 0; i < SV_MATCH_CANDIDATES; i++)
+      if (candX[i] >= 0)
+        svMatchRefine(tmpl, scr, candX[i] * SV_MATCH_COARSE, candY[i] * SV_MATCH_COARSE,
+          SV_MATCH_COARSE, &best, &bestX, &bestY);
+  }
 
-  // container grid
-  GtkWidget * optsPage = gtk_grid_new();
-  gtk_grid_set_column_homogeneous(GTK_GRID(optsPage), false);
-  gtk_container_set_border_width(GTK_CONTAINER(optsPage), 7);
-  gtk_grid_set_column_spacing(GTK_GRID(optsPage), 7);
-  gtk_grid_set_row_spacing(GTK_GRID(optsPage), 5);
+  if (best > limit)
+    return false;
 
-  guint rowNum = 1;
+  *foundX = bestX;
+  *foundY = bestY;
 
-  // show tooltips
-  GtkWidget * lblTooltips = gtk_label_new("Show tooltips");
-  gtk_widget_set_halign(lblTooltips, GTK_ALIGN_END);
-  GtkWidget * chkShowTooltips = gtk_check_button_new();
-  g_hash_table_insert(htAppOptions, "chkShowTooltips", chkShowTooltips);
-  if (app->showTooltips)
-    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkShowTooltips), true);
-  svSetTooltip(chkShowTooltips, "Displays tooltips for most app items");
+  return true;
+}
 
-  gtk_grid_attach(GTK_GRID(optsPage), lblTooltips, 1, rowNum, 1, 1);
-  gtk_grid_attach(GTK_GRID(optsPage), chkShowTooltips, 2, rowNum++, 1, 1);
 
-  // log to file
-  GtkWidget * lblLog = gtk_label_new("Log events to file");
-  gtk_widget_set_halign(lblLog, GTK_ALIGN_END);
-  GtkWidget * chkLogToFile = gtk_check_button_new();
-  g_hash_table_insert(htAppOptions, "chkLogToFile", chkLogToFile);
-  svSetTooltip(chkLogToFile, "Logs most app events to a log file");
+/* load a reference image to look for on screen */
+/* (relative paths are in the config dir; fixedX / fixedY are -1 to look anywhere) */
+MatchTemplate * svMatchTemplateLoad (const char * path, gint fixedX, gint fixedY, GString * errStr)
+{
+  char * fullPath = g_path_is_absolute(path) ? g_strdup(path) :
+    g_build_filename(app->appConfigDir->str, path, NULL);  // <<<--- do NOT make const char *
 
-  if (app->logToFile)
-    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkLogToFile), true);
+  GError * error = NULL;
+  GdkPixbuf * pic = gdk_pixbuf_new_from_file(fullPath, &error);
 
-  gtk_grid_attach(GTK_GRID(optsPage), lblLog, 1, rowNum, 1, 1);
-  gtk_grid_attach(GTK_GRID(optsPage), chkLogToFile, 2, rowNum++, 1, 1);
+  if (!pic)
+  {
+    if (errStr)
+      g_string_append_printf(errStr, "Unable to load '%s': %s\n", fullPath, error->message);
 
-  // scan timeout
-  GtkWidget * lblScanTime = gtk_label_new("Scan timeout (secs)");
-  gtk_widget_set_halign(lblScanTime, GTK_ALIGN_END);
-  GtkWidget * spinScanTimeout = gtk_spin_button_new_with_range(0, 100, 1);
-  g_hash_table_insert(htAppOptions, "spinScanTimeout", spinScanTimeout);
-  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinScanTimeout), app->scanTimeout);
-  svSetTooltip(spinScanTimeout, "How long the app waits before moving to the next viewer "
-    "when scanning is enabled");
+    g_error_free(error);
+    g_free(fullPath);
+    return NULL;
+  }
 
-  gtk_grid_attach(GTK_GRID(optsPage), lblScanTime, 1, rowNum, 1, 1);
-  gtk_grid_attach(GTK_GRID(optsPage), spinScanTimeout, 2, rowNum++, 1, 1);
+  MatchTemplate * tmpl = g_new0(MatchTemplate, 1);
+  tmpl->refs = 1;
+  tmpl->path = g_string_new(fullPath);
+  tmpl->fixedX = fixedX;
+  tmpl->fixedY = fixedY;
+  tmpl->gray = svMatchGray(pic, &tmpl->width, &tmpl->height);
+  tmpl->coarse = svMatchShrink(tmpl->gray, tmpl->width, tmpl->height, &tmpl->cw, &tmpl->ch);
 
-  // vnc wait time
-  GtkWidget * lblVNCWaitTime = gtk_label_new("VNC wait time");
-  gtk_widget_set_halign(lblVNCWaitTime, GTK_ALIGN_END);
-  GtkWidget * spinVncWaitTime = gtk_spin_button_new_with_range(0, 100, 1);
-  g_hash_table_insert(htAppOptions, "spinVncWaitTime", spinVncWaitTime);
-  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinVncWaitTime), app->vncConnectWaitTime);
-  svSetTooltip(spinVncWaitTime, "How long the app waits before a VNC connection "
-    "attempt times out");
+  g_object_unref(pic);
+  g_free(fullPath);
 
-  gtk_grid_attach(GTK_GRID(optsPage), lblVNCWaitTime, 1, rowNum, 1, 1);
-  gtk_grid_attach(GTK_GRID(optsPage), spinVncWaitTime, 2, rowNum++, 1, 1);
+  return tmpl;
+}
 
-  // ssh wait time
-  GtkWidget * lblSSHWaitTime = gtk_label_new("SSH wait time");
-  gtk_widget_set_halign(lblSSHWaitTime, GTK_ALIGN_END);
-  GtkWidget * spinSSHWaitTime = gtk_spin_button_new_with_range(0, 100, 1);
-  g_hash_table_insert(htAppOptions, "spinSSHWaitTime", spinSSHWaitTime);
-  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinSSHWaitTime), app->sshConnectWaitTime);
-  svSetTooltip(spinSSHWaitTime, "How long the app waits before a SSH connection "
-    "attempt times out");
 
-  gtk_grid_attach(GTK_GRID(optsPage), lblSSHWaitTime, 1, rowNum, 1, 1);
-  gtk_grid_attach(GTK_GRID(optsPage), spinSSHWaitTime, 2, rowNum++, 1, 1);
+/* drop a reference to a reference image */
+void svMatchTemplateUnref (MatchTemplate * tmpl)
+{
+  if (!tmpl || --tmpl->refs > 0)
+    return;
 
-  // ssh command
-  GtkWidget * lblSSHCmd = gtk_label_new("SSH command");
-  gtk_widget_set_halign(lblSSHCmd, GTK_ALIGN_END);
-  GtkWidget * entSSHCommand = gtk_entry_new();
-  g_hash_table_insert(htAppOptions, "entSSHCommand", entSSHCommand);
-  gtk_entry_set_width_chars(GTK_ENTRY(entSSHCommand), 30);
-  gtk_entry_set_text(GTK_ENTRY(entSSHCommand), app->sshCommand->str);
-  svSetTooltip(entSSHCommand, "The system SSH command (/usr/bin/ssh, etc)");
+  g_free(tmpl->gray);
+  g_free(tmpl->coarse);
+  g_string_free(tmpl->path, true);
+  g_free(tmpl);
+}
 
-  gtk_grid_attach(GTK_GRID(optsPage), lblSSHCmd, 1, rowNum, 1, 1);
-  gtk_grid_attach(GTK_GRID(optsPage), entSSHCommand, 2, rowNum++, 1, 1);
 
-  // add optsPage to parent box
-  gtk_box_pack_start(GTK_BOX(boxOptsParent), optsPage, false, false, 0);
+/* grab a connection's screen for matching (NULL if there isn't one) */
+MatchScreen * svMatchScreenNew (Connection * con)
+{
+  if (con->state != SV_STATE_CONNECTED)
+    return NULL;
 
-  // ------------------- save / cancel buttons -------------------
-  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  GdkPixbuf * pic = svConnectionPixbuf(con);
+  if (!pic)
+    return NULL;
 
-  // save
-  GtkWidget * btnSave = gtk_button_new_with_label("Save");
-  gtk_widget_set_size_request(btnSave, 110, -1);
-  svSetTooltip(btnSave, "Click to save these settings");
-  g_signal_connect(btnSave, "clicked", G_CALLBACK(svHandleAppOptionsButtons), htAppOptions);
+  MatchScreen * scr = g_new0(MatchScreen, 1);
+  scr->gray = svMatchGray(pic, &scr->width, &scr->height);
+  scr->coarse = svMatchShrink(scr->gray, scr->width, scr->height, &scr->cw, &scr->ch);
 
-  // cancel
-  GtkWidget * btnCancel = gtk_button_new_with_label("Cancel");
-  g_hash_table_insert(htAppOptions, "btnCancel", btnCancel);
-  gtk_widget_set_size_request(btnCancel, 110, -1);
-  svSetTooltip(btnCancel, "Click to abandon any changes.  "
-    "Caution: Any changes will be lost!");
-  g_signal_connect(btnCancel, "clicked", G_CALLBACK(svHandleAppOptionsButtons), htAppOptions);
+  g_object_unref(pic);
 
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnSave, false, false, 3);
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnCancel, false, false, 3);
-  //
-  gtk_container_add(GTK_CONTAINER(boxOptsParent), boxButtons);
+  return scr;
+}
 
-  // show everything
-  gtk_widget_show_all(win);
 
-  gtk_window_present(GTK_WINDOW(win));
+/* free a grabbed screen */
+void svMatchScreenFree (MatchScreen * scr)
+{
+  if (!scr)
+    return;
 
-  // focus the first entry
-  gtk_widget_grab_focus(chkShowTooltips);
+  g_free(scr->gray);
+  g_free(scr->coarse);
+  g_free(scr);
 }
 
 
-/* handle send function key button */
-void svHandleSendFunctionKeyButton (GtkWidget * unused, gpointer data)
+/* finish a screen wait - found (error is NULL) or not - and tell whoever asked */
+void svMatchWaitEnd (MatchWait * wait, const char * error, gint x, gint y)
 {
-  // get the connections glist item for this index
-  Connection * con = svGetSelectedConnectionListConnection();
-  if (!con || con->name->len == 0)
-    return;
+  Connection * con = wait->con;
 
-  guint key = GPOINTER_TO_UINT(data);
+  con->matchWaits = g_list_remove(con->matchWaits, wait);
 
-  guint keys[1];
-  keys[0] = key;
+  if (wait->timeoutSource > 0)
+    g_source_remove(wait->timeoutSource);
 
-  vnc_display_send_keys(VNC_DISPLAY(con->vncObj), keys, 1);
+  MatchCallback cb = wait->cb;
+  gpointer data = wait->data;
+
+  svMatchTemplateUnref(wait->tmpl);
+  g_free(wait);
+
+  if (cb)
+    cb(con, error, x, y, data);
 }
 
 
-/* handle 'close' button on connection actions window */
-void svHandleConnectionActionsCloseButton (GtkWidget * unused1, gpointer unused2)
+/* check the screen for everything being waited on */
+void svMatchCheck (Connection * con)
 {
-  if (app->connectionActionsWindow)
+  if (!con->matchWaits)
+    return;
+
+  MatchScreen * scr = svMatchScreenNew(con);
+  if (!scr)
+    return;
+
+  // (a callback can add or end waits, so walk a copy)
+  GList * waits = g_list_copy(con->matchWaits);
+
+  for (GList * l = waits; l; l = l->next)
   {
-    gtk_widget_destroy(app->connectionActionsWindow);
-    gtk_window_present(GTK_WINDOW(app->mainWin));
-    app->connectionActionsWindow = NULL;
+    MatchWait * wait = l->data;
+    gint x = 0;
+    gint y = 0;
+
+    if (g_list_find(con->matchWaits, wait) && svMatchFind(wait->tmpl, scr, &x, &y))
+      svMatchWaitEnd(wait, NULL, x, y);
   }
+
+  g_list_free(waits);
+
+  svMatchScreenFree(scr);
 }
 
 
-/* handle esc key from connection actions window */
-gboolean svHandleConnectionActionsCloseKey (GtkWidget * widget, GdkEventKey * event, gpointer data)
+/* check a connection's screen for waits, after a screen update */
+gboolean svMatchTimer (gpointer data)
 {
-  // handle esc key
-  if (event->keyval == GDK_KEY_Escape)
-  {
-    svHandleConnectionActionsCloseButton(NULL, NULL);
-    return true;
-  }
+  Connection * con = (Connection *)data;
 
-  return false;
+  con->matchSource = 0;
+  con->matchLast = g_get_monotonic_time();
+
+  svMatchCheck(con);
+
+  return G_SOURCE_REMOVE;
 }
 
 
-/* create and display connection actions window */
-void svShowConnectionActionsWindow ()
+/* the screen changed - check it for waits soon (no more often than every SV_MATCH_MIN_MS) */
+void svMatchSchedule (Connection * con)
 {
-  if (app->connectionActionsWindow)
+  if (!con->matchWaits || con->matchSource > 0)
     return;
 
-  // create connection actions window
-  app->connectionActionsWindow = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  const gint64 sinceMs = (g_get_monotonic_time() - con->matchLast) / 1000;
 
-  // set window title
-  gtk_window_set_title(GTK_WINDOW(app->connectionActionsWindow), "SpiritVNC Connection Actions");
-  gtk_window_set_modal(GTK_WINDOW(app->connectionActionsWindow), true);
-  //gtk_window_set_resizable(GTK_WINDOW(app->connectionActionsWindow), false);
-  gtk_window_set_transient_for(GTK_WINDOW(app->connectionActionsWindow), GTK_WINDOW(app->mainWin));
-  gtk_window_set_position(GTK_WINDOW(app->connectionActionsWindow), GTK_WIN_POS_CENTER_ON_PARENT);
+  con->matchSource = g_timeout_add(sinceMs >= SV_MATCH_MIN_MS ? 0 : (guint)(SV_MATCH_MIN_MS - sinceMs),
+    svMatchTimer, con);
+}
 
-  // parent grid
-  GtkWidget * parentGrid = gtk_grid_new();
-  gtk_grid_set_row_spacing(GTK_GRID(parentGrid), 10);
-  gtk_grid_set_column_spacing(GTK_GRID(parentGrid), 10);
-  gtk_container_set_border_width(GTK_CONTAINER(parentGrid), 10);
-  gtk_container_add(GTK_CONTAINER(app->connectionActionsWindow), parentGrid);
 
-  // send control-alt-delete
-  GtkWidget * btnCAD = gtk_button_new_with_label("Send Ctrl+Alt+Del");
-  g_signal_connect(btnCAD, "clicked", G_CALLBACK(svHandleSendCADMenuItem), NULL);
-  gtk_grid_attach(GTK_GRID(parentGrid), btnCAD, 0, 0, 1, 1);
+/* handle a screen wait running out of time */
+gboolean svMatchWaitTimeout (gpointer data)
+{
+  MatchWait * wait = (MatchWait *)data;
 
-  // send control-alt-delete
-  GtkWidget * btnCSE = gtk_button_new_with_label("Send Ctrl+Shift+Esc");
-  g_signal_connect(btnCSE, "clicked", G_CALLBACK(svHandleSendCSEMenuItem), NULL);
-  gtk_grid_attach(GTK_GRID(parentGrid), btnCSE, 1, 0, 1, 1);
+  wait->timeoutSource = 0;
 
-  // send refresh request
-  GtkWidget * btnRefresh = gtk_button_new_with_label("Send refresh request");
-  g_signal_connect(btnRefresh, "clicked", G_CALLBACK(svHandleRequestUpdateMenuItem), NULL);
-  gtk_grid_attach(GTK_GRID(parentGrid), btnRefresh, 0, 1, 1, 1);
+  svMatchWaitEnd(wait, "timeout", -1, -1);
 
-  // send f8 key
-  GtkWidget * btnF8 = gtk_button_new_with_label("Send F8 key");
-  g_signal_connect(btnF8, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F8));
-  gtk_grid_attach(GTK_GRID(parentGrid), btnF8, 1, 1, 1, 1);
+  return G_SOURCE_REMOVE;
+}
 
-  // send f9 key
-  GtkWidget * btnF9 = gtk_button_new_with_label("Send F9 key");
-  g_signal_connect(btnF9, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F9));
-  gtk_grid_attach(GTK_GRID(parentGrid), btnF9, 0, 2, 1, 1);
 
-  // send f11 key
-  GtkWidget * btnF11 = gtk_button_new_with_label("Send F11 key");
-  g_signal_connect(btnF11, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F11));
-  gtk_grid_attach(GTK_GRID(parentGrid), btnF11, 1, 2, 1, 1);
+/* wait (up to secs) for a connection's screen to show a reference image, then call cb */
+/* (checked right away, then again as screen updates arrive) */
+void svMatchWaitAdd (Connection * con, MatchTemplate * tmpl, guint secs, MatchCallback cb, gpointer data)
+{
+  MatchWait * wait = g_new0(MatchWait, 1);
+  wait->con = con;
+  wait->tmpl = tmpl;
+  wait->cb = cb;
+  wait->data = data;
+  wait->timeoutSource = g_timeout_add_seconds(MAX(secs, 1), svMatchWaitTimeout, wait);
 
-  // send f12 key
-  GtkWidget * btnF12 = gtk_button_new_with_label("Send F12 key");
-  g_signal_connect(btnF12, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F12));
-  gtk_grid_attach(GTK_GRID(parentGrid), btnF12, 0, 3, 1, 1);
+  tmpl->refs++;
 
-  // send entered keys
-  GtkWidget * btnKeys = gtk_button_new_with_label("Send entered keys...");
-  g_signal_connect(btnKeys, "clicked", G_CALLBACK(svHandleSendEnteredKeystrokesMenuItem), NULL);
-  gtk_grid_attach(GTK_GRID(parentGrid), btnKeys, 1, 3, 1, 1);
+  con->matchWaits = g_list_append(con->matchWaits, wait);
 
-  // close button box
-  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  svMatchSchedule(con);
+}
 
-  // cancel
-  GtkWidget * btnClose = gtk_button_new_with_label("Close");
-  g_signal_connect(btnClose, "clicked", G_CALLBACK(svHandleConnectionActionsCloseButton), NULL);
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnClose, false, false, 3);
-  //
-  gtk_grid_attach(GTK_GRID(parentGrid), boxButtons, 1, 4, 1, 1);
 
-  // show everything
-  gtk_widget_show_all(app->connectionActionsWindow);
+/* end a connection's screen waits - those for cb / data (NULL for any), or all of them */
+/* (callbacks are told about it only if error is set) */
+void svMatchWaitCancel (Connection * con, MatchCallback cb, gpointer data, const char * error)
+{
+  GList * l = con->matchWaits;
 
-  // focus the window
-  gtk_window_present(GTK_WINDOW(app->connectionActionsWindow));
+  while (l)
+  {
+    GList * next = l->next;
+    MatchWait * wait = l->data;
 
-  // add escape key handling to close window
-  g_signal_connect(app->connectionActionsWindow, "key-press-event", G_CALLBACK(svHandleConnectionActionsCloseKey),
-    NULL);
+    if ((!cb || wait->cb == cb) && (!data || wait->data == data))
+    {
+      if (!error)
+        wait->cb = NULL;
+
+      svMatchWaitEnd(wait, error, -1, -1);
+
+      // (a callback may have ended others)
+      next = con->matchWaits;
+    }
+
+    l = next;
+  }
+
+  if (!con->matchWaits && con->matchSource > 0)
+  {
+    g_source_remove(con->matchSource);
+    con->matchSource = 0;
+  }
 }
 
 
-/* create and display connection edit window */
-void svShowConnectionEditWindow (Connection * con)
+/* a macro's {WAITFOR} finished - carry on, or give up */
+void svMacroMatched (Connection * con, const char * error, gint x, gint y, gpointer unused)
 {
-  if (!con || con->name->len == 0)
+  if (error)
+  {
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Macro stopped on '%s' - screen wait failed: %s", con->name->str, error);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+
+    svMacroStop(con);
     return;
+  }
 
-  // hash table to contain pointers to this window and its children
-  GHashTable * ht = g_hash_table_new(NULL, NULL);
+  con->macroSource = g_idle_add(svMacroPlayNext, con);
+}
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Editing connection '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
 
-  // store this connection in hash table
-  g_hash_table_insert(ht, "con", con);
+/* free what a macro step holds */
+void svMacroStepClear (gpointer data)
+{
+  MacroStep * step = (MacroStep *)data;
 
-  gboolean preventConnectedEditing = false;
+  svMatchTemplateUnref(step->match);
+  step->match = NULL;
+}
 
-  // don't allow editing of certain things if we're waiting or connected
-  if (con->state == SV_STATE_WAITING || con->state == SV_STATE_CONNECTED)
-    preventConnectedEditing = true;
 
-  // create edit window
-  GtkWidget * win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-  g_hash_table_insert(ht, "win", win);
-  gtk_window_set_modal(GTK_WINDOW(win), true);
-  gtk_window_set_resizable(GTK_WINDOW(win), false);
-  gtk_window_set_transient_for(GTK_WINDOW(win), GTK_WINDOW(app->mainWin));
-  gtk_window_set_position(GTK_WINDOW(win), GTK_WIN_POS_CENTER_ON_PARENT);
+/* handle send entered keystrokes window buttons */
+void svHandleSendEnteredKeystrokesButtons (GtkButton * button, gpointer userData)
+{
+  // hash table for pointers to child window and its children
+  GHashTable * ht = (GHashTable *)userData;
+  if (!ht)
+    return;
 
-  // set window title
-  GString * strTitle = g_string_new(NULL);
-  g_string_printf(strTitle, "Editing '%s' - SpiritVNC", con->name->str);
-  gtk_window_set_title(GTK_WINDOW(win), strTitle->str);
-  g_string_free(strTitle, true);
+  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
+  if (!win)
+    return;
 
-  // create parent box
-  GtkWidget * boxEditParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
-  gtk_container_set_border_width(GTK_CONTAINER(boxEditParent), 5);
-  gtk_container_add(GTK_CONTAINER(win), boxEditParent);
+  // handle cancel button
+  if ((GtkWidget *)button == (GtkWidget *)g_hash_table_lookup(ht, "btnCancel"))
+  {
+    gtk_widget_destroy(win);
 
-  // tab control
-  GtkWidget * editTab = gtk_notebook_new();
+    gtk_window_present(GTK_WINDOW(app->mainWin));
 
-  // ------------------- vnc page -------------------
-  GtkWidget * vncPage = gtk_grid_new();
-  GtkWidget * lblVNCTab = gtk_label_new("VNC options");
-  gtk_container_set_border_width(GTK_CONTAINER(vncPage), 7);
-  gtk_grid_set_column_spacing(GTK_GRID(vncPage), 7);
-  gtk_grid_set_row_spacing(GTK_GRID(vncPage), 5);
+    g_hash_table_destroy(ht);
 
-  // connection name
-  GtkWidget * lblConName = gtk_label_new("Connection name");
-  gtk_widget_set_halign(lblConName, GTK_ALIGN_END);
-  GtkWidget * connectionName = gtk_entry_new();
-  g_hash_table_insert(ht, "connectionName", connectionName);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(connectionName), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(connectionName), 30);
-  gtk_entry_set_text(GTK_ENTRY(connectionName), con->name->str);
-  svSetTooltip(connectionName, "The name you choose for this connection "
-    "(not the host address)");
+    return;
+  }
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblConName, 1, 1, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), connectionName, 2, 1, 3, 1);
+  Connection * con = (Connection *)g_hash_table_lookup(ht, "con");
+  if (!con || !svConnectionScreen(con) || con->state != SV_STATE_CONNECTED)
+    return;
 
-  // connection group
-  GtkWidget * lblConGroup = gtk_label_new("Connection group");
-  gtk_widget_set_halign(lblConGroup, GTK_ALIGN_END);
-  GtkWidget * connectionGroup = gtk_entry_new();
-  g_hash_table_insert(ht, "connectionGroup", connectionGroup);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(connectionGroup), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(connectionGroup), 30);
-  gtk_entry_set_text(GTK_ENTRY(connectionGroup), con->group->str);
-  svSetTooltip(connectionGroup, "The group this connection belongs to");
+  const char * skType = (char *)g_hash_table_lookup(ht, "type");
+  GString * skTextToSend = (GString *)g_hash_table_lookup(ht, "textToSend");
+  GtkWidget * skTextView = (GtkWidget *)g_hash_table_lookup(ht, "textView");
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblConGroup, 1, 2, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), connectionGroup, 2, 2, 3, 1);
+  char * text = NULL;
 
-  // connection address
-  GtkWidget * lblConAddr = gtk_label_new("Remote address");
-  gtk_widget_set_halign(lblConAddr, GTK_ALIGN_END);
-  GtkWidget * remoteAddress = gtk_entry_new();
-  g_hash_table_insert(ht, "remoteAddress", remoteAddress);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(remoteAddress), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(remoteAddress), 30);
-  gtk_entry_set_text(GTK_ENTRY(remoteAddress), con->address->str);
-  svSetTooltip(remoteAddress, "The network address of the remote host");
+  // we're sending keys from the send keys window
+  if (skType == SV_SENDKEYS_TYPE_ENTRY)
+  {
+    if (!skTextView)
+      return;
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblConAddr, 1, 3, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), remoteAddress, 2, 3, 3, 1);
+    GtkTextBuffer * tb = gtk_text_view_get_buffer(GTK_TEXT_VIEW(skTextView));
 
-  // f12 macro
-  GtkWidget * lblF12Macro = gtk_label_new("F12 macro");
-  gtk_widget_set_halign(lblF12Macro, GTK_ALIGN_END);
-  GtkWidget * f12Macro = gtk_entry_new();
-  g_hash_table_insert(ht, "f12Macro", f12Macro);
-  gtk_entry_set_width_chars(GTK_ENTRY(f12Macro), 30);
-  gtk_entry_set_text(GTK_ENTRY(f12Macro), con->f12Macro->str);
-  svSetTooltip(f12Macro, "The characters sent to the remote host when the "
-    "F12 key is pressed");
+    GtkTextIter start, end;
+    gtk_text_buffer_get_start_iter(tb, &start);
+    gtk_text_buffer_get_end_iter(tb, &end);
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblF12Macro, 1, 4, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), f12Macro, 2, 4, 3, 1);
+    text = gtk_text_buffer_get_text(tb, &start, &end, false);  //  <<<--- NO const char *
+    if (text[0] == '\0')
+    {
+      g_free(text);
+      return;
+    }
+  }
+  // we're sending keys directly from another function
+  else
+  {
+    if (!skTextToSend || skTextToSend->len == 0)
+      return;
 
-  // vnc or vnc-over-ssh
-  gboolean allowConnectionTypeChange = true;
+    // set text
+    text = g_strdup(skTextToSend->str);
 
-  if (con->type == SV_TYPE_VNC_REVERSE || preventConnectedEditing)
-    allowConnectionTypeChange = false;
+    // free up gstring
+    g_string_free(skTextToSend, true);
+  }
 
-  GtkWidget * boxVNCChoice = gtk_box_new(GTK_ORIENTATION_VERTICAL, 3);
+  // paste through the remote clipboard if this connection is set up for it,
+  // otherwise fall back to keystrokes
+  if (con->pasteMode != SV_PASTE_CLIPBOARD || !svPasteViaClipboard(con, text))
+  {
+    // one keystroke per character, played like a macro (so '{' has to be doubled)
+    char * validText = g_utf8_make_valid(text, -1);  // <<<--- do NOT make const char *
+    GString * macro = g_string_new(NULL);
 
-  GtkWidget * lblVNCChoice = gtk_label_new("Server type");
-  gtk_widget_set_halign(lblVNCChoice, GTK_ALIGN_END);
+    for (const char * p = validText; *p != '\0'; p = g_utf8_next_char(p))
+    {
+      const gunichar ch = g_utf8_get_char(p);
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCChoice, 1, 5, 1, 1);
+      if (ch == '{')
+        g_string_append(macro, "{{");
+      else
+        g_string_append_unichar(macro, ch);
+    }
 
-  // - vnc choice group
-  GSList * vncChoiceGroup = NULL;
-  GtkWidget * vncChoice = gtk_radio_button_new_with_label(vncChoiceGroup, "VNC");
-  g_hash_table_insert(ht, "vncChoice", vncChoice);
-  gtk_widget_set_sensitive(vncChoice, allowConnectionTypeChange);
-  vncChoiceGroup = gtk_radio_button_get_group(GTK_RADIO_BUTTON(vncChoice));
-  GtkWidget * svncChoice = gtk_radio_button_new_with_label(vncChoiceGroup, "VNC over SSH");
-  g_hash_table_insert(ht, "svncChoice", svncChoice);
-  gtk_widget_set_sensitive(svncChoice, allowConnectionTypeChange);
-  svSetTooltip(vncChoice, "Sets this to be a VNC connection");
-  vncChoiceGroup = gtk_radio_button_get_group(GTK_RADIO_BUTTON(svncChoice));
-  svSetTooltip(svncChoice, "Sets this to be a VNC-over-SSH connection");
+    GArray * program = svMacroCompile(macro->str, NULL);
 
-  // - set value from connection
-  if (con->type == SV_TYPE_VNC)
-    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(vncChoice), true);
-  else if (con->type == SV_TYPE_VNC_OVER_SSH)
-    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(svncChoice), true);
+    // (these keys replace anything still playing)
+    svMacroStop(con);
+    svMacroPlayProgram(con, program);
 
-  gtk_container_add(GTK_CONTAINER(boxVNCChoice), vncChoice);
-  gtk_container_add(GTK_CONTAINER(boxVNCChoice), svncChoice);
+    g_array_unref(program);
+    g_string_free(macro, true);
+    g_free(validText);
+  }
 
-  gtk_grid_attach(GTK_GRID(vncPage), boxVNCChoice, 2, 5, 1, 1);
+  g_free(text);
 
-  // vnc port
-  GtkWidget * lblVNCPort = gtk_label_new("VNC port");
-  gtk_widget_set_halign(lblVNCPort, GTK_ALIGN_END);
-  GtkWidget * vncPort = gtk_entry_new();
-  g_hash_table_insert(ht, "vncPort", vncPort);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(vncPort), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(vncPort), 10);
-  gtk_entry_set_text(GTK_ENTRY(vncPort), con->vncPort->str);
-  svSetTooltip(vncPort, "The remote host's numbered VNC port");
+  if (win)
+    gtk_widget_destroy(win);
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCPort, 1, 6, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncPort, 2, 6, 3, 1);
+  gtk_window_present(GTK_WINDOW(app->mainWin));
 
-  // vnc password
-  GtkWidget * lblVNCPass = gtk_label_new("VNC password");
-  gtk_widget_set_halign(lblVNCPass, GTK_ALIGN_END);
-  GtkWidget * vncPassword = gtk_entry_new();
-  g_hash_table_insert(ht, "vncPassword", vncPassword);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(vncPassword), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(vncPassword), 30);
-  gtk_entry_set_visibility(GTK_ENTRY(vncPassword), false);
-  gsize vncPassOutLen = 0;
-  unsigned char * vncPassTemp = g_base64_decode(con->vncPass->str, &vncPassOutLen);
-  gtk_entry_set_text(GTK_ENTRY(vncPassword), (const char *)vncPassTemp);
-  g_free(vncPassTemp);
-  svSetTooltip(vncPassword, "The standard VNC password");
+  g_hash_table_destroy(ht);
+}
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCPass, 1, 7, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncPassword, 2, 7, 3, 1);
 
-  // vnc login username
-  GtkWidget * lblVNCLoginName = gtk_label_new("VNC login username");
-  gtk_widget_set_halign(lblVNCLoginName, GTK_ALIGN_END);
-  GtkWidget * vncLoginUsername = gtk_entry_new();
-  g_hash_table_insert(ht, "vncLoginUsername", vncLoginUsername);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(vncLoginUsername), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(vncLoginUsername), 30);
-  gtk_entry_set_text(GTK_ENTRY(vncLoginUsername), con->vncLoginUser->str);
-  svSetTooltip(vncLoginUsername, "The username used with VNC 'login' authentication");
+/* handle custom command output window 'ok' button */
+void svHandleCommandOutputOk (GtkButton * self, gpointer userData)
+{
+  GtkWidget * outWin = (GtkWidget *)userData;
+  if (!outWin)
+    return;
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCLoginName, 1, 8, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncLoginUsername, 2, 8, 3, 1);
+  // destroy the command output window
+  gtk_widget_destroy(outWin);
 
-  // vnc login password
-  GtkWidget * lblVNCLoginPass = gtk_label_new("VNC login password");
-  gtk_widget_set_halign(lblVNCLoginPass, GTK_ALIGN_END);
-  GtkWidget * vncLoginPassword = gtk_entry_new();
-  g_hash_table_insert(ht, "vncLoginPassword", vncLoginPassword);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(vncLoginPassword), false);
+  gtk_window_present(GTK_WINDOW(app->mainWin));
+}
+
+
+/* handle the app options 'save' button */
+void svHandleAppOptionsButtons (GtkButton * button, gpointer userData)
+{
+  GHashTable * ht = (GHashTable *)userData;
+  if (!ht)
+    return;
+
+  const GtkWidget * btnCancel = (GtkWidget *)g_hash_table_lookup(ht, "btnCancel");
+  if (!btnCancel)
+    return;
+
+  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
+  if (!win)
+    return;
+
+  // handle cancel
+  if ((GtkWidget *)button == btnCancel)
+  {
+    // log
+    svLog("Canceled app options editing", true);
+
+    // destroy the app options window
+    gtk_widget_destroy(win);
+
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+
+    return;
+  }
+
+  // *** save stuff ***
+
+  // log
+  svLog("Saving app options", true);
+
+  // -------------------------------------------
+
+  // show tooltips
+  GtkWidget * chkShowTooltips = (GtkWidget *)g_hash_table_lookup(ht, "chkShowTooltips");
+  if (chkShowTooltips)
+    app->showTooltips = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkShowTooltips));
+
+  // log to file
+  GtkWidget * chkLogToFile = (GtkWidget *)g_hash_table_lookup(ht, "chkLogToFile");
+  if (chkLogToFile)
+    app->logToFile = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkLogToFile));
+
+  // scan timeout
+  GtkWidget * entScanTimeout = (GtkWidget *)g_hash_table_lookup(ht, "entScanTimeout");
+  if (entScanTimeout)
+    app->scanTimeout = atoi(gtk_entry_get_text(GTK_ENTRY(entScanTimeout)));
+
+  // vnc connect wait time
+  GtkWidget * entVncWaitTime = (GtkWidget *)g_hash_table_lookup(ht, "entVncWaitTime");
+  if (entVncWaitTime)
+    app->vncConnectWaitTime = atoi(gtk_entry_get_text(GTK_ENTRY(entVncWaitTime)));
+
+  // ssh connect wait time
+  GtkWidget * entSSHWaitTime = (GtkWidget *)g_hash_table_lookup(ht, "entSSHWaitTime");
+  if (entSSHWaitTime)
+    app->sshConnectWaitTime = atoi(gtk_entry_get_text(GTK_ENTRY(entSSHWaitTime)));
+
+  // ssh command
+  GtkWidget * entSSHCommand = (GtkWidget *)g_hash_table_lookup(ht, "entSSHCommand");
+  if (entSSHCommand)
+    g_string_assign(app->sshCommand, gtk_entry_get_text(GTK_ENTRY(entSSHCommand)));
+
+  // listening ports (checked before saving anything else)
+  GtkWidget * entListenPorts = (GtkWidget *)g_hash_table_lookup(ht, "entListenPorts");
+  GArray * listenPortsTest = g_array_new(false, false, sizeof(guint16));
+  const gboolean listenPortsOkay = !entListenPorts ||
+    svListenParsePorts(gtk_entry_get_text(GTK_ENTRY(entListenPorts)), listenPortsTest);
+  g_array_unref(listenPortsTest);
+
+  // allowed reverse addresses (also checked first)
+  GtkWidget * entReverseAllow = (GtkWidget *)g_hash_table_lookup(ht, "entReverseAllow");
+  GPtrArray * reverseAllowTest = g_ptr_array_new_with_free_func(g_object_unref);
+  const gboolean reverseAllowOkay = !entReverseAllow ||
+    svReverseParseAllow(gtk_entry_get_text(GTK_ENTRY(entReverseAllow)), reverseAllowTest);
+
+  if (!reverseAllowOkay)
+  {
+    g_ptr_array_unref(reverseAllowTest);
+    svShowMessageDialog("<b>'Allowed reverse addresses' has problems</b>\n\nPlease enter "
+      "addresses or networks (192.168.1.5, 10.0.0.0/8, fd00::/8, etc) separated by commas, "
+      "or leave it empty to allow any address");
+    gtk_window_present(GTK_WINDOW(win));
+    gtk_widget_grab_focus(entReverseAllow);
+    return;
+  }
+
+  if (!listenPortsOkay)
+  {
+    g_ptr_array_unref(reverseAllowTest);
+
+    svShowMessageDialog("<b>'Listening ports' has problems</b>\n\nPlease enter one or more "
+      "port numbers (1 - 65535) separated by commas or spaces");
+    gtk_window_present(GTK_WINDOW(win));
+    gtk_widget_grab_focus(entListenPorts);
+    return;
+  }
+
+  // listening ports and backlog (take effect the next time listen mode is enabled)
+  if (entListenPorts)
+    g_string_assign(app->listenPorts, gtk_entry_get_text(GTK_ENTRY(entListenPorts)));
+
+  GtkWidget * spinListenBacklog = (GtkWidget *)g_hash_table_lookup(ht, "spinListenBacklog");
+  if (spinListenBacklog)
+    app->listenBacklog = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinListenBacklog));
+
+  // reverse connection admission (applies right away)
+  if (entReverseAllow)
+  {
+    g_string_assign(app->reverseAllowText, gtk_entry_get_text(GTK_ENTRY(entReverseAllow)));
+    g_ptr_array_unref(app->reverseAllow);
+    app->reverseAllow = reverseAllowTest;
+  }
+  else
+    g_ptr_array_unref(reverseAllowTest);
+
+  GtkWidget * spinReverseMax = (GtkWidget *)g_hash_table_lookup(ht, "spinReverseMax");
+  if (spinReverseMax)
+    app->reverseMax = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinReverseMax));
+
+  GtkWidget * spinReverseRate = (GtkWidget *)g_hash_table_lookup(ht, "spinReverseRate");
+  if (spinReverseRate)
+    app->reverseRatePerMin = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinReverseRate));
+
+  // clipboard history memory cap
+  GtkWidget * spinClipHistoryKB = (GtkWidget *)g_hash_table_lookup(ht, "spinClipHistoryKB");
+  if (spinClipHistoryKB)
+  {
+    app->clipHistoryKB = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinClipHistoryKB));
+    svClipHistoryTrim(NULL);
+  }
+
+  // reachability probe concurrency
+  GtkWidget * spinProbeConcurrency = (GtkWidget *)g_hash_table_lookup(ht, "spinProbeConcurrency");
+  if (spinProbeConcurrency)
+    app->probeConcurrency = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinProbeConcurrency));
+
+  // reachability probe reads rfb banner
+  GtkWidget * chkProbeBanner = (GtkWidget *)g_hash_table_lookup(ht, "chkProbeBanner");
+  if (chkProbeBanner)
+    app->probeReadBanner = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkProbeBanner));
+
+  // reachability probe interval (restarts the timer if changed)
+  GtkWidget * spinProbeInterval = (GtkWidget *)g_hash_table_lookup(ht, "spinProbeInterval");
+  if (spinProbeInterval)
+  {
+    guint probeInterval = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinProbeInterval));
+
+    if (probeInterval != app->probeInterval)
+    {
+      app->probeInterval = probeInterval;
+      svProbeSchedule();
+    }
+  }
+
+  // framebuffer memory budget (applies right away)
+  GtkWidget * spinFbBudget = (GtkWidget *)g_hash_table_lookup(ht, "spinFbBudget");
+  if (spinFbBudget)
+  {
+    app->fbBudgetMB = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinFbBudget));
+    svFbBudgetEnforce();
+  }
+
+  // pre-connect on hover / select
+  GtkWidget * chkPreconnect = (GtkWidget *)g_hash_table_lookup(ht, "chkPreconnect");
+  if (chkPreconnect)
+    app->preconnect = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkPreconnect));
+
+  // dns cache time
+  GtkWidget * spinDnsCacheSecs = (GtkWidget *)g_hash_table_lookup(ht, "spinDnsCacheSecs");
+  if (spinDnsCacheSecs)
+    app->dnsCacheSecs = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinDnsCacheSecs));
+
+  // idle disconnect minutes
+  GtkWidget * spinIdleMinutes = (GtkWidget *)g_hash_table_lookup(ht, "spinIdleMinutes");
+  if (spinIdleMinutes)
+    app->idleMinutes = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinIdleMinutes));
+
+  // reconnect idle connections when selected
+  GtkWidget * chkIdleReconnect = (GtkWidget *)g_hash_table_lookup(ht, "chkIdleReconnect");
+  if (chkIdleReconnect)
+    app->idleReconnect = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkIdleReconnect));
+
+  // shared memory screen export (starts or stops right away)
+  GtkWidget * chkShmExport = (GtkWidget *)g_hash_table_lookup(ht, "chkShmExport");
+  if (chkShmExport)
+  {
+    app->shmExport = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkShmExport));
+    svShmExportAll();
+  }
+
+  // run connections in viewer processes (from their next connect)
+  GtkWidget * chkHelperViewers = (GtkWidget *)g_hash_table_lookup(ht, "chkHelperViewers");
+  if (chkHelperViewers)
+    app->helperViewers = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkHelperViewers));
+
+  // last-known screen previews (turning them off removes the ones kept)
+  GtkWidget * chkSavePreviews = (GtkWidget *)g_hash_table_lookup(ht, "chkSavePreviews");
+  if (chkSavePreviews)
+  {
+    app->savePreviews = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkSavePreviews));
+
+    if (!app->savePreviews)
+      svPreviewDeleteAll();
+  }
+
+  // automation control socket (opens or closes right away)
+  GtkWidget * chkControlSocket = (GtkWidget *)g_hash_table_lookup(ht, "chkControlSocket");
+  if (chkControlSocket)
+  {
+    app->controlSocket = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(chkControlSocket));
+
+    if (app->controlSocket)
+      svControlStart();
+    else
+      svControlStop();
+  }
+
+  // -------------------------------------------
+
+  // set or unset tooltips
+  svSetMenuItemTooltips();
+  svSetHostlistItemsTooltips();
+  svReverseShowRejected();
+  svSetTooltip(app->scanImage, "Toggle scan mode");
+  svSetTooltip(app->addConnectionImage, "Add a new connection");
+
+  // write out our config
+  svConfigWrite();
+
+  g_hash_table_destroy(ht);
+
+  // destroy options window
+  gtk_widget_destroy(win);
+
+  gtk_window_present(GTK_WINDOW(app->mainWin));
+}
+
+
+/* handle the connection edit 'save' button */
+void svHandleConnectionEditButtons (GtkButton * button, gpointer userData)
+{
+  // hash table contains pointers to child window, its controls and data
+  GHashTable * ht = (GHashTable *)userData;
+  if (!ht)
+    return;
+
+  // set con object
+  Connection * con = (Connection *)g_hash_table_lookup(ht, "con");
+  if (!con)
+    return;
+
+  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
+  if (!win)
+    return;
+
+  // handle cancel button
+  if ((GtkWidget *)button == (GtkWidget *)g_hash_table_lookup(ht, "btnCancel"))
+  {
+    app->addNewConnection = false;
+
+    g_hash_table_destroy(ht);
+
+    gtk_widget_destroy(win);
+
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+    return;
+  }
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Saving settings for '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // connection name
+  const char * oldVal = (const char *)con->name->str;
+  const char * nameVal = (const char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "connectionName")));
+  const char * addressVal = (const char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "remoteAddress")));
+
+  // **===== validate stuff first =====**
+
+  // if no connection name, warn user
+  if (nameVal[0] == '\0')
+  {
+    svShowMessageDialog("<b>'Connection name' cannot be empty</b>\n\nPlease enter a "
+                                      "connection name then try saving again");
+
+    gtk_window_present(GTK_WINDOW(win));
+
+    // focus remote address
+    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "connectionName"));
+
+    return;
+  }
+
+  // if no host address, warn user (if not a reverse / listening connection)
+  if (addressVal[0] == '\0' && con->type != SV_TYPE_VNC_REVERSE)
+  {
+    svShowMessageDialog("<b>'Remote Address' cannot be empty</b>\n\nPlease enter a "
+                                      "valid remote address then try saving again");
+
+    gtk_window_present(GTK_WINDOW(win));
+
+    // focus remote address
+    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "remoteAddress"));
+
+    return;
+  }
+
+  // if the f12 macro doesn't compile, warn user
+  const char * f12Val = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "f12Macro")));
+
+  GString * macroErrors = g_string_new(NULL);
+  GArray * f12Test = svMacroCompile(f12Val, macroErrors);
+  g_array_unref(f12Test);
+
+  if (macroErrors->len > 0)
+  {
+    char * escaped = g_markup_escape_text(macroErrors->str, -1);
+    GString * msgStr = g_string_new(NULL);
+    g_string_printf(msgStr, "<b>'F12 macro' has problems</b>\n\n%s\nPlease fix the "
+                                      "F12 macro then try saving again", escaped);
+    svShowMessageDialog(msgStr->str);
+    g_string_free(msgStr, true);
+    g_free(escaped);
+    g_string_free(macroErrors, true);
+
+    gtk_window_present(GTK_WINDOW(win));
+
+    // focus f12 macro
+    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "f12Macro"));
+
+    return;
+  }
+
+  g_string_free(macroErrors, true);
+
+  // paste keys must be a single key or chord
+  const char * pasteKeysVal = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "pasteKeys")));
+
+  GString * pasteKeysMacro = g_string_new(NULL);
+  g_string_printf(pasteKeysMacro, "{%s}", pasteKeysVal);
+
+  GArray * pasteKeysTest = svMacroCompile(pasteKeysMacro->str, NULL);
+
+  gboolean pasteKeysValid = pasteKeysTest->len == 1 &&
+    g_array_index(pasteKeysTest, MacroStep, 0).type == SV_MACRO_KEYS;
+
+  g_array_unref(pasteKeysTest);
+  g_string_free(pasteKeysMacro, true);
+
+  if (!pasteKeysValid)
+  {
+    svShowMessageDialog("<b>'Paste keys' must be a single key or chord</b>\n\nPlease enter "
+                                      "something like CTRL+V or SHIFT+INSERT then try saving again");
+
+    gtk_window_present(GTK_WINDOW(win));
+
+    // focus paste keys
+    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "pasteKeys"));
+
+    return;
+  }
+
+  // a repeater connection needs to say which server it wants
+  const char * repeaterIdVal = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "repeaterId")));
+
+  if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "rvncChoice"))) &&
+    (repeaterIdVal[0] == '\0' || strlen(repeaterIdVal) >= SV_REPEATER_REQUEST_LEN))
+  {
+    svShowMessageDialog("<b>'Repeater ID' is needed for repeater connections</b>\n\nPlease enter "
+                                      "the server's repeater ID number (or its host:port) then try saving again");
+
+    gtk_window_present(GTK_WINDOW(win));
+
+    // focus repeater id
+    gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "repeaterId"));
+
+    return;
+  }
+
+  // check for duplicate name if this is a new connection
+  if (app->addNewConnection)
+  {
+    // check if a connection exists with the same name
+    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+    for (GList * l = rows; l; l = l->next)
+    {
+      GtkListBoxRow * row = l->data;
+      GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+
+      const Connection * conTemp = g_object_get_data(G_OBJECT(box), "con");
+      if (!conTemp)
+          continue;
+
+      // if a connection exists with this name, warn user
+      if (strcmp(conTemp->name->str, nameVal) == 0)
+      {
+        GtkWidget * dialog = gtk_message_dialog_new_with_markup(GTK_WINDOW(win),
+                                          GTK_DIALOG_DESTROY_WITH_PARENT,
+                                          GTK_MESSAGE_ERROR,
+                                          GTK_BUTTONS_CLOSE,
+                                          "<b>Error: Connection name already exists</b>\n\nPlease change the "
+                                            "connection's name then try saving again");
+        gtk_window_set_title(GTK_WINDOW(dialog), "Name already exists - SpiritVNC");
+        gtk_dialog_run(GTK_DIALOG(dialog));
+        gtk_widget_destroy(dialog);
+
+        gtk_window_present(GTK_WINDOW(win));
+
+        // focus the connection name
+        gtk_widget_grab_focus((GtkWidget *)g_hash_table_lookup(ht, "connectionName"));
+
+        return;
+      }
+    }
+
+    g_list_free(rows);
+  }
+
+  // (its preview goes with it)
+  if (strcmp(con->name->str, nameVal) != 0)
+    svPreviewRename(con, nameVal);
+
+  // set new name
+  g_string_assign(con->name, nameVal);
+
+  // update existing list item
+  // if value changed, find server list row with old name and update
+  if (strcmp(oldVal, nameVal) != 0)
+  {
+    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+    // loop through each row
+    for (GList * l = rows; l != NULL; l = l->next)
+    {
+      GtkWidget * row = GTK_WIDGET(l->data);
+
+      // get box that holds status image and label
+      GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+      if (!rowBox)
+        continue;
+
+      // get box's children
+      GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+
+      GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+
+      g_list_free(boxChildren);
+
+      // get label's text
+      if (label && GTK_IS_LABEL(label))
+      {
+        const char * text = gtk_label_get_text(GTK_LABEL(label));
+
+        // if label's text matches this edited connection's old
+        // name, update it
+        if (strcmp(text, oldVal) == 0)
+        {
+          gtk_label_set_text(GTK_LABEL(label), nameVal);
+          break;
+        }
+      }
+    }
+
+    // Free the list
+    g_list_free(rows);
+  }
+
+  // connection group
+  const char * groupVal = (char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "connectionGroup")));
+
+  // set new value
+  if (groupVal[0] != '\0')
+    g_string_assign(con->group, groupVal);
+  else
+    g_string_assign(con->group, "General");
+
+  // connection address
+  // set new value
+  g_string_assign(con->address, addressVal);
+
+  // connection f12 macro
+  svSetF12Macro(con, f12Val);
+
+  // don't change type for reverse vnc connections
+  if (con->type != SV_TYPE_VNC_REVERSE)
+  {
+    // vnc choice radio button
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "vncChoice"))))
+      con->type = SV_TYPE_VNC;
+
+    // vnc-over-ssh choice radio button
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "svncChoice"))))
+      con->type = SV_TYPE_VNC_OVER_SSH;
+
+    // vnc-via-repeater choice radio button
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "rvncChoice"))))
+      con->type = SV_TYPE_VNC_REPEATER;
+  }
+
+  // repeater id
+  g_string_assign(con->repeaterId, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "repeaterId"))));
+
+  // vnc port
+  const char * vPortVal = (char *)gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncPort")));
+
+  // set new value
+  g_string_assign(con->vncPort, vPortVal);
+
+  // vnc password
+  const char * vPassVal = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncPassword")));
+
+  char * vPassDecoded = g_base64_encode((const unsigned char *)vPassVal, strlen(vPassVal));
+  g_string_assign(con->vncPass, vPassDecoded);
+  g_free(vPassDecoded);
+
+  // vnc 'login' username
+  g_string_assign(con->vncLoginUser, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncLoginUsername"))));
+
+  // vnc 'login' password
+  const char * vLoginPassVal = gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "vncLoginPassword")));
+
+  char * vLoginPassDecoded = g_base64_encode((const unsigned char *)vLoginPassVal, strlen(vLoginPassVal));
+  g_string_assign(con->vncLoginPass, vLoginPassDecoded);
+  g_free(vLoginPassDecoded);
+
+  // vnc image quality
+  con->quality = gtk_combo_box_get_active(GTK_COMBO_BOX((GtkWidget *)g_hash_table_lookup(ht, "vncQuality")));
+
+  // vnc lossy encoding
+  con->lossyEncoding = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "vncLossyEncoding")));
+
+  // vnc scaling
+  con->scale = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "vncScaling")));
+
+  // resize remote desktop to fit
+  con->remoteResize = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "remoteResize")));
+
+  // coalesce pointer motion
+  con->coalescePointer = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "coalescePointer")));
+
+  // clipboard sync
+  con->clipboardSync = gtk_combo_box_get_active(GTK_COMBO_BOX((GtkWidget *)g_hash_table_lookup(ht, "clipboardSync")));
+
+  // send keys paste mode
+  con->pasteMode = gtk_combo_box_get_active(GTK_COMBO_BOX((GtkWidget *)g_hash_table_lookup(ht, "pasteMode")));
+
+  // paste keys
+  g_string_assign(con->pasteKeys, pasteKeysVal);
+
+  // auto-reconnect
+  con->autoReconnect = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "autoReconnect")));
+
+  // auto-reconnect attempts
+  con->reconnectMaxTries = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "reconnectMax")));
+
+  // stop any pending retries if auto-reconnect was turned off
+  if (!con->autoReconnect)
+    svReconnectCancel(con, true);
+
+  // dead-peer timeout (takes effect on the next connect)
+  con->liveTimeout = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "liveTimeout")));
+
+  // idle disconnect minutes
+  con->idleMinutes = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "idleMinutes")));
+
+  // ssh username
+  g_string_assign(con->sshUser, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "sshUsername"))));
+
+  // ssh port
+  g_string_assign(con->sshPort, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "sshPort"))));
+
+  // ssh private key file
+  g_string_assign(con->sshPrivKeyfile, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "sshPrivateKey"))));
+
+  // custom command 1 enabled
+  con->customCmd1Enabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "cmd1Enabled")));
+
+  // custom command 1 label
+  g_string_assign(con->customCmd1Label, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd1Label"))));
+
+  // custom command 1
+  g_string_assign(con->customCmd1, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd1"))));
+
+  // custom command 2 enabled
+  con->customCmd2Enabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "cmd2Enabled")));
+
+  // custom command 2 label
+  g_string_assign(con->customCmd2Label, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd2Label"))));
+
+  // custom command 2
+  g_string_assign(con->customCmd2, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd2"))));
+
+  // custom command 3 enabled
+  con->customCmd3Enabled = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON((GtkWidget *)g_hash_table_lookup(ht, "cmd3Enabled")));
+
+  // custom command 3 label
+  g_string_assign(con->customCmd3Label, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd3Label"))));
+
+  // custom command 3
+  g_string_assign(con->customCmd3, gtk_entry_get_text(GTK_ENTRY((GtkWidget *)g_hash_table_lookup(ht, "cmd3"))));
+
+  // write out the settings
+  svConfigWrite();
+
+  // ========= add to the hostlist and connections if this is a new connection =========
+  if (app->addNewConnection)
+  {
+    // get all rows from host list
+    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+    gint rowIdx = -1;
+
+    const char * lastGroup = NULL;
+    gboolean myGroupFound = false;
+
+    // go through connections glist and find last of this group
+    for (GList * l = rows; l; l = l->next)
+    {
+      GtkListBoxRow * row = l->data;
+      GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+
+      Connection * conTemp = g_object_get_data(G_OBJECT(box), "con");
+
+      // break if we are at the end of this new connection's group
+      if (conTemp)
+      {
+        // checking if we need to add an empty row before our new connection
+        if (conTemp->group->len > 0 && strcmp(conTemp->group->str, con->group->str) == 0)
+          myGroupFound = true;
+
+        // get out of loop if we just left our group into another
+        if (lastGroup && strcmp(conTemp->group->str, lastGroup) != 0 &&
+          strcmp(lastGroup, con->group->str) == 0)
+          break;
+
+        lastGroup = conTemp->group->str;
+      }
+
+      rowIdx++;
+    }
+
+    g_list_free(rows);
+
+    // insert into connections list at currently selected location or
+    // the end of the list if rowIdx is -1
+
+    // insert empty row before new connection (with new group)
+    if (!myGroupFound)
+      svInsertHostListRow("", rowIdx, NULL);
+
+    // insert new connection
+    svInsertHostListRow(con->name->str, rowIdx, con);
+
+    app->addNewConnection = false;
+
+    svSetHostlistItemsTooltips();
+  }
+
+  // destroy the connection settings window
+  gtk_widget_destroy(win);
+
+  gtk_window_present(GTK_WINDOW(app->mainWin));
+
+  // free the g_new'd settings
+  g_hash_table_destroy(ht);
+
+  // (a viewer process's screen only takes the scaling and resizing settings)
+  if (con->state == SV_STATE_CONNECTED)
+  {
+    svConnectionApplyScale(con);
+
+    con->resizeWidth = 0;
+    con->resizeHeight = 0;
+    svRemoteResizeSoon(con);
+  }
+
+  // update stuff if connected
+  if (con->state == SV_STATE_CONNECTED && con->vncObj)
+  {
+    // set image quality
+    switch (con->quality)
+    {
+      case SV_QUAL_LOW:
+        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_LOW);
+        break;
+      case SV_QUAL_MEDIUM:
+        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_MEDIUM);
+        break;
+      case SV_QUAL_FULL:
+        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_FULL);
+        break;
+      default:
+        vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_DEFAULT);
+    }
+
+    // set lossy encoding
+    vnc_display_set_lossy_encoding(VNC_DISPLAY(con->vncObj), con->lossyEncoding);
+
+    // set scaling (a tile or detached window keeps its own)
+    vnc_display_set_scaling(VNC_DISPLAY(con->vncObj), svConnectionScaled(con));
+    vnc_display_set_keep_aspect_ratio(VNC_DISPLAY(con->vncObj), TRUE);
+  }
+}
+
+
+/* handles the 'choose private key' button in the connection editor */
+void svHandleConnectionSSHPrivKey (GtkButton * self, gpointer userData)
+{
+  // hash table has pointers to child window and its controls
+  GHashTable * ht = (GHashTable *)userData;
+  if (!ht)
+    return;
+
+  GtkWidget * entry = (GtkWidget *)g_hash_table_lookup(ht, "sshPrivateKey");
+  if (!entry || !GTK_IS_ENTRY(entry))
+    return;
+
+  GtkWidget * win = (GtkWidget *)g_hash_table_lookup(ht, "win");
+  if (!win)
+    return;
+
+  GtkWidget * dialog;
+  GtkFileChooserAction action = GTK_FILE_CHOOSER_ACTION_OPEN;
+  gint res;
+
+  dialog = gtk_file_chooser_dialog_new("Choose a private key",
+                                        GTK_WINDOW(win),
+                                        action,
+                                        ("_Cancel"),
+                                        GTK_RESPONSE_CANCEL,
+                                        ("_Open"),
+                                        GTK_RESPONSE_ACCEPT,
+                                        NULL);
+
+  res = gtk_dialog_run(GTK_DIALOG (dialog));
+
+  if (res == GTK_RESPONSE_ACCEPT)
+  {
+    char * filename;  //  <<<-- NO const char *
+    GtkFileChooser * chooser = GTK_FILE_CHOOSER(dialog);
+    filename = gtk_file_chooser_get_filename(chooser);
+    gtk_entry_set_text(GTK_ENTRY(entry), filename);
+    g_free(filename);
+  }
+
+  // destroy the dialog window
+  gtk_widget_destroy(dialog);
+
+  gtk_window_present(GTK_WINDOW(app->mainWin));
+}
+
+
+/* create and display connection edit window */
+void svShowAppOptionsWindow ()
+{
+  GHashTable * htAppOptions = g_hash_table_new(NULL, NULL);
+  if (!htAppOptions)
+    return;
+
+  // log
+  svLog("Editing app options", true);
+
+  // create edit window
+  GtkWidget * win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  //opts->optionsWin = win;
+  g_hash_table_insert(htAppOptions, "win", win);
+
+  // set window title
+  gtk_window_set_title(GTK_WINDOW(win), "SpiritVNC App Options");
+  gtk_window_set_modal(GTK_WINDOW(win), true);
+  gtk_window_set_resizable(GTK_WINDOW(win), false);
+  gtk_window_set_transient_for(GTK_WINDOW(win), GTK_WINDOW(app->mainWin));
+  gtk_window_set_position(GTK_WINDOW(win), GTK_WIN_POS_CENTER_ON_PARENT);
+
+  // parent box
+  GtkWidget * boxOptsParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
+  gtk_container_set_border_width(GTK_CONTAINER(boxOptsParent), 5);
+  gtk_container_add(GTK_CONTAINER(win), boxOptsParent);
+
+  // container grid
+  GtkWidget * optsPage = gtk_grid_new();
+  gtk_grid_set_column_homogeneous(GTK_GRID(optsPage), false);
+  gtk_container_set_border_width(GTK_CONTAINER(optsPage), 7);
+  gtk_grid_set_column_spacing(GTK_GRID(optsPage), 7);
+  gtk_grid_set_row_spacing(GTK_GRID(optsPage), 5);
+
+  guint rowNum = 1;
+
+  // show tooltips
+  GtkWidget * lblTooltips = gtk_label_new("Show tooltips");
+  gtk_widget_set_halign(lblTooltips, GTK_ALIGN_END);
+  GtkWidget * chkShowTooltips = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkShowTooltips", chkShowTooltips);
+  if (app->showTooltips)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkShowTooltips), true);
+  svSetTooltip(chkShowTooltips, "Displays tooltips for most app items");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblTooltips, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkShowTooltips, 2, rowNum++, 1, 1);
+
+  // log to file
+  GtkWidget * lblLog = gtk_label_new("Log events to file");
+  gtk_widget_set_halign(lblLog, GTK_ALIGN_END);
+  GtkWidget * chkLogToFile = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkLogToFile", chkLogToFile);
+  svSetTooltip(chkLogToFile, "Logs most app events to a log file");
+
+  if (app->logToFile)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkLogToFile), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblLog, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkLogToFile, 2, rowNum++, 1, 1);
+
+  // scan timeout
+  GtkWidget * lblScanTime = gtk_label_new("Scan timeout (secs)");
+  gtk_widget_set_halign(lblScanTime, GTK_ALIGN_END);
+  GtkWidget * spinScanTimeout = gtk_spin_button_new_with_range(0, 100, 1);
+  g_hash_table_insert(htAppOptions, "spinScanTimeout", spinScanTimeout);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinScanTimeout), app->scanTimeout);
+  svSetTooltip(spinScanTimeout, "How long the app waits before moving to the next viewer "
+    "when scanning is enabled");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblScanTime, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinScanTimeout, 2, rowNum++, 1, 1);
+
+  // vnc wait time
+  GtkWidget * lblVNCWaitTime = gtk_label_new("VNC wait time");
+  gtk_widget_set_halign(lblVNCWaitTime, GTK_ALIGN_END);
+  GtkWidget * spinVncWaitTime = gtk_spin_button_new_with_range(0, 100, 1);
+  g_hash_table_insert(htAppOptions, "spinVncWaitTime", spinVncWaitTime);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinVncWaitTime), app->vncConnectWaitTime);
+  svSetTooltip(spinVncWaitTime, "How long the app waits before a VNC connection "
+    "attempt times out");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblVNCWaitTime, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinVncWaitTime, 2, rowNum++, 1, 1);
+
+  // ssh wait time
+  GtkWidget * lblSSHWaitTime = gtk_label_new("SSH wait time");
+  gtk_widget_set_halign(lblSSHWaitTime, GTK_ALIGN_END);
+  GtkWidget * spinSSHWaitTime = gtk_spin_button_new_with_range(0, 100, 1);
+  g_hash_table_insert(htAppOptions, "spinSSHWaitTime", spinSSHWaitTime);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinSSHWaitTime), app->sshConnectWaitTime);
+  svSetTooltip(spinSSHWaitTime, "How long the app waits before a SSH connection "
+    "attempt times out");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblSSHWaitTime, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinSSHWaitTime, 2, rowNum++, 1, 1);
+
+  // ssh command
+  GtkWidget * lblSSHCmd = gtk_label_new("SSH command");
+  gtk_widget_set_halign(lblSSHCmd, GTK_ALIGN_END);
+  GtkWidget * entSSHCommand = gtk_entry_new();
+  g_hash_table_insert(htAppOptions, "entSSHCommand", entSSHCommand);
+  gtk_entry_set_width_chars(GTK_ENTRY(entSSHCommand), 30);
+  gtk_entry_set_text(GTK_ENTRY(entSSHCommand), app->sshCommand->str);
+  svSetTooltip(entSSHCommand, "The system SSH command (/usr/bin/ssh, etc)");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblSSHCmd, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), entSSHCommand, 2, rowNum++, 1, 1);
+
+  // listening ports
+  GtkWidget * lblListenPorts = gtk_label_new("Listening ports");
+  gtk_widget_set_halign(lblListenPorts, GTK_ALIGN_END);
+  GtkWidget * entListenPorts = gtk_entry_new();
+  g_hash_table_insert(htAppOptions, "entListenPorts", entListenPorts);
+  gtk_entry_set_width_chars(GTK_ENTRY(entListenPorts), 30);
+  gtk_entry_set_text(GTK_ENTRY(entListenPorts), app->listenPorts->str);
+  svSetTooltip(entListenPorts, "Ports listen mode accepts reverse VNC connections on, over both IPv4 and "
+    "IPv6, separated by commas (5500, etc).  Changes apply the next time listen mode is enabled");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblListenPorts, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), entListenPorts, 2, rowNum++, 1, 1);
+
+  // listen backlog
+  GtkWidget * lblListenBacklog = gtk_label_new("Listen backlog");
+  gtk_widget_set_halign(lblListenBacklog, GTK_ALIGN_END);
+  GtkWidget * spinListenBacklog = gtk_spin_button_new_with_range(1, 4096, 16);
+  g_hash_table_insert(htAppOptions, "spinListenBacklog", spinListenBacklog);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinListenBacklog), app->listenBacklog);
+  svSetTooltip(spinListenBacklog, "How many reverse connections can be waiting to be accepted at once, "
+    "for bursts like many hosts rebooting together");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblListenBacklog, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinListenBacklog, 2, rowNum++, 1, 1);
+
+  // max listening sessions
+  GtkWidget * lblReverseMax = gtk_label_new("Max listening sessions");
+  gtk_widget_set_halign(lblReverseMax, GTK_ALIGN_END);
+  GtkWidget * spinReverseMax = gtk_spin_button_new_with_range(0, 10000, 10);
+  g_hash_table_insert(htAppOptions, "spinReverseMax", spinReverseMax);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinReverseMax), app->reverseMax);
+  svSetTooltip(spinReverseMax, "Reverse connections beyond this many listening sessions are "
+    "turned away (0 is no limit)");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblReverseMax, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinReverseMax, 2, rowNum++, 1, 1);
+
+  // reverse connections per minute, per address
+  GtkWidget * lblReverseRate = gtk_label_new("Reverse connections per minute, per address");
+  gtk_widget_set_halign(lblReverseRate, GTK_ALIGN_END);
+  GtkWidget * spinReverseRate = gtk_spin_button_new_with_range(0, 6000, 1);
+  g_hash_table_insert(htAppOptions, "spinReverseRate", spinReverseRate);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinReverseRate), app->reverseRatePerMin);
+  svSetTooltip(spinReverseRate, "Turns away a remote address that connects more often than this "
+    "(0 is no limit)");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblReverseRate, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinReverseRate, 2, rowNum++, 1, 1);
+
+  // allowed reverse addresses
+  GtkWidget * lblReverseAllow = gtk_label_new("Allowed reverse addresses");
+  gtk_widget_set_halign(lblReverseAllow, GTK_ALIGN_END);
+  GtkWidget * entReverseAllow = gtk_entry_new();
+  g_hash_table_insert(htAppOptions, "entReverseAllow", entReverseAllow);
+  gtk_entry_set_width_chars(GTK_ENTRY(entReverseAllow), 30);
+  gtk_entry_set_text(GTK_ENTRY(entReverseAllow), app->reverseAllowText->str);
+  svSetTooltip(entReverseAllow, "Only accept reverse connections from these addresses or networks "
+    "(192.168.1.5, 10.0.0.0/8, etc), separated by commas.  Leave empty to allow any address");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblReverseAllow, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), entReverseAllow, 2, rowNum++, 1, 1);
+
+  // clipboard history memory cap
+  GtkWidget * lblClipHistory = gtk_label_new("Clipboard history (KB)");
+  gtk_widget_set_halign(lblClipHistory, GTK_ALIGN_END);
+  GtkWidget * spinClipHistoryKB = gtk_spin_button_new_with_range(0, 1048576, 256);
+  g_hash_table_insert(htAppOptions, "spinClipHistoryKB", spinClipHistoryKB);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinClipHistoryKB), app->clipHistoryKB);
+  svSetTooltip(spinClipHistoryKB, "How much memory the clipboard history of all connections "
+    "may use before the oldest entries are dropped");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblClipHistory, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinClipHistoryKB, 2, rowNum++, 1, 1);
+
+  // reachability probe interval
+  GtkWidget * lblProbeInterval = gtk_label_new("Host check interval (secs)");
+  gtk_widget_set_halign(lblProbeInterval, GTK_ALIGN_END);
+  GtkWidget * spinProbeInterval = gtk_spin_button_new_with_range(0, 86400, 30);
+  g_hash_table_insert(htAppOptions, "spinProbeInterval", spinProbeInterval);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinProbeInterval), app->probeInterval);
+  svSetTooltip(spinProbeInterval, "How often the app checks in the background whether each "
+    "host is reachable (0 turns background checks off)");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblProbeInterval, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinProbeInterval, 2, rowNum++, 1, 1);
+
+  // reachability probe concurrency
+  GtkWidget * lblProbeConcurrency = gtk_label_new("Simultaneous host checks");
+  gtk_widget_set_halign(lblProbeConcurrency, GTK_ALIGN_END);
+  GtkWidget * spinProbeConcurrency = gtk_spin_button_new_with_range(1, 64, 1);
+  g_hash_table_insert(htAppOptions, "spinProbeConcurrency", spinProbeConcurrency);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinProbeConcurrency), app->probeConcurrency);
+  svSetTooltip(spinProbeConcurrency, "How many hosts are checked at the same time");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblProbeConcurrency, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinProbeConcurrency, 2, rowNum++, 1, 1);
+
+  // reachability probe reads rfb banner
+  GtkWidget * lblProbeBanner = gtk_label_new("Read VNC version when checking");
+  gtk_widget_set_halign(lblProbeBanner, GTK_ALIGN_END);
+  GtkWidget * chkProbeBanner = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkProbeBanner", chkProbeBanner);
+  svSetTooltip(chkProbeBanner, "Waits for each VNC server's version greeting when checking hosts, "
+    "so the VNC server itself (not just the port) is known to be answering");
+
+  if (app->probeReadBanner)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkProbeBanner), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblProbeBanner, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkProbeBanner, 2, rowNum++, 1, 1);
+
+  // framebuffer memory budget
+  GtkWidget * lblFbBudget = gtk_label_new("Framebuffer memory budget (MB)");
+  gtk_widget_set_halign(lblFbBudget, GTK_ALIGN_END);
+  GtkWidget * spinFbBudget = gtk_spin_button_new_with_range(0, 65536, 64);
+  g_hash_table_insert(htAppOptions, "spinFbBudget", spinFbBudget);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinFbBudget), app->fbBudgetMB);
+  svSetTooltip(spinFbBudget, "When open connections' screens need more memory than this, "
+    "the least recently viewed background connections are closed (0 is no limit)");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblFbBudget, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinFbBudget, 2, rowNum++, 1, 1);
+
+  // pre-connect on hover / select
+  GtkWidget * lblPreconnect = gtk_label_new("Pre-connect when pointed at or selected");
+  gtk_widget_set_halign(lblPreconnect, GTK_ALIGN_END);
+  GtkWidget * chkPreconnect = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkPreconnect", chkPreconnect);
+  svSetTooltip(chkPreconnect, "Looks up and connects to a VNC host as soon as it's pointed at or "
+    "selected, so opening it starts faster.  Unused pre-connections are closed after a few seconds");
+
+  if (app->preconnect)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkPreconnect), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblPreconnect, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkPreconnect, 2, rowNum++, 1, 1);
+
+  // dns cache time
+  GtkWidget * lblDnsCacheSecs = gtk_label_new("Remember host lookups (secs)");
+  gtk_widget_set_halign(lblDnsCacheSecs, GTK_ALIGN_END);
+  GtkWidget * spinDnsCacheSecs = gtk_spin_button_new_with_range(0, 86400, 30);
+  g_hash_table_insert(htAppOptions, "spinDnsCacheSecs", spinDnsCacheSecs);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinDnsCacheSecs), app->dnsCacheSecs);
+  svSetTooltip(spinDnsCacheSecs, "How long a host name's addresses are reused by connections and "
+    "host checks before looking it up again (0 always looks up)");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblDnsCacheSecs, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinDnsCacheSecs, 2, rowNum++, 1, 1);
+
+  // idle disconnect minutes
+  GtkWidget * lblIdleMinutes = gtk_label_new("Disconnect idle connections (mins)");
+  gtk_widget_set_halign(lblIdleMinutes, GTK_ALIGN_END);
+  GtkWidget * spinIdleMinutes = gtk_spin_button_new_with_range(0, SV_IDLE_MAX_MINUTES, 5);
+  g_hash_table_insert(htAppOptions, "spinIdleMinutes", spinIdleMinutes);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spinIdleMinutes), app->idleMinutes);
+  svSetTooltip(spinIdleMinutes, "Disconnects connections that haven't been viewed or typed into "
+    "for this many minutes (0 never does).  Connections can override this in their settings");
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblIdleMinutes, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), spinIdleMinutes, 2, rowNum++, 1, 1);
+
+  // reconnect idle connections when selected
+  GtkWidget * lblIdleReconnect = gtk_label_new("Reconnect idle connections when selected");
+  gtk_widget_set_halign(lblIdleReconnect, GTK_ALIGN_END);
+  GtkWidget * chkIdleReconnect = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkIdleReconnect", chkIdleReconnect);
+  svSetTooltip(chkIdleReconnect, "Reconnects a connection that was closed for being idle "
+    "as soon as it's selected again");
+
+  if (app->idleReconnect)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkIdleReconnect), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblIdleReconnect, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkIdleReconnect, 2, rowNum++, 1, 1);
+
+  // shared memory screen export
+  GtkWidget * lblShmExport = gtk_label_new("Share screens with other programs");
+  gtk_widget_set_halign(lblShmExport, GTK_ALIGN_END);
+  GtkWidget * chkShmExport = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkShmExport", chkShmExport);
+  svSetTooltip(chkShmExport, "Publishes each connected screen in shared memory (readable only by your "
+    "user) so monitoring tools can watch it without screenshots.  The name is in the log");
+
+  if (app->shmExport)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkShmExport), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblShmExport, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkShmExport, 2, rowNum++, 1, 1);
+
+  // run connections in viewer processes
+  GtkWidget * lblHelperViewers = gtk_label_new("Run each connection in its own process");
+  gtk_widget_set_halign(lblHelperViewers, GTK_ALIGN_END);
+  GtkWidget * chkHelperViewers = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkHelperViewers", chkHelperViewers);
+  svSetTooltip(chkHelperViewers, "Spreads decoding across cpu cores and keeps one misbehaving server from "
+    "taking the others down.  Clipboard, macros and screenshots aren't available in these sessions");
+
+  if (app->helperViewers)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkHelperViewers), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblHelperViewers, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkHelperViewers, 2, rowNum++, 1, 1);
+
+  // last-known screen previews
+  GtkWidget * lblSavePreviews = gtk_label_new("Keep previews of connection screens");
+  gtk_widget_set_halign(lblSavePreviews, GTK_ALIGN_END);
+  GtkWidget * chkSavePreviews = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkSavePreviews", chkSavePreviews);
+  svSetTooltip(chkSavePreviews, "Keeps a small copy of each connection's screen on disk, shown dimmed while "
+    "it connects and in the connection list's tooltips.  Turning this off removes them");
+
+  if (app->savePreviews)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkSavePreviews), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblSavePreviews, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkSavePreviews, 2, rowNum++, 1, 1);
+
+  // automation control socket
+  GtkWidget * lblControlSocket = gtk_label_new("Automation control socket");
+  gtk_widget_set_halign(lblControlSocket, GTK_ALIGN_END);
+  GtkWidget * chkControlSocket = gtk_check_button_new();
+  g_hash_table_insert(htAppOptions, "chkControlSocket", chkControlSocket);
+  svSetTooltip(chkControlSocket, "Lets scripts run by your user connect, type, take screenshots and "
+    "disconnect through 'control.sock' in the config folder");
+
+  if (app->controlSocket)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkControlSocket), true);
+
+  gtk_grid_attach(GTK_GRID(optsPage), lblControlSocket, 1, rowNum, 1, 1);
+  gtk_grid_attach(GTK_GRID(optsPage), chkControlSocket, 2, rowNum++, 1, 1);
+
+  // add optsPage to parent box
+  gtk_box_pack_start(GTK_BOX(boxOptsParent), optsPage, false, false, 0);
+
+  // ------------------- save / cancel buttons -------------------
+  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+
+  // save
+  GtkWidget * btnSave = gtk_button_new_with_label("Save");
+  gtk_widget_set_size_request(btnSave, 110, -1);
+  svSetTooltip(btnSave, "Click to save these settings");
+  g_signal_connect(btnSave, "clicked", G_CALLBACK(svHandleAppOptionsButtons), htAppOptions);
+
+  // cancel
+  GtkWidget * btnCancel = gtk_button_new_with_label("Cancel");
+  g_hash_table_insert(htAppOptions, "btnCancel", btnCancel);
+  gtk_widget_set_size_request(btnCancel, 110, -1);
+  svSetTooltip(btnCancel, "Click to abandon any changes.  "
+    "Caution: Any changes will be lost!");
+  g_signal_connect(btnCancel, "clicked", G_CALLBACK(svHandleAppOptionsButtons), htAppOptions);
+
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnSave, false, false, 3);
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnCancel, false, false, 3);
+  //
+  gtk_container_add(GTK_CONTAINER(boxOptsParent), boxButtons);
+
+  // show everything
+  gtk_widget_show_all(win);
+
+  gtk_window_present(GTK_WINDOW(win));
+
+  // focus the first entry
+  gtk_widget_grab_focus(chkShowTooltips);
+}
+
+
+/* handle send function key button */
+void svHandleSendFunctionKeyButton (GtkWidget * button, gpointer data)
+{
+  // the connection the actions window was opened for
+  Connection * con = (Connection *)g_object_get_data(G_OBJECT(button), "con");
+  if (!con || con->name->len == 0)
+    return;
+
+  guint key = GPOINTER_TO_UINT(data);
+
+  guint keys[1];
+  keys[0] = key;
+
+  svConnectionSendKeys(con, keys, 1);
+}
+
+
+/* handle 'close' button on connection actions window */
+void svHandleConnectionActionsCloseButton (GtkWidget * unused1, gpointer unused2)
+{
+  if (app->connectionActionsWindow)
+  {
+    gtk_widget_destroy(app->connectionActionsWindow);
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+    app->connectionActionsWindow = NULL;
+  }
+}
+
+
+/* handle esc key from connection actions window */
+gboolean svHandleConnectionActionsCloseKey (GtkWidget * widget, GdkEventKey * event, gpointer data)
+{
+  // handle esc key
+  if (event->keyval == GDK_KEY_Escape)
+  {
+    svHandleConnectionActionsCloseButton(NULL, NULL);
+    return true;
+  }
+
+  return false;
+}
+
+
+/* create and display connection actions window (for a connection) */
+void svShowConnectionActionsWindow (Connection * con)
+{
+  if (app->connectionActionsWindow)
+    return;
+
+  // create connection actions window
+  app->connectionActionsWindow = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+
+  // set window title
+  gtk_window_set_title(GTK_WINDOW(app->connectionActionsWindow), "SpiritVNC Connection Actions");
+  gtk_window_set_modal(GTK_WINDOW(app->connectionActionsWindow), true);
+  //gtk_window_set_resizable(GTK_WINDOW(app->connectionActionsWindow), false);
+  gtk_window_set_transient_for(GTK_WINDOW(app->connectionActionsWindow), GTK_WINDOW(app->mainWin));
+  gtk_window_set_position(GTK_WINDOW(app->connectionActionsWindow), GTK_WIN_POS_CENTER_ON_PARENT);
+
+  // parent grid
+  GtkWidget * parentGrid = gtk_grid_new();
+  gtk_grid_set_row_spacing(GTK_GRID(parentGrid), 10);
+  gtk_grid_set_column_spacing(GTK_GRID(parentGrid), 10);
+  gtk_container_set_border_width(GTK_CONTAINER(parentGrid), 10);
+  gtk_container_add(GTK_CONTAINER(app->connectionActionsWindow), parentGrid);
+
+  // send control-alt-delete
+  GtkWidget * btnCAD = gtk_button_new_with_label("Send Ctrl+Alt+Del");
+  g_signal_connect(btnCAD, "clicked", G_CALLBACK(svHandleSendCADMenuItem), con);
+  gtk_grid_attach(GTK_GRID(parentGrid), btnCAD, 0, 0, 1, 1);
+
+  // send control-alt-delete
+  GtkWidget * btnCSE = gtk_button_new_with_label("Send Ctrl+Shift+Esc");
+  g_signal_connect(btnCSE, "clicked", G_CALLBACK(svHandleSendCSEMenuItem), con);
+  gtk_grid_attach(GTK_GRID(parentGrid), btnCSE, 1, 0, 1, 1);
+
+  // send refresh request
+  GtkWidget * btnRefresh = gtk_button_new_with_label("Send refresh request");
+  g_signal_connect(btnRefresh, "clicked", G_CALLBACK(svHandleRequestUpdateMenuItem), con);
+  gtk_grid_attach(GTK_GRID(parentGrid), btnRefresh, 0, 1, 1, 1);
+
+  // send f8 key
+  GtkWidget * btnF8 = gtk_button_new_with_label("Send F8 key");
+  g_object_set_data(G_OBJECT(btnF8), "con", con);
+  g_signal_connect(btnF8, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F8));
+  gtk_grid_attach(GTK_GRID(parentGrid), btnF8, 1, 1, 1, 1);
+
+  // send f9 key
+  GtkWidget * btnF9 = gtk_button_new_with_label("Send F9 key");
+  g_object_set_data(G_OBJECT(btnF9), "con", con);
+  g_signal_connect(btnF9, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F9));
+  gtk_grid_attach(GTK_GRID(parentGrid), btnF9, 0, 2, 1, 1);
+
+  // send f11 key
+  GtkWidget * btnF11 = gtk_button_new_with_label("Send F11 key");
+  g_object_set_data(G_OBJECT(btnF11), "con", con);
+  g_signal_connect(btnF11, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F11));
+  gtk_grid_attach(GTK_GRID(parentGrid), btnF11, 1, 2, 1, 1);
+
+  // send f12 key
+  GtkWidget * btnF12 = gtk_button_new_with_label("Send F12 key");
+  g_object_set_data(G_OBJECT(btnF12), "con", con);
+  g_signal_connect(btnF12, "clicked", G_CALLBACK(svHandleSendFunctionKeyButton), GUINT_TO_POINTER(GDK_KEY_F12));
+  gtk_grid_attach(GTK_GRID(parentGrid), btnF12, 0, 3, 1, 1);
+
+  // send entered keys
+  GtkWidget * btnKeys = gtk_button_new_with_label("Send entered keys...");
+  g_signal_connect(btnKeys, "clicked", G_CALLBACK(svHandleSendEnteredKeystrokesMenuItem), con);
+  gtk_grid_attach(GTK_GRID(parentGrid), btnKeys, 1, 3, 1, 1);
+
+  // close button box
+  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+
+  // cancel
+  GtkWidget * btnClose = gtk_button_new_with_label("Close");
+  g_signal_connect(btnClose, "clicked", G_CALLBACK(svHandleConnectionActionsCloseButton), NULL);
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnClose, false, false, 3);
+  //
+  gtk_grid_attach(GTK_GRID(parentGrid), boxButtons, 1, 4, 1, 1);
+
+  // show everything
+  gtk_widget_show_all(app->connectionActionsWindow);
+
+  // focus the window
+  gtk_window_present(GTK_WINDOW(app->connectionActionsWindow));
+
+  // add escape key handling to close window
+  g_signal_connect(app->connectionActionsWindow, "key-press-event", G_CALLBACK(svHandleConnectionActionsCloseKey),
+    NULL);
+}
+
+
+/* create and display connection edit window */
+void svShowConnectionEditWindow (Connection * con)
+{
+  if (!con || con->name->len == 0)
+    return;
+
+  // hash table to contain pointers to this window and its children
+  GHashTable * ht = g_hash_table_new(NULL, NULL);
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Editing connection '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // store this connection in hash table
+  g_hash_table_insert(ht, "con", con);
+
+  gboolean preventConnectedEditing = false;
+
+  // don't allow editing of certain things if we're waiting or connected
+  if (con->state == SV_STATE_WAITING || con->state == SV_STATE_CONNECTED)
+    preventConnectedEditing = true;
+
+  // create edit window
+  GtkWidget * win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  g_hash_table_insert(ht, "win", win);
+  gtk_window_set_modal(GTK_WINDOW(win), true);
+  gtk_window_set_resizable(GTK_WINDOW(win), false);
+  gtk_window_set_transient_for(GTK_WINDOW(win), GTK_WINDOW(app->mainWin));
+  gtk_window_set_position(GTK_WINDOW(win), GTK_WIN_POS_CENTER_ON_PARENT);
+
+  // set window title
+  GString * strTitle = g_string_new(NULL);
+  g_string_printf(strTitle, "Editing '%s' - SpiritVNC", con->name->str);
+  gtk_window_set_title(GTK_WINDOW(win), strTitle->str);
+  g_string_free(strTitle, true);
+
+  // create parent box
+  GtkWidget * boxEditParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
+  gtk_container_set_border_width(GTK_CONTAINER(boxEditParent), 5);
+  gtk_container_add(GTK_CONTAINER(win), boxEditParent);
+
+  // tab control
+  GtkWidget * editTab = gtk_notebook_new();
+
+  // ------------------- vnc page -------------------
+  GtkWidget * vncPage = gtk_grid_new();
+  GtkWidget * lblVNCTab = gtk_label_new("VNC options");
+  gtk_container_set_border_width(GTK_CONTAINER(vncPage), 7);
+  gtk_grid_set_column_spacing(GTK_GRID(vncPage), 7);
+  gtk_grid_set_row_spacing(GTK_GRID(vncPage), 5);
+
+  // connection name
+  GtkWidget * lblConName = gtk_label_new("Connection name");
+  gtk_widget_set_halign(lblConName, GTK_ALIGN_END);
+  GtkWidget * connectionName = gtk_entry_new();
+  g_hash_table_insert(ht, "connectionName", connectionName);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(connectionName), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(connectionName), 30);
+  gtk_entry_set_text(GTK_ENTRY(connectionName), con->name->str);
+  svSetTooltip(connectionName, "The name you choose for this connection "
+    "(not the host address)");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblConName, 1, 1, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), connectionName, 2, 1, 3, 1);
+
+  // connection group
+  GtkWidget * lblConGroup = gtk_label_new("Connection group");
+  gtk_widget_set_halign(lblConGroup, GTK_ALIGN_END);
+  GtkWidget * connectionGroup = gtk_entry_new();
+  g_hash_table_insert(ht, "connectionGroup", connectionGroup);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(connectionGroup), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(connectionGroup), 30);
+  gtk_entry_set_text(GTK_ENTRY(connectionGroup), con->group->str);
+  svSetTooltip(connectionGroup, "The group this connection belongs to");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblConGroup, 1, 2, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), connectionGroup, 2, 2, 3, 1);
+
+  // connection address
+  GtkWidget * lblConAddr = gtk_label_new("Remote address");
+  gtk_widget_set_halign(lblConAddr, GTK_ALIGN_END);
+  GtkWidget * remoteAddress = gtk_entry_new();
+  g_hash_table_insert(ht, "remoteAddress", remoteAddress);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(remoteAddress), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(remoteAddress), 30);
+  gtk_entry_set_text(GTK_ENTRY(remoteAddress), con->address->str);
+  svSetTooltip(remoteAddress, "The network address of the remote host");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblConAddr, 1, 3, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), remoteAddress, 2, 3, 3, 1);
+
+  // f12 macro
+  GtkWidget * lblF12Macro = gtk_label_new("F12 macro");
+  gtk_widget_set_halign(lblF12Macro, GTK_ALIGN_END);
+  GtkWidget * f12Macro = gtk_entry_new();
+  g_hash_table_insert(ht, "f12Macro", f12Macro);
+  gtk_entry_set_width_chars(GTK_ENTRY(f12Macro), 30);
+  gtk_entry_set_text(GTK_ENTRY(f12Macro), con->f12Macro->str);
+  svSetTooltip(f12Macro, "The keys sent to the remote host when the F12 key is pressed.  "
+    "Use {ENTER}, {TAB}, {ESC}, {F5}, chords like {CTRL+ALT+T}, repeats like {TAB 3}, "
+    "pauses in milliseconds like {WAIT 500}, waits for the screen to show an image like "
+    "{WAITFOR login.png 30} and {{ for a literal '{'");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblF12Macro, 1, 4, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), f12Macro, 2, 4, 3, 1);
+
+  // vnc or vnc-over-ssh
+  gboolean allowConnectionTypeChange = true;
+
+  if (con->type == SV_TYPE_VNC_REVERSE || preventConnectedEditing)
+    allowConnectionTypeChange = false;
+
+  GtkWidget * boxVNCChoice = gtk_box_new(GTK_ORIENTATION_VERTICAL, 3);
+
+  GtkWidget * lblVNCChoice = gtk_label_new("Server type");
+  gtk_widget_set_halign(lblVNCChoice, GTK_ALIGN_END);
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCChoice, 1, 5, 1, 1);
+
+  // - vnc choice group
+  GSList * vncChoiceGroup = NULL;
+  GtkWidget * vncChoice = gtk_radio_button_new_with_label(vncChoiceGroup, "VNC");
+  g_hash_table_insert(ht, "vncChoice", vncChoice);
+  gtk_widget_set_sensitive(vncChoice, allowConnectionTypeChange);
+  vncChoiceGroup = gtk_radio_button_get_group(GTK_RADIO_BUTTON(vncChoice));
+  GtkWidget * svncChoice = gtk_radio_button_new_with_label(vncChoiceGroup, "VNC over SSH");
+  g_hash_table_insert(ht, "svncChoice", svncChoice);
+  gtk_widget_set_sensitive(svncChoice, allowConnectionTypeChange);
+  svSetTooltip(vncChoice, "Sets this to be a VNC connection");
+  vncChoiceGroup = gtk_radio_button_get_group(GTK_RADIO_BUTTON(svncChoice));
+  svSetTooltip(svncChoice, "Sets this to be a VNC-over-SSH connection");
+  GtkWidget * rvncChoice = gtk_radio_button_new_with_label(vncChoiceGroup, "VNC via repeater");
+  g_hash_table_insert(ht, "rvncChoice", rvncChoice);
+  gtk_widget_set_sensitive(rvncChoice, allowConnectionTypeChange);
+  svSetTooltip(rvncChoice, "Sets this to be a connection through an UltraVNC-style repeater "
+    "(the remote address and VNC port are the repeater's)");
+
+  // - set value from connection
+  if (con->type == SV_TYPE_VNC)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(vncChoice), true);
+  else if (con->type == SV_TYPE_VNC_OVER_SSH)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(svncChoice), true);
+  else if (con->type == SV_TYPE_VNC_REPEATER)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(rvncChoice), true);
+
+  gtk_container_add(GTK_CONTAINER(boxVNCChoice), vncChoice);
+  gtk_container_add(GTK_CONTAINER(boxVNCChoice), svncChoice);
+  gtk_container_add(GTK_CONTAINER(boxVNCChoice), rvncChoice);
+
+  gtk_grid_attach(GTK_GRID(vncPage), boxVNCChoice, 2, 5, 1, 1);
+
+  // vnc port
+  GtkWidget * lblVNCPort = gtk_label_new("VNC port");
+  gtk_widget_set_halign(lblVNCPort, GTK_ALIGN_END);
+  GtkWidget * vncPort = gtk_entry_new();
+  g_hash_table_insert(ht, "vncPort", vncPort);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(vncPort), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(vncPort), 10);
+  gtk_entry_set_text(GTK_ENTRY(vncPort), con->vncPort->str);
+  svSetTooltip(vncPort, "The remote host's numbered VNC port");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCPort, 1, 6, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncPort, 2, 6, 3, 1);
+
+  // vnc password
+  GtkWidget * lblVNCPass = gtk_label_new("VNC password");
+  gtk_widget_set_halign(lblVNCPass, GTK_ALIGN_END);
+  GtkWidget * vncPassword = gtk_entry_new();
+  g_hash_table_insert(ht, "vncPassword", vncPassword);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(vncPassword), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(vncPassword), 30);
+  gtk_entry_set_visibility(GTK_ENTRY(vncPassword), false);
+  gsize vncPassOutLen = 0;
+  unsigned char * vncPassTemp = g_base64_decode(con->vncPass->str, &vncPassOutLen);
+  gtk_entry_set_text(GTK_ENTRY(vncPassword), (const char *)vncPassTemp);
+  g_free(vncPassTemp);
+  svSetTooltip(vncPassword, "The standard VNC password");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCPass, 1, 7, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncPassword, 2, 7, 3, 1);
+
+  // vnc login username
+  GtkWidget * lblVNCLoginName = gtk_label_new("VNC login username");
+  gtk_widget_set_halign(lblVNCLoginName, GTK_ALIGN_END);
+  GtkWidget * vncLoginUsername = gtk_entry_new();
+  g_hash_table_insert(ht, "vncLoginUsername", vncLoginUsername);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(vncLoginUsername), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(vncLoginUsername), 30);
+  gtk_entry_set_text(GTK_ENTRY(vncLoginUsername), con->vncLoginUser->str);
+  svSetTooltip(vncLoginUsername, "The username used with VNC 'login' authentication");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCLoginName, 1, 8, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncLoginUsername, 2, 8, 3, 1);
+
+  // vnc login password
+  GtkWidget * lblVNCLoginPass = gtk_label_new("VNC login password");
+  gtk_widget_set_halign(lblVNCLoginPass, GTK_ALIGN_END);
+  GtkWidget * vncLoginPassword = gtk_entry_new();
+  g_hash_table_insert(ht, "vncLoginPassword", vncLoginPassword);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(vncLoginPassword), false);
   gtk_entry_set_width_chars(GTK_ENTRY(vncLoginPassword), 30);
   gtk_entry_set_visibility(GTK_ENTRY(vncLoginPassword), false);
   gsize vncLoginPassOutLen = 0;
@@ -1397,3721 +3018,10913 @@ void svShowConnectionEditWindow (Connection * con)
   g_free(vncLoginPassTemp);
   svSetTooltip(vncLoginPassword, "The password used with VNC 'login' authentication");
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCLoginPass, 1, 9, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncLoginPassword, 2, 9, 3, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCLoginPass, 1, 9, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncLoginPassword, 2, 9, 3, 1);
+
+  // vnc quality
+  GtkWidget * lblVNCQuality = gtk_label_new("VNC quality");
+  gtk_widget_set_halign(lblVNCQuality, GTK_ALIGN_END);
+  GtkWidget * vncQuality = gtk_combo_box_text_new();
+  g_hash_table_insert(ht, "vncQuality", vncQuality);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(vncQuality), false);
+
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Low");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Medium");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Full");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Default");
+
+  gtk_combo_box_set_active(GTK_COMBO_BOX(vncQuality), con->quality);
+  svSetTooltip(vncQuality, "The remote host's displayed image quality");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCQuality, 1, 10, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncQuality, 2, 10, 3, 1);
+
+  // vnc lossy encoding
+  GtkWidget * lblVNCLossy = gtk_label_new("VNC lossy encoding");
+  gtk_widget_set_halign(lblVNCLossy, GTK_ALIGN_END);
+  GtkWidget * vncLossyEncoding = gtk_check_button_new();
+  g_hash_table_insert(ht, "vncLossyEncoding", vncLossyEncoding);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(vncLossyEncoding), false);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(vncLossyEncoding), con->lossyEncoding);
+  svSetTooltip(vncLossyEncoding, "Enables the remote host's lossy encoding");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCLossy, 1, 11, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncLossyEncoding, 2, 11, 3, 1);
+
+  // vnc scaling
+  GtkWidget * lblVNCScaling = gtk_label_new("VNC scaling");
+  gtk_widget_set_halign(lblVNCScaling, GTK_ALIGN_END);
+  GtkWidget * vncScaling = gtk_check_button_new();
+  g_hash_table_insert(ht, "vncScaling", vncScaling);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(vncScaling), con->scale);
+  svSetTooltip(vncScaling, "Scales the remote host's display");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblVNCScaling, 1, 12, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), vncScaling, 2, 12, 3, 1);
+
+  // clipboard sync
+  GtkWidget * lblClipboardSync = gtk_label_new("Clipboard sync");
+  gtk_widget_set_halign(lblClipboardSync, GTK_ALIGN_END);
+  GtkWidget * clipboardSync = gtk_combo_box_text_new();
+  g_hash_table_insert(ht, "clipboardSync", clipboardSync);
+
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(clipboardSync), "Manual");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(clipboardSync), "From remote host");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(clipboardSync), "To remote host");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(clipboardSync), "Both ways");
+
+  gtk_combo_box_set_active(GTK_COMBO_BOX(clipboardSync), con->clipboardSync);
+  svSetTooltip(clipboardSync, "Automatically copies clipboard text between this computer and "
+    "the remote host while this connection is being viewed");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblClipboardSync, 1, 13, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), clipboardSync, 2, 13, 3, 1);
+
+  // send keys paste mode
+  GtkWidget * lblPasteMode = gtk_label_new("Send keys as");
+  gtk_widget_set_halign(lblPasteMode, GTK_ALIGN_END);
+  GtkWidget * pasteMode = gtk_combo_box_text_new();
+  g_hash_table_insert(ht, "pasteMode", pasteMode);
+
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(pasteMode), "Keystrokes");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(pasteMode), "Clipboard paste");
+
+  gtk_combo_box_set_active(GTK_COMBO_BOX(pasteMode), con->pasteMode);
+  svSetTooltip(pasteMode, "How 'Send keys' text reaches the remote host.  'Clipboard paste' "
+    "sets the remote clipboard and presses the paste keys, which is much faster for large "
+    "text.  Text that isn't Latin-1 is always sent as keystrokes");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblPasteMode, 1, 14, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), pasteMode, 2, 14, 3, 1);
+
+  // paste keys
+  GtkWidget * lblPasteKeys = gtk_label_new("Paste keys");
+  gtk_widget_set_halign(lblPasteKeys, GTK_ALIGN_END);
+  GtkWidget * pasteKeys = gtk_entry_new();
+  g_hash_table_insert(ht, "pasteKeys", pasteKeys);
+  gtk_entry_set_width_chars(GTK_ENTRY(pasteKeys), 30);
+  gtk_entry_set_text(GTK_ENTRY(pasteKeys), con->pasteKeys->str);
+  svSetTooltip(pasteKeys, "The keys that paste on the remote host, like CTRL+V, "
+    "SHIFT+INSERT or CTRL+SHIFT+V");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblPasteKeys, 1, 15, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), pasteKeys, 2, 15, 3, 1);
+
+  // auto-reconnect
+  GtkWidget * lblAutoReconnect = gtk_label_new("Auto-reconnect");
+  gtk_widget_set_halign(lblAutoReconnect, GTK_ALIGN_END);
+  GtkWidget * autoReconnect = gtk_check_button_new();
+  g_hash_table_insert(ht, "autoReconnect", autoReconnect);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(autoReconnect), con->autoReconnect);
+  svSetTooltip(autoReconnect, "Reconnects automatically when this connection drops or fails, "
+    "waiting longer between each attempt.  Disconnecting manually never reconnects");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblAutoReconnect, 1, 16, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), autoReconnect, 2, 16, 3, 1);
+
+  // auto-reconnect attempts
+  GtkWidget * lblReconnectMax = gtk_label_new("Reconnect attempts");
+  gtk_widget_set_halign(lblReconnectMax, GTK_ALIGN_END);
+  GtkWidget * reconnectMax = gtk_spin_button_new_with_range(0, 1000, 1);
+  g_hash_table_insert(ht, "reconnectMax", reconnectMax);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(reconnectMax), con->reconnectMaxTries);
+  svSetTooltip(reconnectMax, "How many times to try reconnecting before giving up "
+    "(0 keeps trying)");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblReconnectMax, 1, 17, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), reconnectMax, 2, 17, 3, 1);
+
+  // dead-peer timeout
+  GtkWidget * lblLiveTimeout = gtk_label_new("Dead-peer timeout (secs)");
+  gtk_widget_set_halign(lblLiveTimeout, GTK_ALIGN_END);
+  GtkWidget * liveTimeout = gtk_spin_button_new_with_range(0, 3600, 1);
+  g_hash_table_insert(ht, "liveTimeout", liveTimeout);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(liveTimeout), con->liveTimeout);
+  svSetTooltip(liveTimeout, "Marks the connection stale if the server stops answering for this many "
+    "seconds, using TCP keepalive (or SSH keepalive) plus periodic update requests.  "
+    "Combine with auto-reconnect to recover dropped links quickly (0 turns this off)");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblLiveTimeout, 1, 18, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), liveTimeout, 2, 18, 3, 1);
+
+  // idle disconnect minutes
+  GtkWidget * lblIdleMinutes = gtk_label_new("Idle disconnect (mins)");
+  gtk_widget_set_halign(lblIdleMinutes, GTK_ALIGN_END);
+  GtkWidget * idleMinutes = gtk_spin_button_new_with_range(-1, SV_IDLE_MAX_MINUTES, 1);
+  g_hash_table_insert(ht, "idleMinutes", idleMinutes);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(idleMinutes), con->idleMinutes);
+  svSetTooltip(idleMinutes, "Disconnects this connection after it hasn't been viewed or typed into "
+    "for this many minutes (-1 uses the app setting, 0 never does)");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblIdleMinutes, 1, 19, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), idleMinutes, 2, 19, 3, 1);
+
+  // repeater id
+  GtkWidget * lblRepeaterId = gtk_label_new("Repeater ID");
+  gtk_widget_set_halign(lblRepeaterId, GTK_ALIGN_END);
+  GtkWidget * repeaterId = gtk_entry_new();
+  g_hash_table_insert(ht, "repeaterId", repeaterId);
+  gtk_entry_set_width_chars(GTK_ENTRY(repeaterId), 30);
+  gtk_entry_set_text(GTK_ENTRY(repeaterId), con->repeaterId->str);
+  svSetTooltip(repeaterId, "For repeater connections, the ID number the server registered with "
+    "the repeater, or the host:port the repeater should connect to");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblRepeaterId, 1, 20, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), repeaterId, 2, 20, 3, 1);
+
+  // resize remote desktop to fit
+  GtkWidget * lblRemoteResize = gtk_label_new("Resize remote desktop to fit");
+  gtk_widget_set_halign(lblRemoteResize, GTK_ALIGN_END);
+  GtkWidget * remoteResize = gtk_check_button_new();
+  g_hash_table_insert(ht, "remoteResize", remoteResize);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(remoteResize), con->remoteResize);
+  svSetTooltip(remoteResize, "Asks the server to change its desktop to the size of the viewing area "
+    "(when it supports that), so no bandwidth is spent on pixels that would be scaled away or scrolled out of view");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblRemoteResize, 1, 21, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), remoteResize, 2, 21, 3, 1);
+
+  // coalesce pointer motion
+  GtkWidget * lblCoalescePointer = gtk_label_new("Coalesce pointer motion");
+  gtk_widget_set_halign(lblCoalescePointer, GTK_ALIGN_END);
+  GtkWidget * coalescePointer = gtk_check_button_new();
+  g_hash_table_insert(ht, "coalescePointer", coalescePointer);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(coalescePointer), con->coalescePointer);
+  svSetTooltip(coalescePointer, "Sends only the latest pointer position once per interval (or right away when "
+    "a button changes), with the interval following the connection's round-trip time - for slow or distant links");
+
+  gtk_grid_attach(GTK_GRID(vncPage), lblCoalescePointer, 1, 22, 1, 1);
+  gtk_grid_attach(GTK_GRID(vncPage), coalescePointer, 2, 22, 3, 1);
+
+  //
+  gtk_notebook_append_page(GTK_NOTEBOOK(editTab), vncPage, lblVNCTab);
+
+  // ------------------- ssh page -------------------
+  GtkWidget * sshPage = gtk_grid_new();
+  GtkWidget * lblSSHTab = gtk_label_new("SSH options");
+  gtk_container_set_border_width(GTK_CONTAINER(sshPage), 7);
+  gtk_grid_set_column_spacing(GTK_GRID(sshPage), 7);
+  gtk_grid_set_row_spacing(GTK_GRID(sshPage), 5);
+
+  // ssh name
+  GtkWidget * lblSSHName = gtk_label_new("SSH username");
+  gtk_widget_set_halign(lblSSHName, GTK_ALIGN_END);
+  GtkWidget * sshUsername = gtk_entry_new();
+  g_hash_table_insert(ht, "sshUsername", sshUsername);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(sshUsername), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(sshUsername), 30);
+  gtk_entry_set_text(GTK_ENTRY(sshUsername), con->sshUser->str);
+  svSetTooltip(sshUsername, "The username used for the remote host's SSH server");
+
+  gtk_grid_attach(GTK_GRID(sshPage), lblSSHName, 1, 1, 1, 1);
+  gtk_grid_attach(GTK_GRID(sshPage), sshUsername, 2, 1, 3, 1);
+
+  // ssh port
+  GtkWidget * lblSSHPort = gtk_label_new("SSH port");
+  gtk_widget_set_halign(lblSSHPort, GTK_ALIGN_END);
+  GtkWidget * sshPort = gtk_entry_new();
+  g_hash_table_insert(ht, "sshPort", sshPort);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(sshPort), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(sshPort), 10);
+  gtk_entry_set_text(GTK_ENTRY(sshPort), con->sshPort->str);
+  svSetTooltip(sshPort, "The remote host's numbered SSH server's port");
+
+  gtk_grid_attach(GTK_GRID(sshPage), lblSSHPort, 1, 2, 1, 1);
+  gtk_grid_attach(GTK_GRID(sshPage), sshPort, 2, 2, 3, 1);
+
+  // ssh private key
+  GtkWidget * lblSSHPrivKey = gtk_label_new("SSH private key (if any)");
+  gtk_widget_set_halign(lblSSHPrivKey, GTK_ALIGN_END);
+  GtkWidget * sshPrivateKey = gtk_entry_new();
+  g_hash_table_insert(ht, "sshPrivateKey", sshPrivateKey);
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(sshPrivateKey), false);
+  gtk_entry_set_width_chars(GTK_ENTRY(sshPrivateKey), 30);
+  gtk_entry_set_text(GTK_ENTRY(sshPrivateKey), con->sshPrivKeyfile->str);
+  svSetTooltip(sshPrivateKey, "The private key (if any) used to authenticate on the remote "
+    "host's SSH server");
+
+  GtkWidget * btnSSHPrivKey = gtk_button_new_with_label("...");
+  if (preventConnectedEditing)
+    gtk_widget_set_sensitive(GTK_WIDGET(btnSSHPrivKey), false);
+  g_signal_connect(btnSSHPrivKey, "clicked", G_CALLBACK(svHandleConnectionSSHPrivKey), ht);
+  svSetTooltip(btnSSHPrivKey, "Click to select a private key for the remote host's SSH server");
+
+  gtk_grid_attach(GTK_GRID(sshPage), lblSSHPrivKey, 1, 4, 1, 1);
+  gtk_grid_attach(GTK_GRID(sshPage), sshPrivateKey, 2, 4, 1, 1);
+  gtk_grid_attach(GTK_GRID(sshPage), btnSSHPrivKey, 3, 4, 1, 1);
+
+  //
+  gtk_notebook_append_page(GTK_NOTEBOOK(editTab), sshPage, lblSSHTab);
+
+  // ------------------- custom commands page -------------------
+  GtkWidget * customCmdsPage = gtk_grid_new();
+  GtkWidget * lblCmdsTab = gtk_label_new("Custom commands");
+  gtk_container_set_border_width(GTK_CONTAINER(customCmdsPage), 7);
+  gtk_grid_set_column_spacing(GTK_GRID(customCmdsPage), 7);
+  gtk_grid_set_row_spacing(GTK_GRID(customCmdsPage), 14);
+
+  // command 1
+  GtkWidget * frameCmd1 = gtk_frame_new("Command 1");
+  gtk_frame_set_shadow_type(GTK_FRAME(frameCmd1), GTK_SHADOW_ETCHED_IN);
+  gtk_grid_attach(GTK_GRID(customCmdsPage), frameCmd1, 1, 1, 1, 1);
+  GtkWidget * gridCmd1 = gtk_grid_new();
+  gtk_grid_set_column_spacing(GTK_GRID(gridCmd1), 5);
+  gtk_grid_set_row_spacing(GTK_GRID(gridCmd1), 5);
+  gtk_container_add(GTK_CONTAINER(frameCmd1), gridCmd1);
+
+  // - enabled
+  GtkWidget * lblCmd1Enabled = gtk_label_new("Enabled");
+  gtk_widget_set_halign(lblCmd1Enabled, GTK_ALIGN_END);
+  GtkWidget * cmd1Enabled = gtk_check_button_new();
+  g_hash_table_insert(ht, "cmd1Enabled", cmd1Enabled);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cmd1Enabled), con->customCmd1Enabled);
+  svSetTooltip(cmd1Enabled, "Enables custom command 1");
+
+  gtk_grid_attach(GTK_GRID(gridCmd1), lblCmd1Enabled, 1, 2, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd1), cmd1Enabled, 2, 2, 1, 1);
+
+  // - label
+  GtkWidget * lblCmd1Label = gtk_label_new("Label");
+  gtk_widget_set_halign(lblCmd1Label, GTK_ALIGN_END);
+  GtkWidget * cmd1Label = gtk_entry_new();
+  g_hash_table_insert(ht, "cmd1Label", cmd1Label);
+  gtk_entry_set_width_chars(GTK_ENTRY(cmd1Label), 30);
+  gtk_entry_set_text(GTK_ENTRY(cmd1Label), con->customCmd1Label->str);
+  svSetTooltip(cmd1Label, "The displayed menu label for custom command 1");
+
+  gtk_grid_attach(GTK_GRID(gridCmd1), lblCmd1Label, 1, 3, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd1), cmd1Label, 2, 3, 1, 1);
+
+  // - command
+  GtkWidget * lblCmd1 = gtk_label_new("Command");
+  gtk_widget_set_halign(lblCmd1, GTK_ALIGN_END);
+  GtkWidget * cmd1 = gtk_entry_new();
+  g_hash_table_insert(ht, "cmd1", cmd1);
+  gtk_entry_set_width_chars(GTK_ENTRY(cmd1), 30);
+  gtk_entry_set_text(GTK_ENTRY(cmd1), con->customCmd1->str);
+  svSetTooltip(cmd1, "The actual command that is run");
+
+  gtk_grid_attach(GTK_GRID(gridCmd1), lblCmd1, 1, 4, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd1), cmd1, 2, 4, 1, 1);
+
+  // command 2
+  GtkWidget * frameCmd2 = gtk_frame_new("Command 2");
+  gtk_frame_set_shadow_type(GTK_FRAME(frameCmd2), GTK_SHADOW_ETCHED_IN);
+  gtk_grid_attach(GTK_GRID(customCmdsPage), frameCmd2, 1, 2, 1, 1);
+  GtkWidget * gridCmd2 = gtk_grid_new();
+  gtk_grid_set_column_spacing(GTK_GRID(gridCmd2), 5);
+  gtk_grid_set_row_spacing(GTK_GRID(gridCmd2), 5);
+  gtk_container_add(GTK_CONTAINER(frameCmd2), gridCmd2);
+
+  // - enabled
+  GtkWidget * lblCmd2Enabled = gtk_label_new("Enabled");
+  gtk_widget_set_halign(lblCmd2Enabled, GTK_ALIGN_END);
+  GtkWidget * cmd2Enabled = gtk_check_button_new();
+  g_hash_table_insert(ht, "cmd2Enabled", cmd2Enabled);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cmd2Enabled), con->customCmd2Enabled);
+  svSetTooltip(cmd2Enabled, "Enables custom command 2");
+
+  gtk_grid_attach(GTK_GRID(gridCmd2), lblCmd2Enabled, 1, 2, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd2), cmd2Enabled, 2, 2, 1, 1);
+
+  // - label
+  GtkWidget * lblCmd2Label = gtk_label_new("Label");
+  gtk_widget_set_halign(lblCmd2Label, GTK_ALIGN_END);
+  GtkWidget * cmd2Label = gtk_entry_new();
+  g_hash_table_insert(ht, "cmd2Label", cmd2Label);
+  gtk_entry_set_width_chars(GTK_ENTRY(cmd2Label), 30);
+  gtk_entry_set_text(GTK_ENTRY(cmd2Label), con->customCmd2Label->str);
+  svSetTooltip(cmd2Label, "The displayed menu label for custom command 2");
+
+  gtk_grid_attach(GTK_GRID(gridCmd2), lblCmd2Label, 1, 3, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd2), cmd2Label, 2, 3, 1, 1);
+
+  // - command
+  GtkWidget * lblCmd2 = gtk_label_new("Command");
+  gtk_widget_set_halign(lblCmd2, GTK_ALIGN_END);
+  GtkWidget * cmd2 = gtk_entry_new();
+  g_hash_table_insert(ht, "cmd2", cmd2);
+  gtk_entry_set_width_chars(GTK_ENTRY(cmd2), 30);
+  gtk_entry_set_text(GTK_ENTRY(cmd2), con->customCmd2->str);
+  svSetTooltip(cmd2, "The actual command that is run");
+
+  gtk_grid_attach(GTK_GRID(gridCmd2), lblCmd2, 1, 4, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd2), cmd2, 2, 4, 1, 1);
+
+  // command 3
+  GtkWidget * frameCmd3 = gtk_frame_new("Command 3");
+  gtk_frame_set_shadow_type(GTK_FRAME(frameCmd3), GTK_SHADOW_ETCHED_IN);
+  gtk_grid_attach(GTK_GRID(customCmdsPage), frameCmd3, 1, 3, 1, 1);
+  GtkWidget * gridCmd3 = gtk_grid_new();
+  gtk_grid_set_column_spacing(GTK_GRID(gridCmd3), 5);
+  gtk_grid_set_row_spacing(GTK_GRID(gridCmd3), 5);
+  gtk_container_add(GTK_CONTAINER(frameCmd3), gridCmd3);
+
+  // - enabled
+  GtkWidget * lblCmd3Enabled = gtk_label_new("Enabled");
+  gtk_widget_set_halign(lblCmd3Enabled, GTK_ALIGN_END);
+  GtkWidget * cmd3Enabled = gtk_check_button_new();
+  g_hash_table_insert(ht, "cmd3Enabled", cmd3Enabled);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cmd3Enabled), con->customCmd3Enabled);
+  svSetTooltip(cmd3Enabled, "Enables custom command 3");
+
+  gtk_grid_attach(GTK_GRID(gridCmd3), lblCmd3Enabled, 1, 2, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd3), cmd3Enabled, 2, 2, 1, 1);
+
+  // - label
+  GtkWidget * lblCmd3Label = gtk_label_new("Label");
+  gtk_widget_set_halign(lblCmd3Label, GTK_ALIGN_END);
+  GtkWidget * cmd3Label = gtk_entry_new();
+  g_hash_table_insert(ht, "cmd3Label", cmd3Label);
+  gtk_entry_set_width_chars(GTK_ENTRY(cmd3Label), 30);
+  gtk_entry_set_text(GTK_ENTRY(cmd3Label), con->customCmd3Label->str);
+  svSetTooltip(cmd3Label, "The displayed label for custom command 3");
+
+  gtk_grid_attach(GTK_GRID(gridCmd3), lblCmd3Label, 1, 3, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd3), cmd3Label, 2, 3, 1, 1);
+
+  // - command
+  GtkWidget * lblCmd3 = gtk_label_new("Command");
+  gtk_widget_set_halign(lblCmd3, GTK_ALIGN_END);
+  GtkWidget * cmd3 = gtk_entry_new();
+  g_hash_table_insert(ht, "cmd3", cmd3);
+  gtk_entry_set_width_chars(GTK_ENTRY(cmd3), 30);
+  gtk_entry_set_text(GTK_ENTRY(cmd3), con->customCmd3->str);
+  svSetTooltip(cmd3, "The actual command run");
+
+  gtk_grid_attach(GTK_GRID(gridCmd3), lblCmd3, 1, 4, 1, 1);
+  gtk_grid_attach(GTK_GRID(gridCmd3), cmd3, 2, 4, 1, 1);
+
+  //
+  gtk_notebook_append_page(GTK_NOTEBOOK(editTab), customCmdsPage, lblCmdsTab);
+
+  // -- end of tab control --
+  gtk_container_add(GTK_CONTAINER(boxEditParent), editTab);
+
+  // ------------------- save / cancel buttons -------------------
+  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+
+  // save
+  GtkWidget * btnSave = gtk_button_new_with_label("Save");
+  gtk_widget_set_size_request(btnSave, 110, -1);
+  svSetTooltip(btnSave, "Click to save these settings");
+  g_signal_connect(btnSave, "clicked", G_CALLBACK(svHandleConnectionEditButtons), ht);
+
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnSave, false, false, 3);
+
+  // cancel
+  GtkWidget * btnCancel = gtk_button_new_with_label("Cancel");
+  g_hash_table_insert(ht, "btnCancel", btnCancel);
+  gtk_widget_set_size_request(btnCancel, 110, -1);
+  svSetTooltip(btnCancel, "Click to abandon any changes.  Caution: Any changes will be lost!");
+  g_signal_connect(btnCancel, "clicked", G_CALLBACK(svHandleConnectionEditButtons), ht);
+
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnCancel, false, false, 3);
+
+  //
+  gtk_container_add(GTK_CONTAINER(boxEditParent), boxButtons);
+
+  // show everything
+  gtk_widget_show_all(win);
+
+  gtk_window_present(GTK_WINDOW(win));
+
+  // focus the first entry
+  gtk_widget_grab_focus(connectionName);
+}
+
+
+/* handle app->parent divider position change */
+void svHandlePaneDividerChange (GtkPaned * paned, GtkScrollType * scroll_type, gpointer userData)
+{
+  if (!paned)
+    return;
+
+  // store handle position (basically 'list width')
+  app->serverListWidth = gtk_paned_get_position(paned);
+
+  // the viewed connection's server may want to match the new size
+  svRemoteResizeSoon(app->selectedConnection);
+}
+
+
+/* handle main window state changes */
+void svHandleMainWinChange (GtkWidget * widget, GdkEventWindowState * event, gpointer userData)
+{
+  if (!widget || widget != app->mainWin)
+    return;
+
+  // set maximized value
+  if (event->new_window_state & GDK_WINDOW_STATE_MAXIMIZED)
+    app->maximized = true;
+  else
+    app->maximized = false;
+
+  // set fullscreen value
+  if (event->new_window_state & GDK_WINDOW_STATE_FULLSCREEN)
+    app->fullscreen = true;
+  else
+    app->fullscreen = false;
+}
+
+
+/* set or unset menu item tooltips */
+/* (connection settings and app options tooltips are set elsewhere) */
+void svSetMenuItemTooltips ()
+{
+  // set tooltips
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "requestUpdate"),
+    "Asks the remote host to send an updated screen");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "sendEnteredKeys"),
+    "Sends entered or pasted keys to the remote host");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "sendCAD"),
+    "Sends the Control+Alt+Delete key combination to the remote host");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "sendCSE"),
+    "Sends the Control+Shift+Esc key combination to the remote host");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "addNew"),
+    "Adds a new connection to the connection list");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "fullscreen"),
+    "Toggles app fullscreen mode");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "listenMode"),
+    "Toggles reverse VNC (listening) mode");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "screenshot"),
+    "Takes a screenshot of the remote host");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "scanMode"),
+    "Toggles timed scan mode");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "tileView"),
+    "Shows several connected connections side by side (the focused one, in bold, takes input)");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "probeHosts"),
+    "Checks whether each host in the connection list is reachable");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "appOptions"),
+    "Displays the app preferences window");
+  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "quit"),
+    "Closes all connections and quits the app");
+}
+
+
+/* check for, prompt and display new new connection add */
+void svCheckForNewConnectionAdd ()
+{
+  // if nothing was added, prompt user to create a new connection
+  if (!app->addNewConnection)
+    return;
+
+  // create and edit new connection
+  Connection * con = g_new0(Connection, 1);
+  if (!con)
+    return;
+
+  svInitConnObject(con);
+
+  // set up new connection
+  g_string_assign(con->name, "(new connection)");
+  g_string_assign(con->group, "General");
+
+  // show connection editor window
+  svShowConnectionEditWindow(con);
+}
+
+
+/* make a unique listening connection name like 'prefix-20240101120000' (or '...-2', '-3' in a burst) */
+GString * svReverseUniqueName (const char * prefix)
+{
+  GDateTime * now = g_date_time_new_now_local();
+  char * nowStr = g_date_time_format(now, "%Y%m%d%H%M%S");  //  <<<--- do NOT make const char *
+
+  GString * base = g_string_new(NULL);
+  g_string_printf(base, "%s-%s", prefix, nowStr);
+
+  g_free(nowStr);
+  g_date_time_unref(now);
+
+  GString * name = g_string_new(base->str);
+
+  for (guint n = 2; svConnectionFromName(name->str); n++)
+    g_string_printf(name, "%s-%u", base->str, n);
+
+  g_string_free(base, true);
+
+  return name;
+}
+
+
+/* add a listening connection for an accepted reverse vnc client */
+void svReverseConnectionAdd (gint fd)
+{
+  // create new connection object
+  Connection * con = g_new0(Connection, 1);
+  if (!con)
+  {
+    close(fd);
+    return;
+  }
+
+  svInitConnObject(con);
+
+  GString * name = svReverseUniqueName("Listening");
+
+  // set up new connection
+  g_string_assign(con->name, name->str);
+  g_string_assign(con->group, "Listening");
+  con->type = SV_TYPE_VNC_REVERSE;
+  con->quality = SV_QUAL_MEDIUM;
+  con->listenFd = fd;
+  con->scale = true;
+
+  g_string_free(name, true);
+
+  app->reverseCount++;
+
+  // create box, image and label for listbox row
+  svInsertHostListRow(con->name->str, -1, con);
+
+  svConnectionCreate(con);
+}
+
+
+/* parse an allowed-address list like '10.0.0.0/8, 192.168.1.5' into masks */
+/* (false if any entry is bad - bad entries are skipped, and the rest are still added) */
+gboolean svReverseParseAllow (const char * text, GPtrArray * masks)
+{
+  gchar ** parts = g_strsplit_set(text ? text : "", ", ", -1);
+  gboolean okay = true;
+
+  for (gint i = 0; parts[i]; i++)
+  {
+    if (parts[i][0] == '\0')
+      continue;
+
+    GInetAddressMask * mask = g_inet_address_mask_new_from_string(parts[i], NULL);
+
+    if (mask)
+      g_ptr_array_add(masks, mask);
+    else
+      okay = false;
+  }
+
+  g_strfreev(parts);
+
+  return okay;
+}
+
+
+/* whether an allowed-address list has been given at all (even one whose entries are all bad) */
+gboolean svReverseAllowSet ()
+{
+  const char * text = app->reverseAllowText->str;
+
+  return text[strspn(text, ", ")] != '\0';
+}
+
+
+/* make room for a new address's rate bucket, never dropping the one for keep */
+/* (buckets that have filled back up hold nothing worth keeping - failing that, the longest unseen goes) */
+void svReverseBucketsTrim (const char * keep, gint64 now, double rate)
+{
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  const char * oldestKey = NULL;
+  gint64 oldest = G_MAXINT64;
+
+  g_hash_table_iter_init(&iter, app->reverseBuckets);
+
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    const RateBucket * bucket = (RateBucket *)value;
+
+    if (strcmp((char *)key, keep) == 0)
+      continue;
+
+    if (now - bucket->last >= 60 * G_USEC_PER_SEC ||
+      bucket->tokens + (double)(now - bucket->last) * rate / (60.0 * G_USEC_PER_SEC) >= rate)
+      g_hash_table_iter_remove(&iter);
+    else if (bucket->last < oldest)
+    {
+      oldest = bucket->last;
+      oldestKey = (char *)key;
+    }
+  }
+
+  if (g_hash_table_size(app->reverseBuckets) >= SV_REVERSE_BUCKETS_MAX && oldestKey)
+    g_hash_table_remove(app->reverseBuckets, oldestKey);
+}
+
+
+/* update the listen mode tooltip with how many reverse connections were turned away */
+void svReverseShowRejected ()
+{
+  if (app->reverseRejected == 0)
+  {
+    svSetTooltip(app->listenImage, "Toggle listen mode");
+    return;
+  }
+
+  GString * tipStr = g_string_new(NULL);
+  g_string_printf(tipStr, "Toggle listen mode\n(%u reverse connections turned away)", app->reverseRejected);
+  svSetTooltip(app->listenImage, tipStr->str);
+  g_string_free(tipStr, true);
+}
+
+
+/* decide whether to accept a reverse connection from addr, before anything is created for it */
+/* (reason is set when it's turned away) */
+gboolean svReverseAdmit (GInetAddress * addr, const char ** reason)
+{
+  // too many listening sessions already
+  if (app->reverseMax > 0 && app->reverseCount >= app->reverseMax)
+  {
+    *reason = "too many listening sessions";
+    return false;
+  }
+
+  if (!addr)
+    return true;
+
+  // not on the allowed list
+  // (a list with nothing usable in it lets no one in, rather than everyone)
+  if (app->reverseAllow->len > 0 || svReverseAllowSet())
+  {
+    gboolean allowed = false;
+
+    for (guint i = 0; i < app->reverseAllow->len && !allowed; i++)
+      allowed = g_inet_address_mask_matches(G_INET_ADDRESS_MASK(g_ptr_array_index(app->reverseAllow, i)), addr);
+
+    if (!allowed)
+    {
+      *reason = "not an allowed address";
+      return false;
+    }
+  }
+
+  // per-address token bucket, refilled at the per-minute rate and holding up to a minute's worth
+  if (app->reverseRatePerMin > 0)
+  {
+    const gint64 now = g_get_monotonic_time();
+    const double rate = app->reverseRatePerMin;
+
+    char * key = g_inet_address_to_string(addr);
+    RateBucket * bucket = g_hash_table_lookup(app->reverseBuckets, key);
+
+    // (a flood from many addresses drops the idle buckets, instead of growing without end)
+    if (!bucket && g_hash_table_size(app->reverseBuckets) >= SV_REVERSE_BUCKETS_MAX)
+      svReverseBucketsTrim(key, now, rate);
+
+    if (!bucket)
+    {
+      bucket = g_new0(RateBucket, 1);
+      bucket->tokens = rate;
+      bucket->last = now;
+      g_hash_table_insert(app->reverseBuckets, key, bucket);
+    }
+    else
+      g_free(key);
+
+    bucket->tokens = MIN(rate, bucket->tokens + (double)(now - bucket->last) * rate / (60.0 * G_USEC_PER_SEC));
+    bucket->last = now;
+
+    if (bucket->tokens < 1.0)
+    {
+      *reason = "connecting too often";
+      return false;
+    }
+
+    bucket->tokens -= 1.0;
+  }
+
+  return true;
+}
+
+
+/* handle reverse vnc connections waiting on a listening socket */
+gboolean svHandleReverseConnection (GSocket * sock, GIOCondition condition, gpointer data)
+{
+  ListenSocket * listener = (ListenSocket *)data;
+
+  // take everything that's waiting, not just one per wakeup
+  while (true)
+  {
+    GError * error = NULL;
+    GSocket * client = g_socket_accept(sock, NULL, &error);
+
+    if (!client)
+    {
+      if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+      {
+        GString * logStr = g_string_new(NULL);
+        g_string_printf(logStr, "Listen mode - accept failed on port %u: %s", listener->port, error->message);
+        svLog(logStr->str, false);
+        g_string_free(logStr, true);
+      }
+
+      g_error_free(error);
+      break;
+    }
+
+    // turn it away now if it's not wanted, before any widgets or vnc obj are made for it
+    GSocketAddress * remote = g_socket_get_remote_address(client, NULL);
+    GInetAddress * remoteAddr = remote ? g_inet_socket_address_get_address(G_INET_SOCKET_ADDRESS(remote)) : NULL;
+    const char * reason = NULL;
+
+    if (!svReverseAdmit(remoteAddr, &reason))
+    {
+      app->reverseRejected++;
+
+      char * addrStr = remoteAddr ? g_inet_address_to_string(remoteAddr) : g_strdup("unknown address");
+
+      GString * logStr = g_string_new(NULL);
+      g_string_printf(logStr, "Listen mode - turned away %s on port %u: %s (%u so far)", addrStr,
+        listener->port, reason, app->reverseRejected);
+      svLog(logStr->str, true);
+      g_string_free(logStr, true);
+
+      g_free(addrStr);
+
+      if (remote)
+        g_object_unref(remote);
+
+      g_object_unref(client);
+
+      svReverseShowRejected();
+      continue;
+    }
+
+    if (remote)
+      g_object_unref(remote);
+
+    // the vnc obj owns (and closes) its own copy of the socket, ours closes with the GSocket
+    const gint fd = svSocketDupFd(client);
+    g_object_unref(client);
+
+    if (fd < 0)
+      continue;
+
+    svReverseConnectionAdd(fd);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+/* parse a listening ports list like '5500, 5501' into ports */
+/* (false if any port is bad or there are none) */
+gboolean svListenParsePorts (const char * text, GArray * ports)
+{
+  gchar ** parts = g_strsplit_set(text ? text : "", ", ", -1);
+  gboolean okay = true;
+
+  for (gint i = 0; parts[i]; i++)
+  {
+    if (parts[i][0] == '\0')
+      continue;
+
+    char * end = NULL;
+    const gint64 value = g_ascii_strtoll(parts[i], &end, 10);
+
+    if (*end != '\0' || value < 1 || value > 65535)
+    {
+      okay = false;
+      break;
+    }
+
+    const guint16 port = (guint16)value;
+    gboolean repeated = false;
+
+    for (guint j = 0; j < ports->len; j++)
+      if (g_array_index(ports, guint16, j) == port)
+        repeated = true;
+
+    if (!repeated)
+      g_array_append_val(ports, port);
+  }
+
+  g_strfreev(parts);
+
+  return okay && ports->len > 0;
+}
+
+
+/* return true if a port is one of the configured listening ports */
+gboolean svListenIsPort (guint16 port)
+{
+  GArray * ports = g_array_new(false, false, sizeof(guint16));
+  gboolean found = false;
+
+  svListenParsePorts(app->listenPorts->str, ports);
+
+  for (guint i = 0; i < ports->len; i++)
+    if (g_array_index(ports, guint16, i) == port)
+      found = true;
+
+  g_array_unref(ports);
+
+  return found;
+}
+
+
+/* create, bind and start watching one listening socket */
+/* (NULL if it can't be, with the reason in errStr) */
+ListenSocket * svListenOpen (GSocketFamily family, guint16 port, GString * errStr)
+{
+  const char * familyStr = (family == G_SOCKET_FAMILY_IPV6) ? "IPv6" : "IPv4";
+
+  GError * error = NULL;
+  GSocket * sock = g_socket_new(family, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, &error);
+
+  if (!sock)
+  {
+    g_string_printf(errStr, "%s port %u: %s", familyStr, port, error->message);
+    g_error_free(error);
+    return NULL;
+  }
+
+  // keep the ipv6 socket to ipv6, so the ipv4 socket can have the same port
+  if (family == G_SOCKET_FAMILY_IPV6)
+    g_socket_set_option(sock, IPPROTO_IPV6, IPV6_V6ONLY, 1, NULL);
+
+  g_socket_set_blocking(sock, false);
+  g_socket_set_listen_backlog(sock, MAX(app->listenBacklog, 1));
+
+  GInetAddress * addr = g_inet_address_new_any(family);
+  GSocketAddress * sockAddr = g_inet_socket_address_new(addr, port);
+
+  const gboolean okay = g_socket_bind(sock, sockAddr, true, &error) && g_socket_listen(sock, &error);
+
+  g_object_unref(sockAddr);
+  g_object_unref(addr);
+
+  if (!okay)
+  {
+    g_string_printf(errStr, "%s port %u: %s", familyStr, port, error->message);
+    g_error_free(error);
+    g_object_unref(sock);
+    return NULL;
+  }
+
+  ListenSocket * listener = g_new0(ListenSocket, 1);
+  listener->sock = sock;
+  listener->port = port;
+
+  // start listening
+  listener->source = g_socket_create_source(sock, G_IO_IN, NULL);
+  g_source_set_callback(listener->source, (GSourceFunc)svHandleReverseConnection, listener, NULL);
+  g_source_attach(listener->source, g_main_context_default());
+
+  return listener;
+}
+
+
+/* stop watching and close one listening socket */
+void svListenClose (gpointer data)
+{
+  ListenSocket * listener = (ListenSocket *)data;
+
+  g_source_destroy(listener->source);
+  g_source_unref(listener->source);
+
+  g_socket_close(listener->sock, NULL);
+  g_object_unref(listener->sock);
+
+  g_free(listener);
+}
+
+
+/* listen on every configured port, over both ipv6 and ipv4 */
+/* (false if nothing could be listened on) */
+gboolean svListenStart ()
+{
+  GArray * ports = g_array_new(false, false, sizeof(guint16));
+
+  if (!svListenParsePorts(app->listenPorts->str, ports))
+    g_array_set_size(ports, 0);
+
+  const GSocketFamily families[] = { G_SOCKET_FAMILY_IPV6, G_SOCKET_FAMILY_IPV4 };
+
+  GString * failures = g_string_new(NULL);
+  GString * errStr = g_string_new(NULL);
+  GString * logStr = g_string_new(NULL);
+
+  for (guint i = 0; i < ports->len; i++)
+  {
+    const guint16 port = g_array_index(ports, guint16, i);
+    GString * portErrors = g_string_new(NULL);
+    gboolean anyFamily = false;
+
+    for (guint f = 0; f < G_N_ELEMENTS(families); f++)
+    {
+      ListenSocket * listener = svListenOpen(families[f], port, errStr);
+
+      if (listener)
+      {
+        g_ptr_array_add(app->listeners, listener);
+        anyFamily = true;
+      }
+      else
+      {
+        g_string_printf(logStr, "Listen mode - unable to listen on %s", errStr->str);
+        svLog(logStr->str, false);
+
+        g_string_append_printf(portErrors, "%s\n", errStr->str);
+      }
+    }
+
+    if (anyFamily)
+    {
+      g_string_printf(logStr, "Listen mode - listening on port %u", port);
+      svLog(logStr->str, true);
+    }
+    // (only worth reporting if the port can't be used at all - plenty of hosts have no ipv6)
+    else
+      g_string_append(failures, portErrors->str);
+
+    g_string_free(portErrors, true);
+  }
+
+  const gboolean listening = (app->listeners->len > 0);
+
+  if (!listening || failures->len > 0)
+  {
+    char * escaped = g_markup_escape_text(ports->len > 0 ? failures->str : "No valid ports are set\n", -1);
+    GString * msgStr = g_string_new(NULL);
+
+    g_string_printf(msgStr, "<b>%s</b>\n\n%s\nCheck the listening ports in the app options",
+      listening ? "Some listening ports couldn't be opened" : "Unable to listen for reverse connections",
+      escaped);
+    svShowMessageDialog(msgStr->str);
+
+    g_string_free(msgStr, true);
+    g_free(escaped);
+  }
+
+  g_string_free(logStr, true);
+  g_string_free(errStr, true);
+  g_string_free(failures, true);
+  g_array_unref(ports);
+
+  return listening;
+}
+
+
+/* stop listening on all ports */
+void svListenStop ()
+{
+  // (the array frees each listening socket)
+  g_ptr_array_set_size(app->listeners, 0);
+}
+
+
+/* menu item handler - toggle listen mode */
+void svHandleListenModeMenuItem ()
+{
+  app->listenMode = !app->listenMode;
+
+  // couldn't listen anywhere, so stay out of listen mode
+  if (app->listenMode && !svListenStart())
+    app->listenMode = false;
+
+  if (app->listenMode)
+  {
+    // change listen mode tools menu item text
+    gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "listenMode")), "Disable _listen mode");
+
+    // change listen toolbutton to 'enabled' image
+    if (app->listenImage)
+    {
+      gtk_image_clear(GTK_IMAGE(app->listenImage));
+      gtk_image_set_from_resource(GTK_IMAGE(app->listenImage), "/com/spiritvnc/pngs/listen-enabled.png");
+    }
+  }
+  else
+  {
+    // change listen mode tools menu item text
+    gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "listenMode")), "Enable _listen mode");
+    gtk_window_set_title(GTK_WINDOW(app->mainWin), "SpiritVNC");
+
+    // change listen toolbutton to 'disabled' image
+    if (app->listenImage)
+    {
+      gtk_image_clear(GTK_IMAGE(app->listenImage));
+      gtk_image_set_from_resource(GTK_IMAGE(app->listenImage), "/com/spiritvnc/pngs/listen-disabled.png");
+    }
+
+    svListenStop();
+  }
+}
+
+
+/* handle window delete properly */
+gboolean svMainWinDeleteEvent(GtkWidget * w, GdkEvent * e, gpointer u)
+{
+  svDoQuit();
+  return false;
+}
+
+
+/* create the main app GUI */
+void svCreateGUI (GtkApplication * gtkApp)
+{
+  if (app->mainWin)
+    return;
+
+  // create main window
+  app->mainWin = gtk_application_window_new(gtkApp);
+  //gtk_application_add_window(app->gApp, GTK_WINDOW(app->mainWin));
+  gtk_window_set_title(GTK_WINDOW(app->mainWin), "SpiritVNC");
+  gtk_window_set_default_size(GTK_WINDOW(app->mainWin), 1024, 720);
+  g_signal_connect(app->mainWin, "delete-event", G_CALLBACK(svMainWinDeleteEvent), NULL);
+
+  // go bye-bye if we can't even make the main window
+  if (!app->mainWin)
+  {
+    svLog("SpiritVNC-GTK: Fatal error - main window is NULL. Terminating program", false);
+    exit(-1);
+  }
+
+  // window icon
+  GdkPixbuf * appIcon = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/spiritvnc.png", NULL);
+  if (appIcon)
+  {
+    gtk_window_set_default_icon(appIcon);
+    g_object_unref(appIcon);
+  }
+
+  gtk_window_set_application(GTK_WINDOW(app->mainWin), GTK_APPLICATION(gtkApp));
+
+  // ############### PARENT PANE ###########################################
+  app->parent = gtk_paned_new(GTK_ORIENTATION_HORIZONTAL);
+  gtk_container_add(GTK_CONTAINER(app->mainWin), app->parent);
+
+  // ************** tools menu - start **************************
+
+  // tools menubar
+  app->menuBar = gtk_menu_bar_new();
+
+  // first top-level menu item
+  GtkWidget * tools = gtk_menu_item_new_with_label("_Tools");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(tools), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(tools), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(app->menuBar), tools);
+
+  // submenu for tools
+  GtkWidget * submenu = gtk_menu_new();
+
+  // request update
+  GtkWidget * upd = gtk_menu_item_new_with_label("Request _update");
+  g_hash_table_insert(app->toolsItems, "requestUpdate", upd);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(upd), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(upd), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), upd);
+  g_signal_connect(upd, "activate", G_CALLBACK(svHandleRequestUpdateMenuItem), NULL);
+
+  // *** begin 'send' submenu ***
+
+  // send submenu
+  GtkWidget * ssm = gtk_menu_item_new_with_label("Send...");
+  g_hash_table_insert(app->toolsItems, "send", ssm);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(ssm), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(ssm), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), ssm);
+
+  // create submenu
+  GtkWidget * sendMen = gtk_menu_new();
+
+  // attach submenu to 'send' item
+  gtk_menu_item_set_submenu(GTK_MENU_ITEM(ssm), sendMen);
+
+  // send entered keystrokes
+  GtkWidget * sks = gtk_menu_item_new_with_label("_Keys...");
+  g_hash_table_insert(app->toolsItems, "sendEnteredKeys", sks);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(sks), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(sks), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(sendMen), sks);
+  g_signal_connect(sks, "activate", G_CALLBACK(svHandleSendEnteredKeystrokesMenuItem), NULL);
+
+  // send ctrl+alt+del
+  GtkWidget * cad = gtk_menu_item_new_with_label("Ctrl+_Alt+Del");
+  g_hash_table_insert(app->toolsItems, "sendCAD", cad);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cad), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(cad), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(sendMen), cad);
+  g_signal_connect(cad, "activate", G_CALLBACK(svHandleSendCADMenuItem), NULL);
+
+  // send ctrl+shift+esc
+  GtkWidget * cse = gtk_menu_item_new_with_label("Ctrl+Shift+_Esc");
+  g_hash_table_insert(app->toolsItems, "sendCSE", cse);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cse), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(cse), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(sendMen), cse);
+  g_signal_connect(cse, "activate", G_CALLBACK(svHandleSendCSEMenuItem), NULL);
+
+  // *** end of 'send' submenu ***
+
+  // screenshot
+  GtkWidget * scr = gtk_menu_item_new_with_label("_Screenshot");
+  g_hash_table_insert(app->toolsItems, "screenshot", scr);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(scr), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(scr), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), scr);
+  g_signal_connect(scr, "activate", G_CALLBACK(svHandleScreenshotMenuItem), NULL);
+
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), gtk_separator_menu_item_new());
+
+  // *** end of connection-centric stuff ***
+
+  // listen mode
+  GtkWidget * lis = gtk_menu_item_new_with_label("Enable _listen mode");
+  g_hash_table_insert(app->toolsItems, "listenMode", lis);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(lis), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(lis), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), lis);
+  g_signal_connect(lis, "activate", G_CALLBACK(svHandleListenModeMenuItem), NULL);
+
+  // scan mode
+  GtkWidget * scn = gtk_menu_item_new_with_label("Enable scan _mode");
+  g_hash_table_insert(app->toolsItems, "scanMode", scn);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(scn), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(scn), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), scn);
+  g_signal_connect(scn, "activate", G_CALLBACK(svHandleScanModeMenuItem), NULL);
+
+  // tile view
+  GtkWidget * til = gtk_menu_item_new_with_label("_Tile view");
+  g_hash_table_insert(app->toolsItems, "tileView", til);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(til), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), til);
+
+  GtkWidget * tileMen = gtk_menu_new();
+  gtk_menu_item_set_submenu(GTK_MENU_ITEM(til), tileMen);
+
+  const char * tileLabels[] = {"_Off", "_2 connections", "_4 connections", "_9 connections"};
+  const guint tileCounts[] = {0, 2, 4, 9};
+  GSList * tileGroup = NULL;
+
+  for (guint i = 0; i < G_N_ELEMENTS(tileCounts); i++)
+  {
+    GtkWidget * tileItem = gtk_radio_menu_item_new_with_mnemonic(tileGroup, tileLabels[i]);
+    tileGroup = gtk_radio_menu_item_get_group(GTK_RADIO_MENU_ITEM(tileItem));
+    gtk_menu_shell_append(GTK_MENU_SHELL(tileMen), tileItem);
+    g_signal_connect(tileItem, "toggled", G_CALLBACK(svHandleTileMenuItem), GUINT_TO_POINTER(tileCounts[i]));
+  }
+
+  // check hosts
+  GtkWidget * prb = gtk_menu_item_new_with_label("Chec_k all hosts now");
+  g_hash_table_insert(app->toolsItems, "probeHosts", prb);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(prb), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(prb), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), prb);
+  g_signal_connect(prb, "activate", G_CALLBACK(svHandleProbeHostsMenuItem), NULL);
+
+  // add new
+  GtkWidget * add = gtk_menu_item_new_with_label("Add _new connection...");
+  g_hash_table_insert(app->toolsItems, "addNew", add);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(add), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), add);
+  g_signal_connect(add, "activate", G_CALLBACK(svHandleAddNewConnectionMenuItem), NULL);
+
+  // fullscreen
+  GtkWidget * ful = gtk_menu_item_new_with_label("Toggle _fullscreen");
+  g_hash_table_insert(app->toolsItems, "fullscreen", ful);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(ful), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(ful), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), ful);
+  g_signal_connect(ful, "activate", G_CALLBACK(svHandleFullscreenMenuItem), NULL);
+
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), gtk_separator_menu_item_new());
+  // *** end of operations-centric stuff ***
+
+  // app options
+  GtkWidget * ao = gtk_menu_item_new_with_label("_Preferences");
+  g_hash_table_insert(app->toolsItems, "appOptions", ao);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(ao), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), ao);
+  g_signal_connect(ao, "activate", G_CALLBACK(svShowAppOptionsWindow), NULL);
+
+  // quit
+  GtkWidget * qui = gtk_menu_item_new_with_label("_Quit");
+  g_hash_table_insert(app->toolsItems, "quit", qui);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(qui), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), qui);
+  g_signal_connect(qui, "activate", G_CALLBACK(svDoQuit), NULL);
+
+  // add submenu to tools
+  gtk_menu_item_set_submenu(GTK_MENU_ITEM(tools), submenu);
+
+  //gtk_application_set_menubar(GTK_APPLICATION(gtkApp), G_MENU_MODEL(app->menuBar));
+
+  // ################ TOOLS MENU - END #######################
+
+  // help top menu
+  GtkWidget * help = gtk_menu_item_new_with_label("_Help");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(help), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(help), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(app->menuBar), help);
+
+  GtkWidget * helpSub = gtk_menu_new();
+
+  // about
+  GtkWidget * abt = gtk_menu_item_new_with_label("_About");
+  g_hash_table_insert(app->toolsItems, "about", abt);
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(abt), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(helpSub), abt);
+  g_signal_connect(abt, "activate", G_CALLBACK(svShowAboutWindow), NULL);
+
+  // add submenu to help
+  gtk_menu_item_set_submenu(GTK_MENU_ITEM(help), helpSub);
+
+  // ################# PANES - START #################
+
+  // server list -- nearly the heart of the program
+  // * (keep this here, needed for config read) *
+  app->serverList = gtk_list_box_new();
+  gtk_list_box_set_selection_mode(GTK_LIST_BOX(app->serverList), GTK_SELECTION_BROWSE);
+  g_signal_connect(app->serverList, "button-press-event", G_CALLBACK(svHandleConnectionListClicks), NULL);
+  gtk_widget_add_events(app->serverList, GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
+  g_signal_connect(app->serverList, "motion-notify-event", G_CALLBACK(svHandleConnectionListMotion), NULL);
+  g_signal_connect(app->serverList, "leave-notify-event", G_CALLBACK(svHandleConnectionListLeave), NULL);
+
+  // read in the config file and fill the connection listbox + glist
+  svConfigRead();
+
+  gtk_list_box_unselect_all(GTK_LIST_BOX(app->serverList));
+
+  // **** left pane ****
+  // parent listbox and display stack
+  // menu and hostlist
+  GtkWidget * leftBox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 3);
+  gtk_container_set_border_width(GTK_CONTAINER(leftBox), 2);
+  // add the leftBox parent container to left pane
+  gtk_paned_pack1(GTK_PANED(app->parent), leftBox, false, true);
+
+  // pack menu-bar and server list into leftBox
+  gtk_box_pack_start(GTK_BOX(leftBox), app->menuBar, false, false, 0);
+  //gtk_container_add(GTK_CONTAINER(app->mainWin), app->menuBar);
+
+  // ############# toolbar area ###################################################
+  GtkWidget * toolBar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  gtk_box_pack_start(GTK_BOX(leftBox), toolBar, false, false, 2);
+
+  // listen toolbutton
+  app->toolbuttonListen = gtk_event_box_new();
+  g_signal_connect(G_OBJECT(app->toolbuttonListen), "button-press-event", G_CALLBACK(svHandleListenModeMenuItem), NULL);
+  app->listenImage = gtk_image_new_from_resource("/com/spiritvnc/pngs/listen-disabled.png");
+  svSetTooltip(app->listenImage, "Toggle listen mode");
+  gtk_container_add(GTK_CONTAINER(app->toolbuttonListen), app->listenImage);
+  gtk_box_pack_start(GTK_BOX(toolBar), app->toolbuttonListen, false, false, 3);
+
+  // scan toolbutton
+  app->toolbuttonScan = gtk_event_box_new();
+  g_signal_connect(G_OBJECT(app->toolbuttonScan), "button-press-event", G_CALLBACK(svHandleScanModeMenuItem), NULL);
+  app->scanImage = gtk_image_new_from_resource("/com/spiritvnc/pngs/scan-disabled.png");
+  svSetTooltip(app->scanImage, "Toggle scan mode");
+  gtk_container_add(GTK_CONTAINER(app->toolbuttonScan), app->scanImage);
+  gtk_box_pack_start(GTK_BOX(toolBar), app->toolbuttonScan, false, false, 3);
+
+  // add connection toolbutton
+  app->addConnectionToolbutton = gtk_event_box_new();
+  g_signal_connect(G_OBJECT(app->addConnectionToolbutton), "button-press-event", G_CALLBACK(svHandleAddNewConnectionMenuItem), NULL);
+  app->addConnectionImage = gtk_image_new_from_resource("/com/spiritvnc/pngs/add-connection.png");
+  svSetTooltip(app->addConnectionImage, "Add a new connection");
+  gtk_container_add(GTK_CONTAINER(app->addConnectionToolbutton), app->addConnectionImage);
+  gtk_box_pack_start(GTK_BOX(toolBar), app->addConnectionToolbutton, false, false, 3);
+
+  // ############# toolbar area end ###################################################
+
+  // scrollable parent for server list
+  app->serverListScroller = gtk_scrolled_window_new(NULL, NULL);
+  gtk_widget_set_vexpand(app->serverListScroller, true);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(app->serverListScroller),
+    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+
+  // add server list to scroller
+  gtk_container_add(GTK_CONTAINER(app->serverListScroller), app->serverList);
+  // add server list scroller to leftBox
+  gtk_box_pack_start(GTK_BOX(leftBox), app->serverListScroller, true, true, 0);
+
+  // quicknote item label
+  app->quickNoteLabel = gtk_label_new("-");
+  gtk_widget_set_halign(app->quickNoteLabel, GTK_ALIGN_START);
+  gtk_widget_set_margin_start(app->quickNoteLabel, 3);
+  gtk_widget_set_margin_top(app->quickNoteLabel, 7);
+  gtk_label_set_ellipsize(GTK_LABEL(app->quickNoteLabel), PANGO_ELLIPSIZE_END);
+  // pack quicknote label in leftBox
+  gtk_box_pack_start(GTK_BOX(leftBox), app->quickNoteLabel, false, false, 0);
+
+  // quicknote last connected
+  app->quickNoteLastConnected = gtk_label_new("Last connected: -");
+  gtk_label_set_line_wrap(GTK_LABEL(app->quickNoteLastConnected), true);
+  gtk_widget_set_halign(app->quickNoteLastConnected, GTK_ALIGN_START);
+  gtk_widget_set_margin_start(app->quickNoteLastConnected, 3);
+  gtk_widget_set_margin_top(app->quickNoteLastConnected, 7);
+  // pack quicknote label in leftBox
+  gtk_box_pack_start(GTK_BOX(leftBox), app->quickNoteLastConnected, false, false, 0);
+
+  // auto-reconnect status (only shown while reconnecting)
+  app->quickNoteReconnect = gtk_label_new(NULL);
+  gtk_label_set_line_wrap(GTK_LABEL(app->quickNoteReconnect), true);
+  gtk_widget_set_halign(app->quickNoteReconnect, GTK_ALIGN_START);
+  gtk_widget_set_margin_start(app->quickNoteReconnect, 3);
+  gtk_widget_set_no_show_all(app->quickNoteReconnect, true);
+  gtk_box_pack_start(GTK_BOX(leftBox), app->quickNoteReconnect, false, false, 0);
+
+  // connection last error scroller
+  GtkWidget * errorScroller = gtk_scrolled_window_new(NULL, NULL);
+  // add quicknote scroller to leftBox
+  gtk_box_pack_start(GTK_BOX(leftBox), errorScroller, false, false, 0);
+
+  // connection last error
+  app->quickNoteLastError = gtk_text_view_new();
+  gtk_text_view_set_editable(GTK_TEXT_VIEW(app->quickNoteLastError), false);
+  gtk_text_view_set_left_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 5);
+  gtk_text_view_set_top_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 2);
+  gtk_text_view_set_right_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 5);
+  gtk_text_view_set_bottom_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 2);
+  // pack quicknote label in leftBox
+  gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(app->quickNoteLastError), GTK_WRAP_WORD_CHAR);
+  gtk_container_add(GTK_CONTAINER(errorScroller), app->quickNoteLastError);
+
+  // quicknote scroller
+  GtkWidget * quickScroller = gtk_scrolled_window_new(NULL, NULL);
+  gtk_widget_set_size_request(quickScroller, -1, 180); //160);
+  // add quicknote scroller to leftBox
+  gtk_box_pack_start(GTK_BOX(leftBox), quickScroller, false, false, 0);
+
+  // quick note editor
+  app->quickNoteView = gtk_text_view_new();
+  gtk_text_view_set_editable(GTK_TEXT_VIEW(app->quickNoteView), false);
+  gtk_text_view_set_left_margin(GTK_TEXT_VIEW(app->quickNoteView), 5);
+  gtk_text_view_set_top_margin(GTK_TEXT_VIEW(app->quickNoteView), 2);
+  gtk_text_view_set_right_margin(GTK_TEXT_VIEW(app->quickNoteView), 5);
+  gtk_text_view_set_bottom_margin(GTK_TEXT_VIEW(app->quickNoteView), 2);
+  // add quickNoteView to quicknote scroller
+  gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(app->quickNoteView), GTK_WRAP_WORD_CHAR);
+  gtk_container_add(GTK_CONTAINER(quickScroller), app->quickNoteView);
+
+  app->quickNoteLastErrorBuffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(app->quickNoteLastError));
+  app->quickNoteBuffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(app->quickNoteView));
+
+  // **** right pane ****
+  // vnc viewer
+  // display stack for vnc display objects
+  // scrollable parent for stack
+  app->displayStackScroller = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(app->displayStackScroller),
+    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_paned_pack2(GTK_PANED(app->parent), app->displayStackScroller, true, true);
+
+  //// display stack for vnc display objects
+  app->displayStack = gtk_stack_new();
+  gtk_stack_set_homogeneous(GTK_STACK(app->displayStack), false);
+  gtk_stack_set_interpolate_size(GTK_STACK(app->displayStack), false);
+  gtk_widget_set_hexpand(app->displayStack, false);
+  gtk_widget_set_vexpand(app->displayStack, false);
+  gtk_container_add(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
+
+  // dimmed last-known screen of the connection being connected (shown only when there is one)
+  app->previewArea = gtk_drawing_area_new();
+  gtk_widget_set_no_show_all(app->previewArea, true);
+  g_signal_connect(app->previewArea, "draw", G_CALLBACK(svPreviewDraw), NULL);
+  gtk_stack_add_named(GTK_STACK(app->displayStack), app->previewArea, "(preview)");
+
+  // (window and divider changes resize the viewed connection's remote desktop, if it's set to)
+  g_signal_connect(app->displayStackScroller, "size-allocate", G_CALLBACK(svHandleViewportResize), NULL);
+
+  // ################# PANES - END ################
+
+  // set or unset tooltips
+  svSetMenuItemTooltips();
+
+  // show everything
+  gtk_widget_show_all(app->mainWin);
+
+  //gtk_window_present(GTK_WINDOW(app->mainWin));
+
+  // if saved main window state was maximized, maximize the main window
+  if (app->maximized)
+    gtk_window_maximize(GTK_WINDOW(app->mainWin));
+
+  // size the hostlist pane
+  gtk_paned_set_position(GTK_PANED(app->parent), app->serverListWidth);
+
+  // connect the pane handle handler handlething handlez (leave this here, not by widget creation)
+  g_signal_connect(app->parent, "notify::position", G_CALLBACK(svHandlePaneDividerChange), NULL);
+
+  // handle window max / un-max
+  g_signal_connect(app->mainWin, "window-state-event", G_CALLBACK(svHandleMainWinChange), NULL);
+
+  // watch the local clipboard for text to sync to the viewed connection
+  g_signal_connect(gtk_clipboard_get(GDK_SELECTION_CLIPBOARD), "owner-change",
+    G_CALLBACK(svHandleLocalClipboardChange), NULL);
+
+  // start background reachability checks, if enabled
+  svProbeSchedule();
+
+  // watch for idle connections
+  g_timeout_add_seconds(30, svIdleTimer, NULL);
+
+  // keep each connected connection's screen for next time
+  g_timeout_add_seconds(SV_PREVIEW_SAVE_SECS, svPreviewTimer, NULL);
+
+  // open the automation control socket, if enabled
+  svControlStart();
+
+  // check if we need to show the 'add new connection' prompt
+  svCheckForNewConnectionAdd();
+}
+
+
+/* create new config folder(s) and file if none exists */
+gboolean svConfigCreateNew (gboolean createEmptyConfigFile)
+{
+  // create app's config folder, making parent folders as necessary
+  gint result = g_mkdir_with_parents(app->appConfigDir->str, 0755);
+
+  // error in folder creation
+  if (result == -1)
+  {
+    GString * strErr = g_string_new(NULL);
+    gint errCode = errno;
+    g_string_printf(strErr, "svConfigCreateNew - Can't create config folder(s) - Error code: %i, %s",
+      errCode, strerror(errCode));
+    svLog(strErr->str, false);
+    g_string_free(strErr, true);
+    return false;
+  }
+
+  if (createEmptyConfigFile)
+  {
+    // only create a new empty file if one doesn't exist already
+    if (!g_file_test(app->appConfigFile->str, G_FILE_TEST_IS_REGULAR | G_FILE_TEST_EXISTS))
+    {
+      svLog("svConfigCreateNew - Creating new empty config file", false);
+
+      // --- attempt to write empty config file ---
+      if (!g_file_set_contents(app->appConfigFile->str, "\n", -1, NULL))
+      {
+        svLog("svConfigCreateNew - Error: SpiritVNC could not write empty config file", false);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+/* insert a row into the connection listbox */
+void svInsertHostListRow (const char * rowText, gint idx, Connection * con)
+{
+  if (!rowText)  // do NOT check con for NULL here, it's okay if it's null
+    return;
+
+  // box
+  GtkWidget * rowBox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 3);
+  if (!rowBox)
+    return;
+
+  // assign a connection to the row, if available
+  g_object_set_data(G_OBJECT(rowBox), "con", con);
+
+  // image
+  GdkPixbuf * pb;
+
+  if (rowText[0] != '\0')
+    pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected.png", NULL);
+  else
+    pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/blank.png", NULL);
+
+  GtkWidget * img = gtk_image_new_from_pixbuf(pb);
+
+  // label
+  GtkWidget * label = gtk_label_new(rowText);
+  gtk_widget_set_halign(label, GTK_ALIGN_START);
+
+  // add img and label to box
+  gtk_box_pack_start(GTK_BOX(rowBox), img, false, false, 3);
+  gtk_box_pack_start(GTK_BOX(rowBox), label, false, false, 0);
+
+  gtk_widget_set_visible(img, true);
+  gtk_widget_set_visible(label, true);
+  gtk_widget_set_visible(rowBox, true);
+
+  // (tooltips show the connection's last-known screen, when there is one)
+  g_signal_connect(rowBox, "query-tooltip", G_CALLBACK(svHandleHostListTooltip), NULL);
+
+  // add box to connections listbox
+  gtk_list_box_insert(GTK_LIST_BOX(app->serverList), rowBox, idx);
+}
+
+
+/* read the config file and fill the connections listbox + glist */
+void svConfigRead ()
+{
+  GError * readError = NULL;
+
+  char * strIn = NULL;
+
+  // check and create any missing config folders
+  if (!svConfigCreateNew(true))
+  {
+    svLog("svConfigRead - Could not create new config dirs or file - quitting app", false);
+    exit(-1);
+  }
+
+  // read config file contents into strIn
+  if (!g_file_get_contents(app->appConfigFile->str, &strIn, NULL, &readError))
+  {
+    GString * errStr = g_string_new(NULL);
+
+    if (readError)
+      g_string_printf(errStr, "svConfigRead - Error opening config file\nError: %s", readError->message);
+    else
+      g_string_assign(errStr, "svConfigRead - Error opening config file - No error reported");
+
+    svLog(errStr->str, false);
+    g_string_free(errStr, true);
+  }
+
+  if (readError)
+    g_error_free(readError);
+
+  // get out if strIn is null
+  if (!strIn)
+    return;
+
+  // create initial con object
+  Connection * con = g_new0(Connection, 1);
+  svInitConnObject(con);
+
+  char ** lines = g_strsplit(strIn, "\n", -1);  //  <<<--- do NOT make const char **
+
+  g_free(strIn);
+
+  GString * strLastGroup = g_string_new(NULL);
+
+  // process each line
+  for (char ** line = lines; *line != NULL; line++)
+  {
+    // process each line
+
+    // split up property and value
+    char ** propAndVal = g_strsplit(*line, "=", 2);
+
+    // property and value must both be non-null
+    if (!propAndVal[0] || !propAndVal[1])
+    {
+      g_strfreev(propAndVal);
+      continue;
+    }
+
+    // trim whitespace (in-place)
+    g_strstrip(propAndVal[0]);
+    g_strstrip(propAndVal[1]);
+
+    // assign prop and vals
+    GString * strProp = g_string_new(propAndVal[0]);
+    GString * strVal = g_string_new(propAndVal[1]);
+
+    g_strfreev(propAndVal);
+
+    //printf("Prop: %s, Val: %s\n", strProp->str, strVal->str);
+
+    // ** start assigning values to properties **
+
+    // ===== app settings =====
+
+    // * serverListWidth *
+    if (strcmp(strProp->str, "hostlistwidth") == 0)
+    {
+      app->serverListWidth = atoi(strVal->str);
+
+      if (app->serverListWidth < 1)
+        app->serverListWidth = 120;
+    }
+
+    // * showTooltips *
+    if (strcmp(strProp->str, "showtooltips") == 0)
+      app->showTooltips = svStringToBool(strVal->str);
+
+    // * maximized *
+    if (strcmp(strProp->str, "maximized") == 0)
+      app->maximized = svStringToBool(strVal->str);
+
+    // * log to file *
+    if (strcmp(strProp->str, "logtofile") == 0)
+      app->logToFile = svStringToBool(strVal->str);
+
+    // * debug mode *
+    if (strcmp(strProp->str, "debugmode") == 0)
+      app->debugMode = svStringToBool(strVal->str);
+
+    // * scan wait time *
+    if (strcmp(strProp->str, "scantimeout") == 0)
+      app->scanTimeout = atoi(strVal->str);
+
+    // * vnc connect timeout *
+    if (strcmp(strProp->str, "vnctimeout") == 0)
+      app->vncConnectWaitTime = atoi(strVal->str);
+
+    // * ssh command *
+    if (strcmp(strProp->str, "sshcommand") == 0)
+      g_string_assign(app->sshCommand, strVal->str);
+
+    // * ssh connect timeout *
+    if (strcmp(strProp->str, "sshtimeout") == 0)
+      app->sshConnectWaitTime = atoi(strVal->str);
+
+    // * clipboard history memory cap *
+    if (strcmp(strProp->str, "cliphistorykb") == 0)
+      app->clipHistoryKB = atoi(strVal->str);
+
+    // * reachability probe interval *
+    if (strcmp(strProp->str, "probeinterval") == 0)
+      app->probeInterval = atoi(strVal->str);
+
+    // * reachability probe concurrency *
+    if (strcmp(strProp->str, "probeconcurrency") == 0)
+    {
+      app->probeConcurrency = atoi(strVal->str);
+
+      if (app->probeConcurrency < 1)
+        app->probeConcurrency = 8;
+    }
+
+    // * reachability probe reads rfb banner *
+    if (strcmp(strProp->str, "probebanner") == 0)
+      app->probeReadBanner = svStringToBool(strVal->str);
+
+    // * framebuffer memory budget *
+    if (strcmp(strProp->str, "fbbudgetmb") == 0)
+      app->fbBudgetMB = atoi(strVal->str);
+
+    // * pre-connect on hover / select *
+    if (strcmp(strProp->str, "preconnect") == 0)
+      app->preconnect = svStringToBool(strVal->str);
+
+    // * listening ports *
+    if (strcmp(strProp->str, "listenports") == 0)
+      g_string_assign(app->listenPorts, strVal->str);
+
+    // * listen backlog *
+    if (strcmp(strProp->str, "listenbacklog") == 0)
+      app->listenBacklog = atoi(strVal->str);
+
+    // * max listening sessions *
+    if (strcmp(strProp->str, "reversemax") == 0)
+      app->reverseMax = atoi(strVal->str);
+
+    // * reverse connections per minute, per address *
+    if (strcmp(strProp->str, "reverserate") == 0)
+      app->reverseRatePerMin = atoi(strVal->str);
+
+    // * allowed reverse addresses (bad entries are dropped) *
+    if (strcmp(strProp->str, "reverseallow") == 0)
+    {
+      g_string_assign(app->reverseAllowText, strVal->str);
+      g_ptr_array_set_size(app->reverseAllow, 0);
+
+      if (!svReverseParseAllow(strVal->str, app->reverseAllow))
+      {
+        GString * logStr = g_string_new(NULL);
+
+        if (app->reverseAllow->len == 0)
+          g_string_printf(logStr, "No usable entries in allowed reverse addresses '%s' - "
+            "all reverse connections will be turned away", strVal->str);
+        else
+          g_string_printf(logStr, "Skipped bad entries in allowed reverse addresses '%s'", strVal->str);
+
+        svLog(logStr->str, false);
+        g_string_free(logStr, true);
+      }
+    }
+
+    // * dns cache time *
+    if (strcmp(strProp->str, "dnscachesecs") == 0)
+      app->dnsCacheSecs = atoi(strVal->str);
+
+    // * idle disconnect minutes * (out-of-range values are ignored)
+    if (strcmp(strProp->str, "appidleminutes") == 0)
+    {
+      const gint idleMinutes = atoi(strVal->str);
+
+      if (idleMinutes >= 0 && idleMinutes <= SV_IDLE_MAX_MINUTES)
+        app->idleMinutes = idleMinutes;
+    }
+
+    // * reconnect idle connections when selected *
+    if (strcmp(strProp->str, "idlereconnect") == 0)
+      app->idleReconnect = svStringToBool(strVal->str);
+
+    // * shared memory screen export *
+    if (strcmp(strProp->str, "shmexport") == 0)
+      app->shmExport = svStringToBool(strVal->str);
+
+    // * run connections in viewer processes *
+    if (strcmp(strProp->str, "helperviewers") == 0)
+      app->helperViewers = svStringToBool(strVal->str);
+
+    // * last-known screen previews *
+    if (strcmp(strProp->str, "savepreviews") == 0)
+      app->savePreviews = svStringToBool(strVal->str);
+
+    // * automation control socket *
+    if (strcmp(strProp->str, "controlsocket") == 0)
+      app->controlSocket = svStringToBool(strVal->str);
+
+    // ===== individual connection settings =====
+
+    // * connName *
+    if (strcmp(strProp->str, "host") == 0)
+    {
+      // if there was a previous con object, add it
+      // to the connections GList
+      if (con->name && con->name->len > 0)
+      {
+        // create box, image and label for listbox row
+        svInsertHostListRow(con->name->str, -1, con);
+
+        app->addNewConnection = false;
+      }
+
+      // create new con object
+      con = g_new0(Connection, 1);
+      svInitConnObject(con);
+
+      // connection name
+      g_string_assign(con->name, strVal->str);
+    }
+
+    // * connGroup *
+    if (strcmp(strProp->str, "group") == 0)
+    {
+      // add a separator if it's a new group
+      if (strcmp(strVal->str, strLastGroup->str) != 0)
+        svInsertHostListRow("", -1, NULL);
+
+      g_string_assign(con->group, strVal->str);
+      g_string_assign(strLastGroup, strVal->str);
+    }
+
+    // * address *
+    if (strcmp(strProp->str, "address") == 0 || strcmp(strProp->str, "hostaddress") == 0)
+      g_string_assign(con->address, strVal->str);
+
+    // * type *
+    if (strcmp(strProp->str, "type") == 0)
+    {
+      if (strcmp(strVal->str, "0") == 0 || strcmp(strVal->str, "v") == 0)
+        con->type = SV_TYPE_VNC;
+      else if (strcmp(strVal->str, "1") == 0 || strcmp(strVal->str, "s") == 0)
+        con->type = SV_TYPE_VNC_OVER_SSH;
+      else if (strcmp(strVal->str, "3") == 0 || strcmp(strVal->str, "r") == 0)
+        con->type = SV_TYPE_VNC_REPEATER;
+      else
+        con->type = SV_TYPE_VNC;
+    }
+
+    // * vncPort *
+    if (strcmp(strProp->str, "vncport") == 0)
+      g_string_assign(con->vncPort, strVal->str);
+
+    // * vncPass *
+    if (strcmp(strProp->str, "vncpass") == 0)
+      g_string_assign(con->vncPass, strVal->str);
+
+    // * vncLoginUser *
+    if (strcmp(strProp->str, "vncloginuser") == 0)
+      g_string_assign(con->vncLoginUser, strVal->str);
+
+    // * vncLoginPass *
+    if (strcmp(strProp->str, "vncloginpass") == 0)
+      g_string_assign(con->vncLoginPass, strVal->str);
+
+    // * scaling *
+    if (strcmp(strProp->str, "scale") == 0)
+      con->scale = svStringToBool(strVal->str);
+
+    // * resize remote desktop to fit *
+    if (strcmp(strProp->str, "remoteresize") == 0)
+      con->remoteResize = svStringToBool(strVal->str);
+
+    // * coalesce pointer motion *
+    if (strcmp(strProp->str, "coalescepointer") == 0)
+      con->coalescePointer = svStringToBool(strVal->str);
+
+    // * showRemoteCursor *
+    if (strcmp(strProp->str, "showremotecursor") == 0)
+      con->showRemoteCursor = svStringToBool(strVal->str);
+
+    // * imageQuality *
+    if (strcmp(strProp->str, "quality") == 0)
+    {
+      if (strcmp(strVal->str, "0") == 0)
+        con->quality = SV_QUAL_LOW;
+      else if (strcmp(strVal->str, "1") == 0 || strcmp(strVal->str, "5") == 0)
+        con->quality = SV_QUAL_MEDIUM;
+      else if (strcmp(strVal->str, "2") == 0 || strcmp(strVal->str, "9") == 0)
+        con->quality = SV_QUAL_FULL;
+      else
+        con->quality = SV_QUAL_DEFAULT;
+    }
+
+    // * lossy encoding *
+    if (strcmp(strProp->str, "lossyencoding") == 0)
+      con->lossyEncoding = svStringToBool(strVal->str);
+
+    // * clipboard sync *
+    if (strcmp(strProp->str, "clipboardsync") == 0)
+    {
+      con->clipboardSync = atoi(strVal->str);
+
+      if (con->clipboardSync > SV_CLIP_SYNC_BOTH)
+        con->clipboardSync = SV_CLIP_SYNC_MANUAL;
+    }
+
+    // * paste mode *
+    if (strcmp(strProp->str, "pastemode") == 0)
+    {
+      if (strcmp(strVal->str, "1") == 0)
+        con->pasteMode = SV_PASTE_CLIPBOARD;
+      else
+        con->pasteMode = SV_PASTE_KEYSTROKES;
+    }
+
+    // * paste keys *
+    if (strcmp(strProp->str, "pastekeys") == 0 && strVal->len > 0)
+      g_string_assign(con->pasteKeys, strVal->str);
+
+    // * auto-reconnect *
+    if (strcmp(strProp->str, "autoreconnect") == 0)
+      con->autoReconnect = svStringToBool(strVal->str);
+
+    // * auto-reconnect attempts *
+    if (strcmp(strProp->str, "reconnectmax") == 0)
+      con->reconnectMaxTries = atoi(strVal->str);
+
+    // * dead-peer timeout *
+    if (strcmp(strProp->str, "livetimeout") == 0)
+      con->liveTimeout = atoi(strVal->str);
+
+    // * idle disconnect minutes * (-1 is the app setting)
+    if (strcmp(strProp->str, "idleminutes") == 0)
+      con->idleMinutes = CLAMP(atoi(strVal->str), -1, SV_IDLE_MAX_MINUTES);
+
+    // * repeater id *
+    if (strcmp(strProp->str, "repeaterid") == 0)
+      g_string_assign(con->repeaterId, strVal->str);
+
+    // * sshPort *
+    if (strcmp(strProp->str, "sshport") == 0)
+      g_string_assign(con->sshPort, strVal->str);
+
+    // * sshPrivKeyfile *
+    if (strcmp(strProp->str, "sshkeyprivate") == 0)
+      g_string_assign(con->sshPrivKeyfile, strVal->str);
+
+    // * sshUser *
+    if (strcmp(strProp->str, "sshuser") == 0)
+      g_string_assign(con->sshUser, strVal->str);
+
+    // * f12Macro *
+    if (strcmp(strProp->str, "f12macro") == 0)
+      svSetF12Macro(con, strVal->str);
+
+    // * quicknote *
+    if (strcmp(strProp->str, "quicknote") == 0)
+      g_string_assign(con->quickNote, strVal->str);
+
+    // * custom command 1 enabled *
+    if (strcmp(strProp->str, "customcmd1enabled") == 0 || strcmp(strProp->str, "customcommand1enabled") == 0)
+      con->customCmd1Enabled = svStringToBool(strVal->str);
+
+    // * custom command 1 label *
+    if (strcmp(strProp->str, "customcmd1label") == 0 || strcmp(strProp->str, "customcommand1label") == 0)
+      g_string_assign(con->customCmd1Label, strVal->str);
+
+    // * custom command 1 *
+    if (strcmp(strProp->str, "customcmd1") == 0 || strcmp(strProp->str, "customcommand1") == 0)
+      g_string_assign(con->customCmd1, strVal->str);
+
+    // * custom command 2 enabled *
+    if (strcmp(strProp->str, "customcmd2enabled") == 0 || strcmp(strProp->str, "customcommand2enabled") == 0)
+      con->customCmd2Enabled = svStringToBool(strVal->str);
+
+    // * custom command 2 label *
+    if (strcmp(strProp->str, "customcmd2label") == 0 || strcmp(strProp->str, "customcommand2label") == 0)
+      g_string_assign(con->customCmd2Label, strVal->str);
+
+    // * custom command 2 *
+    if (strcmp(strProp->str, "customcmd2") == 0 || strcmp(strProp->str, "customcommand2") == 0)
+      g_string_assign(con->customCmd2, strVal->str);
+
+    // * custom command 3 enabled *
+    if (strcmp(strProp->str, "customcmd3enabled") == 0 || strcmp(strProp->str, "customcommand3enabled") == 0)
+      con->customCmd3Enabled = svStringToBool(strVal->str);
+
+    // * custom command 3 label *
+    if (strcmp(strProp->str, "customcmd3label") == 0 || strcmp(strProp->str, "customcommand3label") == 0)
+      g_string_assign(con->customCmd3Label, strVal->str);
+
+    // * custom command 3 *
+    if (strcmp(strProp->str, "customcmd3") == 0 || strcmp(strProp->str, "customcommand3") == 0)
+      g_string_assign(con->customCmd3, strVal->str);
+
+    // * last connect time *
+    if (strcmp(strProp->str, "lastconnecttime") == 0)
+      g_string_assign(con->lastConnectTime, strVal->str);
+
+    // view-only / read-only
+    if (strcmp(strProp->str, "viewonly") == 0)
+      con->viewOnly = svStringToBool(strVal->str);
+
+    // free up gstrings
+    g_string_free(strProp, true);
+    g_string_free(strVal, true);
+  }
+
+  // free up stuffz
+  g_string_free(strLastGroup, true);
+  g_strfreev(lines);
+
+  // add last con item, if not null
+  if (con && con->name->len > 0)
+  {
+    svInsertHostListRow(con->name->str, -1, con);
+
+    app->addNewConnection = false;
+  }
+  else
+    svFreeConnObject(con);
+
+  svInsertHostListRow("", -1, NULL);
+
+  // set or unset hostlist item tooltips
+  svSetHostlistItemsTooltips();
+}
+
+
+/* write the configuration file */
+void svConfigWrite ()
+{
+  // no re-entrance
+  static gboolean inConfigWrite = false;
+
+  if (inConfigWrite)
+    return;
+
+  // set non-re-entrance flag
+  inConfigWrite = true;
+
+  // if it's not possible to create a config directory, get out
+  if (!svConfigCreateNew(false))
+  {
+    svLog("svConfigWrite - Could not create new config dirs or file", false);
+    inConfigWrite = false;
+    return;
+  }
+
+  GString * outStr = g_string_new(NULL);
+
+  // header
+  g_string_append(outStr, "# SpiritVNC - GTK 3 version\n");
+  g_string_append(outStr, "# 2022-2026 Will Brokenbourgh - to God be the glory!\n");
+  g_string_append(outStr, "# Generated by app version "SV_APP_VERSION"\n#\n");
+
+  // config version
+  g_string_append(outStr, "configver=1.0\n");
+
+  // --- app options ---
+
+  // list width
+  g_string_append_printf(outStr, "hostlistwidth=%i\n", app->serverListWidth);
+
+  // show tooltips
+  g_string_append_printf(outStr, "showtooltips=%i\n", svIntFromBool(app->showTooltips));
+
+  // log to file
+  g_string_append_printf(outStr, "logtofile=%i\n", svIntFromBool(app->logToFile));
+
+  // debug mode
+  g_string_append_printf(outStr, "debugmode=%i\n", svIntFromBool(app->debugMode));
+
+  // window maximized
+  g_string_append_printf(outStr, "maximized=%i\n", svIntFromBool(app->maximized));
+
+  // scan wait time
+  g_string_append_printf(outStr, "scantimeout=%i\n", app->scanTimeout);
+
+  // vnc connect timeout
+  g_string_append_printf(outStr, "vnctimeout=%i\n", app->vncConnectWaitTime);
+
+  // ssh command
+  g_string_append_printf(outStr, "sshcommand=%s\n", app->sshCommand->str);
+
+  // ssh connect timeout
+  g_string_append_printf(outStr, "sshtimeout=%i\n", app->sshConnectWaitTime);
+
+  // clipboard history memory cap
+  g_string_append_printf(outStr, "cliphistorykb=%i\n", app->clipHistoryKB);
+
+  // reachability probes
+  g_string_append_printf(outStr, "probeinterval=%i\n", app->probeInterval);
+  g_string_append_printf(outStr, "probeconcurrency=%i\n", app->probeConcurrency);
+  g_string_append_printf(outStr, "probebanner=%i\n", svIntFromBool(app->probeReadBanner));
+
+  // framebuffer memory budget
+  g_string_append_printf(outStr, "fbbudgetmb=%u\n", app->fbBudgetMB);
+
+  // pre-connect on hover / select
+  g_string_append_printf(outStr, "preconnect=%i\n", svIntFromBool(app->preconnect));
+
+  // listening ports and backlog
+  g_string_append_printf(outStr, "listenports=%s\n", app->listenPorts->str);
+  g_string_append_printf(outStr, "listenbacklog=%u\n", app->listenBacklog);
+
+  // reverse connection admission
+  g_string_append_printf(outStr, "reversemax=%u\n", app->reverseMax);
+  g_string_append_printf(outStr, "reverserate=%u\n", app->reverseRatePerMin);
+  g_string_append_printf(outStr, "reverseallow=%s\n", app->reverseAllowText->str);
+
+  // dns cache time
+  g_string_append_printf(outStr, "dnscachesecs=%u\n", app->dnsCacheSecs);
+
+  // idle disconnect
+  g_string_append_printf(outStr, "appidleminutes=%u\n", app->idleMinutes);
+  g_string_append_printf(outStr, "idlereconnect=%i\n", svIntFromBool(app->idleReconnect));
+  g_string_append_printf(outStr, "shmexport=%i\n", svIntFromBool(app->shmExport));
+  g_string_append_printf(outStr, "helperviewers=%i\n", svIntFromBool(app->helperViewers));
+  g_string_append_printf(outStr, "savepreviews=%i\n", svIntFromBool(app->savePreviews));
+  g_string_append_printf(outStr, "controlsocket=%i\n", svIntFromBool(app->controlSocket));
+
+  // space
+  g_string_append(outStr, "\n");
+
+  // --- per-connection settings ---
+  // go through connection list and add each connection's settings
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkListBoxRow * row = l->data;
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+
+    const Connection * con = g_object_get_data(G_OBJECT(box), "con");
+
+    if (!con || con->name->len == 0 || con->type == SV_TYPE_VNC_REVERSE)
+      continue;
+
+    g_string_append_printf(outStr, "host=%s\n", con->name->str);
+    g_string_append_printf(outStr, "group=%s\n", con->group->str);
+    g_string_append_printf(outStr, "address=%s\n", con->address->str);
+    g_string_append_printf(outStr, "type=%i\n", con->type);
+    g_string_append_printf(outStr, "vncport=%s\n", con->vncPort->str);
+    g_string_append_printf(outStr, "vncpass=%s\n", con->vncPass->str);
+    g_string_append_printf(outStr, "vncloginuser=%s\n", con->vncLoginUser->str);
+    g_string_append_printf(outStr, "vncloginpass=%s\n", con->vncLoginPass->str);
+    g_string_append_printf(outStr, "scale=%i\n", svIntFromBool(con->scale));
+    g_string_append_printf(outStr, "remoteresize=%i\n", svIntFromBool(con->remoteResize));
+    g_string_append_printf(outStr, "coalescepointer=%i\n", svIntFromBool(con->coalescePointer));
+    g_string_append_printf(outStr, "lossyencoding=%i\n", svIntFromBool(con->lossyEncoding));
+    g_string_append_printf(outStr, "quality=%i\n", con->quality);
+    g_string_append_printf(outStr, "clipboardsync=%i\n", con->clipboardSync);
+    g_string_append_printf(outStr, "pastemode=%i\n", con->pasteMode);
+    g_string_append_printf(outStr, "pastekeys=%s\n", con->pasteKeys->str);
+    g_string_append_printf(outStr, "autoreconnect=%i\n", svIntFromBool(con->autoReconnect));
+    g_string_append_printf(outStr, "reconnectmax=%i\n", con->reconnectMaxTries);
+    g_string_append_printf(outStr, "livetimeout=%u\n", con->liveTimeout);
+    g_string_append_printf(outStr, "idleminutes=%i\n", con->idleMinutes);
+    g_string_append_printf(outStr, "repeaterid=%s\n", con->repeaterId->str);
+    g_string_append_printf(outStr, "sshuser=%s\n", con->sshUser->str);
+    g_string_append_printf(outStr, "sshpass=%s\n", con->sshPass->str);
+    g_string_append_printf(outStr, "sshport=%s\n", con->sshPort->str);
+    g_string_append_printf(outStr, "sshkeyprivate=%s\n", con->sshPrivKeyfile->str);
+    g_string_append_printf(outStr, "f12macro=%s\n", con->f12Macro->str);
+    g_string_append_printf(outStr, "quicknote=%s\n", con->quickNote->str);
+    g_string_append_printf(outStr, "lastconnecttime=%s\n", con->lastConnectTime->str);
+    g_string_append_printf(outStr, "customcmd1enabled=%i\n", svIntFromBool(con->customCmd1Enabled));
+    g_string_append_printf(outStr, "customcmd1label=%s\n", con->customCmd1Label->str);
+    g_string_append_printf(outStr, "customcmd1=%s\n", con->customCmd1->str);
+    g_string_append_printf(outStr, "customcmd2enabled=%i\n", svIntFromBool(con->customCmd2Enabled));
+    g_string_append_printf(outStr, "customcmd2label=%s\n", con->customCmd2Label->str);
+    g_string_append_printf(outStr, "customcmd2=%s\n", con->customCmd2->str);
+    g_string_append_printf(outStr, "customcmd3enabled=%i\n", svIntFromBool(con->customCmd3Enabled));
+    g_string_append_printf(outStr, "customcmd3label=%s\n", con->customCmd3Label->str);
+    g_string_append_printf(outStr, "customcmd3=%s\n", con->customCmd3->str);
+    g_string_append_printf(outStr, "viewonly=%i\n", svIntFromBool(con->viewOnly));
+
+    // empty line after this connection
+    g_string_append(outStr, "\n");
+  }
+
+  // empty line at end of file
+  g_string_append(outStr, "\n");
+
+  // --- attempt to write config file out ---
+  if (!g_file_set_contents(app->appConfigFile->str, outStr->str, -1, NULL))
+    svLog("svConfigWrite - Error: SpiritVNC could not write config file", false);
+
+  g_list_free(rows);
+  g_string_free(outStr, true);
+
+  // set no-re-entrance flag
+  inConfigWrite = false;
+}
+
+
+/* add a small reachability badge to a connection list icon */
+/* (takes ownership of pb and returns the icon to use) */
+GdkPixbuf * svProbeBadge (GdkPixbuf * pb, const Connection * con)
+{
+  if (!pb || !con || con->probeState == SV_PROBE_UNKNOWN)
+    return pb;
+
+  // a live session says more than the prober can
+  if (con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING)
+    return pb;
+
+  const gint w = gdk_pixbuf_get_width(pb);
+  const gint h = gdk_pixbuf_get_height(pb);
+
+  cairo_surface_t * surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+  cairo_t * cr = cairo_create(surface);
+
+  gdk_cairo_set_source_pixbuf(cr, pb, 0, 0);
+  cairo_paint(cr);
+
+  // dot in the lower-right corner - green for reachable, red for not
+  const double r = MAX(w, h) / 6.0;
+
+  cairo_arc(cr, w - r - 1, h - r - 1, r, 0, 2 * G_PI);
+
+  if (con->probeState == SV_PROBE_REACHABLE)
+    cairo_set_source_rgb(cr, 0.2, 0.75, 0.2);
+  else
+    cairo_set_source_rgb(cr, 0.85, 0.2, 0.2);
+
+  cairo_fill_preserve(cr);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_set_line_width(cr, 1);
+  cairo_stroke(cr);
+
+  cairo_destroy(cr);
+
+  GdkPixbuf * badged = gdk_pixbuf_get_from_surface(surface, 0, 0, w, h);
+
+  cairo_surface_destroy(surface);
+
+  if (!badged)
+    return pb;
+
+  g_object_unref(pb);
+
+  return badged;
+}
+
+
+/* finish a reachability probe and start the next queued one */
+void svProbeFinish (ProbeJob * job, guint probeState, const char * version)
+{
+  Connection * con = job->con;
+
+  // (con is NULL if the connection was deleted while this probe ran)
+  if (con)
+  {
+    con->probeJob = NULL;
+    con->probeState = probeState;
+    con->probeRtt = (probeState == SV_PROBE_REACHABLE) ? job->rtt : 0;
+    g_string_assign(con->probeVersion, version ? version : "");
+
+    GDateTime * now = g_date_time_new_now_local();
+    char * nowStr = g_date_time_format(now, "%H:%M:%S");  //  <<<--- do NOT make const char *
+    g_string_assign(con->probeTime, nowStr);
+    g_free(nowStr);
+    g_date_time_unref(now);
+
+    svSetIconFromConnectionName(con->name->str, con->state);
+  }
+
+  if (job->sockCon)
+  {
+    g_io_stream_close(G_IO_STREAM(job->sockCon), NULL, NULL);
+    g_object_unref(job->sockCon);
+  }
+
+  g_object_unref(job->client);
+  g_object_unref(job->cancel);
+  g_free(job);
+
+  app->probeActive--;
+
+  svProbeStartNext();
+}
+
+
+/* handle a probe's rfb version banner being read */
+void svProbeBannerRead (GObject * source, GAsyncResult * res, gpointer data)
+{
+  ProbeJob * job = (ProbeJob *)data;
+
+  gsize bytesRead = 0;
+  guint major = 0;
+  guint minor = 0;
+
+  // something answered either way, but only record a version for a real rfb banner
+  if (g_input_stream_read_all_finish(G_INPUT_STREAM(source), res, &bytesRead, NULL) &&
+    bytesRead == SV_PROBE_BANNER_LEN && strncmp(job->banner, "RFB ", 4) == 0 &&
+    sscanf(job->banner + 4, "%3u.%3u", &major, &minor) == 2)
+  {
+    char version[16];
+    g_snprintf(version, sizeof(version), "%u.%u", major, minor);
+
+    svProbeFinish(job, SV_PROBE_REACHABLE, version);
+  }
+  else
+    svProbeFinish(job, SV_PROBE_REACHABLE, NULL);
+}
+
+
+/* handle a host name lookup finishing, and answer everyone waiting on it */
+void svDnsResolved (GObject * source, GAsyncResult * res, gpointer data)
+{
+  DnsEntry * entry = (DnsEntry *)data;
+
+  GError * error = NULL;
+  GList * addrs = g_resolver_lookup_by_name_finish(G_RESOLVER(source), res, &error);
+
+  const gint64 now = g_get_monotonic_time();
+
+  g_resolver_free_addresses(entry->addrs);
+  entry->addrs = addrs;
+  entry->pending = false;
+
+  // failures aren't cached, so the next connect asks again
+  entry->expires = addrs ? now + (gint64)app->dnsCacheSecs * G_USEC_PER_SEC : 0;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+
+  if (addrs)
+    g_string_printf(logStr, "Resolved '%s' in %li ms (%u addresses)", entry->host->str,
+      (long)((now - entry->startTime) / 1000), g_list_length(addrs));
+  else
+    g_string_printf(logStr, "Unable to resolve '%s': %s", entry->host->str, error ? error->message : "unknown error");
+
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // (detach the waiters first, so a callback can start a new lookup for this host)
+  GList * waiters = entry->waiters;
+  entry->waiters = NULL;
+
+  for (GList * l = waiters; l; l = l->next)
+  {
+    DnsWaiter * waiter = (DnsWaiter *)l->data;
+
+    waiter->callback(entry->addrs, addrs ? NULL : (error ? error->message : "Unable to resolve host"),
+      now - waiter->startTime, waiter->data);
+
+    g_free(waiter);
+  }
+
+  g_list_free(waiters);
+
+  if (error)
+    g_error_free(error);
+}
+
+
+/* look up a host name through the shared cache, calling back with its addresses */
+/* (a cached answer calls back before this returns - lookups already running are shared) */
+void svDnsResolve (const char * host, DnsCallback callback, gpointer data)
+{
+  if (!host || !callback)
+    return;
+
+  DnsEntry * entry = g_hash_table_lookup(app->dnsCache, host);
+
+  if (!entry)
+  {
+    entry = g_new0(DnsEntry, 1);
+    entry->host = g_string_new(host);
+    g_hash_table_insert(app->dnsCache, entry->host->str, entry);
+  }
+
+  const gint64 now = g_get_monotonic_time();
+
+  // still fresh
+  if (!entry->pending && entry->addrs && now < entry->expires)
+  {
+    callback(entry->addrs, NULL, 0, data);
+    return;
+  }
+
+  DnsWaiter * waiter = g_new0(DnsWaiter, 1);
+  waiter->callback = callback;
+  waiter->data = data;
+  waiter->startTime = now;
+
+  entry->waiters = g_list_append(entry->waiters, waiter);
+
+  // someone already asked, so wait along with them
+  if (entry->pending)
+    return;
+
+  entry->pending = true;
+  entry->startTime = now;
+
+  GResolver * resolver = g_resolver_get_default();
+  g_resolver_lookup_by_name_async(resolver, host, NULL, svDnsResolved, entry);
+  g_object_unref(resolver);
+}
+
+
+/* handle a probe's tcp connect completing */
+void svProbeConnected (GObject * source, GAsyncResult * res, gpointer data)
+{
+  ProbeJob * job = (ProbeJob *)data;
+
+  job->sockCon = g_socket_client_connect_finish(G_SOCKET_CLIENT(source), res, NULL);
+
+  if (!job->sockCon)
+  {
+    svProbeFinish(job, SV_PROBE_UNREACHABLE, NULL);
+    return;
+  }
+
+  job->rtt = g_get_monotonic_time() - job->startTime;
+
+  // ssh banners aren't fixed-length, so only vnc ports get their banner read
+  if (!app->probeReadBanner || !job->con || job->con->type != SV_TYPE_VNC)
+  {
+    svProbeFinish(job, SV_PROBE_REACHABLE, NULL);
+    return;
+  }
+
+  GInputStream * in = g_io_stream_get_input_stream(G_IO_STREAM(job->sockCon));
+
+  g_input_stream_read_all_async(in, job->banner, SV_PROBE_BANNER_LEN, G_PRIORITY_LOW,
+    job->cancel, svProbeBannerRead, job);
+}
+
+
+/* handle a probe's host name being resolved */
+void svProbeResolved (GList * addrs, const char * error, gint64 usecs, gpointer data)
+{
+  ProbeJob * job = (ProbeJob *)data;
+
+  if (!addrs || g_cancellable_is_cancelled(job->cancel))
+  {
+    svProbeFinish(job, SV_PROBE_UNREACHABLE, NULL);
+    return;
+  }
+
+  if (job->con)
+    job->con->resolveTime = usecs;
+
+  // (round-trip time is just the tcp connect, name lookup is timed separately)
+  job->startTime = g_get_monotonic_time();
+
+  GSocketAddress * sockAddr = g_inet_socket_address_new((GInetAddress *)addrs->data, job->port);
+
+  g_socket_client_connect_async(job->client, G_SOCKET_CONNECTABLE(sockAddr), job->cancel,
+    svProbeConnected, job);
+
+  g_object_unref(sockAddr);
+}
+
+
+/* start a reachability probe for one connection */
+void svProbeStart (Connection * con)
+{
+  // vnc-over-ssh hosts are checked at their ssh port
+  guint16 port = 0;
+
+  if (con->type == SV_TYPE_VNC_OVER_SSH)
+    port = (con->sshPort->len > 0) ? atoi(con->sshPort->str) : 22;
+  else
+    port = (con->vncPort->len > 0) ? atoi(con->vncPort->str) : 5900;
+
+  ProbeJob * job = g_new0(ProbeJob, 1);
+  job->con = con;
+  job->cancel = g_cancellable_new();
+  job->client = g_socket_client_new();
+  job->port = port;
+
+  // don't wait on a dead host any longer than a real connection would
+  g_socket_client_set_timeout(job->client, MAX(app->vncConnectWaitTime, 1));
+
+  con->probeJob = job;
+  app->probeActive++;
+
+  svDnsResolve(con->address->str, svProbeResolved, job);
+}
+
+
+/* start queued probes, up to the concurrency limit */
+void svProbeStartNext ()
+{
+  while (app->probeActive < MAX(app->probeConcurrency, 1) && !g_queue_is_empty(app->probeQueue))
+  {
+    Connection * con = (Connection *)g_queue_pop_head(app->probeQueue);
+    con->probeQueued = false;
+
+    if (con->address->len > 0 && !con->probeJob)
+      svProbeStart(con);
+  }
+
+  // refresh tooltips once a full pass is done
+  if (app->probeActive == 0)
+    svSetHostlistItemsTooltips();
+}
+
+
+/* queue a reachability probe for every connection in the list */
+void svProbeAll ()
+{
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(l->data));
+    if (!rowBox)
+      continue;
+
+    Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+
+    if (!con || con->type == SV_TYPE_VNC_REVERSE || con->address->len == 0 ||
+      con->probeQueued || con->probeJob)
+      continue;
+
+    con->probeQueued = true;
+    g_queue_push_tail(app->probeQueue, con);
+  }
+
+  g_list_free(rows);
+
+  svProbeStartNext();
+}
+
+
+/* stop a connection's queued or running probe */
+void svProbeCancel (Connection * con)
+{
+  if (!con)
+    return;
+
+  if (con->probeQueued)
+  {
+    g_queue_remove(app->probeQueue, con);
+    con->probeQueued = false;
+  }
+
+  // the job finishes on its own once cancelled, but must not touch con again
+  if (con->probeJob)
+  {
+    con->probeJob->con = NULL;
+    g_cancellable_cancel(con->probeJob->cancel);
+    con->probeJob = NULL;
+  }
+}
+
+
+/* periodic reachability probe timer */
+gboolean svProbeTimer (gpointer unused)
+{
+  svProbeAll();
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+/* (re)start the periodic reachability probes from the app options */
+void svProbeSchedule ()
+{
+  if (app->probeTimerSource > 0)
+  {
+    g_source_remove(app->probeTimerSource);
+    app->probeTimerSource = 0;
+  }
+
+  if (app->probeInterval == 0)
+    return;
+
+  app->probeTimerSource = g_timeout_add_seconds(app->probeInterval, svProbeTimer, NULL);
+
+  // don't make the user wait a whole interval for the first results
+  svProbeAll();
+}
+
+
+/* menu item handler - check all hosts now */
+void svHandleProbeHostsMenuItem (GtkMenuItem * unused1, gpointer unused2)
+{
+  svLog("Checking all hosts for reachability", true);
+
+  svProbeAll();
+}
+
+
+/* sets a connection's icon in the connection list */
+void svSetIconFromConnectionName (const char * text, guint state)
+{
+  // (every state change comes through here, so control clients hear about it here)
+  svControlNotifyState(svConnectionFromName(text), state);
+
+  // (and the tiles may need to change)
+  svTileLayoutSoon();
+
+  // (a connecting connection shows its last-known screen)
+  Connection * stateCon = svConnectionFromName(text);
+
+  if (state == SV_STATE_WAITING)
+    svPreviewShow(stateCon);
+  else
+    svPreviewHide(stateCon);
+
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  // loop through each row
+  for (GList * l = rows; l != NULL; l = l->next)
+  {
+    GtkWidget * row = GTK_WIDGET(l->data);
+
+    // get box that holds status image and label
+    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+    if (!rowBox)
+      continue;
+
+    // get box's children
+    GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+
+    GtkWidget * img = (GtkWidget *)g_list_nth_data(boxChildren, 0);
+    GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+
+    g_list_free(boxChildren);
+
+    // get label's text, if any
+    const char * lText = gtk_label_get_text(GTK_LABEL(label));
+
+    if (!lText)
+      continue;
+
+    // if the label text matches, modify the icon
+    if (strcmp(lText, text) == 0)
+    {
+      if (img)
+      {
+        gtk_image_clear(GTK_IMAGE(img));
+
+        // image
+        GdkPixbuf * pb;
+
+        switch (state)
+        {
+          case SV_STATE_DISCONNECTED:
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected.png", NULL);
+            break;
+
+          case SV_STATE_CONNECTED:
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/connected.png", NULL);
+            break;
+
+          case SV_STATE_WAITING:
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/connecting.png", NULL);
+            break;
+
+          case SV_STATE_TIMEOUT:
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/noconnect.png", NULL);
+            break;
+
+          case SV_STATE_ERROR:
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected_error.png", NULL);
+            break;
+
+          case SV_STATE_EVICTED:
+          case SV_STATE_IDLE:
+            // faded 'disconnected' so it doesn't read as an error
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected.png", NULL);
+            if (pb)
+              gdk_pixbuf_saturate_and_pixelate(pb, pb, 0.0, true);
+            break;
+
+          default:
+            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/blank.png", NULL);
+        }
+
+        // add the reachability badge, if any
+        pb = svProbeBadge(pb, g_object_get_data(G_OBJECT(rowBox), "con"));
+
+        // set the icon
+        gtk_image_set_from_pixbuf(GTK_IMAGE(img), pb);
+
+      }
+
+      return;
+    }
+  }
+
+  g_list_free(rows);
+}
+
+
+/* sets a connection's text in the connection list */
+void svSetTextFromConnectionName (const char * currentText, const char * newText)
+{
+  if (!currentText || !newText)
+    return;
+
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  // loop through each row
+  for (GList * l = rows; l != NULL; l = l->next)
+  {
+    GtkWidget * row = GTK_WIDGET(l->data);
+
+    // get box that holds status image and label
+    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+
+    if (!rowBox)
+      continue;
+
+    // get box's children
+    GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+
+    GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+
+    g_list_free(boxChildren);
+
+    // get label's text, if any
+    const char * lText = gtk_label_get_text(GTK_LABEL(label));
+
+    if (!lText)
+      continue;
+
+    // if the label text matches, change to new text
+    if (strcmp(lText, currentText) == 0)
+    {
+      if (label)
+        gtk_label_set_label(GTK_LABEL(label), newText);
+
+      return;
+    }
+  }
+
+  g_list_free(rows);
+}
+
+
+/* closes all connections (typically when exiting program) */
+void svEndAllConnections ()
+{
+  // end all viewers
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkListBoxRow * row = l->data;
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+
+    Connection * con = g_object_get_data(G_OBJECT(box), "con");
+
+    if (!con)
+      continue;
+
+    // nothing should come back to life while we're quitting
+    svReconnectCancel(con, true);
+
+    // keep its last screen for next time
+    svPreviewSave(con);
+
+    if (con->state == SV_STATE_CONNECTED && con->vncObj)
+    {
+      con->disconnectType = SV_DISC_MANUAL;
+      vnc_display_close(VNC_DISPLAY(con->vncObj));
+    }
+  }
+
+  g_list_free(rows);
+}
+
+
+/* shut everything down and quit the app */
+void svDoQuit ()
+{
+  svControlStop();
+
+  svEndAllConnections();
+
+  svConfigWrite();
+
+  svLog("--- App ending ---", false);
+
+  g_application_quit(G_APPLICATION(app->gApp));
+}
+
+
+/*  find unused TCP port in 'ephemeral / temporary' range  */
+gint svFindFreeTcpPort ()
+{
+  gint nSock = 0;
+  struct sockaddr_in structSockAddress;
+
+  structSockAddress.sin_family = AF_INET;
+  structSockAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  nSock = socket(AF_INET, SOCK_STREAM, 0);
+
+  if (nSock < 0)
+  {
+    svLog("svFindFreeTcpPort - ERROR - Cannot create socket for svFindFreeTCPPort", false);
+    return 0;
+  }
+
+  // go through a range of startingLocalPort to + 99 to see if we can use for ssh forwarding
+  for (uint16_t nPort = 49152; nPort < 65534; nPort ++)
+  {
+    structSockAddress.sin_port = htons((unsigned short)nPort);
+
+    // don't clobber the listening ports
+    if (svListenIsPort(nPort))
+      continue;
+
+    // if nothing is on this port and it's not the reverse vnc port, return the port number
+    if (bind(nSock, (const struct sockaddr *)&structSockAddress, sizeof(structSockAddress)) == 0)
+    {
+      close(nSock);
+      return nPort;
+    }
+  }
+
+  close(nSock);
+
+  return 0;
+}
+
+
+/* deal with server list clicks */
+gboolean svHandleConnectionListClicks (GtkWidget * widget, GdkEvent * event, void * data)
+{
+  GdkEventType type = gdk_event_get_event_type(event);
+
+  // if not a left or right button press, get out
+  if (type != GDK_BUTTON_PRESS && type != GDK_2BUTTON_PRESS)
+    return false;
+
+  guint clickCount = 0;
+  guint button = 0;
+
+  // set last button number
+  if (!gdk_event_get_button(event, &button))
+    return false;
+
+  // set last click count
+  if (!gdk_event_get_click_count(event, &clickCount))
+    return false;
+
+  double x = 0;
+  double y = 0;
+
+  // get the row's internal name from the mouse's y position
+  if (!gdk_event_get_coords(event, &x, &y))
+    return false;
+
+  // hide any active display if list is single-clicked
+  if (button != GDK_BUTTON_SECONDARY && clickCount == 1)
+  {
+    GtkWidget * currentDisplay = gtk_stack_get_visible_child(GTK_STACK(app->displayStack));
+
+    if (currentDisplay)
+      gtk_widget_hide(currentDisplay);
+  }
+
+  // get the clicked row
+  GtkListBoxRow * row = gtk_list_box_get_row_at_y(GTK_LIST_BOX(widget), y);
+  if (!row)
+  {
+    //printf("DEBUG: row is null in svHandleConnectionListClicks\n");
+    return false;
+  }
+
+  // get box that holds status image and label
+  GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+  if (!rowBox)
+    return false;
+
+  // get connection from attached rowBox data
+  Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+
+  // **### DON'T check con for null here!! ###**
+
+  // do stuffs based on mouse button and number of clicks
+  if (button > 0 && clickCount > 0)
+  {
+    // single left-click
+    if (button == GDK_BUTTON_PRIMARY && clickCount == 1)
+      svConnectionSwitch(con);
+
+    // double left-click
+    if (button == GDK_BUTTON_PRIMARY && clickCount == 2)
+      svConnectionCreate(con);
+
+    // single right-click
+    if (button == GDK_BUTTON_SECONDARY && clickCount == 1)
+      svConnectionRightClick(con);
+  }
+
+  return false;
+}
+
+
+/* return the Connection * of the currently-selected connection listbox item */
+Connection * svGetSelectedConnectionListConnection ()
+{
+  // figure out which connection is selected
+  GtkListBoxRow * selectedRow = gtk_list_box_get_selected_row(GTK_LIST_BOX(app->serverList));
+  if (!selectedRow)
+    return NULL;
+
+  GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(selectedRow));
+  if (!rowBox)
+    return NULL;
+
+  return (Connection *)g_object_get_data(G_OBJECT(rowBox), "con");
+}
+
+
+/* menu item handler - send update request to currently-selected server */
+void svHandleRequestUpdateMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  // the connection asked about, or (from the tools menu) the selected one
+  Connection * con = userData ? (Connection *)userData : svGetSelectedConnectionListConnection();
+
+  if (!con || con->name->len == 0)
+    return;
+
+  svConnectionRequestUpdate(con);
+}
+
+
+/* menu item handler - send Ctrl+Alt+Del to currently-selected server */
+void svHandleSendCADMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  // the connection asked about, or (from the tools menu) the selected one
+  Connection * con = userData ? (Connection *)userData : svGetSelectedConnectionListConnection();
+  if (!con || con->name->len == 0)
+    return;
+
+  guint keys[] = {
+    GDK_KEY_Control_L,
+    GDK_KEY_Alt_L,
+    GDK_KEY_Delete
+  };
+
+  svConnectionSendKeys(con, keys, sizeof(keys) / sizeof(keys[0]));
+}
+
+
+/* menu item handler - send Ctrl+Shift+Esc to currently-selected server */
+void svHandleSendCSEMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  // the connection asked about, or (from the tools menu) the selected one
+  Connection * con = userData ? (Connection *)userData : svGetSelectedConnectionListConnection();
+
+  if (!con || con->name->len == 0)
+    return;
+
+  guint keys[] = {
+    GDK_KEY_Control_L,
+    GDK_KEY_Shift_L,
+    GDK_KEY_Escape
+  };
+
+  svConnectionSendKeys(con, keys, sizeof(keys) / sizeof(keys[0]));
+}
+
+
+/* menu item handler - shows 'send keys' window */
+void svHandleSendEnteredKeystrokesMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  // the connection asked about, or (from the tools menu) the selected one
+  Connection * con = userData ? (Connection *)userData : svGetSelectedConnectionListConnection();
+  if (!con || con->name->len == 0)
+    return;
+
+  // create output window
+  GtkWidget * sendKeysWin = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_modal(GTK_WINDOW(sendKeysWin), true);
+  gtk_window_set_transient_for(GTK_WINDOW(sendKeysWin), GTK_WINDOW(app->mainWin));
+  gtk_window_set_position(GTK_WINDOW(sendKeysWin), GTK_WIN_POS_CENTER_ON_PARENT);
+  gtk_window_set_modal(GTK_WINDOW(sendKeysWin), true);
+  gtk_window_set_resizable(GTK_WINDOW(sendKeysWin), false);
+
+  // set window title
+  GString * titleStr = g_string_new(NULL);
+  g_string_printf(titleStr, "Send keys to '%s' - SpiritVNC", con->name->str);
+  gtk_window_set_title(GTK_WINDOW(sendKeysWin), titleStr->str);
+  g_string_free(titleStr, true);
+
+  // parent box
+  GtkWidget * boxParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
+  gtk_container_set_border_width(GTK_CONTAINER(boxParent), 5);
+  gtk_container_add(GTK_CONTAINER(sendKeysWin), boxParent);
+
+  // container grid
+  GtkWidget * grid = gtk_grid_new();
+  gtk_grid_set_column_homogeneous(GTK_GRID(grid), false);
+  gtk_container_set_border_width(GTK_CONTAINER(grid), 7);
+  gtk_grid_set_column_spacing(GTK_GRID(grid), 7);
+  gtk_grid_set_row_spacing(GTK_GRID(grid), 5);
+
+  // add grid to parent box
+  gtk_box_pack_start(GTK_BOX(boxParent), grid, false, false, 0);
+
+  // out label
+  GtkWidget * lblIn = gtk_label_new("Enter or paste keys / text to send below");
+  gtk_widget_set_halign(lblIn, GTK_ALIGN_START);
+  gtk_grid_attach(GTK_GRID(grid), lblIn, 1, 1, 1, 1);
+
+  // scroller for textview
+  GtkWidget * scroll = gtk_scrolled_window_new(NULL, NULL);
+  gtk_widget_set_size_request(scroll, 500, 400);
+
+  gtk_grid_attach(GTK_GRID(grid), scroll, 1, 3, 1, 1);
+
+  // output textview
+  GtkWidget * textIn = gtk_text_view_new();
+  //gtk_text_view_set_editable(GTK_TEXT_VIEW(textOut), false);
+  gtk_text_view_set_monospace(GTK_TEXT_VIEW(textIn), true);
+
+  // add textview to scroller
+  gtk_container_add(GTK_CONTAINER(scroll), textIn);
+
+  // ------------------- set sendkeys data --------------
+  GHashTable * ht = g_hash_table_new(NULL, NULL);
+  if (ht)
+  {
+    g_hash_table_insert(ht, "type", SV_SENDKEYS_TYPE_ENTRY);
+    g_hash_table_insert(ht, "win", sendKeysWin);
+    g_hash_table_insert(ht, "textView", textIn);
+    g_hash_table_insert(ht, "con", con);
+  }
+
+  // ------------------- send / cancel buttons -------------------
+  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+
+  // send
+  GtkWidget * btnSend = gtk_button_new_with_label("Send");
+  gtk_widget_set_size_request(btnSend, 110, -1);
+  svSetTooltip(btnSend, "Click to send this text");
+  g_signal_connect(btnSend, "clicked", G_CALLBACK(svHandleSendEnteredKeystrokesButtons), ht);
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnSend, false, false, 3);
+
+  // cancel
+  GtkWidget * btnCancel = gtk_button_new_with_label("Cancel");
+  g_hash_table_insert(ht, "btnCancel", btnCancel);
+  gtk_widget_set_size_request(btnCancel, 110, -1);
+  svSetTooltip(btnCancel, "Click to close this window without sending");
+  g_signal_connect(btnCancel, "clicked", G_CALLBACK(svHandleSendEnteredKeystrokesButtons), ht);
+  gtk_box_pack_end(GTK_BOX(boxButtons), btnCancel, false, false, 3);
+  //
+  gtk_container_add(GTK_CONTAINER(boxParent), boxButtons);
+
+  // show everything
+  gtk_widget_show_all(sendKeysWin);
+
+  gtk_window_present(GTK_WINDOW(sendKeysWin));
+}
+
+
+/* menu item handler - run custom command */
+void svHandleCustomCommandMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  const char * cmd = (const char *)userData;
+  if (!cmd)
+    return;
+
+  GError * gError = NULL;
+  char * stdOut = NULL;
+
+  // run the command synchronous, will block
+  if (!g_spawn_command_line_sync(cmd, &stdOut, NULL, NULL, &gError))
+  {
+    GtkWidget * dialog = gtk_message_dialog_new_with_markup(GTK_WINDOW(app->mainWin),
+                                      GTK_DIALOG_DESTROY_WITH_PARENT,
+                                      GTK_MESSAGE_ERROR,
+                                      GTK_BUTTONS_CLOSE,
+                                      "<b>Error running custom command</b>\n\n%s",
+                                      gError->message);
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+
+    if (gError)
+      g_error_free(gError);
+
+     return;
+  }
+  else
+  {
+    // show command output if not null or empty
+    if (stdOut && stdOut[0] != '\0')
+    {
+      // create output window
+      GtkWidget * outWin = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+      gtk_window_set_modal(GTK_WINDOW(outWin), true);
+
+      // set window title
+      gtk_window_set_title(GTK_WINDOW(outWin), "Custom command output - SpiritVNC");
+      gtk_window_set_modal(GTK_WINDOW(outWin), true);
+      gtk_window_set_resizable(GTK_WINDOW(outWin), false);
+      gtk_window_set_transient_for(GTK_WINDOW(outWin), GTK_WINDOW(app->mainWin));
+      gtk_window_set_position(GTK_WINDOW(outWin), GTK_WIN_POS_CENTER_ON_PARENT);
+
+      // parent box
+      GtkWidget * boxParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
+      gtk_container_set_border_width(GTK_CONTAINER(boxParent), 5);
+      gtk_container_add(GTK_CONTAINER(outWin), boxParent);
+
+      // container grid
+      GtkWidget * grid = gtk_grid_new();
+      gtk_grid_set_column_homogeneous(GTK_GRID(grid), false);
+      gtk_container_set_border_width(GTK_CONTAINER(grid), 7);
+      gtk_grid_set_column_spacing(GTK_GRID(grid), 7);
+      gtk_grid_set_row_spacing(GTK_GRID(grid), 5);
+
+      // add grid to parent box
+      gtk_box_pack_start(GTK_BOX(boxParent), grid, false, false, 0);
+
+      // command label (to show command that was executed)
+      GtkWidget * lblCmd = gtk_label_new("");
+      gtk_widget_set_halign(lblCmd, GTK_ALIGN_START);
+      GString * cmdString = g_string_new(NULL);
+      g_string_printf(cmdString, "Command: '%s'", cmd);
+      gtk_label_set_text(GTK_LABEL(lblCmd), cmdString->str);
+      g_string_free(cmdString, true);
+      gtk_grid_attach(GTK_GRID(grid), lblCmd, 1, 2, 1, 1);
+
+      // scroller for textview
+      GtkWidget * scroll = gtk_scrolled_window_new(NULL, NULL);
+      gtk_widget_set_size_request(scroll, 500, 400);
+
+      gtk_grid_attach(GTK_GRID(grid), scroll, 1, 3, 1, 1);
+
+      // output textview
+      GtkWidget * textOut = gtk_text_view_new();
+      gtk_text_view_set_editable(GTK_TEXT_VIEW(textOut), false);
+      gtk_text_view_set_monospace(GTK_TEXT_VIEW(textOut), true);
+
+      // set textview text
+      GtkTextBuffer * tb = gtk_text_view_get_buffer(GTK_TEXT_VIEW(textOut));
+      gtk_text_buffer_set_text(tb, stdOut, -1);
+
+      // add textview to scroller
+      gtk_container_add(GTK_CONTAINER(scroll), textOut);
+
+      // ------------------- ok button -------------------
+      GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+
+      // okay
+      GtkWidget * btnOk = gtk_button_new_with_label("OK");
+      gtk_widget_set_size_request(btnOk, 110, -1);
+      g_signal_connect(btnOk, "clicked", G_CALLBACK(svHandleCommandOutputOk), outWin);
+
+      gtk_box_pack_end(GTK_BOX(boxButtons), btnOk, false, false, 3);
+      //
+      gtk_container_add(GTK_CONTAINER(boxParent), boxButtons);
+
+      // show everything
+      gtk_widget_show_all(outWin);
+
+      gtk_window_present(GTK_WINDOW(outWin));
+    }
+
+    if (stdOut)
+      g_free(stdOut);
+  }
+}
+
+
+/* menu item handler - call connection start */
+void svHandleConnectMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  Connection * con = (Connection *)userData;
+  if (!con)
+    return;
+
+  svConnectionCreate(con);
+}
+
+
+/* menu item handler - call connection end */
+void svHandleDisconnectMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  Connection * con = (Connection *)userData;
+  if (!con)
+    return;
+
+  svConnectionEnd(con);
+}
+
+
+/* menu item handler - call connection editor */
+void svHandleEditMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  Connection * con = (Connection *)userData;
+  if (!con)
+    return;
+
+  svShowConnectionEditWindow(con);
+}
+
+/* menu item handler - call connection editor */
+void svHandleSyncClipboardMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  const Connection * con = (Connection *)userData;
+  if (!con)
+    return;
+
+  // set local clipboard
+  svClipSetLocal(svClipLatest(con));
+}
+
+
+/* menu item handler - set local clipboard to a clipboard history entry */
+void svHandleClipHistoryMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  svClipSetLocal((GBytes *)userData);
+}
+
+
+/* menu item handler - send local clipboard to right-clicked connection */
+void svHandleSendClipboardMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  svClipRequestLocal((Connection *)userData, true);
+}
+
+
+/* menu item handler - get right-clicked connection's f12 macro (NOT on clipboard!) */
+void svHandleF12GetMacroMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  const Connection * con = (Connection *)userData;
+
+  if (!con)
+    return;
+
+  g_string_assign(app->f12Storage, con->f12Macro->str);
+}
+
+
+/* menu item handler - set right-clicked connection's f12 macro (NOT from clipboard!) */
+void svHandleF12PutMacroMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  Connection * con = (Connection *)userData;
+  if (!con)
+    return;
+
+  gint res = -1;
+
+  // if there's an existing f12 macro, confirm overwriting first
+  if (con->f12Macro->len > 0)
+  {
+    GtkWidget * dialog = gtk_message_dialog_new(GTK_WINDOW(app->mainWin),
+                                    GTK_DIALOG_DESTROY_WITH_PARENT,
+                                    GTK_MESSAGE_QUESTION,
+                                    GTK_BUTTONS_YES_NO,
+                                    "Are you sure you want to replace the existing F12 macro for '%s'?",
+                                    con->name->str);
+    res = gtk_dialog_run(GTK_DIALOG(dialog));
+
+    // destroy the dialog box
+    gtk_widget_destroy(dialog);
+
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+  }
+
+  // only set f12 macro if user confirms 'ok' to overwriting or there's nothing to overwrite
+  if (res == GTK_RESPONSE_YES || con->f12Macro->len == 0)
+  {
+    svSetF12Macro(con, app->f12Storage->str);
+    svConfigWrite();
+  }
+}
+
+
+/* clean up connection object if deleted */
+void svFreeConnObject(Connection * con)
+{
+  if (!con)
+    return;
+
+  // a listening session slot is free again
+  if (con->type == SV_TYPE_VNC_REVERSE && app->reverseCount > 0)
+    app->reverseCount--;
+
+  // stop any f12 macro still scheduled for this connection
+  svMacroStop(con);
+
+  // stop any reachability probe for this connection
+  svProbeCancel(con);
+
+  // stop any pending auto-reconnect
+  if (con->reconnectSource > 0)
+    g_source_remove(con->reconnectSource);
+
+  // stop the dead-peer watchdog, any connect still in flight and any held-back pointer motion
+  svWatchdogStop(con);
+  svPointerCancel(con);
+  svConnectDirectCancel(con, true);
+
+  // drop any pre-connection, and stop waiting to pre-connect it
+  svWarmDrop(con);
+
+  // let a waiting command-line screenshot go, and anyone waiting over the control socket
+  svRemoteShotFinish(con, "the connection was deleted");
+  svControlForget(con);
+  svMatchWaitCancel(con, NULL, NULL, "deleted");
+  svShmClose(con);
+
+  // (a viewer process ends its connection once we hang up)
+  svTileRemove(con);
+  svDetachEnd(con);
+  svHelperStop(con);
+  svRemoteResizeCancel(con);
+  svPreviewHide(con);
+  svPreviewForget(con);
+
+  if (app->warmHoverCon == con)
+  {
+    app->warmHoverCon = NULL;
+
+    if (app->warmHoverSource > 0)
+    {
+      g_source_remove(app->warmHoverSource);
+      app->warmHoverSource = 0;
+    }
+  }
+
+  if (con->name)
+    g_string_free(con->name, true);
+  if (con->group)
+    g_string_free(con->group, true);
+  if (con->address)
+    g_string_free(con->address, true);
+  if (con->vncPort)
+    g_string_free(con->vncPort, true);
+  if (con->vncPass)
+    g_string_free(con->vncPass, true);
+  if (con->vncLoginUser)
+    g_string_free(con->vncLoginUser, true);
+  if (con->vncLoginPass)
+    g_string_free(con->vncLoginPass, true);
+  if (con->sshPort)
+    g_string_free(con->sshPort, true);
+  if (con->sshPrivKeyfile)
+    g_string_free(con->sshPrivKeyfile, true);
+  if (con->sshUser)
+    g_string_free(con->sshUser, true);
+  if (con->sshPass)
+    g_string_free(con->sshPass, true);
+  if (con->f12Macro)
+    g_string_free(con->f12Macro, true);
+  if (con->repeaterId)
+    g_string_free(con->repeaterId, true);
+  if (con->shotFile)
+    g_string_free(con->shotFile, true);
+  if (con->f12Program)
+    g_array_unref(con->f12Program);
+  if (con->pasteKeys)
+    g_string_free(con->pasteKeys, true);
+  if (con->probeVersion)
+    g_string_free(con->probeVersion, true);
+  if (con->probeTime)
+    g_string_free(con->probeTime, true);
+  if (con->quickNote)
+    g_string_free(con->quickNote, true);
+  if (con->customCmd1Label)
+    g_string_free(con->customCmd1Label, true);
+  if (con->customCmd1)
+    g_string_free(con->customCmd1, true);
+  if (con->customCmd2Label)
+    g_string_free(con->customCmd2Label, true);
+  if (con->customCmd2)
+    g_string_free(con->customCmd2, true);
+  if (con->customCmd3Label)
+    g_string_free(con->customCmd3Label, true);
+  if (con->customCmd3)
+    g_string_free(con->customCmd3, true);
+  if (con->lastErrorMessage)
+    g_string_free(con->lastErrorMessage, true);
+  if (con->lastConnectTime)
+    g_string_free(con->lastConnectTime, true);
+  if (con->clipLastSent)
+    g_bytes_unref(con->clipLastSent);
+
+  // drop this connection's clipboard history
+  svClipHistoryRemove(con);
+
+  g_free(con);
+}
+
+
+/* menu item handler - delete a connection */
+void svHandleDeleteMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  Connection * con = (Connection *)userData;
+
+  if (!con)
+    return;
+
+  gint res = -1;
+
+  if (con->type != SV_TYPE_VNC_REVERSE)
+  {
+    GtkWidget * dialog = gtk_message_dialog_new(GTK_WINDOW(app->mainWin),
+                                    GTK_DIALOG_DESTROY_WITH_PARENT,
+                                    GTK_MESSAGE_QUESTION,
+                                    GTK_BUTTONS_YES_NO,
+                                    "Are you sure you want to delete '%s'?",
+                                    con->name->str);
+    res = gtk_dialog_run(GTK_DIALOG(dialog));
+
+    // destroy the dialog box
+    gtk_widget_destroy(dialog);
+
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+  }
+
+  if (res == GTK_RESPONSE_YES || con->type == SV_TYPE_VNC_REVERSE)
+  {
+    // get all connection listbox rows
+    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+    // loop through each row
+    for (GList * l = rows; l != NULL; l = l->next)
+    {
+      GtkWidget * row = GTK_WIDGET(l->data);
+
+      // get box that holds status image and label
+      GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+
+      if (!rowBox)
+        continue;
+
+      // get box's children
+      GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+
+      GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+
+      g_list_free(boxChildren);
+
+      if (label && GTK_IS_LABEL(label))
+      {
+        const char * text = gtk_label_get_text(GTK_LABEL(label));
+
+        // found matching row string
+        if (strcmp(text, con->name->str) == 0)
+        {
+          // destroy the child widget (will remove from container too)
+          if (row)
+            gtk_widget_destroy(row);
+
+          // release and clean up connection resources
+          if (app->selectedConnection == con)
+            app->selectedConnection = NULL;
+
+          // its preview goes too
+          svPreviewDelete(con);
+
+          svFreeConnObject(con);
+
+          break;
+        }
+      }
+    }
+
+    // Free the list
+    g_list_free(rows);
+  }
+}
+
+
+/* menu item handler - add new connection */
+void svHandleAddNewConnectionMenuItem (GtkMenuItem *, gpointer)
+{
+  app->addNewConnection = true;
+
+  svCheckForNewConnectionAdd();
+}
+
+
+/* menu item handler - toggle fullscreen */
+void svHandleFullscreenMenuItem (GtkMenuItem *, gpointer)
+{
+  // if fullscreen, unfullscreen and vice-versa
+  if (app->fullscreen)
+    gtk_window_unfullscreen(GTK_WINDOW(app->mainWin));
+  else
+    gtk_window_fullscreen(GTK_WINDOW(app->mainWin));
+}
+
+
+/* check for connected connections */
+gboolean svThereAreConnectedConnections ()
+{
+  gboolean result = false;
+
+  // go through connection listbox and return correct connection
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkListBoxRow * row = l->data;
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+
+    // if there's a connected connection, return true
+    const Connection * con = g_object_get_data(G_OBJECT(box), "con");
+    if (con && con->state == SV_STATE_CONNECTED)
+    {
+      result = true;
+      break;
+    }
+  }
+
+  g_list_free(rows);
+
+  return result;
+}
+
+
+/* scanMode - move to next connected connection on server list */
+gboolean svScanModeNextConnection (gpointer unused)
+{
+  // if there are no more connected connections, cancel scan mode
+  if (!svThereAreConnectedConnections())
+  {
+    // cancel scan mode
+    svCancelScanMode(false);
+
+    // tell user
+    svShowMessageDialog("There are no connected connections.\n\nScan mode terminated.");
+
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+
+    return G_SOURCE_REMOVE;
+  }
+
+  // see if there's a selected connection
+  gint selectedIndex = -1;
+  gboolean looped = false;
+
+  GtkListBoxRow * selectedRow = gtk_list_box_get_selected_row(GTK_LIST_BOX(app->serverList));
+
+  // set selectedIndex if there is a selected row
+  if (selectedRow)
+    selectedIndex = gtk_list_box_row_get_index(selectedRow);
+
+  // go through connection listbox and select the next connected connection
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkListBoxRow * row = l->data;
+    gint rowIndex = gtk_list_box_row_get_index(row);;
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+
+    // if this is a connected connection, process it
+    Connection * con = g_object_get_data(G_OBJECT(box), "con");
+    if (con && con->state == SV_STATE_CONNECTED)
+    {
+      // if nothing is selected, select the first connected connection
+      // in the list, otherwise select the next connected connection
+      if ((selectedIndex == -1) || (rowIndex > selectedIndex))
+      {
+        gtk_list_box_select_row(GTK_LIST_BOX(app->serverList), GTK_LIST_BOX_ROW(row));
+        svConnectionSwitch(con);
+        break;
+      }
+    }
+
+    // we've reached the end of the list, loop around
+    if (!l->next)
+    {
+      // get out if we've already looped, to prevent infinity loopage
+      if (looped)
+        break;
+
+      looped = true;
+
+      // reset selectedIndex so the first connected connection will be selected / switched to
+      selectedIndex = -1;
+
+      // set our iterator to the first row glist element
+      l = g_list_first(rows);
+
+      // if for some reason the first element is null, get out
+      if (!l)
+        break;
+    }
+  }
+
+  g_list_free(rows);
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+void svCancelScanMode (gboolean removeSource)
+{
+  // cancel scan mode
+  app->scanMode = false;
+
+  // change listen mode tools menu item text
+  gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "scanMode")), "Enable sca_n mode");
+
+  // change listen toolbutton to 'enabled' image
+  if (app->listenImage)
+  {
+    gtk_image_clear(GTK_IMAGE(app->scanImage));
+    gtk_image_set_from_resource(GTK_IMAGE(app->scanImage), "/com/spiritvnc/pngs/scan-disabled.png");
+  }
+
+  // remove timer source
+  if (app->scanTimerSource > 0)
+  {
+    // only remove source if manually canceling scan mode
+    if (removeSource)
+      g_source_remove(app->scanTimerSource);
+
+    app->scanTimerSource = 0;
+  }
+}
+
+
+/* menu item handler - toggle scan mode */
+void svHandleScanModeMenuItem (GtkMenuItem * unused1, gpointer unused2)
+{
+  // toggle scan mode
+  app->scanMode = !app->scanMode;
+
+  if (app->scanMode)
+  {
+    // start scan mode if there's any connected connections
+    if (svThereAreConnectedConnections())
+    {
+      // change listen mode tools menu item text
+      gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "scanMode")), "Disable sca_n mode");
+
+      // change listen toolbutton to 'enabled' image
+      if (app->listenImage)
+      {
+        gtk_image_clear(GTK_IMAGE(app->scanImage));
+        gtk_image_set_from_resource(GTK_IMAGE(app->scanImage), "/com/spiritvnc/pngs/scan-enabled.png");
+      }
+
+      // start scan timer
+      app->scanTimerSource = g_timeout_add_seconds(app->scanTimeout, svScanModeNextConnection, NULL);
+    }
+    else
+    {
+      // let user know there's no connected connections
+      svShowMessageDialog("There are no connected connections.\n\nScan mode not started.");
+
+      gtk_window_present(GTK_WINDOW(app->mainWin));
+
+      // cancel scan mode
+      svCancelScanMode(true);
+    }
+  }
+  else
+    // cancel scan mode
+    svCancelScanMode(true);
+}
+
+
+/* menu item handler - do screenshot of current vnc connection */
+void svHandleScreenshotMenuItem (GtkMenuItem * unused, gpointer userData)
+{
+  // the connection asked about, or (from the tools menu) the selected one
+  const Connection * con = userData ? (Connection *)userData : svGetSelectedConnectionListConnection();
+  if (!con)
+    return;
+
+  // save screenshot to pixbuf
+  GdkPixbuf * pic = svConnectionPixbuf(con);
+  if (!pic)
+    return;
+
+  // open save dialog
+  GtkWidget * dialog;
+  GtkFileChooser * chooser;
+  GtkFileChooserAction action = GTK_FILE_CHOOSER_ACTION_SAVE;
+  gint res;
+
+  // get the current time
+  GDateTime * now = g_date_time_new_now_local();
+
+  // format the time as a human-readable string
+  char * formattedTime = g_date_time_format(now, "%Y-%m-%d--%H-%M-%S");  // <<<--- do NOT make const char *
+
+  GString * existingFilename = g_string_new(NULL);
+  g_string_printf(existingFilename, "spiritvnc-screenshot-%s.png", formattedTime);
+
+  // free resources
+  g_free(formattedTime);
+  g_date_time_unref(now);
+
+  dialog = gtk_file_chooser_dialog_new("Save screenshot",
+                                        GTK_WINDOW(app->mainWin),
+                                        action,
+                                        "_Cancel",
+                                        GTK_RESPONSE_CANCEL,
+                                        "_Save",
+                                        GTK_RESPONSE_ACCEPT,
+                                        NULL);
+  chooser = GTK_FILE_CHOOSER(dialog);
+
+  gtk_file_chooser_set_do_overwrite_confirmation(chooser, true);
+  gtk_file_chooser_set_current_name(chooser, existingFilename->str);
+  g_string_free(existingFilename, true);
+
+  res = gtk_dialog_run(GTK_DIALOG(dialog));
+
+  if (res == GTK_RESPONSE_ACCEPT)
+  {
+    char * filename = gtk_file_chooser_get_filename(chooser);  //  <<<--- do NOT make const char *
+
+    gdk_pixbuf_save(pic, filename, "png", NULL, "tEXt::Generator App", "spiritvncgtk", NULL);
+
+    g_free(filename);
+    g_object_unref(pic);
+  }
+
+  // destroy dialog
+  gtk_widget_destroy(dialog);
+
+  gtk_window_present(GTK_WINDOW(app->mainWin));
+}
+
+
+void svHandleViewOnlyMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  if (!gMenuItem)
+    return;
+
+  Connection * con = (Connection *)userData;
+  if (!con)
+    return;
+
+  // get menu item's children
+  GList * children = gtk_container_get_children(GTK_CONTAINER(gMenuItem));
+  if (!children)
+    return;
+
+  // parent box is first child
+  GtkWidget * parentBox = (GtkWidget *)g_list_nth_data(children, 0);
+  if (!parentBox)
+    return;
+
+  // now get parent box's childre
+  GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(parentBox));
+  if (!boxChildren)
+    return;
+
+  // checkbox is first child
+  GtkWidget * checkBox = (GtkWidget *)g_list_nth_data(boxChildren, 0);
+  if (!checkBox)
+    return;
+
+  // toggle view-only
+  con->viewOnly = !con->viewOnly;
+
+  // set the viewer now if it's connected
+  if (con->state == SV_STATE_CONNECTED && con->vncObj)
+    vnc_display_set_read_only(VNC_DISPLAY(con->vncObj), con->viewOnly || con->tileMuted);
+
+  // set the checkbox's checked state
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(checkBox), con->viewOnly);
+
+  svConfigWrite();
+
+  // free lists
+  g_list_free(children);
+  g_list_free(boxChildren);
+}
+
+
+/* create connection right-click menu */
+void svConnectionRightClick (Connection * con)
+{
+  if (!con)
+    return;
+
+  // right-click menu
+  GtkWidget * rightMenu = gtk_menu_new();
+
+  // connect menu item
+  if (con->state != SV_STATE_CONNECTED && con->state != SV_STATE_WAITING)
+  {
+    GtkWidget * connect = gtk_menu_item_new_with_label("Connect");
+    svSetTooltip(connect, "Attempts to start this connection to the remote host");
+    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(connect), true);
+    gtk_widget_set_sensitive(GTK_WIDGET(connect), true);
+    gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), connect);
+    g_signal_connect(connect, "activate", G_CALLBACK(svHandleConnectMenuItem), con);
+  }
+
+  // disconnect menu item
+  if (con->state == SV_STATE_CONNECTED)
+  {
+    GtkWidget * disconnect = gtk_menu_item_new_with_label("Disconnect");
+    svSetTooltip(disconnect, "Disconnects this connection from the remote host");
+    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(disconnect), true);
+    gtk_widget_set_sensitive(GTK_WIDGET(disconnect), true);
+    gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), disconnect);
+    g_signal_connect(disconnect, "activate", G_CALLBACK(svHandleDisconnectMenuItem), con);
+
+    // detach / reattach menu item
+    GtkWidget * detach = gtk_menu_item_new_with_label(con->detachWin ? "Reattach window" : "Detach window");
+    svSetTooltip(detach, con->detachWin ? "Puts this connection back in the main window" :
+      "Moves this connection into a window of its own, e.g. for another monitor");
+    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(detach), true);
+    gtk_widget_set_sensitive(GTK_WIDGET(detach), true);
+    gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), detach);
+    g_signal_connect(detach, "activate", G_CALLBACK(svHandleDetachMenuItem), con);
+  }
+
+  // edit menu item
+  GtkWidget * edit = gtk_menu_item_new_with_label("Edit");
+  svSetTooltip(edit, "Opens this connection in the Edit Connection window");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(edit), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(edit), true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), edit);
+  g_signal_connect(edit, "activate", G_CALLBACK(svHandleEditMenuItem), con);
+
+   // f12 macro section
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+
+  // view-only menu item
+  GtkWidget * viewOnly = gtk_menu_item_new_with_label("View only");
+  svSetTooltip(viewOnly, "Sets this connection to view-only (no mouse or keyboard events will be sent)");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(viewOnly), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(viewOnly), true);
+  // remove menu item's original child
+  GtkWidget * origChild = gtk_bin_get_child(GTK_BIN(viewOnly));
+  gtk_container_remove(GTK_CONTAINER(viewOnly), origChild);
+  // make a box to put our checkbox and label into
+  GtkWidget * childBox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  // checkbox
+  GtkWidget * viewOnlyCheckbox = gtk_check_button_new();
+  gtk_box_pack_start(GTK_BOX(childBox), viewOnlyCheckbox, false, false, 0);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(viewOnlyCheckbox), con->viewOnly);
+  // label
+  GtkWidget * viewOnlyLabel = gtk_label_new("View only");
+  gtk_box_pack_start(GTK_BOX(childBox), viewOnlyLabel, false, false, 0);
+  //
+  gtk_container_add(GTK_CONTAINER(viewOnly), childBox);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), viewOnly);
+  g_signal_connect(viewOnly, "activate", G_CALLBACK(svHandleViewOnlyMenuItem), con);
+
+ // f12 macro section
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+
+  // get f12 macro menu item
+  GtkWidget * getF12 = gtk_menu_item_new_with_label("Get F12 macro");
+  svSetTooltip(getF12, "Gets this connection's F12 macro so it can put into another connection's F12 macro");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(getF12), false);
+  gtk_widget_set_sensitive(GTK_WIDGET(getF12), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), getF12);
+  g_signal_connect(getF12, "activate", G_CALLBACK(svHandleF12GetMacroMenuItem), con);
+
+  // only enable if this connection has f12 macro text
+  if (con->f12Macro->len > 0)
+    gtk_widget_set_sensitive(GTK_WIDGET(getF12), true);
+
+  // put f12 macro menu item
+  GtkWidget * putF12 = gtk_menu_item_new_with_label("Put F12 macro");
+  svSetTooltip(putF12, "Puts a stored F12 macro into this connection's F12 macro");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(putF12), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(putF12), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), putF12);
+  g_signal_connect(putF12, "activate", G_CALLBACK(svHandleF12PutMacroMenuItem), con);
+
+  // only enable when connected and there's something to 'put'
+  //if (con->state == SV_STATE_CONNECTED && app->f12Storage->len > 0)
+  if (app->f12Storage->len > 0)
+    gtk_widget_set_sensitive(GTK_WIDGET(putF12), true);
+
+  // delete section
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+
+  // delete menu item
+  GtkWidget * delete = gtk_menu_item_new_with_label("Delete...");
+  svSetTooltip(delete, "The app will ask you if you're sure you want to delete this connection");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(delete), true);
+  if (con->state != SV_STATE_CONNECTED && con->state != SV_STATE_WAITING)
+    gtk_widget_set_sensitive(GTK_WIDGET(delete), true);
+  else
+    gtk_widget_set_sensitive(GTK_WIDGET(delete), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), delete);
+  g_signal_connect(delete, "activate", G_CALLBACK(svHandleDeleteMenuItem), con);
+
+  gboolean enableCustomCommands = false;
+
+  // only display custom commands submenu if any subcommands are enabled and have a label
+  if ((con->customCmd1Enabled && con->customCmd1Label->len > 0) ||
+    (con->customCmd2Enabled && con->customCmd2Label->len > 0) ||
+    (con->customCmd3Enabled && con->customCmd3Label->len > 0))
+  {
+    enableCustomCommands = true;
+  }
+  // custom commands submenu
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+
+  // custom commands
+  GtkWidget * cc = gtk_menu_item_new_with_label("Custom commands");
+  svSetTooltip(cc, "Custom commands sub-menu");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cc), true);
+  gtk_widget_set_sensitive(GTK_WIDGET(cc), enableCustomCommands); //true);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), cc);
+
+  // create submenu
+  GtkWidget * customCommands = gtk_menu_new();
+
+  // attach submenu to custom commands item
+  gtk_menu_item_set_submenu(GTK_MENU_ITEM(cc), customCommands);
+
+  if (con->customCmd1Enabled && enableCustomCommands)
+  {
+    // custom command 1
+    GtkWidget * cmdLbl1 = gtk_menu_item_new_with_label(con->customCmd1Label->str);
+    svSetTooltip(cmdLbl1, "Runs custom command 1");
+    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cmdLbl1), true);
+    gtk_widget_set_sensitive(GTK_WIDGET(cmdLbl1), con->customCmd1Enabled);
+    gtk_menu_shell_append(GTK_MENU_SHELL(customCommands), cmdLbl1);
+    g_signal_connect(cmdLbl1, "activate", G_CALLBACK(svHandleCustomCommandMenuItem), con->customCmd1->str);
+  }
+
+  if (con->customCmd2Enabled && enableCustomCommands)
+  {
+    // custom command 2
+    GtkWidget * cmdLbl2 = gtk_menu_item_new_with_label(con->customCmd2Label->str);
+    svSetTooltip(cmdLbl2, "Runs custom command 2");
+    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cmdLbl2), true);
+    gtk_widget_set_sensitive(GTK_WIDGET(cmdLbl2), con->customCmd2Enabled);
+    gtk_menu_shell_append(GTK_MENU_SHELL(customCommands), cmdLbl2);
+    g_signal_connect(cmdLbl2, "activate", G_CALLBACK(svHandleCustomCommandMenuItem), con->customCmd2->str);
+  }
+
+  if (con->customCmd3Enabled && enableCustomCommands)
+  {
+    // custom command 3
+    GtkWidget * cmdLbl3 = gtk_menu_item_new_with_label(con->customCmd3Label->str);
+    svSetTooltip(cmdLbl3, "Runs custom command 3");
+    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cmdLbl3), true);
+    gtk_widget_set_sensitive(GTK_WIDGET(cmdLbl3), con->customCmd3Enabled);
+    gtk_menu_shell_append(GTK_MENU_SHELL(customCommands), cmdLbl3);
+    g_signal_connect(cmdLbl3, "activate", G_CALLBACK(svHandleCustomCommandMenuItem), con->customCmd3->str);
+  }
+  //}
+
+  // and all the rest, all on gilligan's island
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+
+  // sync clipboard item
+  GtkWidget * setClipboard = gtk_menu_item_new_with_label("Set my clipboard to this connection's clipboard");
+  svSetTooltip(setClipboard, "Sets this computer's clipboard to the contents of this connection's clipboard");
+  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(setClipboard), true);
+  if (svClipLatest(con))
+    gtk_widget_set_sensitive(GTK_WIDGET(setClipboard), true);
+  else
+    gtk_widget_set_sensitive(GTK_WIDGET(setClipboard), false);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), setClipboard);
+  g_signal_connect(setClipboard, "activate", G_CALLBACK(svHandleSyncClipboardMenuItem), con);
+
+  // clipboard history submenu
+  GtkWidget * clipHistory = gtk_menu_item_new_with_label("Clipboard history");
+  svSetTooltip(clipHistory, "Recent clipboard text from this connection");
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), clipHistory);
+
+  GtkWidget * clipHistoryMenu = gtk_menu_new();
+  gtk_menu_item_set_submenu(GTK_MENU_ITEM(clipHistory), clipHistoryMenu);
+
+  guint clipCount = 0;
+
+  for (GList * l = app->clipHistory->head; l; l = l->next)
+  {
+    const ClipEntry * entry = (const ClipEntry *)l->data;
+
+    if (entry->con != con)
+      continue;
+
+    GString * preview = svClipPreview(entry->text->bytes);
+    GtkWidget * clipItem = gtk_menu_item_new_with_label(preview->str);
+    g_string_free(preview, true);
+
+    gtk_menu_shell_append(GTK_MENU_SHELL(clipHistoryMenu), clipItem);
+
+    // the menu item holds its own reference in case the entry is dropped while it's open
+    g_signal_connect_data(clipItem, "activate", G_CALLBACK(svHandleClipHistoryMenuItem),
+      g_bytes_ref(entry->text->bytes), (GClosureNotify)g_bytes_unref, 0);
+
+    clipCount++;
+  }
+
+  gtk_widget_set_sensitive(GTK_WIDGET(clipHistory), clipCount > 0);
+
+  // send clipboard item
+  GtkWidget * sendClipboard = gtk_menu_item_new_with_label("Send my clipboard to this connection");
+  svSetTooltip(sendClipboard, "Sets this connection's clipboard to the contents of this computer's clipboard");
+  gtk_widget_set_sensitive(GTK_WIDGET(sendClipboard), con->state == SV_STATE_CONNECTED && !con->viewOnly);
+  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), sendClipboard);
+  g_signal_connect(sendClipboard, "activate", G_CALLBACK(svHandleSendClipboardMenuItem), con);
+
+
+  // show all the thingz
+  gtk_widget_show_all(GTK_WIDGET(rightMenu));
+
+  // pop up the menu
+  gtk_menu_popup_at_pointer(GTK_MENU(rightMenu), NULL);
+}
+
+
+/* time out a connected connection if it doesn't initialize in time */
+/* (run as a thread) */
+gpointer svConnectionInitWaiter (void * data)
+{
+  Connection * con = (Connection *)data;
+
+  if (!con)
+    return NULL;
+
+  // wait for vnc connection timeout
+  for (guint i = 0; i < app->vncConnectWaitTime; i++)
+  {
+    // break out if connection becomes initialized
+    if (con->state != SV_STATE_WAITING)
+      break;
+
+    sleep(1);
+  }
+
+  // if the connection isn't actually initialized (fully connected), close it
+  if (con->state != SV_STATE_CONNECTED)
+  {
+    if (con->vncObj)
+      vnc_display_close(VNC_DISPLAY(con->vncObj));
+
+    // call server error handler directly
+    svServerError(NULL, "Viewer failed to initialize in time", con);
+  }
+
+  return NULL;
+}
+
+
+/* handle vnc obj connection event */
+void svServerConnected (GtkWidget * vncObj)
+{
+  Connection * con = svConnectionFromVNCObj(vncObj);
+  if (!con)
+    return;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Server connected (but not init'd) to '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // spawn initialize waiter thread
+  GThread * initWaiter G_GNUC_UNUSED = g_thread_new("init-waiter", svConnectionInitWaiter, con);
+}
+
+
+/* show a connection's auto-reconnect status in the quicknote area, if it's selected */
+void svReconnectShowStatus (const Connection * con)
+{
+  if (!app->quickNoteReconnect || con != app->selectedConnection)
+    return;
+
+  // nothing to show
+  if (!con || con->reconnectTries == 0)
+  {
+    gtk_widget_hide(app->quickNoteReconnect);
+    return;
+  }
+
+  GString * strStatus = g_string_new(NULL);
+
+  if (con->reconnectSource > 0)
+  {
+    GDateTime * at = g_date_time_new_from_unix_local(con->reconnectAt / G_USEC_PER_SEC);
+    char * atStr = g_date_time_format(at, "%H:%M:%S");  // <<<--- do NOT make const char *
+
+    if (con->reconnectMaxTries > 0)
+      g_string_printf(strStatus, "Reconnect attempt %u of %u at %s", con->reconnectTries,
+        con->reconnectMaxTries, atStr);
+    else
+      g_string_printf(strStatus, "Reconnect attempt %u at %s", con->reconnectTries, atStr);
+
+    g_free(atStr);
+    g_date_time_unref(at);
+  }
+  else if (con->state == SV_STATE_WAITING)
+    g_string_printf(strStatus, "Reconnecting (attempt %u)", con->reconnectTries);
+  else
+    g_string_printf(strStatus, "Gave up reconnecting after %u attempts", con->reconnectTries);
+
+  gtk_label_set_text(GTK_LABEL(app->quickNoteReconnect), strStatus->str);
+  gtk_widget_show(app->quickNoteReconnect);
+
+  g_string_free(strStatus, true);
+}
+
+
+/* auto-reconnect timer - try the connection again */
+gboolean svReconnectTimer (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con)
+    return G_SOURCE_REMOVE;
+
+  con->reconnectSource = 0;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Auto-reconnecting '%s - %s' (attempt %u)", con->name->str,
+    con->address->str, con->reconnectTries);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  svConnectionCreate(con);
+
+  svReconnectShowStatus(con);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/* schedule a connection's next auto-reconnect attempt */
+/* (capped exponential backoff with jitter, so a network blip doesn't */
+/* have every connection retrying at the same moment) */
+void svReconnectSchedule (Connection * con)
+{
+  if (!con || con->reconnectSource > 0)
+    return;
+
+  GString * logStr = g_string_new(NULL);
+
+  // out of attempts
+  if (con->reconnectMaxTries > 0 && con->reconnectTries >= con->reconnectMaxTries)
+  {
+    g_string_printf(logStr, "Giving up auto-reconnecting '%s - %s' after %u attempts",
+      con->name->str, con->address->str, con->reconnectTries);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+
+    svReconnectShowStatus(con);
+
+    return;
+  }
+
+  // base * 2^tries, capped
+  guint64 delay = (guint64)SV_RECONNECT_BASE_MS << MIN(con->reconnectTries, 16);
+
+  if (delay > SV_RECONNECT_CAP_MS)
+    delay = SV_RECONNECT_CAP_MS;
+
+  // 'equal jitter' - wait at least half the delay, plus a random part of the other half
+  const guint wait = delay / 2 + g_random_int_range(0, delay / 2 + 1);
+
+  con->reconnectTries++;
+  con->reconnectAt = g_get_real_time() + (gint64)wait * 1000;
+  con->reconnectSource = g_timeout_add(wait, svReconnectTimer, con);
+
+  g_string_printf(logStr, "Auto-reconnect attempt %u for '%s - %s' in %u ms", con->reconnectTries,
+    con->name->str, con->address->str, wait);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  svReconnectShowStatus(con);
+}
+
+
+/* cancel a connection's pending auto-reconnect attempt */
+/* (resetTries also forgets how many attempts were made) */
+void svReconnectCancel (Connection * con, gboolean resetTries)
+{
+  if (!con)
+    return;
+
+  if (con->reconnectSource > 0)
+  {
+    g_source_remove(con->reconnectSource);
+    con->reconnectSource = 0;
+  }
+
+  if (resetTries)
+    con->reconnectTries = 0;
+
+  svReconnectShowStatus(con);
+}
+
+
+/* framebuffer bytes a connected session holds on this side */
+/* (gtk-vnc keeps a full-size local surface at 4 bytes per pixel, whatever the server's depth) */
+gsize svFbBytes (GtkWidget * vncObj)
+{
+  if (!vncObj)
+    return 0;
+
+  return (gsize)vnc_display_get_width(VNC_DISPLAY(vncObj)) *
+    (gsize)vnc_display_get_height(VNC_DISPLAY(vncObj)) * 4;
+}
+
+
+/* close connections nobody has looked at or typed into for their idle time */
+gboolean svIdleTimer (gpointer data)
+{
+  const gint64 now = g_get_monotonic_time();
+
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(l->data));
+    if (!rowBox)
+      continue;
+
+    Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+
+    // the connection being viewed is never idle (nor is one on screen in a window or tile of its own)
+    if (!con || con == app->selectedConnection || con->detachWin || con->tileBox || con->type == SV_TYPE_VNC_REVERSE ||
+      con->state != SV_STATE_CONNECTED || !con->vncObj)
+      continue;
+
+    // -1 uses the app setting, 0 is never
+    const gint idleMinutes = (con->idleMinutes < 0) ? (gint)app->idleMinutes : con->idleMinutes;
+
+    if (idleMinutes <= 0 || now - con->lastViewed < (gint64)idleMinutes * 60 * G_USEC_PER_SEC)
+      continue;
+
+    // log
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Connection '%s - %s' idle for %i minutes, disconnecting", con->name->str,
+      con->address->str, idleMinutes);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+
+    g_string_printf(con->lastErrorMessage, "Disconnected after %i idle minutes", idleMinutes);
+
+    con->disconnectType = SV_DISC_IDLE;
+    svConnectionEnd(con);
+  }
+
+  g_list_free(rows);
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+/* close a background session to give back its framebuffer memory */
+void svFbEvict (Connection * con, gsize totalBytes)
+{
+  if (!con || !con->vncObj)
+    return;
+
+  g_string_printf(con->lastErrorMessage, "Closed to stay under the %u MB framebuffer memory budget "
+    "(least recently viewed)", app->fbBudgetMB);
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Evicting connection '%s - %s' (%" G_GSIZE_FORMAT " KB of %" G_GSIZE_FORMAT
+    " KB framebuffers in use)", con->name->str, con->address->str, con->fbBytes / 1024, totalBytes / 1024);
+  svLog(logStr->str, false);
+  g_string_free(logStr, true);
+
+  svMacroStop(con);
+  svWatchdogStop(con);
+
+  con->disconnectType = SV_DISC_EVICTED;
+
+  vnc_display_close(VNC_DISPLAY(con->vncObj));
+}
+
+
+/* close least-recently-viewed background sessions until the framebuffers fit the budget */
+void svFbBudgetEnforce ()
+{
+  // 0 is no budget
+  if (app->fbBudgetMB == 0)
+    return;
+
+  const gsize budget = (gsize)app->fbBudgetMB * 1024 * 1024;
+
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  while (true)
+  {
+    gsize total = 0;
+    Connection * victim = NULL;
+
+    for (GList * l = rows; l; l = l->next)
+    {
+      GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(l->data));
+      if (!rowBox)
+        continue;
+
+      Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+
+      // (sessions already on their way out don't count)
+      if (!con || !con->vncObj || con->state != SV_STATE_CONNECTED ||
+        con->disconnectType == SV_DISC_EVICTED)
+        continue;
+
+      total += con->fbBytes;
+
+      // never the one being looked at (or one on screen in a window or tile of its own)
+      if (con != app->selectedConnection && !con->detachWin && !con->tileBox &&
+        (!victim || con->lastViewed < victim->lastViewed))
+        victim = con;
+    }
+
+    if (total <= budget || !victim)
+      break;
+
+    svFbEvict(victim, total);
+  }
+
+  g_list_free(rows);
+}
+
+
+/* handle a vnc obj's remote desktop changing size */
+void svHandleDesktopResize (GtkWidget * vncObj, gint width, gint height, gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con || con->vncObj != vncObj)
+    return;
+
+  con->fbBytes = (gsize)MAX(width, 0) * (gsize)MAX(height, 0) * 4;
+
+  if (con->state == SV_STATE_CONNECTED)
+    svFbBudgetEnforce();
+
+  // (publishing notices the new size and replaces the shared segment)
+  if (con->shm)
+    svShmDirty(con, 0, 0, MAX(width, 0), MAX(height, 0));
+}
+
+
+/* make a shared memory segment name for a connection's screen, unique to this share */
+/* (short, since some systems allow only 31 characters - clients get it from the control socket) */
+void svShmName (char * name, gsize nameLen)
+{
+  static guint shmCount = 0;
+
+  #ifdef _WIN32
+  g_snprintf(name, nameLen, "/svnc-%x", ++shmCount);
+  #else
+  g_snprintf(name, nameLen, "/svnc-%u-%x", (guint)getpid(), ++shmCount);
+  #endif
+}
+
+
+/* stop sharing a connection's screen, telling anyone mapped that it's gone */
+void svShmClose (Connection * con)
+{
+  ShmExport * shm = con->shm;
+  if (!shm)
+    return;
+
+  con->shm = NULL;
+
+  if (shm->source > 0)
+    g_source_remove(shm->source);
+
+  #ifndef _WIN32
+  if (shm->hdr)
+  {
+    g_atomic_int_set(&shm->hdr->live, 0);
+    munmap(shm->hdr, shm->size);
+  }
+
+  shm_unlink(shm->name);
+  #endif
+
+  g_array_unref(shm->dirty);
+  g_free(shm);
+}
+
+
+/* start sharing a connection's screen in a read-only-to-others shared memory segment */
+/* (false if it can't be created) */
+gboolean svShmOpen (Connection * con, guint width, guint height)
+{
+  #ifdef _WIN32
+  return false;
+  #else
+  if (con->shm || width == 0 || height == 0)
+    return false;
+
+  ShmExport * shm = g_new0(ShmExport, 1);
+  svShmName(shm->name, sizeof(shm->name));
+
+  // rows are padded to 4 bytes
+  const guint stride = (width * 3 + 3) & ~3u;
+
+  shm->size = sizeof(ShmHeader) + (gsize)stride * height;
+  shm->dirty = g_array_new(false, false, sizeof(ShmRect));
+
+  // (anything left from a crashed run that had our pid goes - no live process can own the name)
+  shm_unlink(shm->name);
+
+  gint fd = shm_open(shm->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+  if (fd < 0 || ftruncate(fd, shm->size) != 0)
+  {
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Unable to share the screen of '%s' as '%s'", con->name->str, shm->name);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+
+    if (fd >= 0)
+    {
+      close(fd);
+      shm_unlink(shm->name);
+    }
+
+    g_array_unref(shm->dirty);
+    g_free(shm);
+
+    return false;
+  }
+
+  void * mem = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  // (the mapping keeps the segment; the descriptor isn't needed)
+  close(fd);
+
+  if (mem == MAP_FAILED)
+  {
+    shm_unlink(shm->name);
+    g_array_unref(shm->dirty);
+    g_free(shm);
+    return false;
+  }
+
+  shm->hdr = (ShmHeader *)mem;
+  shm->pixels = (guchar *)mem + sizeof(ShmHeader);
+
+  // (fresh pages are zero, so only the non-zero fields need setting)
+  shm->hdr->magic = SV_SHM_MAGIC;
+  shm->hdr->version = SV_SHM_VERSION;
+  shm->hdr->headerSize = sizeof(ShmHeader);
+  shm->hdr->width = width;
+  shm->hdr->height = height;
+  shm->hdr->stride = stride;
+  shm->hdr->format = SV_SHM_FORMAT_RGB24;
+  shm->hdr->ringSize = SV_SHM_RING;
+  g_atomic_int_set(&shm->hdr->live, 1);
+
+  con->shm = shm;
+
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Sharing the screen of '%s' as '%s' (%ux%u)", con->name->str, shm->name, width, height);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // everything is new to readers
+  svShmDirty(con, 0, 0, width, height);
+
+  svControlNotifyScreen(con, true);
+
+  return true;
+  #endif
+}
+
+
+/* copy the changed parts of a connection's screen into its shared segment */
+/* (writers bump seq to odd before and back to even after, so readers can */
+/* tell when they've read a half-written frame and try again) */
+void svShmPublish (Connection * con)
+{
+  ShmExport * shm = con->shm;
+
+  if (!shm || !con->vncObj || shm->dirty->len == 0)
+    return;
+
+  GdkPixbuf * pic = vnc_display_get_pixbuf(VNC_DISPLAY(con->vncObj));
+  if (!pic)
+    return;
+
+  const guint width = gdk_pixbuf_get_width(pic);
+  const guint height = gdk_pixbuf_get_height(pic);
+
+  // the desktop changed size - readers see 'live' drop and map the new segment
+  if (width != shm->hdr->width || height != shm->hdr->height)
+  {
+    svShmClose(con);
+
+    if (svShmOpen(con, width, height))
+      svShmPublish(con);
+
+    g_object_unref(pic);
+    return;
+  }
+
+  const guint channels = gdk_pixbuf_get_n_channels(pic);
+  const guint picStride = gdk_pixbuf_get_rowstride(pic);
+  const guchar * picPixels = gdk_pixbuf_get_pixels(pic);
+  ShmHeader * hdr = shm->hdr;
+
+  g_atomic_int_inc(&hdr->seq);
+
+  const guint frame = hdr->frame + 1;
+
+  for (guint i = 0; i < shm->dirty->len; i++)
+  {
+    ShmRect * rect = &g_array_index(shm->dirty, ShmRect, i);
+
+    // (clip, in case the update raced a resize)
+    const guint x = MIN(rect->x, width);
+    const guint y = MIN(rect->y, height);
+    const guint w = MIN(rect->width, width - x);
+    const guint h = MIN(rect->height, height - y);
+
+    for (guint row = y; row < y + h; row++)
+    {
+      const guchar * src = picPixels + (gsize)row * picStride + (gsize)x * channels;
+      guchar * dst = shm->pixels + (gsize)row * hdr->stride + (gsize)x * 3;
+
+      if (channels == 3)
+        memcpy(dst, src, (gsize)w * 3);
+      else
+        for (guint col = 0; col < w; col++, src += channels, dst += 3)
+          memcpy(dst, src, 3);
+    }
+
+    // note it in the ring for readers that only want what changed
+    ShmRect * slot = &hdr->ring[hdr->ringHead % SV_SHM_RING];
+    slot->x = x;
+    slot->y = y;
+    slot->width = w;
+    slot->height = h;
+    slot->frame = frame;
+
+    hdr->ringHead++;
+  }
+
+  hdr->frame = frame;
+
+  g_atomic_int_inc(&hdr->seq);
+
+  g_array_set_size(shm->dirty, 0);
+
+  g_object_unref(pic);
+
+  svControlNotifyScreen(con, false);
+}
+
+
+/* publish a connection's batched screen changes */
+gboolean svShmTimer (gpointer data)
+{
+  Connection * con = (Connection *)data;
+
+  if (con->shm)
+  {
+    con->shm->source = 0;
+    svShmPublish(con);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/* note part of a connection's screen changed, and publish it soon */
+/* (updates are batched, so a burst of small ones costs one screen grab) */
+void svShmDirty (Connection * con, guint x, guint y, guint width, guint height)
+{
+  ShmExport * shm = con->shm;
+  if (!shm || width == 0 || height == 0)
+    return;
+
+  // too many pieces - just send the lot
+  if (shm->dirty->len >= SV_SHM_RING / 2)
+  {
+    g_array_set_size(shm->dirty, 1);
+
+    ShmRect * all = &g_array_index(shm->dirty, ShmRect, 0);
+    all->x = 0;
+    all->y = 0;
+    all->width = shm->hdr->width;
+    all->height = shm->hdr->height;
+  }
+  else
+  {
+    ShmRect rect = { x, y, width, height, 0 };
+    g_array_append_val(shm->dirty, rect);
+  }
+
+  if (shm->source == 0)
+    shm->source = g_timeout_add(SV_SHM_MIN_MS, svShmTimer, con);
+}
+
+
+/* start sharing every connected screen, or stop sharing them all */
+void svShmExportAll ()
+{
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
+    Connection * con = box ? g_object_get_data(G_OBJECT(box), "con") : NULL;
+
+    if (!con)
+      continue;
+
+    if (app->shmExport && con->state == SV_STATE_CONNECTED && con->vncObj)
+      svShmOpen(con, vnc_display_get_width(VNC_DISPLAY(con->vncObj)), vnc_display_get_height(VNC_DISPLAY(con->vncObj)));
+    else if (!app->shmExport)
+      svShmClose(con);
+  }
+
+  g_list_free(rows);
+}
+
+
+/* handle vnc obj disconnection event */
+void svServerDisconnected (GtkWidget * vncObj)
+{
+  Connection * con = svConnectionFromVNCObj(vncObj);
+  if (!con)
+    return;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Server disconnected '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // stop any running f12 macro
+  svMacroStop(con);
+
+  // keep its last screen for next time (if the display still has it)
+  svPreviewSave(con);
+
+  // nothing will show up on this screen now
+  svMatchWaitCancel(con, NULL, NULL, "disconnected");
+  svShmClose(con);
+
+  // stop the dead-peer watchdog, and drop any held-back pointer motion
+  svWatchdogStop(con);
+  svPointerCancel(con);
+
+  // a screenshot can't happen now
+  svRemoteShotFinish(con, "disconnected before the screen arrived");
+
+  // if this is svnc, spawn ssh connection stop thread
+  if (con->type == SV_TYPE_VNC_OVER_SSH)
+    con->sshCloseThread = g_thread_new("ssh-closer", svSSHConnectionCloser, con);
+
+  // (a detached or tiled display goes back first, so it's removed from where it's expected)
+  svTileRemove(con);
+  svDetachEnd(con);
+  svRemoteResizeCancel(con);
+
+  // hide the vnc display widget
+  gtk_widget_set_visible(con->vncObj, false);
+
+  // remove the vnc display widget from the display stack
+  gtk_container_remove(GTK_CONTAINER(app->displayStack), con->vncObj);
+
+  con->vncObj = NULL;
+
+  // * set disconnect state and icon *
+
+  gboolean manualDisconnect = false;
+
+  // server stopped answering
+  if (con->disconnectType == SV_DISC_STALE)
+    con->state = SV_STATE_TIMEOUT;
+  // closed to stay under the framebuffer budget
+  else if (con->disconnectType == SV_DISC_EVICTED)
+    con->state = SV_STATE_EVICTED;
+  // closed for being idle
+  else if (con->disconnectType == SV_DISC_IDLE)
+    con->state = SV_STATE_IDLE;
+  // manual disconnect
+  else if (con->state == SV_STATE_CONNECTED && con->disconnectType != SV_DISC_VNC_ERROR && con->disconnectType != SV_DISC_SSH_ERROR)
+  {
+    manualDisconnect = true;
+    con->state = SV_STATE_DISCONNECTED;
+  }
+  // timeout disconnect
+  else if (con->state == SV_STATE_WAITING && con->disconnectType != SV_DISC_VNC_ERROR &&
+    con->disconnectType != SV_DISC_SSH_ERROR)
+    con->state = SV_STATE_TIMEOUT;
+  // error
+  else if (con->state == SV_STATE_ERROR || con->disconnectType == SV_DISC_VNC_ERROR || con->disconnectType == SV_DISC_SSH_ERROR)
+    con->state = SV_STATE_ERROR;
+
+  // set icon
+  svSetIconFromConnectionName(con->name->str, con->state);
+
+  // a batch run records this host and moves on
+  if (con->batchItem)
+    svBatchItemDone(con);
+
+  // automatically delete listening connections on manual disconnect (or eviction - they can't come back)
+  if (con->type == SV_TYPE_VNC_REVERSE && (manualDisconnect || con->disconnectType == SV_DISC_EVICTED))
+  {
+    svHandleDeleteMenuItem(NULL, con);
+    return;
+  }
+
+  // anything but a manual disconnect (or an eviction or idle close) gets retried, if enabled
+  if (con->autoReconnect && con->type != SV_TYPE_VNC_REVERSE && con->disconnectType != SV_DISC_MANUAL &&
+    con->disconnectType != SV_DISC_EVICTED && con->disconnectType != SV_DISC_IDLE)
+    svReconnectSchedule(con);
+}
+
+
+/* handle vnc obj connection error event */
+void svServerError (VncConnection * conn, const char * message, void * data)
+{
+  if (!message)
+    return;
+
+  Connection * con = (Connection *)data;
+  if (!con)
+    return;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Server error '%s - %s': %s", con->name->str, con->address->str, message);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // set state based on 'timeout' or 'timed out' string in error message
+  if (strstr(message, "timeout") || strstr(message, "timed out"))
+    con->state = SV_STATE_TIMEOUT;
+  else
+    con->state = SV_STATE_ERROR;
+
+  svSetIconFromConnectionName(con->name->str, con->state);
+
+  // set connection's last error message
+  g_string_assign(con->lastErrorMessage, message);
+
+  // only show newly-connected server if the listitem is selected
+  const char * selectedRowText = svSelectedRowText();
+
+  if (selectedRowText && strcmp(con->name->str, selectedRowText) == 0)
+    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, con->lastErrorMessage->str, -1);
+}
+
+
+/* turn on tcp keepalive for a socket, tuned so a dead peer is noticed in about 'secs' seconds */
+void svSocketSetKeepalive (GSocket * sock, guint secs)
+{
+  if (!sock)
+    return;
+
+  g_socket_set_keepalive(sock, true);
+
+#ifdef TCP_KEEPIDLE
+  // start probing at half the deadline, then give three quick probes the rest
+  g_socket_set_option(sock, IPPROTO_TCP, TCP_KEEPIDLE, MAX(secs / 2, 1), NULL);
+  g_socket_set_option(sock, IPPROTO_TCP, TCP_KEEPINTVL, MAX(secs / 6, 1), NULL);
+  g_socket_set_option(sock, IPPROTO_TCP, TCP_KEEPCNT, 3, NULL);
+#endif
+}
+
+
+/* return a copy of a socket's descriptor for a vnc obj to own and close (-1 if it can't be made) */
+/* (a winsock socket isn't a C runtime descriptor, so dup() doesn't work on it there) */
+gint svSocketDupFd (GSocket * sock)
+{
+  if (!sock)
+    return -1;
+
+#ifdef _WIN32
+  WSAPROTOCOL_INFOW info;
+
+  if (WSADuplicateSocketW((SOCKET)g_socket_get_fd(sock), GetCurrentProcessId(), &info) != 0)
+    return -1;
+
+  const SOCKET copy = WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &info, 0,
+    WSA_FLAG_OVERLAPPED);
+
+  return (copy == INVALID_SOCKET) ? -1 : (gint)copy;
+#else
+  return dup(g_socket_get_fd(sock));
+#endif
+}
+
+
+/* free an app-managed connect's resources */
+void svConnectJobFree (ConnectJob * job)
+{
+  if (job->staggerSource > 0)
+    g_source_remove(job->staggerSource);
+
+  g_resolver_free_addresses(job->addrs);
+  g_string_free(job->lastError, true);
+  g_object_unref(job->client);
+  g_object_unref(job->cancel);
+  g_free(job);
+}
+
+
+/* unhook a finished app-managed connect from its connection */
+void svConnectJobDetach (ConnectJob * job)
+{
+  if (!job->con)
+    return;
+
+  if (job->con->connectJob == job)
+    job->con->connectJob = NULL;
+
+  if (job->con->warmJob == job)
+    job->con->warmJob = NULL;
+}
+
+
+/* give up on an app-managed connect, reporting it the way the vnc obj would */
+void svConnectDirectFail (ConnectJob * job, const char * message)
+{
+  Connection * con = job->con;
+
+  // (con is NULL if the connection was deleted while connecting)
+  if (con)
+  {
+    svConnectJobDetach(job);
+
+    // (a failed pre-connect just goes away quietly)
+    if (con->vncObj && !job->warm)
+    {
+      if (message && !g_cancellable_is_cancelled(job->cancel))
+        svServerError(NULL, message, con);
+
+      svServerDisconnected(con->vncObj);
+    }
+  }
+
+  svConnectJobFree(job);
+}
+
+
+/* order resolved addresses for racing - alternate families, starting with */
+/* the resolver's first choice (rfc 8305) */
+GList * svConnectInterleave (GList * addrs)
+{
+  if (!addrs)
+    return NULL;
+
+  const GSocketFamily firstFamily = g_inet_address_get_family(G_INET_ADDRESS(addrs->data));
+
+  GList * first = NULL;
+  GList * other = NULL;
+
+  for (GList * l = addrs; l; l = l->next)
+  {
+    if (g_inet_address_get_family(G_INET_ADDRESS(l->data)) == firstFamily)
+      first = g_list_append(first, g_object_ref(l->data));
+    else
+      other = g_list_append(other, g_object_ref(l->data));
+  }
+
+  GList * out = NULL;
+
+  while (first || other)
+  {
+    if (first)
+    {
+      out = g_list_append(out, first->data);
+      first = g_list_delete_link(first, first);
+    }
+
+    if (other)
+    {
+      out = g_list_append(out, other->data);
+      other = g_list_delete_link(other, other);
+    }
+  }
+
+  return out;
+}
+
+
+/* start an attempt at a direct vnc connection's next address, and schedule the one after */
+void svConnectDirectNext (ConnectJob * job)
+{
+  if (job->staggerSource > 0)
+  {
+    g_source_remove(job->staggerSource);
+    job->staggerSource = 0;
+  }
+
+  if (!job->next)
+    return;
+
+  GInetAddress * addr = G_INET_ADDRESS(job->next->data);
+  job->next = job->next->next;
+
+  GSocketAddress * sockAddr = g_inet_socket_address_new(addr, job->port);
+
+  job->attempts++;
+
+  g_socket_client_connect_async(job->client, G_SOCKET_CONNECTABLE(sockAddr), job->cancel,
+    svConnectDirectDone, job);
+
+  g_object_unref(sockAddr);
+
+  // don't wait out a dead path's whole timeout before trying the next address
+  if (job->next)
+    job->staggerSource = g_timeout_add(SV_CONNECT_STAGGER_MS, svConnectDirectStagger, job);
+}
+
+
+/* start the next racing attempt once the current one has had a head start */
+gboolean svConnectDirectStagger (gpointer data)
+{
+  ConnectJob * job = (ConnectJob *)data;
+
+  job->staggerSource = 0;
+
+  if (!g_cancellable_is_cancelled(job->cancel))
+    svConnectDirectNext(job);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/* handle one of a direct vnc connection's racing tcp connects completing */
+void svConnectDirectDone (GObject * source, GAsyncResult * res, gpointer data)
+{
+  ConnectJob * job = (ConnectJob *)data;
+
+  job->attempts--;
+
+  GError * error = NULL;
+  GSocketConnection * sockCon = g_socket_client_connect_finish(G_SOCKET_CLIENT(source), res, &error);
+
+  // another attempt already won (or we were cancelled), so drop this one
+  if (sockCon && (job->done || g_cancellable_is_cancelled(job->cancel)))
+  {
+    g_object_unref(sockCon);
+    sockCon = NULL;
+  }
+
+  if (!sockCon)
+  {
+    if (error)
+    {
+      g_string_assign(job->lastError, error->message);
+      g_error_free(error);
+    }
+
+    // a failure starts the next address right away
+    if (!job->done && job->con && job->next && !g_cancellable_is_cancelled(job->cancel))
+      svConnectDirectNext(job);
+    // otherwise give up once every attempt has finished without a winner
+    else if (job->attempts == 0)
+    {
+      if (job->done)
+        svConnectJobFree(job);
+      else
+        svConnectDirectFail(job, job->lastError->len > 0 ? job->lastError->str : NULL);
+    }
+
+    return;
+  }
+
+  // first one in wins - stop the others
+  job->done = true;
+  job->next = NULL;
+  g_cancellable_cancel(job->cancel);
+
+  if (job->staggerSource > 0)
+  {
+    g_source_remove(job->staggerSource);
+    job->staggerSource = 0;
+  }
+
+  Connection * con = job->con;
+  const gboolean warm = job->warm;
+
+  svConnectJobDetach(job);
+
+  // losers still running clean the job up when they finish
+  if (job->attempts == 0)
+    svConnectJobFree(job);
+
+  if (!con)
+  {
+    g_object_unref(sockCon);
+    return;
+  }
+
+  // a pre-connect holds on to its socket until the connection is opened
+  if (warm)
+  {
+    svWarmHold(con, sockCon);
+    return;
+  }
+
+  if (!con->vncObj)
+  {
+    g_object_unref(sockCon);
+    return;
+  }
+
+  // a repeater needs to be told which server we want first
+  if (con->type == SV_TYPE_VNC_REPEATER)
+    svRepeaterStart(con, sockCon);
+  else
+    svConnectDirectAttach(con, sockCon);
+}
+
+
+/* hand a connected socket to a direct vnc connection's vnc obj (takes ownership of sockCon) */
+void svConnectDirectAttach (Connection * con, GSocketConnection * sockCon)
+{
+  GSocket * sock = g_socket_connection_get_socket(sockCon);
+
+  // log which address won
+  GSocketAddress * remote = g_socket_connection_get_remote_address(sockCon, NULL);
+
+  if (remote)
+  {
+    char * addrStr = g_inet_address_to_string(g_inet_socket_address_get_address(G_INET_SOCKET_ADDRESS(remote)));
+
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Connected '%s - %s' via %s", con->name->str, con->address->str, addrStr);
+    svLog(logStr->str, true);
+    g_string_free(logStr, true);
+
+    g_free(addrStr);
+    g_object_unref(remote);
+  }
+
+  if (con->liveTimeout > 0)
+    svSocketSetKeepalive(sock, con->liveTimeout);
+
+  // the vnc obj owns (and closes) its own copy of the socket
+  gint fd = svSocketDupFd(sock);
+
+  g_object_unref(sockCon);
+
+  if (fd < 0)
+  {
+    svServerError(NULL, "Unable to hand the connected socket to the viewer", con);
+    svServerDisconnected(con->vncObj);
+    return;
+  }
+
+  vnc_display_open_fd_with_hostname(VNC_DISPLAY(con->vncObj), fd, con->address->str);
+}
+
+
+/* finish a repeater handshake - hand the socket to the vnc obj, or report why not */
+void svRepeaterDone (RepeaterJob * job, const char * error)
+{
+  Connection * con = job->con;
+  GSocketConnection * sockCon = job->sockCon;
+
+  const gboolean cancelled = g_cancellable_is_cancelled(job->cancel);
+
+  g_object_unref(job->cancel);
+  g_free(job);
+
+  // (con is NULL if the connection was deleted during the handshake)
+  if (con)
+    con->repeaterJob = NULL;
+
+  if (!con || !con->vncObj)
+  {
+    g_object_unref(sockCon);
+    return;
+  }
+
+  if (error || cancelled)
+  {
+    g_object_unref(sockCon);
+
+    if (error && !cancelled)
+      svServerError(NULL, error, con);
+
+    svServerDisconnected(con->vncObj);
+    return;
+  }
+
+  // the repeater has joined us to the server, so the rest is ordinary rfb
+  svConnectDirectAttach(con, sockCon);
+}
+
+
+/* handle the repeater taking our session request */
+void svRepeaterRequestSent (GObject * source, GAsyncResult * res, gpointer data)
+{
+  RepeaterJob * job = (RepeaterJob *)data;
+
+  GError * error = NULL;
+
+  if (!g_output_stream_write_all_finish(G_OUTPUT_STREAM(source), res, NULL, &error))
+  {
+    svRepeaterDone(job, error->message);
+    g_error_free(error);
+    return;
+  }
+
+  svRepeaterDone(job, NULL);
+}
+
+
+/* handle the repeater's greeting, then ask it for our server */
+void svRepeaterGreeted (GObject * source, GAsyncResult * res, gpointer data)
+{
+  RepeaterJob * job = (RepeaterJob *)data;
+
+  GError * error = NULL;
+  gsize bytesRead = 0;
+
+  if (!g_input_stream_read_all_finish(G_INPUT_STREAM(source), res, &bytesRead, &error) ||
+    bytesRead != SV_PROBE_BANNER_LEN)
+  {
+    svRepeaterDone(job, error ? error->message : "The repeater closed the connection");
+
+    if (error)
+      g_error_free(error);
+
+    return;
+  }
+
+  // repeaters greet viewers with a zero version - a real version means a vnc server answered
+  if (memcmp(job->greeting, "RFB 000.000\n", SV_PROBE_BANNER_LEN) != 0)
+  {
+    svRepeaterDone(job, "This address isn't a VNC repeater (a VNC server answered)");
+    return;
+  }
+
+  // the request is a fixed-size, zero-padded 'ID:nnnn' (or 'host:port' for the server to reach)
+  memset(job->request, 0, sizeof(job->request));
+
+  const char * id = job->con ? job->con->repeaterId->str : "";
+  gboolean numeric = (id[0] != '\0');
+
+  for (const char * c = id; *c; c++)
+    if (!g_ascii_isdigit(*c))
+      numeric = false;
+
+  g_snprintf(job->request, sizeof(job->request), numeric ? "ID:%s" : "%s", id);
+
+  GOutputStream * out = g_io_stream_get_output_stream(G_IO_STREAM(job->sockCon));
+
+  g_output_stream_write_all_async(out, job->request, SV_REPEATER_REQUEST_LEN, G_PRIORITY_DEFAULT,
+    job->cancel, svRepeaterRequestSent, job);
+}
+
+
+/* start the repeater handshake on a connected socket (takes ownership of sockCon) */
+void svRepeaterStart (Connection * con, GSocketConnection * sockCon)
+{
+  RepeaterJob * job = g_new0(RepeaterJob, 1);
+  job->con = con;
+  job->sockCon = sockCon;
+  job->cancel = g_cancellable_new();
+
+  con->repeaterJob = job;
+
+  GInputStream * in = g_io_stream_get_input_stream(G_IO_STREAM(sockCon));
+
+  g_input_stream_read_all_async(in, job->greeting, SV_PROBE_BANNER_LEN, G_PRIORITY_DEFAULT,
+    job->cancel, svRepeaterGreeted, job);
+}
+
+
+/* handle a direct vnc connection's host name being resolved */
+void svConnectDirectResolved (GList * addrs, const char * error, gint64 usecs, gpointer data)
+{
+  ConnectJob * job = (ConnectJob *)data;
+
+  if (!job->con || !addrs || g_cancellable_is_cancelled(job->cancel))
+  {
+    svConnectDirectFail(job, error);
+    return;
+  }
+
+  job->con->resolveTime = usecs;
+
+  // race the addresses in our own copy, the cache may replace its list while we're connecting
+  job->addrs = svConnectInterleave(addrs);
+  job->next = job->addrs;
+
+  svConnectDirectNext(job);
+}
+
+
+/* set up an app-managed connect for a direct vnc connection */
+ConnectJob * svConnectJobNew (Connection * con)
+{
+  ConnectJob * job = g_new0(ConnectJob, 1);
+  job->con = con;
+  job->port = (con->vncPort->len > 0) ? atoi(con->vncPort->str) : 5900;
+  job->cancel = g_cancellable_new();
+  job->client = g_socket_client_new();
+  job->lastError = g_string_new(NULL);
+
+  g_socket_client_set_timeout(job->client, MAX(app->vncConnectWaitTime, 1));
+
+  return job;
+}
+
+
+/* connect a direct vnc connection's socket ourselves, using the shared resolver cache */
+void svConnectDirect (Connection * con)
+{
+  // a pre-connected socket the server hasn't hung up on attaches right away
+  if (con->warmSock)
+  {
+    GSocketConnection * sockCon = con->warmSock;
+    con->warmSock = NULL;
+    svWarmDrop(con);
+
+    if (g_socket_condition_check(g_socket_connection_get_socket(sockCon), G_IO_HUP | G_IO_ERR) == 0)
+    {
+      svConnectDirectAttach(con, sockCon);
+      return;
+    }
+
+    g_object_unref(sockCon);
+  }
+
+  // a pre-connect still under way becomes the real thing
+  if (con->warmJob)
+  {
+    ConnectJob * job = con->warmJob;
+    con->warmJob = NULL;
+
+    job->warm = false;
+    con->connectJob = job;
+    return;
+  }
+
+  ConnectJob * job = svConnectJobNew(con);
+
+  con->connectJob = job;
+
+  svDnsResolve(con->address->str, svConnectDirectResolved, job);
+}
+
+
+/* drop a connection's pre-connected socket, or stop its pre-connect */
+void svWarmDrop (Connection * con)
+{
+  if (!con)
+    return;
+
+  if (con->warmSource > 0)
+  {
+    g_source_remove(con->warmSource);
+    con->warmSource = 0;
+  }
+
+  if (con->warmSock)
+  {
+    g_io_stream_close(G_IO_STREAM(con->warmSock), NULL, NULL);
+    g_object_unref(con->warmSock);
+    con->warmSock = NULL;
+  }
+
+  if (con->warmJob)
+  {
+    con->warmJob->con = NULL;
+    g_cancellable_cancel(con->warmJob->cancel);
+    con->warmJob = NULL;
+  }
+}
+
+
+/* handle an unused pre-connected socket running out of time */
+gboolean svWarmExpire (gpointer data)
+{
+  Connection * con = (Connection *)data;
+
+  con->warmSource = 0;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Pre-connection to '%s - %s' unused, closing", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  svWarmDrop(con);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/* hold a pre-connected socket for a while, in case the connection is opened */
+void svWarmHold (Connection * con, GSocketConnection * sockCon)
+{
+  svWarmDrop(con);
+
+  con->warmSock = sockCon;
+  con->warmSource = g_timeout_add_seconds(SV_WARM_HOLD_SECS, svWarmExpire, con);
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Pre-connected to '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+}
+
+
+/* speculatively resolve and connect a connection that's likely to be opened soon */
+void svWarmStart (Connection * con)
+{
+  // (only direct vnc - ssh tunnels are started by their own thread when connecting)
+  if (!app->preconnect || !con || con->type != SV_TYPE_VNC || con->address->len == 0 ||
+    con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING ||
+    con->warmSock || con->warmJob)
+    return;
+
+  ConnectJob * job = svConnectJobNew(con);
+  job->warm = true;
+
+  con->warmJob = job;
+
+  svDnsResolve(con->address->str, svConnectDirectResolved, job);
+}
+
+
+/* pre-connect a connection once the pointer has rested on it for a moment */
+gboolean svWarmHoverTimer (gpointer data)
+{
+  app->warmHoverSource = 0;
+
+  svWarmStart(app->warmHoverCon);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/* handle the pointer moving over the connection list */
+gboolean svHandleConnectionListMotion (GtkWidget * widget, GdkEventMotion * event, gpointer data)
+{
+  if (!app->preconnect)
+    return false;
+
+  GtkListBoxRow * row = gtk_list_box_get_row_at_y(GTK_LIST_BOX(app->serverList), event->y);
+  GtkWidget * rowBox = row ? gtk_bin_get_child(GTK_BIN(row)) : NULL;
+  Connection * con = rowBox ? g_object_get_data(G_OBJECT(rowBox), "con") : NULL;
+
+  if (con == app->warmHoverCon)
+    return false;
+
+  // moved to another row - start waiting again
+  app->warmHoverCon = con;
+
+  if (app->warmHoverSource > 0)
+  {
+    g_source_remove(app->warmHoverSource);
+    app->warmHoverSource = 0;
+  }
+
+  if (con)
+    app->warmHoverSource = g_timeout_add(SV_WARM_HOVER_MS, svWarmHoverTimer, NULL);
+
+  return false;
+}
+
+
+/* stop waiting to pre-connect once the pointer leaves the connection list */
+gboolean svHandleConnectionListLeave (GtkWidget * widget, GdkEventCrossing * event, gpointer data)
+{
+  // (moving onto something inside the list isn't leaving it)
+  if (event->detail == GDK_NOTIFY_INFERIOR)
+    return false;
+
+  app->warmHoverCon = NULL;
+
+  if (app->warmHoverSource > 0)
+  {
+    g_source_remove(app->warmHoverSource);
+    app->warmHoverSource = 0;
+  }
+
+  return false;
+}
+
+
+/* cancel a connection's app-managed tcp connect, if any */
+/* (forget also stops the result from touching con, for when it's being freed) */
+void svConnectDirectCancel (Connection * con, gboolean forget)
+{
+  if (!con)
+    return;
+
+  // (a repeater handshake is the tail end of the same connect)
+  if (con->repeaterJob)
+  {
+    RepeaterJob * repeaterJob = con->repeaterJob;
+
+    if (forget)
+    {
+      repeaterJob->con = NULL;
+      con->repeaterJob = NULL;
+    }
+
+    g_cancellable_cancel(repeaterJob->cancel);
+  }
+
+  if (!con->connectJob)
+    return;
+
+  ConnectJob * job = con->connectJob;
+
+  if (forget)
+  {
+    job->con = NULL;
+    con->connectJob = NULL;
+  }
+
+  g_cancellable_cancel(job->cancel);
+}
+
+
+/* send a connection's latest queued pointer position, if there is one */
+void svPointerFlush (Connection * con)
+{
+  if (!con->pointerPending || !con->vncObj)
+    return;
+
+  con->pointerPending = false;
+
+  VncConnection * vncCon = vnc_display_get_connection(VNC_DISPLAY(con->vncObj));
+
+  if (vncCon)
+    vnc_connection_pointer_event(vncCon, con->pointerMask, con->pointerX, con->pointerY);
+}
+
+
+/* stop a connection's pointer coalescing timer, dropping anything queued */
+void svPointerCancel (Connection * con)
+{
+  if (con->pointerSource > 0)
+  {
+    g_source_remove(con->pointerSource);
+    con->pointerSource = 0;
+  }
+
+  con->pointerPending = false;
+  con->rttProbeSent = 0;
+}
+
+
+/* how long to hold pointer motion for a connection (about half its round trip) */
+guint svPointerInterval (const Connection * con)
+{
+  const gint64 rtt = con->rttEstimate > 0 ? con->rttEstimate : con->probeRtt;
+
+  if (rtt <= 0)
+    return SV_POINTER_DEFAULT_MS;
+
+  return CLAMP(rtt / 2000, SV_POINTER_MIN_MS, SV_POINTER_MAX_MS);
+}
+
+
+/* send what's queued once the interval is up, and keep going while the pointer keeps moving */
+gboolean svPointerTimer (gpointer data)
+{
+  Connection * con = (Connection *)data;
+
+  if (!con->pointerPending)
+  {
+    con->pointerSource = 0;
+    return G_SOURCE_REMOVE;
+  }
+
+  svPointerFlush(con);
+
+  // (the round trip may have changed)
+  con->pointerSource = g_timeout_add(svPointerInterval(con), svPointerTimer, con);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/* time a tiny update request now and then, to see how far away the server is */
+/* (answered by the next update covering the top-left pixel - see svHandleServerActivity) */
+void svPointerRttProbe (Connection * con)
+{
+  const gint64 now = g_get_monotonic_time();
+
+  // (a lost answer doesn't stop the next try)
+  if (con->rttProbeSent > 0 && now - con->rttProbeSent < SV_POINTER_RTT_SECS * G_USEC_PER_SEC)
+    return;
+
+  if (con->rttProbeLast > 0 && now - con->rttProbeLast < SV_POINTER_RTT_SECS * G_USEC_PER_SEC)
+    return;
+
+  VncConnection * vncCon = vnc_display_get_connection(VNC_DISPLAY(con->vncObj));
+
+  if (!vncCon)
+    return;
+
+  con->rttProbeSent = now;
+  con->rttProbeLast = now;
+
+  vnc_connection_framebuffer_update_request(vncCon, false, 0, 0, 1, 1);
+}
+
+
+/* queue a pointer position for a connection - sent right away when a button changes or nothing */
+/* was sent lately, otherwise only the latest position goes, once per interval */
+void svPointerQueue (Connection * con, gint x, gint y, guint mask)
+{
+  if (!con->vncObj)
+    return;
+
+  const gboolean buttonsChanged = (mask != con->pointerMask);
+
+  con->pointerX = x;
+  con->pointerY = y;
+  con->pointerMask = mask;
+  con->pointerPending = true;
+
+  if (!con->coalescePointer || buttonsChanged)
+  {
+    svPointerFlush(con);
+    return;
+  }
+
+  svPointerRttProbe(con);
+
+  // (already waiting - this position replaces the last one)
+  if (con->pointerSource > 0)
+    return;
+
+  svPointerFlush(con);
+  con->pointerSource = g_timeout_add(svPointerInterval(con), svPointerTimer, con);
+}
+
+
+/* whether we send a connection's pointer events ourselves, instead of leaving them to the display */
+/* (relative pointer mode needs the display's own grab handling) */
+gboolean svPointerOwned (const Connection * con)
+{
+  return con->coalescePointer && !con->viewOnly && !con->tileMuted &&
+    vnc_display_is_pointer_absolute(VNC_DISPLAY(con->vncObj));
+}
+
+
+/* turn a spot on a vnc display widget into a spot on the remote screen */
+/* (false if the display has no screen yet) */
+gboolean svPointerPosition (GtkWidget * vncObj, gdouble eventX, gdouble eventY, gint * x, gint * y)
+{
+  const gint fbWidth = vnc_display_get_width(VNC_DISPLAY(vncObj));
+  const gint fbHeight = vnc_display_get_height(VNC_DISPLAY(vncObj));
+
+  if (fbWidth <= 0 || fbHeight <= 0)
+    return false;
+
+  // where the display draws the screen (centered, and fitted when scaling)
+  const gint areaWidth = gtk_widget_get_allocated_width(vncObj);
+  const gint areaHeight = gtk_widget_get_allocated_height(vncObj);
+
+  gdouble scale = 1.0;
+
+  if (vnc_display_get_scaling(VNC_DISPLAY(vncObj)))
+    scale = MIN((gdouble)areaWidth / fbWidth, (gdouble)areaHeight / fbHeight);
+
+  const gdouble offX = MAX(0, (areaWidth - fbWidth * scale) / 2);
+  const gdouble offY = MAX(0, (areaHeight - fbHeight * scale) / 2);
+
+  *x = CLAMP((eventX - offX) / scale, 0, fbWidth - 1);
+  *y = CLAMP((eventY - offY) / scale, 0, fbHeight - 1);
+
+  return true;
+}
+
+
+/* handle the pointer moving over a vnc display (runs ahead of the display's own handling, */
+/* and takes over from it for connections that coalesce motion) */
+gboolean svHandlePointerMotion (GtkWidget * vncObj, GdkEventMotion * event, gpointer data)
+{
+  Connection * con = (Connection *)data;
+  gint x, y;
+
+  if (!svPointerOwned(con) || !svPointerPosition(vncObj, event->x, event->y, &x, &y))
+    return false;
+
+  // (gdk's buttons 1, 2 and 3 are rfb's left, middle and right - bits 1, 2 and 4)
+  guint mask = 0;
+
+  if (event->state & GDK_BUTTON1_MASK)
+    mask |= 1;
+  if (event->state & GDK_BUTTON2_MASK)
+    mask |= 2;
+  if (event->state & GDK_BUTTON3_MASK)
+    mask |= 4;
+
+  svPointerQueue(con, x, y, mask);
+
+  return true;
+}
+
+
+/* handle a button or wheel over a vnc display - any held-back motion has to go first */
+/* (when we've been sending the motion, the display never saw where the pointer went, */
+/* so the buttons have to come from us too) */
+gboolean svHandlePointerButton (GtkWidget * vncObj, GdkEvent * event, gpointer data)
+{
+  Connection * con = (Connection *)data;
+  gdouble eventX, eventY;
+  gint x, y;
+
+  if (con->pointerSource > 0)
+  {
+    g_source_remove(con->pointerSource);
+    con->pointerSource = 0;
+  }
+
+  svPointerFlush(con);
+
+  if (!svPointerOwned(con) || !gdk_event_get_coords(event, &eventX, &eventY) ||
+    !svPointerPosition(vncObj, eventX, eventY, &x, &y))
+    return false;
+
+  if (event->type == GDK_SCROLL)
+  {
+    GdkScrollDirection direction;
+    gdouble deltaX = 0, deltaY = 0;
+    guint bit = 0;
+
+    if (!gdk_event_get_scroll_direction(event, &direction))
+    {
+      // (a smooth scroll goes the way it mostly moved)
+      gdk_event_get_scroll_deltas(event, &deltaX, &deltaY);
+
+      if (deltaX == 0 && deltaY == 0)
+        return true;
+      else if (ABS(deltaY) >= ABS(deltaX))
+        direction = (deltaY < 0 ? GDK_SCROLL_UP : GDK_SCROLL_DOWN);
+      else
+        direction = (deltaX < 0 ? GDK_SCROLL_LEFT : GDK_SCROLL_RIGHT);
+    }
+
+    switch (direction)
+    {
+      case GDK_SCROLL_UP:
+        bit = 8;
+        break;
+      case GDK_SCROLL_DOWN:
+        bit = 16;
+        break;
+      case GDK_SCROLL_LEFT:
+        bit = 32;
+        break;
+      case GDK_SCROLL_RIGHT:
+        bit = 64;
+        break;
+      default:
+        return true;
+    }
+
+    // (the wheel is a press and release of its 'button')
+    svPointerQueue(con, x, y, con->pointerMask | bit);
+    svPointerQueue(con, x, y, con->pointerMask & ~bit);
+
+    return true;
+  }
+
+  const guint button = event->button.button;
+
+  // (double and triple clicks come as plain presses too)
+  if (button < 1 || button > 3 || (event->type != GDK_BUTTON_PRESS && event->type != GDK_BUTTON_RELEASE))
+    return true;
+
+  // (gdk's buttons 1, 2 and 3 are rfb's left, middle and right - bits 1, 2 and 4)
+  const guint bit = (button == 1 ? 1 : button == 2 ? 2 : 4);
+
+  if (event->type == GDK_BUTTON_PRESS)
+  {
+    gtk_widget_grab_focus(vncObj);
+    svPointerQueue(con, x, y, con->pointerMask | bit);
+  }
+  else
+    svPointerQueue(con, x, y, con->pointerMask & ~bit);
+
+  return true;
+}
+
+
+/* note that a connection's server is alive */
+void svHandleServerActivity (VncConnection * unused1, guint x, guint y,
+  guint width, guint height, gpointer data)
+{
+  Connection * con = (Connection *)data;
+
+  if (!con)
+    return;
+
+  const gint64 now = g_get_monotonic_time();
+
+  con->lastActivity = now;
+
+  // the answer to a pointer-timing probe (an update covering the top-left pixel - close enough)
+  if (con->rttProbeSent > 0 && x == 0 && y == 0)
+  {
+    const gint64 sample = now - con->rttProbeSent;
+
+    con->rttEstimate = (con->rttEstimate > 0) ? (con->rttEstimate * 3 + sample) / 4 : sample;
+    con->rttProbeSent = 0;
+  }
+
+  // something may be waiting for the screen to show an image
+  if (con->matchWaits)
+    svMatchSchedule(con);
+
+  // other programs may be watching it
+  if (con->shm)
+    svShmDirty(con, x, y, width, height);
+
+  // a command-line screenshot is waiting for the screen to arrive
+  if (con->shotCmdLine && con->shotSource == 0 && con->state == SV_STATE_CONNECTED)
+    con->shotSource = g_timeout_add(SV_SHOT_SETTLE_MS, svRemoteShotSettle, con);
+
+  // so is a batch run
+  if (con->batchItem && con->state == SV_STATE_CONNECTED)
+    svBatchScreenProgress(con, x, y, width, height);
+}
+
+
+/* dead-peer watchdog - ask for a tiny update when the server has been quiet, */
+/* and drop the connection if it stays quiet past its deadline */
+gboolean svWatchdogTimer (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con)
+    return G_SOURCE_REMOVE;
+
+  if (!con->vncObj || con->state != SV_STATE_CONNECTED || con->liveTimeout == 0)
+  {
+    con->watchdogSource = 0;
+    return G_SOURCE_REMOVE;
+  }
+
+  const gint64 quiet = g_get_monotonic_time() - con->lastActivity;
+
+  // past the deadline - give up on it
+  if (quiet >= (gint64)con->liveTimeout * G_USEC_PER_SEC)
+  {
+    g_string_printf(con->lastErrorMessage, "No response from the server for %u seconds",
+      con->liveTimeout);
+
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Connection '%s - %s' is stale: %s", con->name->str, con->address->str,
+      con->lastErrorMessage->str);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+
+    if (con == app->selectedConnection)
+      gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, con->lastErrorMessage->str, -1);
+
+    con->watchdogSource = 0;
+    con->disconnectType = SV_DISC_STALE;
+
+    vnc_display_close(VNC_DISPLAY(con->vncObj));
+
+    return G_SOURCE_REMOVE;
+  }
+
+  // quiet for a while - a non-incremental request for one pixel always gets an answer
+  if (quiet >= (gint64)MAX(con->liveTimeout / 3, 1) * G_USEC_PER_SEC)
+  {
+    VncConnection * vncCon = vnc_display_get_connection(VNC_DISPLAY(con->vncObj));
+
+    if (vncCon)
+      vnc_connection_framebuffer_update_request(vncCon, false, 0, 0, 1, 1);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+/* start a connection's dead-peer watchdog, if it has a deadline */
+void svWatchdogStart (Connection * con)
+{
+  if (!con || !con->vncObj || con->liveTimeout == 0 || con->watchdogSource > 0)
+    return;
+
+  // (screen updates are tracked from svServerInitialized on)
+  con->watchdogSource = g_timeout_add_seconds(MAX(con->liveTimeout / 3, 1), svWatchdogTimer, con);
+}
+
+
+/* stop a connection's dead-peer watchdog */
+void svWatchdogStop (Connection * con)
+{
+  if (!con || con->watchdogSource == 0)
+    return;
+
+  g_source_remove(con->watchdogSource);
+  con->watchdogSource = 0;
+}
+
+
+/* handle vnc obj initialize event (fully connected) */
+void svServerInitialized (GtkWidget * vncObj)
+{
+  Connection * con = svConnectionFromVNCObj(vncObj);
+  if (!con)
+    return;
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Server initialized (fully connected) '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  con->state = SV_STATE_CONNECTED;
+  svSetIconFromConnectionName(con->name->str, con->state);
+
+  // connected again, so start any future auto-reconnects from scratch
+  svReconnectCancel(con, true);
+
+  if (con->batchItem)
+    con->batchItem->connectTime = g_get_monotonic_time();
+
+  // keep track of screen updates, whatever the dead-peer setting (command-line screenshots wait on them,
+  // and so do the watchdog, screen waits, sharing, batch runs, tiles and pointer timing)
+  con->lastActivity = g_get_monotonic_time();
+  g_signal_connect(vnc_display_get_connection(VNC_DISPLAY(vncObj)), "vnc-framebuffer-update",
+    G_CALLBACK(svHandleServerActivity), con);
+
+  // (a new session's round trip is measured afresh)
+  con->rttEstimate = 0;
+  con->rttProbeSent = 0;
+  con->rttProbeLast = 0;
+
+  // start watching for a dead peer
+  svWatchdogStart(con);
+
+  // account for this session's framebuffer, and make room for it if needed
+  con->fbBytes = svFbBytes(vncObj);
+  con->lastViewed = g_get_monotonic_time();
+  svFbBudgetEnforce();
+
+  // add the vnc obj to the display stack
+  gtk_stack_add_named(GTK_STACK(app->displayStack), vncObj, con->name->str);
+
+  // set last connected time
+  GDateTime * now = g_date_time_new_now_local();
+
+  char * nowStr = g_date_time_format(now, "%H:%M:%S--%Y-%m-%d");  // <<<--- do NOT make const char *
+  g_string_assign(con->lastConnectTime, nowStr);
+  g_free(nowStr);
+
+  // change listening display text and name to actual remote name, if available
+  if (con->type == SV_TYPE_VNC_REVERSE)
+  {
+    const char * remoteName = vnc_display_get_name(VNC_DISPLAY(vncObj));
+
+    if (remoteName && remoteName[0] != '\0')
+    {
+      // make a unique name from the remote name and time
+      GString * fullRemoteName = svReverseUniqueName(remoteName);
+
+      svSetTextFromConnectionName(con->name->str, fullRemoteName->str);
+      g_string_assign(con->name, fullRemoteName->str);
+      g_string_free(fullRemoteName, true);
+    }
+  }
+
+  g_date_time_unref(now);
+
+  // share the screen with other programs, if enabled (after any rename, since the name is in it)
+  if (app->shmExport)
+    svShmOpen(con, vnc_display_get_width(VNC_DISPLAY(vncObj)), vnc_display_get_height(VNC_DISPLAY(vncObj)));
+
+  // update tooltips info
+  svSetHostlistItemsTooltips();
+
+  // fit the remote desktop to where it's shown, if set to
+  con->resizeWidth = 0;
+  con->resizeHeight = 0;
+  svRemoteResizeSoon(con);
+
+  // only show newly-connected server if the listitem is selected
+  const char * selectedRowText = svSelectedRowText();
+
+  if (selectedRowText && strcmp(con->name->str, selectedRowText) == 0)
+  {
+    // set 'last connected' label text
+    if (con->lastConnectTime->len > 0)
+    {
+      GString * strTime = g_string_new(NULL);
+      g_string_printf(strTime, "Last connected: %s", con->lastConnectTime->str);
+      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), strTime->str);
+      g_string_free(strTime, true);
+    }
+    else
+      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), "-");
+
+    // show the remote server screen
+    gtk_widget_show(vncObj);
+    gtk_stack_set_visible_child(GTK_STACK(app->displayStack), vncObj);
+
+    // set keyboard focus
+    gtk_widget_set_can_focus(vncObj, true);
+    // tell the parent container that THIS is the focus child
+    gtk_container_set_focus_child(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
+    gtk_container_set_focus_child(GTK_CONTAINER(app->displayStack), vncObj);
+
+    /* Attempt to focus the vnc display. Unfortunately we have to get a little 'creative'
+     * here and try two different ways (because the idle_add doesn't always work)
+     */
+
+    // try to focus the vnc display at idle time
+    g_idle_add((GSourceFunc)svFocusOnce, vncObj);
+    // try to focus the vnc display (again) after 300 milliseconds
+    g_timeout_add_once(300, (GSourceOnceFunc)gtk_widget_grab_focus, vncObj);
+
+    gtk_widget_grab_focus(vncObj);
+
+    // set tools menu items
+    svSetToolsMenuItems(true);
+  }
+}
+
+
+/* handle vnc obj authentication event */
+void svServerAuthenticate (VncDisplay * display, GValueArray * credList)
+{
+  const char ** data = g_new0(const char *, credList->n_values);
+  gsize outLen = 0;
+  gboolean hasUsername = false;
+
+  Connection * con = svConnectionFromVNCObj(GTK_WIDGET(display));
+
+  // if connection is null, close the connection and get out
+  if (!con)
+  {
+    vnc_display_close(display);
+    svLog("svServerAuthenticate - ERROR: con is null", false);
+    return;
+  }
+
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Server authentication '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+
+  // set vnc login username, if any
+  const char * loginUser = con->vncLoginUser->str;
+
+  // decode vnc and login passwords, if any
+  unsigned char * vncPass = g_base64_decode(con->vncPass->str, &outLen);
+  unsigned char * loginPass = g_base64_decode(con->vncLoginPass->str, &outLen);
+
+  // loop through requested credentials and set each
+  for (guint i = 0 ; i < credList->n_values ; i++)
+  {
+    GValue * cred = credList->values + i; //1;
+
+    switch (g_value_get_enum(cred))
+    {
+      case VNC_DISPLAY_CREDENTIAL_USERNAME:
+        hasUsername = true;
+        data[i] = (char *)loginUser;
+        svLog("Credential 'Username'", true);
+        break;
+      case VNC_DISPLAY_CREDENTIAL_PASSWORD:
+      {
+        if (hasUsername)
+          data[i] = (char *)loginPass;
+        else
+          data[i] = (char *)vncPass;
+        svLog("Credential 'Password'", true);
+      }
+      break;
+      case VNC_DISPLAY_CREDENTIAL_CLIENTNAME:
+          data[i] = "spiritvncgtk";
+          svLog("Credential 'Client Name'", true);
+          break;
+      default:
+          break;
+    }
+  }
+
+  // loop through requested credentials and send data for each
+  for (guint i = 0 ; i < credList->n_values ; i++)
+  {
+    GValue * cred = credList->values + i; //1;
+
+    if (data[i])
+    {
+      if (vnc_display_set_credential(VNC_DISPLAY(display), g_value_get_enum(cred), data[i]))
+      {
+        // log
+        g_string_printf(logStr, "Failed to set credential type '%d'", g_value_get_enum(cred));
+        svLog(logStr->str, false);
+
+        vnc_display_close(VNC_DISPLAY(display));
+        con->state = SV_STATE_DISCONNECTED;
+      }
+    }
+    else
+    {
+      // log
+      g_string_printf(logStr, "Unsupported credential type '%d'", g_value_get_enum(cred));
+      svLog(logStr->str, false);
+
+      vnc_display_close(VNC_DISPLAY(display));
+      con->state = SV_STATE_DISCONNECTED;
+    }
+  }
+
+  g_string_free(logStr, true);
+  g_free(vncPass);
+  g_free(loginPass);
+  g_free(data);
+}
+
+
+/* saves the last selected connection's quicknote text */
+/* (usually before switching to another connection) */
+void svSavePreviousQuickNoteText (const Connection * newConnection)
+{
+  // save previous quicknote before switching
+  Connection * prevCon = app->selectedConnection;
+
+  if (!prevCon || prevCon == newConnection)
+    return;
+
+  if (!prevCon->name || prevCon->name->len == 0)
+    return;
+
+  // quickNoteBuffer must exist
+  if (!app->quickNoteBuffer)
+    return;
+
+  // prevCon->quickNote must exist
+  if (!prevCon->quickNote)
+    return;
+
+  GtkTextIter start;
+  GtkTextIter end;
+
+  gtk_text_buffer_get_start_iter(app->quickNoteBuffer, &start);
+  gtk_text_buffer_get_end_iter(app->quickNoteBuffer, &end);
+
+  char * qText = gtk_text_buffer_get_text(app->quickNoteBuffer, &start, &end, false);
+  if (!qText)
+    return;
+
+  char * encoded = g_base64_encode((const unsigned char *)qText, strlen(qText));
+  g_string_assign(prevCon->quickNote, encoded);
+
+  g_free(encoded);
+  g_free(qText);
+}
+
+
+/* clipboard store hash function */
+guint svClipTextHash (gconstpointer key)
+{
+  return ((const ClipText *)key)->hash;
+}
+
+
+/* clipboard store equality function */
+gboolean svClipTextEqual (gconstpointer a, gconstpointer b)
+{
+  const ClipText * ctA = (const ClipText *)a;
+  const ClipText * ctB = (const ClipText *)b;
+
+  if (ctA == ctB)
+    return true;
+
+  return ctA->hash == ctB->hash && g_bytes_equal(ctA->bytes, ctB->bytes);
+}
+
+
+/* get a reference to the stored copy of some clipboard text, storing it if it's new */
+ClipText * svClipTextRef (const char * text, gsize len)
+{
+  // look up with the caller's buffer so duplicate text is never copied
+  ClipText key;
+  key.bytes = g_bytes_new_static(text, len + 1);
+  key.hash = g_bytes_hash(key.bytes);
+
+  ClipText * ct = (ClipText *)g_hash_table_lookup(app->clipStore, &key);
+
+  if (!ct)
+  {
+    ct = g_new0(ClipText, 1);
+    ct->bytes = g_bytes_new(text, len + 1);
+    ct->hash = key.hash;
+
+    g_hash_table_add(app->clipStore, ct);
+    app->clipBytes += len + 1;
+  }
+
+  g_bytes_unref(key.bytes);
+
+  ct->refs++;
+
+  return ct;
+}
+
+
+/* release a reference to stored clipboard text, freeing it when unused */
+void svClipTextUnref (ClipText * ct)
+{
+  if (!ct || --ct->refs > 0)
+    return;
+
+  g_hash_table_remove(app->clipStore, ct);
+  app->clipBytes -= g_bytes_get_size(ct->bytes);
+
+  g_bytes_unref(ct->bytes);
+  g_free(ct);
+}
+
+
+/* remove a clipboard history entry by its queue link */
+void svClipHistoryDeleteLink (GList * link)
+{
+  ClipEntry * entry = (ClipEntry *)link->data;
+
+  g_queue_delete_link(app->clipHistory, link);
+
+  svClipTextUnref(entry->text);
+  g_free(entry);
+}
+
+
+/* drop the oldest clipboard history entries until the store fits its memory cap */
+void svClipHistoryTrim (const ClipEntry * keep)
+{
+  const gsize maxBytes = (gsize)app->clipHistoryKB * 1024;
+
+  GList * l = app->clipHistory->tail;
+
+  while (l && app->clipBytes > maxBytes)
+  {
+    GList * prev = l->prev;
+
+    // never drop the entry that was just added
+    if (l->data != keep)
+      svClipHistoryDeleteLink(l);
+
+    l = prev;
+  }
+}
+
+
+/* add server clipboard text to a connection's clipboard history */
+void svClipHistoryAdd (Connection * con, const char * text)
+{
+  if (!con || !text)
+    return;
+
+  ClipText * ct = svClipTextRef(text, strlen(text));
+
+  guint count = 0;
+
+  // drop this connection's older copy of the same text and anything past its history limit
+  for (GList * l = app->clipHistory->head; l;)
+  {
+    GList * next = l->next;
+    const ClipEntry * entry = (const ClipEntry *)l->data;
+
+    if (entry->con == con)
+    {
+      if (entry->text == ct || count >= SV_CLIP_HISTORY_MAX - 1)
+        svClipHistoryDeleteLink(l);
+      else
+        count++;
+    }
+
+    l = next;
+  }
+
+  // newest entries go to the head
+  ClipEntry * entry = g_new0(ClipEntry, 1);
+  entry->con = con;
+  entry->text = ct;
+
+  g_queue_push_head(app->clipHistory, entry);
+
+  svClipHistoryTrim(entry);
+}
+
+
+/* remove all of a connection's clipboard history */
+void svClipHistoryRemove (const Connection * con)
+{
+  for (GList * l = app->clipHistory->head; l;)
+  {
+    GList * next = l->next;
+
+    if (((const ClipEntry *)l->data)->con == con)
+      svClipHistoryDeleteLink(l);
+
+    l = next;
+  }
+}
+
+
+/* get a connection's most recent clipboard text, or NULL */
+GBytes * svClipLatest (const Connection * con)
+{
+  for (GList * l = app->clipHistory->head; l; l = l->next)
+  {
+    const ClipEntry * entry = (const ClipEntry *)l->data;
+
+    if (entry->con == con)
+      return entry->text->bytes;
+  }
+
+  return NULL;
+}
+
+
+/* build a short, single-line menu label for clipboard text */
+GString * svClipPreview (GBytes * bytes)
+{
+  const gsize size = g_bytes_get_size(bytes) - 1;
+  const char * text = (const char *)g_bytes_get_data(bytes, NULL);
+
+  // only look at as much text as the label can show
+  char * valid = g_utf8_make_valid(text, MIN(size, SV_CLIP_PREVIEW_CHARS * 4));
+
+  GString * preview = g_string_new(NULL);
+
+  const char * p = valid;
+
+  for (guint i = 0; *p && i < SV_CLIP_PREVIEW_CHARS; i++, p = g_utf8_next_char(p))
+  {
+    gunichar c = g_utf8_get_char(p);
+    g_string_append_unichar(preview, g_unichar_isspace(c) ? ' ' : c);
+  }
+
+  if (*p || size > SV_CLIP_PREVIEW_CHARS * 4)
+    g_string_append(preview, "...");
+
+  g_free(valid);
+
+  char * strSize = g_format_size(size);
+  g_string_append_printf(preview, "  (%s)", strSize);
+  g_free(strSize);
+
+  return preview;
+}
+
+
+/* local clipboard 'get' callback for large text */
+void svClipLazyGet (GtkClipboard * cb, GtkSelectionData * selData, guint info, gpointer data)
+{
+  GBytes * bytes = (GBytes *)data;
+
+  gtk_selection_data_set_text(selData, (const char *)g_bytes_get_data(bytes, NULL),
+    g_bytes_get_size(bytes) - 1);
+}
+
+
+/* local clipboard 'clear' callback for large text */
+void svClipLazyClear (GtkClipboard * cb, gpointer data)
+{
+  g_bytes_unref((GBytes *)data);
+}
+
+
+/* set the local clipboard to stored clipboard text */
+void svClipSetLocal (GBytes * bytes)
+{
+  GtkClipboard * cb = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+
+  if (!bytes || !cb)
+    return;
+
+  const gsize len = g_bytes_get_size(bytes) - 1;
+
+  // small text is handed over as-is so it survives us quitting
+  if (len < SV_CLIP_LAZY_BYTES)
+  {
+    gtk_clipboard_set_text(cb, (const char *)g_bytes_get_data(bytes, NULL), len);
+    return;
+  }
+
+  // large text is only offered, and converted when something actually pastes it
+  GtkTargetList * targetList = gtk_target_list_new(NULL, 0);
+  gtk_target_list_add_text_targets(targetList, 0);
+
+  gint nTargets = 0;
+  GtkTargetEntry * targets = gtk_target_table_new_from_list(targetList, &nTargets);
+
+  if (!gtk_clipboard_set_with_data(cb, targets, nTargets, svClipLazyGet, svClipLazyClear,
+    g_bytes_ref(bytes)))
+    g_bytes_unref(bytes);
+
+  gtk_target_table_free(targets, nTargets);
+  gtk_target_list_unref(targetList);
+}
+
+
+/* convert utf-8 text to latin-1 for the rfb clipboard, or NULL if it can't be */
+char * svClipToLatin1 (const char * text)
+{
+  return g_convert(text, -1, "ISO-8859-1", "UTF-8", NULL, NULL, NULL);
+}
+
+
+/* send local clipboard text to a connection */
+void svClipSendText (Connection * con, const char * text, gboolean force)
+{
+  if (!con || !text || !con->vncObj || con->state != SV_STATE_CONNECTED || con->viewOnly)
+    return;
+
+  const gsize len = strlen(text);
+
+  if (len < 1)
+    return;
+
+  // don't echo text back to the server it came from, or re-send what it already has
+  GBytes * bytes = g_bytes_new(text, len + 1);
+
+  if (!force && con->clipLastSent && g_bytes_equal(bytes, con->clipLastSent))
+  {
+    g_bytes_unref(bytes);
+    return;
+  }
+
+  // send latin-1 when possible, since that's all the rfb clipboard carries
+  char * latin1 = svClipToLatin1(text);
+
+  vnc_display_client_cut_text(VNC_DISPLAY(con->vncObj), latin1 ? latin1 : text);
+
+  g_free(latin1);
+
+  if (con->clipLastSent)
+    g_bytes_unref(con->clipLastSent);
+
+  con->clipLastSent = bytes;
+}
+
+
+/* paste text into a connection by setting its clipboard and pressing its paste keys */
+/* (returns false if the text has to be sent as keystrokes instead) */
+gboolean svPasteViaClipboard (Connection * con, const char * text)
+{
+  if (!con || !text || !con->vncObj || con->state != SV_STATE_CONNECTED || con->viewOnly)
+    return false;
+
+  GString * logStr = g_string_new(NULL);
+
+  // text the rfb clipboard can't carry goes out as keystrokes
+  char * latin1 = svClipToLatin1(text);
+
+  if (!latin1)
+  {
+    g_string_printf(logStr, "Text for '%s' isn't Latin-1, sending it as keystrokes", con->name->str);
+    svLog(logStr->str, true);
+    g_string_free(logStr, true);
+    return false;
+  }
+
+  // give the server a moment to take the clipboard before pasting
+  GString * macro = g_string_new(NULL);
+  g_string_printf(macro, "{WAIT %i}{%s}", SV_PASTE_KEYS_DELAY, con->pasteKeys->str);
+
+  GString * errStr = g_string_new(NULL);
+  GArray * program = svMacroCompile(macro->str, errStr);
+
+  g_string_free(macro, true);
+
+  if (errStr->len > 0)
+  {
+    g_string_printf(logStr, "Paste keys for '%s' have problems, sending text as keystrokes:\n%s",
+      con->name->str, errStr->str);
+    svLog(logStr->str, false);
+
+    g_string_free(errStr, true);
+    g_string_free(logStr, true);
+    g_array_unref(program);
+    g_free(latin1);
+    return false;
+  }
+
+  g_string_free(errStr, true);
+
+  // the paste keys replace anything still playing
+  svMacroStop(con);
+
+  vnc_display_client_cut_text(VNC_DISPLAY(con->vncObj), latin1);
+
+  // don't let clipboard sync send the same text again
+  if (con->clipLastSent)
+    g_bytes_unref(con->clipLastSent);
+
+  con->clipLastSent = g_bytes_new(text, strlen(text) + 1);
+
+  svMacroPlayProgram(con, program);
+
+  g_string_printf(logStr, "Pasted %lu bytes into '%s' through its clipboard",
+    (unsigned long)strlen(latin1), con->name->str);
+  svLog(logStr->str, true);
+
+  g_array_unref(program);
+  g_free(latin1);
+  g_string_free(logStr, true);
+
+  return true;
+}
+
+
+/* local clipboard text received for automatic sending */
+/* (data is the connection's name - it may have been deleted while we waited) */
+void svClipLocalTextReceived (GtkClipboard * cb, const gchar * text, gpointer data)
+{
+  Connection * con = svConnectionFromName((const char *)data);
+
+  if (con)
+    svClipSendText(con, text, false);
+
+  g_free(data);
+}
+
+
+/* local clipboard text received for manual sending */
+void svClipLocalTextReceivedForced (GtkClipboard * cb, const gchar * text, gpointer data)
+{
+  Connection * con = svConnectionFromName((const char *)data);
+
+  if (con)
+    svClipSendText(con, text, true);
+
+  g_free(data);
+}
+
+
+/* request the local clipboard text and send it to a connection */
+void svClipRequestLocal (Connection * con, gboolean force)
+{
+  GtkClipboard * cb = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+
+  if (!con || !cb)
+    return;
+
+  // (the connection is looked up again by name when the text arrives, so freed ones aren't touched)
+  if (force)
+    gtk_clipboard_request_text(cb, svClipLocalTextReceivedForced, g_strdup(con->name->str));
+  else
+    gtk_clipboard_request_text(cb, svClipLocalTextReceived, g_strdup(con->name->str));
+}
+
+
+/* send the local clipboard to a connection if it syncs to the server */
+void svClipPushLocal (Connection * con)
+{
+  if (!con || con->state != SV_STATE_CONNECTED || con->viewOnly ||
+    !(con->clipboardSync & SV_CLIP_SYNC_TO_SERVER))
+    return;
+
+  svClipRequestLocal(con, false);
+}
+
+
+/* handle the local clipboard changing owner */
+void svHandleLocalClipboardChange (GtkClipboard * cb, GdkEvent * event, gpointer data)
+{
+  svClipPushLocal(app->selectedConnection);
+}
+
+
+/* handle vnc obj 'server cut / copy (clipboard) text' event */
+void svHandleServerClipboard (VncConnection * unused, const char * text, void * data)
+{
+  //printf("handle server clipboard\n");
+
+  if (!data || !text)
+    return;
+
+  if (strlen(text) < 1)
+    return;
+
+  Connection * con = (Connection *)data;
+
+  // the rfb clipboard is latin-1, but some servers send utf-8 anyway
+  char * utf8 = NULL;
+
+  if (!g_utf8_validate(text, -1, NULL))
+    utf8 = g_convert(text, -1, "UTF-8", "ISO-8859-1", NULL, NULL, NULL);
+
+  // store this server's clipboard text in the clipboard history
+  svClipHistoryAdd(con, utf8 ? utf8 : text);
+
+  g_free(utf8);
+
+  GBytes * bytes = svClipLatest(con);
+
+  // remember it so it isn't sent straight back
+  if (con->clipLastSent)
+    g_bytes_unref(con->clipLastSent);
+
+  con->clipLastSent = g_bytes_ref(bytes);
 
-  // vnc quality
-  GtkWidget * lblVNCQuality = gtk_label_new("VNC quality");
-  gtk_widget_set_halign(lblVNCQuality, GTK_ALIGN_END);
-  GtkWidget * vncQuality = gtk_combo_box_text_new();
-  g_hash_table_insert(ht, "vncQuality", vncQuality);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(vncQuality), false);
+  // sync to the local clipboard if this is the connection being viewed
+  if (con == app->selectedConnection && (con->clipboardSync & SV_CLIP_SYNC_FROM_SERVER))
+    svClipSetLocal(bytes);
+}
 
-  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Low");
-  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Medium");
-  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Full");
-  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(vncQuality), "Default");
 
-  gtk_combo_box_set_active(GTK_COMBO_BOX(vncQuality), con->quality);
-  svSetTooltip(vncQuality, "The remote host's displayed image quality");
+/* handle key presses */
+/* NOTE: signal only fires from active VncDisplay */
+gboolean svHandleKeyboard (GtkWidget * widget, GdkEventKey * event, gpointer data)
+{
+  // the connection whose screen has the keyboard (which may be in a window or tile of its own)
+  Connection * con = (Connection *)data;
+  if (!con)
+    return false;
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCQuality, 1, 10, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncQuality, 2, 10, 3, 1);
+  // typing into a connection keeps it from going idle
+  con->lastViewed = g_get_monotonic_time();
 
-  // vnc lossy encoding
-  GtkWidget * lblVNCLossy = gtk_label_new("VNC lossy encoding");
-  gtk_widget_set_halign(lblVNCLossy, GTK_ALIGN_END);
-  GtkWidget * vncLossyEncoding = gtk_check_button_new();
-  g_hash_table_insert(ht, "vncLossyEncoding", vncLossyEncoding);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(vncLossyEncoding), false);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(vncLossyEncoding), con->lossyEncoding);
-  svSetTooltip(vncLossyEncoding, "Enables the remote host's lossy encoding");
+  // f8 - connection actions
+  if (event->keyval == GDK_KEY_F8)
+  {
+    if (!con || con->name->len == 0 || con->state != SV_STATE_CONNECTED)
+      return false;
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCLossy, 1, 11, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncLossyEncoding, 2, 11, 3, 1);
+    svShowConnectionActionsWindow(con);
+    return true;
+  }
 
-  // vnc scaling
-  GtkWidget * lblVNCScaling = gtk_label_new("VNC scaling");
-  gtk_widget_set_halign(lblVNCScaling, GTK_ALIGN_END);
-  GtkWidget * vncScaling = gtk_check_button_new();
-  g_hash_table_insert(ht, "vncScaling", vncScaling);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(vncScaling), con->scale);
-  svSetTooltip(vncScaling, "Scales the remote host's display");
+  // f10 - screenshot
+  if (event->keyval == GDK_KEY_F9)
+  {
+    if (!con || con->name->len == 0 || con->state != SV_STATE_CONNECTED)
+      return false;
 
-  gtk_grid_attach(GTK_GRID(vncPage), lblVNCScaling, 1, 12, 1, 1);
-  gtk_grid_attach(GTK_GRID(vncPage), vncScaling, 2, 12, 3, 1);
+    svHandleScreenshotMenuItem(NULL, con);
+    return true;
+  }
 
-  //
-  gtk_notebook_append_page(GTK_NOTEBOOK(editTab), vncPage, lblVNCTab);
+  // f11 - hide host list
+  if (event->keyval == GDK_KEY_F11)
+  {
+    // get current list width
+    gint listWidth = gtk_paned_get_position(GTK_PANED(app->parent));
 
-  // ------------------- ssh page -------------------
-  GtkWidget * sshPage = gtk_grid_new();
-  GtkWidget * lblSSHTab = gtk_label_new("SSH options");
-  gtk_container_set_border_width(GTK_CONTAINER(sshPage), 7);
-  gtk_grid_set_column_spacing(GTK_GRID(sshPage), 7);
-  gtk_grid_set_row_spacing(GTK_GRID(sshPage), 5);
+    if (listWidth < 1)
+      // restore if hidden
+      gtk_paned_set_position(GTK_PANED(app->parent), app->serverListWidthLast);
+    else
+    {
+      // store current hostlist width
+      app->serverListWidthLast = listWidth;
 
-  // ssh name
-  GtkWidget * lblSSHName = gtk_label_new("SSH username");
-  gtk_widget_set_halign(lblSSHName, GTK_ALIGN_END);
-  GtkWidget * sshUsername = gtk_entry_new();
-  g_hash_table_insert(ht, "sshUsername", sshUsername);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(sshUsername), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(sshUsername), 30);
-  gtk_entry_set_text(GTK_ENTRY(sshUsername), con->sshUser->str);
-  svSetTooltip(sshUsername, "The username used for the remote host's SSH server");
+      // hide list
+      gtk_paned_set_position(GTK_PANED(app->parent), 0);
+    }
 
-  gtk_grid_attach(GTK_GRID(sshPage), lblSSHName, 1, 1, 1, 1);
-  gtk_grid_attach(GTK_GRID(sshPage), sshUsername, 2, 1, 3, 1);
+    return true;
+  }
+
+  // f12 macro
+  if (event->keyval == GDK_KEY_F12)
+  {
+    if (!con || con->name->len == 0)
+      return false;
+
+    // play the compiled f12 macro
+    svMacroPlay(con);
+
+    return true;  // stop further handling
+  }
+
+  return false;   // allow normal processing
+}
+
+
+/* create and start a new connection */
+void svConnectionCreate (Connection * con)
+{
+  //  get out if state is CONNECTED or WAITING
+  if (!con || con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING)
+    return;
+
+  // connecting now replaces any pending auto-reconnect (but keeps its attempt count)
+  if (con->reconnectSource > 0)
+  {
+    g_source_remove(con->reconnectSource);
+    con->reconnectSource = 0;
+  }
+
+  GString * logStr = g_string_new(NULL);
+
+  // log
+  if (con->type != SV_TYPE_VNC_REVERSE)
+    g_string_printf(logStr, "Creating new connection for '%s - %s'", con->name->str, con->address->str);
+  else
+    g_string_printf(logStr, "Creating new listening connection");
+
+  // log
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  // run it in a viewer process of its own, if enabled
+  if (app->helperViewers && !app->helperChild && con->type != SV_TYPE_VNC_REVERSE && svHelperStart(con))
+  {
+    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, "", -1);
+
+    con->state = SV_STATE_WAITING;
+    con->disconnectType = SV_DISC_NONE;
+    g_string_truncate(con->lastErrorMessage, 0);
+    con->lastViewed = g_get_monotonic_time();
+
+    svSetIconFromConnectionName(con->name->str, SV_STATE_WAITING);
+
+    return;
+  }
+
+  // create a new vnc obj
+  GtkWidget * vnc = vnc_display_new();
+
+  if (!vnc)
+  {
+    svLog("svConnectionCreate - CRITICAL: Unable to create a new vnc object!", false);
+    return;
+  }
+
+  // clear error quicknote text
+  gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, "", -1);
+
+  // set this connection's vnc obj
+  con->vncObj = vnc;
+
+  // connect vnc obj signals
+  g_signal_connect(con->vncObj, "vnc-initialized", G_CALLBACK(svServerInitialized), NULL);
+  g_signal_connect(con->vncObj, "vnc-connected", G_CALLBACK(svServerConnected), NULL);
+  g_signal_connect(con->vncObj, "vnc-disconnected", G_CALLBACK(svServerDisconnected), NULL);
+  g_signal_connect(con->vncObj, "vnc-auth-credential", G_CALLBACK(svServerAuthenticate), NULL);
+  g_signal_connect(con->vncObj, "vnc-error", G_CALLBACK(svServerError), con);
+  g_signal_connect(con->vncObj, "vnc-server-cut-text", G_CALLBACK(svHandleServerClipboard), con);
+  g_signal_connect(con->vncObj, "vnc-desktop-resize", G_CALLBACK(svHandleDesktopResize), con);
+  g_signal_connect(con->vncObj, "key-press-event", G_CALLBACK(svHandleKeyboard), con);
+  g_signal_connect(con->vncObj, "motion-notify-event", G_CALLBACK(svHandlePointerMotion), con);
+  g_signal_connect(con->vncObj, "button-press-event", G_CALLBACK(svHandlePointerButton), con);
+  g_signal_connect(con->vncObj, "button-release-event", G_CALLBACK(svHandlePointerButton), con);
+  g_signal_connect(con->vncObj, "scroll-event", G_CALLBACK(svHandlePointerButton), con);
+
+  // reset connection variables
+  // (before the icon changes, since everything watching state changes hears about it there)
+  con->state = SV_STATE_WAITING;
+  con->disconnectType = SV_DISC_NONE;
+  g_string_truncate(con->lastErrorMessage, 0);
+
+  // (asked for just now, so it's not the least recently viewed when it comes up)
+  con->lastViewed = g_get_monotonic_time();
+
+  // change connection list icon
+  svSetIconFromConnectionName(con->name->str, SV_STATE_WAITING);
+
+  // process based on type
+  switch (con->type)
+  {
+    case SV_TYPE_VNC:
+    case SV_TYPE_VNC_REVERSE:
+    case SV_TYPE_VNC_REPEATER:
+    // just open the connection straight away
+    svConnectionOpen(con);
+    break;
+
+    case SV_TYPE_VNC_OVER_SSH:
+    // get a free local port to forward to
+    con->sshLocalPort = svFindFreeTcpPort();
+
+    // spawn ssh-related threads (because they block)
+    con->sshThread = g_thread_new("ssh-runner", svCreateSSHConnection, con);
+    con->sshMonitorThread = g_thread_new("ssh-monitor", svSSHMonitor, con);
+    break;
+
+    default:
+    return;
+  }
+}
+
+
+/* set error message on ssh failure */
+void svSetSSHLastErrorMessage (gpointer data)
+{
+  const Connection * con = (Connection *)data;
+  if (!con)
+    return;
+
+  // get the buffer's end iter
+  GtkTextIter end;
+  gtk_text_buffer_get_end_iter(app->quickNoteLastErrorBuffer, &end);
+
+  // build new string
+  GString * newText = g_string_new(NULL);
+
+  // set the string to the latest error message
+  g_string_printf(newText, "%s\n- -\n", con->lastErrorMessage->str);
+
+  // insert the new error text at the end of the quicknote error area
+  gtk_text_buffer_insert(app->quickNoteLastErrorBuffer, &end, newText->str, -1);
+
+  g_string_free(newText, true);
+}
+
+
+/* set error icon from ssh error, and try again later if the connection auto-reconnects */
+void svSetConnectionIconFromSSHError (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con)
+    return;
+
+  // (the vnc display was never opened, so nothing else will clean it up before the next try)
+  if (con->vncObj && !gtk_widget_get_parent(con->vncObj))
+  {
+    GtkWidget * vncObj = con->vncObj;
+    con->vncObj = NULL;
+
+    g_object_ref_sink(vncObj);
+    gtk_widget_destroy(vncObj);
+    g_object_unref(vncObj);
+  }
+
+  svSetIconFromConnectionName(con->name->str, SV_STATE_ERROR);
+
+  // ssh failing is like any other failed connect (svServerDisconnected never hears about it)
+  if (con->autoReconnect && con->state == SV_STATE_ERROR)
+    svReconnectSchedule(con);
+
+  // a batch run records the ssh error instead of waiting out its timeout
+  if (con->batchItem)
+    svBatchItemDone(con);
+}
+
+
+/* monitor ssh connection state and take appropriate action */
+gpointer svSSHMonitor (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con)
+    return NULL;
+
+  // wait for ssh connection
+  for (guint i = 0; i < app->sshConnectWaitTime; i++)
+  {
+    if (con->sshContinue)
+      break;
+
+    sleep(1);
+  }
+
+  // deal with ssh connection timeout / failure
+  if (!con->sshContinue)
+  {
+    // set connection's last error message
+    g_string_assign(con->lastErrorMessage, "Could not connect to SSH server");
+    svLog(con->lastErrorMessage->str, false);
 
-  // ssh port
-  GtkWidget * lblSSHPort = gtk_label_new("SSH port");
-  gtk_widget_set_halign(lblSSHPort, GTK_ALIGN_END);
-  GtkWidget * sshPort = gtk_entry_new();
-  g_hash_table_insert(ht, "sshPort", sshPort);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(sshPort), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(sshPort), 10);
-  gtk_entry_set_text(GTK_ENTRY(sshPort), con->sshPort->str);
-  svSetTooltip(sshPort, "The remote host's numbered SSH server's port");
+    // set last error message text view
+    g_idle_add_once(svSetSSHLastErrorMessage, con);
 
-  gtk_grid_attach(GTK_GRID(sshPage), lblSSHPort, 1, 2, 1, 1);
-  gtk_grid_attach(GTK_GRID(sshPage), sshPort, 2, 2, 3, 1);
+    // set connection variables
+    con->sshContinue = false;
+    con->disconnectType = SV_DISC_SSH_ERROR;
+    con->state = SV_STATE_ERROR;
 
-  // ssh private key
-  GtkWidget * lblSSHPrivKey = gtk_label_new("SSH private key (if any)");
-  gtk_widget_set_halign(lblSSHPrivKey, GTK_ALIGN_END);
-  GtkWidget * sshPrivateKey = gtk_entry_new();
-  g_hash_table_insert(ht, "sshPrivateKey", sshPrivateKey);
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(sshPrivateKey), false);
-  gtk_entry_set_width_chars(GTK_ENTRY(sshPrivateKey), 30);
-  gtk_entry_set_text(GTK_ENTRY(sshPrivateKey), con->sshPrivKeyfile->str);
-  svSetTooltip(sshPrivateKey, "The private key (if any) used to authenticate on the remote "
-    "host's SSH server");
+    // set connection list row's icon
+    g_idle_add_once(svSetConnectionIconFromSSHError, con);
 
-  GtkWidget * btnSSHPrivKey = gtk_button_new_with_label("...");
-  if (preventConnectedEditing)
-    gtk_widget_set_sensitive(GTK_WIDGET(btnSSHPrivKey), false);
-  g_signal_connect(btnSSHPrivKey, "clicked", G_CALLBACK(svHandleConnectionSSHPrivKey), ht);
-  svSetTooltip(btnSSHPrivKey, "Click to select a private key for the remote host's SSH server");
+    return NULL;
+  }
 
-  gtk_grid_attach(GTK_GRID(sshPage), lblSSHPrivKey, 1, 4, 1, 1);
-  gtk_grid_attach(GTK_GRID(sshPage), sshPrivateKey, 2, 4, 1, 1);
-  gtk_grid_attach(GTK_GRID(sshPage), btnSSHPrivKey, 3, 4, 1, 1);
+  // if all seems well, wait to show
+  for (guint i = 0; i < app->sshShowWaitTime; i++)
+    sleep(1);
 
-  //
-  gtk_notebook_append_page(GTK_NOTEBOOK(editTab), sshPage, lblSSHTab);
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Attempting SSH connection open '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-  // ------------------- custom commands page -------------------
-  GtkWidget * customCmdsPage = gtk_grid_new();
-  GtkWidget * lblCmdsTab = gtk_label_new("Custom commands");
-  gtk_container_set_border_width(GTK_CONTAINER(customCmdsPage), 7);
-  gtk_grid_set_column_spacing(GTK_GRID(customCmdsPage), 7);
-  gtk_grid_set_row_spacing(GTK_GRID(customCmdsPage), 14);
+  // attempt to connect to forwarded vnc
+  svConnectionOpen(con);
 
-  // command 1
-  GtkWidget * frameCmd1 = gtk_frame_new("Command 1");
-  gtk_frame_set_shadow_type(GTK_FRAME(frameCmd1), GTK_SHADOW_ETCHED_IN);
-  gtk_grid_attach(GTK_GRID(customCmdsPage), frameCmd1, 1, 1, 1, 1);
-  GtkWidget * gridCmd1 = gtk_grid_new();
-  gtk_grid_set_column_spacing(GTK_GRID(gridCmd1), 5);
-  gtk_grid_set_row_spacing(GTK_GRID(gridCmd1), 5);
-  gtk_container_add(GTK_CONTAINER(frameCmd1), gridCmd1);
+  return NULL;
+}
 
-  // - enabled
-  GtkWidget * lblCmd1Enabled = gtk_label_new("Enabled");
-  gtk_widget_set_halign(lblCmd1Enabled, GTK_ALIGN_END);
-  GtkWidget * cmd1Enabled = gtk_check_button_new();
-  g_hash_table_insert(ht, "cmd1Enabled", cmd1Enabled);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cmd1Enabled), con->customCmd1Enabled);
-  svSetTooltip(cmd1Enabled, "Enables custom command 1");
 
-  gtk_grid_attach(GTK_GRID(gridCmd1), lblCmd1Enabled, 1, 2, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd1), cmd1Enabled, 2, 2, 1, 1);
+/* attempts to write closing commands to the ssh thread's stream */
+gpointer svSSHConnectionCloser (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  if (!con || !con->sshStdIn)
+    return NULL;
 
-  // - label
-  GtkWidget * lblCmd1Label = gtk_label_new("Label");
-  gtk_widget_set_halign(lblCmd1Label, GTK_ALIGN_END);
-  GtkWidget * cmd1Label = gtk_entry_new();
-  g_hash_table_insert(ht, "cmd1Label", cmd1Label);
-  gtk_entry_set_width_chars(GTK_ENTRY(cmd1Label), 30);
-  gtk_entry_set_text(GTK_ENTRY(cmd1Label), con->customCmd1Label->str);
-  svSetTooltip(cmd1Label, "The displayed menu label for custom command 1");
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Attempting to close SSH connection '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-  gtk_grid_attach(GTK_GRID(gridCmd1), lblCmd1Label, 1, 3, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd1), cmd1Label, 2, 3, 1, 1);
+  // send 'exit' and 'exit' control-char sequence
+  write(con->sshStdIn, "\r\n", strlen("\r\n"));
+  write(con->sshStdIn, "exit\n\r\n", strlen("exit\n\r\n"));
+  write(con->sshStdIn, "~.\r\n", strlen("~.\r\n"));
 
-  // - command
-  GtkWidget * lblCmd1 = gtk_label_new("Command");
-  gtk_widget_set_halign(lblCmd1, GTK_ALIGN_END);
-  GtkWidget * cmd1 = gtk_entry_new();
-  g_hash_table_insert(ht, "cmd1", cmd1);
-  gtk_entry_set_width_chars(GTK_ENTRY(cmd1), 30);
-  gtk_entry_set_text(GTK_ENTRY(cmd1), con->customCmd1->str);
-  svSetTooltip(cmd1, "The actual command that is run");
+  // close stdin handle
+  close(con->sshStdIn);
 
-  gtk_grid_attach(GTK_GRID(gridCmd1), lblCmd1, 1, 4, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd1), cmd1, 2, 4, 1, 1);
+  con->sshContinue = false;
 
-  // command 2
-  GtkWidget * frameCmd2 = gtk_frame_new("Command 2");
-  gtk_frame_set_shadow_type(GTK_FRAME(frameCmd2), GTK_SHADOW_ETCHED_IN);
-  gtk_grid_attach(GTK_GRID(customCmdsPage), frameCmd2, 1, 2, 1, 1);
-  GtkWidget * gridCmd2 = gtk_grid_new();
-  gtk_grid_set_column_spacing(GTK_GRID(gridCmd2), 5);
-  gtk_grid_set_row_spacing(GTK_GRID(gridCmd2), 5);
-  gtk_container_add(GTK_CONTAINER(frameCmd2), gridCmd2);
+  return NULL;
+}
 
-  // - enabled
-  GtkWidget * lblCmd2Enabled = gtk_label_new("Enabled");
-  gtk_widget_set_halign(lblCmd2Enabled, GTK_ALIGN_END);
-  GtkWidget * cmd2Enabled = gtk_check_button_new();
-  g_hash_table_insert(ht, "cmd2Enabled", cmd2Enabled);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cmd2Enabled), con->customCmd2Enabled);
-  svSetTooltip(cmd2Enabled, "Enables custom command 2");
 
-  gtk_grid_attach(GTK_GRID(gridCmd2), lblCmd2Enabled, 1, 2, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd2), cmd2Enabled, 2, 2, 1, 1);
+/* ask connection to end */
+/* (ssh cleanup is performed in svServerDisconnected) */
+void svConnectionEnd (Connection * con)
+{
+  if (!con)
+    return;
 
-  // - label
-  GtkWidget * lblCmd2Label = gtk_label_new("Label");
-  gtk_widget_set_halign(lblCmd2Label, GTK_ALIGN_END);
-  GtkWidget * cmd2Label = gtk_entry_new();
-  g_hash_table_insert(ht, "cmd2Label", cmd2Label);
-  gtk_entry_set_width_chars(GTK_ENTRY(cmd2Label), 30);
-  gtk_entry_set_text(GTK_ENTRY(cmd2Label), con->customCmd2Label->str);
-  svSetTooltip(cmd2Label, "The displayed menu label for custom command 2");
+  // log
+  GString * logStr = g_string_new(NULL);
 
-  gtk_grid_attach(GTK_GRID(gridCmd2), lblCmd2Label, 1, 3, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd2), cmd2Label, 2, 3, 1, 1);
+  if (con->type != SV_TYPE_VNC_REVERSE)
+    g_string_printf(logStr, "Ending connection '%s - %s'", con->name->str, con->address->str);
+  else
+    g_string_printf(logStr, "Ending listening connection '%s'", con->name->str);
 
-  // - command
-  GtkWidget * lblCmd2 = gtk_label_new("Command");
-  gtk_widget_set_halign(lblCmd2, GTK_ALIGN_END);
-  GtkWidget * cmd2 = gtk_entry_new();
-  g_hash_table_insert(ht, "cmd2", cmd2);
-  gtk_entry_set_width_chars(GTK_ENTRY(cmd2), 30);
-  gtk_entry_set_text(GTK_ENTRY(cmd2), con->customCmd2->str);
-  svSetTooltip(cmd2, "The actual command that is run");
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-  gtk_grid_attach(GTK_GRID(gridCmd2), lblCmd2, 1, 4, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd2), cmd2, 2, 4, 1, 1);
+  // stop any running f12 macro
+  svMacroStop(con);
 
-  // command 3
-  GtkWidget * frameCmd3 = gtk_frame_new("Command 3");
-  gtk_frame_set_shadow_type(GTK_FRAME(frameCmd3), GTK_SHADOW_ETCHED_IN);
-  gtk_grid_attach(GTK_GRID(customCmdsPage), frameCmd3, 1, 3, 1, 1);
-  GtkWidget * gridCmd3 = gtk_grid_new();
-  gtk_grid_set_column_spacing(GTK_GRID(gridCmd3), 5);
-  gtk_grid_set_row_spacing(GTK_GRID(gridCmd3), 5);
-  gtk_container_add(GTK_CONTAINER(frameCmd3), gridCmd3);
+  // the user asked for this, so don't auto-reconnect
+  svReconnectCancel(con, true);
 
-  // - enabled
-  GtkWidget * lblCmd3Enabled = gtk_label_new("Enabled");
-  gtk_widget_set_halign(lblCmd3Enabled, GTK_ALIGN_END);
-  GtkWidget * cmd3Enabled = gtk_check_button_new();
-  g_hash_table_insert(ht, "cmd3Enabled", cmd3Enabled);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cmd3Enabled), con->customCmd3Enabled);
-  svSetTooltip(cmd3Enabled, "Enables custom command 3");
+  svWatchdogStop(con);
 
-  gtk_grid_attach(GTK_GRID(gridCmd3), lblCmd3Enabled, 1, 2, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd3), cmd3Enabled, 2, 2, 1, 1);
+  // keep its last screen for next time
+  svPreviewSave(con);
 
-  // - label
-  GtkWidget * lblCmd3Label = gtk_label_new("Label");
-  gtk_widget_set_halign(lblCmd3Label, GTK_ALIGN_END);
-  GtkWidget * cmd3Label = gtk_entry_new();
-  g_hash_table_insert(ht, "cmd3Label", cmd3Label);
-  gtk_entry_set_width_chars(GTK_ENTRY(cmd3Label), 30);
-  gtk_entry_set_text(GTK_ENTRY(cmd3Label), con->customCmd3Label->str);
-  svSetTooltip(cmd3Label, "The displayed label for custom command 3");
+  // (an idle close keeps its own type)
+  if ((con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING) && con->disconnectType != SV_DISC_IDLE)
+    con->disconnectType = SV_DISC_MANUAL;
 
-  gtk_grid_attach(GTK_GRID(gridCmd3), lblCmd3Label, 1, 3, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd3), cmd3Label, 2, 3, 1, 1);
+  // a viewer process closes its connection itself, and says so when it's done
+  svHelperSend(con, "disconnect", NULL);
 
-  // - command
-  GtkWidget * lblCmd3 = gtk_label_new("Command");
-  gtk_widget_set_halign(lblCmd3, GTK_ALIGN_END);
-  GtkWidget * cmd3 = gtk_entry_new();
-  g_hash_table_insert(ht, "cmd3", cmd3);
-  gtk_entry_set_width_chars(GTK_ENTRY(cmd3), 30);
-  gtk_entry_set_text(GTK_ENTRY(cmd3), con->customCmd3->str);
-  svSetTooltip(cmd3, "The actual command run");
+  // stop a connect that's still in flight
+  svConnectDirectCancel(con, false);
 
-  gtk_grid_attach(GTK_GRID(gridCmd3), lblCmd3, 1, 4, 1, 1);
-  gtk_grid_attach(GTK_GRID(gridCmd3), cmd3, 2, 4, 1, 1);
+  // close the vnc display connection
+  if (con->vncObj)
+    vnc_display_close(VNC_DISPLAY(con->vncObj));
 
-  //
-  gtk_notebook_append_page(GTK_NOTEBOOK(editTab), customCmdsPage, lblCmdsTab);
+  // set tools menu items (only if this is the one they act on)
+  if (con == app->selectedConnection)
+    svSetToolsMenuItems(false);
+}
 
-  // -- end of tab control --
-  gtk_container_add(GTK_CONTAINER(boxEditParent), editTab);
 
-  // ------------------- save / cancel buttons -------------------
-  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+/* set tools menu connection-related items state */
+void svSetToolsMenuItems(gboolean sState)
+{
+  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "requestUpdate")), sState);
+  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "send")), sState);
+  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "sendEnteredKeys")), sState);
+  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "sendCAD")), sState);
+  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "sendCSE")), sState);
+  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "screenshot")), sState);
+}
 
-  // save
-  GtkWidget * btnSave = gtk_button_new_with_label("Save");
-  gtk_widget_set_size_request(btnSave, 110, -1);
-  svSetTooltip(btnSave, "Click to save these settings");
-  g_signal_connect(btnSave, "clicked", G_CALLBACK(svHandleConnectionEditButtons), ht);
 
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnSave, false, false, 3);
+gboolean svFocusOnce (gpointer data)
+{
+  GtkWidget * w = GTK_WIDGET(data);
 
-  // cancel
-  GtkWidget * btnCancel = gtk_button_new_with_label("Cancel");
-  g_hash_table_insert(ht, "btnCancel", btnCancel);
-  gtk_widget_set_size_request(btnCancel, 110, -1);
-  svSetTooltip(btnCancel, "Click to abandon any changes.  Caution: Any changes will be lost!");
-  g_signal_connect(btnCancel, "clicked", G_CALLBACK(svHandleConnectionEditButtons), ht);
+  if (GTK_IS_WIDGET(w))
+    gtk_widget_grab_focus(w);
 
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnCancel, false, false, 3);
+  return false;  // run once, then stop
+}
 
-  //
-  gtk_container_add(GTK_CONTAINER(boxEditParent), boxButtons);
+/* return where a connection's screen preview is kept (free with g_string_free) */
+GString * svPreviewPath (const char * name)
+{
+  // (names can hold anything, so the file is named after a hash of it)
+  char * hash = g_compute_checksum_for_string(G_CHECKSUM_SHA1, name, -1);  // <<<--- do NOT make const char *
 
-  // show everything
-  gtk_widget_show_all(win);
+  GString * path = g_string_new(app->previewDir->str);
+  g_string_append_printf(path, "/%s.jpg", hash);
 
-  gtk_window_present(GTK_WINDOW(win));
+  g_free(hash);
 
-  // focus the first entry
-  gtk_widget_grab_focus(connectionName);
+  return path;
 }
 
 
-/* handle app->parent divider position change */
-void svHandlePaneDividerChange (GtkPaned * paned, GtkScrollType * scroll_type, gpointer userData)
+/* drop a connection's in-memory preview (the file stays) */
+void svPreviewForget (Connection * con)
 {
-  if (!paned)
-    return;
+  if (con->preview)
+  {
+    g_object_unref(con->preview);
+    con->preview = NULL;
+  }
 
-  // store handle position (basically 'list width')
-  app->serverListWidth = gtk_paned_get_position(paned);
+  if (con->previewTip)
+  {
+    g_object_unref(con->previewTip);
+    con->previewTip = NULL;
+  }
 }
 
 
-/* handle main window state changes */
-void svHandleMainWinChange (GtkWidget * widget, GdkEventWindowState * event, gpointer userData)
+/* return a connection's last-known screen, reading it from disk the first time (owned by the connection) */
+GdkPixbuf * svPreviewGet (Connection * con)
 {
-  if (!widget || widget != app->mainWin)
-    return;
+  if (!app->savePreviews || con->type == SV_TYPE_VNC_REVERSE)
+    return NULL;
 
-  // set maximized value
-  if (event->new_window_state & GDK_WINDOW_STATE_MAXIMIZED)
-    app->maximized = true;
-  else
-    app->maximized = false;
+  if (!con->preview && !con->previewLoaded)
+  {
+    con->previewLoaded = true;
 
-  // set fullscreen value
-  if (event->new_window_state & GDK_WINDOW_STATE_FULLSCREEN)
-    app->fullscreen = true;
-  else
-    app->fullscreen = false;
-}
+    GString * path = svPreviewPath(con->name->str);
 
+    // (no file just means it's never been connected with previews on)
+    if (g_file_test(path->str, G_FILE_TEST_EXISTS))
+      con->preview = gdk_pixbuf_new_from_file(path->str, NULL);
 
-/* set or unset menu item tooltips */
-/* (connection settings and app options tooltips are set elsewhere) */
-void svSetMenuItemTooltips ()
-{
-  // set tooltips
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "requestUpdate"),
-    "Asks the remote host to send an updated screen");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "sendEnteredKeys"),
-    "Sends entered or pasted keys to the remote host");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "sendCAD"),
-    "Sends the Control+Alt+Delete key combination to the remote host");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "sendCSE"),
-    "Sends the Control+Shift+Esc key combination to the remote host");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "addNew"),
-    "Adds a new connection to the connection list");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "fullscreen"),
-    "Toggles app fullscreen mode");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "listenMode"),
-    "Toggles reverse VNC (listening) mode");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "screenshot"),
-    "Takes a screenshot of the remote host");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "scanMode"),
-    "Toggles timed scan mode");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "appOptions"),
-    "Displays the app preferences window");
-  svSetTooltip((GtkWidget *)g_hash_table_lookup(app->toolsItems, "quit"),
-    "Closes all connections and quits the app");
+    g_string_free(path, true);
+  }
+
+  return con->preview;
 }
 
 
-/* check for, prompt and display new new connection add */
-void svCheckForNewConnectionAdd ()
+/* take a shrunk copy of a connection's screen (from its vnc display or its viewer process) */
+GdkPixbuf * svPreviewGrab (Connection * con)
 {
-  // if nothing was added, prompt user to create a new connection
-  if (!app->addNewConnection)
-    return;
+  GdkPixbuf * pic = svConnectionPixbuf(con);
 
-  // create and edit new connection
-  Connection * con = g_new0(Connection, 1);
-  if (!con)
-    return;
+  if (!pic)
+    return NULL;
 
-  svInitConnObject(con);
+  const gint width = gdk_pixbuf_get_width(pic);
+  const gint height = gdk_pixbuf_get_height(pic);
 
-  // set up new connection
-  g_string_assign(con->name, "(new connection)");
-  g_string_assign(con->group, "General");
+  if (width <= SV_PREVIEW_WIDTH || width <= 0 || height <= 0)
+    return pic;
 
-  // show connection editor window
-  svShowConnectionEditWindow(con);
+  GdkPixbuf * small = gdk_pixbuf_scale_simple(pic, SV_PREVIEW_WIDTH,
+    MAX(1, (gint64)height * SV_PREVIEW_WIDTH / width), GDK_INTERP_BILINEAR);
+  g_object_unref(pic);
+
+  return small;
 }
 
 
-/* handle reverse vnc connection */
-gboolean svHandleReverseConnection (gpointer data)
+/* keep a connected connection's current screen, in memory and on disk, if it changed since last time */
+void svPreviewSave (Connection * con)
 {
-  GSocket * sock = (GSocket *)data;
-  if (!sock)
-    return false;
+  if (!con || !app->savePreviews || con->type == SV_TYPE_VNC_REVERSE || con->state != SV_STATE_CONNECTED)
+    return;
 
-  GSocket * client = g_socket_accept(sock, NULL, NULL);
+  // (a viewer process's screen changes aren't tracked here, so it's always taken)
+  if (con->vncObj && con->previewSaved > 0 && con->previewSaved >= con->lastActivity)
+    return;
 
-  // create new connection object
-  Connection * con = g_new0(Connection, 1);
-  if (!con)
-    return false;
+  GdkPixbuf * pic = svPreviewGrab(con);
+  if (!pic)
+    return;
 
-  svInitConnObject(con);
+  svPreviewForget(con);
+  con->preview = pic;
+  con->previewLoaded = true;
+  con->previewSaved = g_get_monotonic_time();
 
-  // make time string
-  GDateTime * now = g_date_time_new_now_local();
-  char * nowStr = g_date_time_format(now, "Listening-%Y%m%d%H%M%S");  //  <<<--- do NOT make const char *
+  if (g_mkdir_with_parents(app->previewDir->str, 0700) != 0)
+    return;
 
-  // set up new connection
-  g_string_assign(con->name, nowStr);
-  g_string_assign(con->group, "Listening");
-  con->type = SV_TYPE_VNC_REVERSE;
-  con->quality = SV_QUAL_MEDIUM;
-  con->listenFd = g_socket_get_fd(client);
-  con->scale = true;
+  // write it alongside, then swap it in, so a crash never leaves half a file
+  GString * path = svPreviewPath(con->name->str);
+  GString * tmpPath = g_string_new(path->str);
+  g_string_append(tmpPath, ".tmp");
 
-  // create box, image and label for listbox row
-  svInsertHostListRow(con->name->str, -1, con);
+  GError * error = NULL;
 
-  svConnectionCreate(con);
+  if (gdk_pixbuf_save(pic, tmpPath->str, "jpeg", &error, "quality", SV_PREVIEW_QUALITY, NULL))
+    rename(tmpPath->str, path->str);
+  else
+  {
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Could not save preview for '%s - %s' - %s", con->name->str, con->address->str,
+      error ? error->message : "unknown error");
+    svLog(logStr->str, true);
+    g_string_free(logStr, true);
 
-  //printf("Reverse connection attempt\n");
-  g_free(nowStr);
-  g_date_time_unref(now);
+    unlink(tmpPath->str);
+  }
 
-  return true;
+  if (error)
+    g_error_free(error);
+
+  g_string_free(tmpPath, true);
+  g_string_free(path, true);
 }
 
 
-/* menu item handler - toggle listen mode */
-void svHandleListenModeMenuItem ()
+/* periodically keep each connected connection's screen */
+gboolean svPreviewTimer (gpointer data)
 {
-  app->listenMode = !app->listenMode;
+  if (!app->savePreviews)
+    return G_SOURCE_CONTINUE;
 
-  if (app->listenMode)
-  {
-    // change listen mode tools menu item text
-    gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "listenMode")), "Disable _listen mode");
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
 
-    // change listen toolbutton to 'enabled' image
-    if (app->listenImage)
-    {
-      gtk_image_clear(GTK_IMAGE(app->listenImage));
-      gtk_image_set_from_resource(GTK_IMAGE(app->listenImage), "/com/spiritvnc/pngs/listen-enabled.png");
-    }
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(l->data));
+    if (!rowBox)
+      continue;
 
-    // create listening socket
-    app->listenSocket = g_socket_new(G_SOCKET_FAMILY_IPV4,
-                                 G_SOCKET_TYPE_STREAM,
-                                 G_SOCKET_PROTOCOL_TCP,
-                                 NULL);
+    Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
 
-    GInetAddress * addr = g_inet_address_new_any(G_SOCKET_FAMILY_IPV4);
-    GSocketAddress * saddr = g_inet_socket_address_new(addr, app->listenPort);
+    if (con)
+      svPreviewSave(con);
+  }
 
-    g_socket_bind(app->listenSocket, saddr, TRUE, NULL);
-    g_socket_listen(app->listenSocket, NULL);
+  g_list_free(rows);
 
-    // start listening
-    app->listenSource = g_socket_create_source(app->listenSocket, G_IO_IN, NULL);
-    g_source_set_callback(app->listenSource, svHandleReverseConnection, app->listenSocket, NULL);
-    g_source_attach(app->listenSource, g_main_context_default());
+  return G_SOURCE_CONTINUE;
+}
 
-  }
-  else
-  {
-    // change listen mode tools menu item text
-    gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "listenMode")), "Enable _listen mode");
-    gtk_window_set_title(GTK_WINDOW(app->mainWin), "SpiritVNC");
 
-    // change listen toolbutton to 'disabled' image
-    if (app->listenImage)
-    {
-      gtk_image_clear(GTK_IMAGE(app->listenImage));
-      gtk_image_set_from_resource(GTK_IMAGE(app->listenImage), "/com/spiritvnc/pngs/listen-disabled.png");
-    }
+/* move a connection's preview file along with a new name */
+void svPreviewRename (const Connection * con, const char * newName)
+{
+  GString * oldPath = svPreviewPath(con->name->str);
+  GString * newPath = svPreviewPath(newName);
 
-    if (app->listenSource)
-    {
-      g_source_destroy(app->listenSource);
-      g_source_unref(app->listenSource);
-      app->listenSource = NULL;
-    }
+  if (g_file_test(oldPath->str, G_FILE_TEST_EXISTS))
+    rename(oldPath->str, newPath->str);
 
-    if (app->listenSocket)
-    {
-      g_socket_close(app->listenSocket, NULL);
-      g_object_unref(app->listenSocket);
-      app->listenSocket = NULL;
-    }
-  }
+  g_string_free(newPath, true);
+  g_string_free(oldPath, true);
 }
 
 
-/* handle window delete properly */
-gboolean svMainWinDeleteEvent(GtkWidget * w, GdkEvent * e, gpointer u)
+/* remove a connection's preview, in memory and on disk */
+void svPreviewDelete (Connection * con)
 {
-  svDoQuit();
-  return false;
+  svPreviewForget(con);
+  con->previewLoaded = false;
+  con->previewSaved = 0;
+
+  GString * path = svPreviewPath(con->name->str);
+  unlink(path->str);
+  g_string_free(path, true);
+
+  if (app->previewCon == con)
+    svPreviewHide(con);
 }
 
 
-/* create the main app GUI */
-void svCreateGUI (GtkApplication * gtkApp)
+/* remove every connection's preview (when previews are turned off) */
+void svPreviewDeleteAll ()
 {
-  if (app->mainWin)
-    return;
-
-  // create main window
-  app->mainWin = gtk_application_window_new(gtkApp);
-  //gtk_application_add_window(app->gApp, GTK_WINDOW(app->mainWin));
-  gtk_window_set_title(GTK_WINDOW(app->mainWin), "SpiritVNC");
-  gtk_window_set_default_size(GTK_WINDOW(app->mainWin), 1024, 720);
-  g_signal_connect(app->mainWin, "delete-event", G_CALLBACK(svMainWinDeleteEvent), NULL);
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
 
-  // go bye-bye if we can't even make the main window
-  if (!app->mainWin)
+  for (GList * l = rows; l; l = l->next)
   {
-    svLog("SpiritVNC-GTK: Fatal error - main window is NULL. Terminating program", false);
-    exit(-1);
-  }
+    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(l->data));
+    if (!rowBox)
+      continue;
 
-  // window icon
-  GdkPixbuf * appIcon = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/spiritvnc.png", NULL);
-  if (appIcon)
-  {
-    gtk_window_set_default_icon(appIcon);
-    g_object_unref(appIcon);
+    Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+
+    if (con)
+      svPreviewDelete(con);
   }
 
-  gtk_window_set_application(GTK_WINDOW(app->mainWin), GTK_APPLICATION(gtkApp));
+  g_list_free(rows);
+}
 
-  // ############### PARENT PANE ###########################################
-  app->parent = gtk_paned_new(GTK_ORIENTATION_HORIZONTAL);
-  gtk_container_add(GTK_CONTAINER(app->mainWin), app->parent);
 
-  // ************** tools menu - start **************************
+/* draw the dimmed last-known screen of the connection being connected */
+gboolean svPreviewDraw (GtkWidget * area, cairo_t * cr, gpointer data)
+{
+  cairo_set_source_rgb(cr, 0, 0, 0);
+  cairo_paint(cr);
 
-  // tools menubar
-  app->menuBar = gtk_menu_bar_new();
+  Connection * con = app->previewCon;
+  GdkPixbuf * pic = con ? svPreviewGet(con) : NULL;
 
-  // first top-level menu item
-  GtkWidget * tools = gtk_menu_item_new_with_label("_Tools");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(tools), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(tools), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(app->menuBar), tools);
+  if (!pic)
+    return true;
 
-  // submenu for tools
-  GtkWidget * submenu = gtk_menu_new();
+  const gint areaWidth = gtk_widget_get_allocated_width(area);
+  const gint areaHeight = gtk_widget_get_allocated_height(area);
+  const gint width = gdk_pixbuf_get_width(pic);
+  const gint height = gdk_pixbuf_get_height(pic);
 
-  // request update
-  GtkWidget * upd = gtk_menu_item_new_with_label("Request _update");
-  g_hash_table_insert(app->toolsItems, "requestUpdate", upd);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(upd), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(upd), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), upd);
-  g_signal_connect(upd, "activate", G_CALLBACK(svHandleRequestUpdateMenuItem), NULL);
+  // fitted and centered, the way a scaled session would show
+  const gdouble scale = MIN((gdouble)areaWidth / width, (gdouble)areaHeight / height);
 
-  // *** begin 'send' submenu ***
+  cairo_save(cr);
+  cairo_translate(cr, (areaWidth - width * scale) / 2, (areaHeight - height * scale) / 2);
+  cairo_scale(cr, scale, scale);
+  gdk_cairo_set_source_pixbuf(cr, pic, 0, 0);
+  cairo_paint_with_alpha(cr, SV_PREVIEW_DIM);
+  cairo_restore(cr);
 
-  // send submenu
-  GtkWidget * ssm = gtk_menu_item_new_with_label("Send...");
-  g_hash_table_insert(app->toolsItems, "send", ssm);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(ssm), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(ssm), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), ssm);
+  // say what it is
+  GString * msgStr = g_string_new(NULL);
+  g_string_printf(msgStr, "Connecting to '%s'...", con->name->str);
 
-  // create submenu
-  GtkWidget * sendMen = gtk_menu_new();
+  cairo_text_extents_t extents;
+  cairo_set_font_size(cr, 16);
+  cairo_text_extents(cr, msgStr->str, &extents);
+  cairo_move_to(cr, (areaWidth - extents.width) / 2, areaHeight / 2);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_show_text(cr, msgStr->str);
 
-  // attach submenu to 'send' item
-  gtk_menu_item_set_submenu(GTK_MENU_ITEM(ssm), sendMen);
+  g_string_free(msgStr, true);
 
-  // send entered keystrokes
-  GtkWidget * sks = gtk_menu_item_new_with_label("_Keys...");
-  g_hash_table_insert(app->toolsItems, "sendEnteredKeys", sks);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(sks), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(sks), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(sendMen), sks);
-  g_signal_connect(sks, "activate", G_CALLBACK(svHandleSendEnteredKeystrokesMenuItem), NULL);
+  return true;
+}
 
-  // send ctrl+alt+del
-  GtkWidget * cad = gtk_menu_item_new_with_label("Ctrl+_Alt+Del");
-  g_hash_table_insert(app->toolsItems, "sendCAD", cad);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cad), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(cad), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(sendMen), cad);
-  g_signal_connect(cad, "activate", G_CALLBACK(svHandleSendCADMenuItem), NULL);
 
-  // send ctrl+shift+esc
-  GtkWidget * cse = gtk_menu_item_new_with_label("Ctrl+Shift+_Esc");
-  g_hash_table_insert(app->toolsItems, "sendCSE", cse);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cse), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(cse), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(sendMen), cse);
-  g_signal_connect(cse, "activate", G_CALLBACK(svHandleSendCSEMenuItem), NULL);
+/* show a connecting connection's last-known screen in the display area, if it's the one selected */
+void svPreviewShow (Connection * con)
+{
+  // (tile view and detached windows have the display area to themselves)
+  if (!app->previewArea || !con || con != app->selectedConnection || con->state != SV_STATE_WAITING ||
+    app->tileCount > 0 || con->detachWin || !svPreviewGet(con))
+    return;
+
+  app->previewCon = con;
+
+  gtk_widget_set_visible(app->previewArea, true);
+  gtk_stack_set_visible_child(GTK_STACK(app->displayStack), app->previewArea);
+  gtk_widget_queue_draw(app->previewArea);
+}
+
+
+/* stop showing a connection's preview, if it's the one showing */
+void svPreviewHide (Connection * con)
+{
+  if (!app->previewArea || !con || app->previewCon != con)
+    return;
+
+  app->previewCon = NULL;
+
+  gtk_widget_set_visible(app->previewArea, false);
+}
+
+
+/* show the connection list's tooltips with a small copy of the connection's last-known screen */
+gboolean svHandleHostListTooltip (GtkWidget * rowBox, gint x, gint y, gboolean keyboardMode,
+  GtkTooltip * tooltip, gpointer data)
+{
+  Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+
+  // (no preview - the row's usual tooltip, if any)
+  if (!con || !app->showTooltips || !svPreviewGet(con))
+    return false;
+
+  if (!con->previewTip)
+  {
+    const gint width = gdk_pixbuf_get_width(con->preview);
+    const gint height = gdk_pixbuf_get_height(con->preview);
+    const gint tipWidth = MIN(width, SV_PREVIEW_TIP_WIDTH);
+
+    con->previewTip = gdk_pixbuf_scale_simple(con->preview, tipWidth, MAX(1, (gint64)height * tipWidth / width),
+      GDK_INTERP_BILINEAR);
+  }
+
+  char * markup = gtk_widget_get_tooltip_markup(rowBox);  // <<<--- do NOT make const char *
 
-  // *** end of 'send' submenu ***
+  if (markup)
+    gtk_tooltip_set_markup(tooltip, markup);
+  else
+    gtk_tooltip_set_text(tooltip, con->name->str);
 
-  // screenshot
-  GtkWidget * scr = gtk_menu_item_new_with_label("_Screenshot");
-  g_hash_table_insert(app->toolsItems, "screenshot", scr);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(scr), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(scr), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), scr);
-  g_signal_connect(scr, "activate", G_CALLBACK(svHandleScreenshotMenuItem), NULL);
+  gtk_tooltip_set_icon(tooltip, con->previewTip);
 
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), gtk_separator_menu_item_new());
+  g_free(markup);
 
-  // *** end of connection-centric stuff ***
+  return true;
+}
 
-  // listen mode
-  GtkWidget * lis = gtk_menu_item_new_with_label("Enable _listen mode");
-  g_hash_table_insert(app->toolsItems, "listenMode", lis);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(lis), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(lis), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), lis);
-  g_signal_connect(lis, "activate", G_CALLBACK(svHandleListenModeMenuItem), NULL);
 
-  // scan mode
-  GtkWidget * scn = gtk_menu_item_new_with_label("Enable scan _mode");
-  g_hash_table_insert(app->toolsItems, "scanMode", scn);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(scn), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(scn), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), scn);
-  g_signal_connect(scn, "activate", G_CALLBACK(svHandleScanModeMenuItem), NULL);
+/* return the widget showing a connection's screen (its vnc display, or a viewer process's view) */
+GtkWidget * svConnectionScreen (const Connection * con)
+{
+  if (con->vncObj)
+    return con->vncObj;
 
-  // add new
-  GtkWidget * add = gtk_menu_item_new_with_label("Add _new connection...");
-  g_hash_table_insert(app->toolsItems, "addNew", add);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(add), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), add);
-  g_signal_connect(add, "activate", G_CALLBACK(svHandleAddNewConnectionMenuItem), NULL);
+  if (con->helper)
+    return con->helper->view;
 
-  // fullscreen
-  GtkWidget * ful = gtk_menu_item_new_with_label("Toggle _fullscreen");
-  g_hash_table_insert(app->toolsItems, "fullscreen", ful);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(ful), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(ful), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), ful);
-  g_signal_connect(ful, "activate", G_CALLBACK(svHandleFullscreenMenuItem), NULL);
+  return NULL;
+}
 
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), gtk_separator_menu_item_new());
-  // *** end of operations-centric stuff ***
 
-  // app options
-  GtkWidget * ao = gtk_menu_item_new_with_label("_Preferences");
-  g_hash_table_insert(app->toolsItems, "appOptions", ao);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(ao), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), ao);
-  g_signal_connect(ao, "activate", G_CALLBACK(svShowAppOptionsWindow), NULL);
+/* return a copy of a connection's screen, from its vnc display or its viewer process (NULL if none) */
+GdkPixbuf * svConnectionPixbuf (const Connection * con)
+{
+  if (con->vncObj)
+    return vnc_display_get_pixbuf(VNC_DISPLAY(con->vncObj));
 
-  // quit
-  GtkWidget * qui = gtk_menu_item_new_with_label("_Quit");
-  g_hash_table_insert(app->toolsItems, "quit", qui);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(qui), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(submenu), qui);
-  g_signal_connect(qui, "activate", G_CALLBACK(svDoQuit), NULL);
+  const HelperProc * helper = con->helper;
 
-  // add submenu to tools
-  gtk_menu_item_set_submenu(GTK_MENU_ITEM(tools), submenu);
+  if (!svHelperScreenLive(helper))
+    return NULL;
 
-  //gtk_application_set_menubar(GTK_APPLICATION(gtkApp), G_MENU_MODEL(app->menuBar));
+  // (copied, since the segment can go away under us - and sized as checked when it was mapped)
+  GdkPixbuf * pic = gdk_pixbuf_new(GDK_COLORSPACE_RGB, false, 8, helper->width, helper->height);
+  if (!pic)
+    return NULL;
 
-  // ################ TOOLS MENU - END #######################
+  guchar * dst = gdk_pixbuf_get_pixels(pic);
+  const gint dstStride = gdk_pixbuf_get_rowstride(pic);
 
-  // help top menu
-  GtkWidget * help = gtk_menu_item_new_with_label("_Help");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(help), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(help), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(app->menuBar), help);
+  // a copy only counts if no frame was being written while it was made (see svShmPublish)
+  for (guint tries = 0; tries < SV_SHM_READ_TRIES; tries++)
+  {
+    const gint seq = g_atomic_int_get(&helper->hdr->seq);
 
-  GtkWidget * helpSub = gtk_menu_new();
+    if (seq & 1)
+    {
+      g_usleep(1000);
+      continue;
+    }
 
-  // about
-  GtkWidget * abt = gtk_menu_item_new_with_label("_About");
-  g_hash_table_insert(app->toolsItems, "about", abt);
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(abt), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(helpSub), abt);
-  g_signal_connect(abt, "activate", G_CALLBACK(svShowAboutWindow), NULL);
+    for (guint row = 0; row < helper->height; row++)
+      memcpy(dst + (gsize)row * dstStride, helper->pixels + (gsize)row * helper->stride, (gsize)helper->width * 3);
 
-  // add submenu to help
-  gtk_menu_item_set_submenu(GTK_MENU_ITEM(help), helpSub);
+    if (g_atomic_int_get(&helper->hdr->seq) == seq && svHelperScreenLive(helper))
+      return pic;
+  }
 
-  // ################# PANES - START #################
+  g_object_unref(pic);
 
-  // server list -- nearly the heart of the program
-  // * (keep this here, needed for config read) *
-  app->serverList = gtk_list_box_new();
-  gtk_list_box_set_selection_mode(GTK_LIST_BOX(app->serverList), GTK_SELECTION_BROWSE);
-  g_signal_connect(app->serverList, "button-press-event", G_CALLBACK(svHandleConnectionListClicks), NULL);
+  return NULL;
+}
 
-  // read in the config file and fill the connection listbox + glist
-  svConfigRead();
 
-  gtk_list_box_unselect_all(GTK_LIST_BOX(app->serverList));
+/* send keys to a connection as one chord - pressed in order, then released in reverse */
+/* (a viewer process gets each key going down and up, as typing into its view does) */
+void svConnectionSendKeys (Connection * con, const guint * keys, guint nKeys)
+{
+  if (con->vncObj)
+  {
+    vnc_display_send_keys(VNC_DISPLAY(con->vncObj), keys, nKeys);
+    return;
+  }
 
-  // **** left pane ****
-  // parent listbox and display stack
-  // menu and hostlist
-  GtkWidget * leftBox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 3);
-  gtk_container_set_border_width(GTK_CONTAINER(leftBox), 2);
-  // add the leftBox parent container to left pane
-  gtk_paned_pack1(GTK_PANED(app->parent), leftBox, false, true);
+  if (!con->helper || con->viewOnly || con->tileMuted)
+    return;
 
-  // pack menu-bar and server list into leftBox
-  gtk_box_pack_start(GTK_BOX(leftBox), app->menuBar, false, false, 0);
-  //gtk_container_add(GTK_CONTAINER(app->mainWin), app->menuBar);
+  GString * args = g_string_new(NULL);
 
-  // ############# toolbar area ###################################################
-  GtkWidget * toolBar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
-  gtk_box_pack_start(GTK_BOX(leftBox), toolBar, false, false, 2);
+  for (guint i = 0; i < nKeys; i++)
+  {
+    g_string_printf(args, "1 %u", keys[i]);
+    svHelperSend(con, "key", args->str);
+  }
 
-  // listen toolbutton
-  app->toolbuttonListen = gtk_event_box_new();
-  g_signal_connect(G_OBJECT(app->toolbuttonListen), "button-press-event", G_CALLBACK(svHandleListenModeMenuItem), NULL);
-  app->listenImage = gtk_image_new_from_resource("/com/spiritvnc/pngs/listen-disabled.png");
-  svSetTooltip(app->listenImage, "Toggle listen mode");
-  gtk_container_add(GTK_CONTAINER(app->toolbuttonListen), app->listenImage);
-  gtk_box_pack_start(GTK_BOX(toolBar), app->toolbuttonListen, false, false, 3);
+  for (guint i = nKeys; i > 0; i--)
+  {
+    g_string_printf(args, "0 %u", keys[i - 1]);
+    svHelperSend(con, "key", args->str);
+  }
 
-  // scan toolbutton
-  app->toolbuttonScan = gtk_event_box_new();
-  g_signal_connect(G_OBJECT(app->toolbuttonScan), "button-press-event", G_CALLBACK(svHandleScanModeMenuItem), NULL);
-  app->scanImage = gtk_image_new_from_resource("/com/spiritvnc/pngs/scan-disabled.png");
-  svSetTooltip(app->scanImage, "Toggle scan mode");
-  gtk_container_add(GTK_CONTAINER(app->toolbuttonScan), app->scanImage);
-  gtk_box_pack_start(GTK_BOX(toolBar), app->toolbuttonScan, false, false, 3);
+  g_string_free(args, true);
+}
 
-  // add connection toolbutton
-  app->addConnectionToolbutton = gtk_event_box_new();
-  g_signal_connect(G_OBJECT(app->addConnectionToolbutton), "button-press-event", G_CALLBACK(svHandleAddNewConnectionMenuItem), NULL);
-  app->addConnectionImage = gtk_image_new_from_resource("/com/spiritvnc/pngs/add-connection.png");
-  svSetTooltip(app->addConnectionImage, "Add a new connection");
-  gtk_container_add(GTK_CONTAINER(app->addConnectionToolbutton), app->addConnectionImage);
-  gtk_box_pack_start(GTK_BOX(toolBar), app->addConnectionToolbutton, false, false, 3);
 
-  // ############# toolbar area end ###################################################
+/* ask a connection's server to send the whole screen again */
+void svConnectionRequestUpdate (Connection * con)
+{
+  if (con->vncObj)
+    vnc_display_request_update(VNC_DISPLAY(con->vncObj));
+  else if (con->helper)
+    svHelperSend(con, "update", NULL);
+}
 
-  // scrollable parent for server list
-  app->serverListScroller = gtk_scrolled_window_new(NULL, NULL);
-  gtk_widget_set_vexpand(app->serverListScroller, true);
-  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(app->serverListScroller),
-    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
 
-  // add server list to scroller
-  gtk_container_add(GTK_CONTAINER(app->serverListScroller), app->serverList);
-  // add server list scroller to leftBox
-  gtk_box_pack_start(GTK_BOX(leftBox), app->serverListScroller, true, true, 0);
+/* ask a connection's server for a desktop of a given size */
+/* (servers without the ExtendedDesktopSize extension ignore it) */
+void svRemoteResizeSend (Connection * con, guint width, guint height)
+{
+  if (con->vncObj)
+    vnc_connection_set_size(vnc_display_get_connection(VNC_DISPLAY(con->vncObj)), width, height);
+  else if (con->helper)
+  {
+    GString * args = g_string_new(NULL);
+    g_string_printf(args, "%u %u", width, height);
+    svHelperSend(con, "resize", args->str);
+    g_string_free(args, true);
+  }
+}
 
-  // quicknote item label
-  app->quickNoteLabel = gtk_label_new("-");
-  gtk_widget_set_halign(app->quickNoteLabel, GTK_ALIGN_START);
-  gtk_widget_set_margin_start(app->quickNoteLabel, 3);
-  gtk_widget_set_margin_top(app->quickNoteLabel, 7);
-  gtk_label_set_ellipsize(GTK_LABEL(app->quickNoteLabel), PANGO_ELLIPSIZE_END);
-  // pack quicknote label in leftBox
-  gtk_box_pack_start(GTK_BOX(leftBox), app->quickNoteLabel, false, false, 0);
 
-  // quicknote last connected
-  app->quickNoteLastConnected = gtk_label_new("Last connected: -");
-  gtk_label_set_line_wrap(GTK_LABEL(app->quickNoteLastConnected), true);
-  gtk_widget_set_halign(app->quickNoteLastConnected, GTK_ALIGN_START);
-  gtk_widget_set_margin_start(app->quickNoteLastConnected, 3);
-  gtk_widget_set_margin_top(app->quickNoteLastConnected, 7);
-  // pack quicknote label in leftBox
-  gtk_box_pack_start(GTK_BOX(leftBox), app->quickNoteLastConnected, false, false, 0);
+/* ask a connection's server to make its desktop the size of the area it's shown in */
+gboolean svRemoteResizeTimer (gpointer data)
+{
+  Connection * con = (Connection *)data;
 
-  // connection last error scroller
-  GtkWidget * errorScroller = gtk_scrolled_window_new(NULL, NULL);
-  // add quicknote scroller to leftBox
-  gtk_box_pack_start(GTK_BOX(leftBox), errorScroller, false, false, 0);
+  con->resizeSource = 0;
 
-  // connection last error
-  app->quickNoteLastError = gtk_text_view_new();
-  gtk_text_view_set_editable(GTK_TEXT_VIEW(app->quickNoteLastError), false);
-  gtk_text_view_set_left_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 5);
-  gtk_text_view_set_top_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 2);
-  gtk_text_view_set_right_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 5);
-  gtk_text_view_set_bottom_margin(GTK_TEXT_VIEW(app->quickNoteLastError), 2);
-  // pack quicknote label in leftBox
-  gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(app->quickNoteLastError), GTK_WRAP_WORD_CHAR);
-  gtk_container_add(GTK_CONTAINER(errorScroller), app->quickNoteLastError);
+  GtkWidget * screen = svConnectionScreen(con);
 
-  // quicknote scroller
-  GtkWidget * quickScroller = gtk_scrolled_window_new(NULL, NULL);
-  gtk_widget_set_size_request(quickScroller, -1, 180); //160);
-  // add quicknote scroller to leftBox
-  gtk_box_pack_start(GTK_BOX(leftBox), quickScroller, false, false, 0);
+  if (!con->remoteResize || con->state != SV_STATE_CONNECTED || !screen)
+    return G_SOURCE_REMOVE;
 
-  // quick note editor
-  app->quickNoteView = gtk_text_view_new();
-  gtk_text_view_set_editable(GTK_TEXT_VIEW(app->quickNoteView), false);
-  gtk_text_view_set_left_margin(GTK_TEXT_VIEW(app->quickNoteView), 5);
-  gtk_text_view_set_top_margin(GTK_TEXT_VIEW(app->quickNoteView), 2);
-  gtk_text_view_set_right_margin(GTK_TEXT_VIEW(app->quickNoteView), 5);
-  gtk_text_view_set_bottom_margin(GTK_TEXT_VIEW(app->quickNoteView), 2);
-  // add quickNoteView to quicknote scroller
-  gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(app->quickNoteView), GTK_WRAP_WORD_CHAR);
-  gtk_container_add(GTK_CONTAINER(quickScroller), app->quickNoteView);
+  // the scrolled window the screen sits in (main window, tile or detached window) is the room we have
+  GtkWidget * area = gtk_widget_get_ancestor(screen, GTK_TYPE_SCROLLED_WINDOW);
 
-  app->quickNoteLastErrorBuffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(app->quickNoteLastError));
-  app->quickNoteBuffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(app->quickNoteView));
+  if (!area || !gtk_widget_get_mapped(area))
+    return G_SOURCE_REMOVE;
 
-  // **** right pane ****
-  // vnc viewer
-  // display stack for vnc display objects
-  // scrollable parent for stack
-  app->displayStackScroller = gtk_scrolled_window_new(NULL, NULL);
-  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(app->displayStackScroller),
-    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
-  gtk_paned_pack2(GTK_PANED(app->parent), app->displayStackScroller, true, true);
+  // (even sizes, since some servers round odd ones and we'd keep asking)
+  const guint width = CLAMP(gtk_widget_get_allocated_width(area), SV_RESIZE_MIN, SV_RESIZE_MAX) & ~1u;
+  const guint height = CLAMP(gtk_widget_get_allocated_height(area), SV_RESIZE_MIN, SV_RESIZE_MAX) & ~1u;
 
-  //// display stack for vnc display objects
-  app->displayStack = gtk_stack_new();
-  gtk_stack_set_homogeneous(GTK_STACK(app->displayStack), false);
-  gtk_stack_set_interpolate_size(GTK_STACK(app->displayStack), false);
-  gtk_widget_set_hexpand(app->displayStack, false);
-  gtk_widget_set_vexpand(app->displayStack, false);
-  gtk_container_add(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
+  if (width == con->resizeWidth && height == con->resizeHeight)
+    return G_SOURCE_REMOVE;
 
-  // ################# PANES - END ################
+  con->resizeWidth = width;
+  con->resizeHeight = height;
 
-  // set or unset tooltips
-  svSetMenuItemTooltips();
+  // already that size
+  if (con->vncObj && (guint)vnc_display_get_width(VNC_DISPLAY(con->vncObj)) == width &&
+    (guint)vnc_display_get_height(VNC_DISPLAY(con->vncObj)) == height)
+    return G_SOURCE_REMOVE;
 
-  // show everything
-  gtk_widget_show_all(app->mainWin);
+  if (!con->vncObj && svHelperScreenLive(con->helper) && con->helper->width == width &&
+    con->helper->height == height)
+    return G_SOURCE_REMOVE;
 
-  //gtk_window_present(GTK_WINDOW(app->mainWin));
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Asking '%s - %s' for a %ux%u desktop", con->name->str, con->address->str, width, height);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-  // if saved main window state was maximized, maximize the main window
-  if (app->maximized)
-    gtk_window_maximize(GTK_WINDOW(app->mainWin));
+  svRemoteResizeSend(con, width, height);
 
-  // size the hostlist pane
-  gtk_paned_set_position(GTK_PANED(app->parent), app->serverListWidth);
+  return G_SOURCE_REMOVE;
+}
+
+
+/* stop waiting to ask for a new desktop size */
+void svRemoteResizeCancel (Connection * con)
+{
+  if (con->resizeSource > 0)
+  {
+    g_source_remove(con->resizeSource);
+    con->resizeSource = 0;
+  }
+}
 
-  // connect the pane handle handler handlething handlez (leave this here, not by widget creation)
-  g_signal_connect(app->parent, "notify::position", G_CALLBACK(svHandlePaneDividerChange), NULL);
 
-  // handle window max / un-max
-  g_signal_connect(app->mainWin, "window-state-event", G_CALLBACK(svHandleMainWinChange), NULL);
+/* (re)start the wait before asking for a new desktop size, so a drag only asks once it stops */
+void svRemoteResizeSoon (Connection * con)
+{
+  if (!con || !con->remoteResize || con->state != SV_STATE_CONNECTED)
+    return;
 
-  // check if we need to show the 'add new connection' prompt
-  svCheckForNewConnectionAdd();
+  if (con->resizeSource > 0)
+    g_source_remove(con->resizeSource);
+
+  con->resizeSource = g_timeout_add(SV_RESIZE_DEBOUNCE_MS, svRemoteResizeTimer, con);
 }
 
 
-/* create new config folder(s) and file if none exists */
-gboolean svConfigCreateNew (gboolean createEmptyConfigFile)
+/* handle an area showing a screen changing size (the main one shows the selected connection) */
+void svHandleViewportResize (GtkWidget * area, GdkRectangle * alloc, gpointer data)
 {
-  // create app's config folder, making parent folders as necessary
-  gint result = g_mkdir_with_parents(app->appConfigDir->str, 0755);
+  svRemoteResizeSoon(data ? (Connection *)data : app->selectedConnection);
+}
 
-  // error in folder creation
-  if (result == -1)
-  {
-    GString * strErr = g_string_new(NULL);
-    gint errCode = errno;
-    g_string_printf(strErr, "svConfigCreateNew - Can't create config folder(s) - Error code: %i, %s",
-      errCode, strerror(errCode));
-    svLog(strErr->str, false);
-    g_string_free(strErr, true);
-    return false;
-  }
 
-  if (createEmptyConfigFile)
+/* apply a connection's scaling setting to whatever is showing its screen */
+void svConnectionApplyScale (Connection * con)
+{
+  if (con->vncObj)
+    vnc_display_set_scaling(VNC_DISPLAY(con->vncObj), svConnectionScaled(con));
+
+  if (con->helper)
   {
-    // only create a new empty file if one doesn't exist already
-    if (!g_file_test(app->appConfigFile->str, G_FILE_TEST_IS_REGULAR | G_FILE_TEST_EXISTS))
-    {
-      svLog("svConfigCreateNew - Creating new empty config file", false);
+    // (unscaled, the view asks for the whole screen and scrolls)
+    if (svConnectionScaled(con) || !con->helper->hdr)
+      gtk_widget_set_size_request(con->helper->view, -1, -1);
+    else
+      gtk_widget_set_size_request(con->helper->view, con->helper->width, con->helper->height);
 
-      // --- attempt to write empty config file ---
-      if (!g_file_set_contents(app->appConfigFile->str, "\n", -1, NULL))
-      {
-        svLog("svConfigCreateNew - Error: SpiritVNC could not write empty config file", false);
-        return false;
-      }
-    }
+    gtk_widget_queue_draw(con->helper->view);
   }
-
-  return true;
 }
 
 
-/* insert a row into the connection listbox */
-void svInsertHostListRow (const char * rowText, gint idx, Connection * con)
+/* put a detached connection's screen back in the main window and close its window */
+void svDetachEnd (Connection * con)
 {
-  if (!rowText)  // do NOT check con for NULL here, it's okay if it's null
+  GtkWidget * win = con->detachWin;
+  if (!win)
     return;
 
-  // box
-  GtkWidget * rowBox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 3);
-  if (!rowBox)
-    return;
+  con->detachWin = NULL;
 
-  // assign a connection to the row, if available
-  g_object_set_data(G_OBJECT(rowBox), "con", con);
+  GtkWidget * screen = svConnectionScreen(con);
 
-  // image
-  GdkPixbuf * pb;
+  // (the window's own update rate goes with it)
+  if (con->detachSource > 0)
+  {
+    g_source_remove(con->detachSource);
+    con->detachSource = 0;
+  }
 
-  if (rowText[0] != '\0')
-    pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected.png", NULL);
-  else
-    pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/blank.png", NULL);
+  if (screen && con->detachDrawHandler > 0)
+    g_signal_handler_disconnect(screen, con->detachDrawHandler);
 
-  GtkWidget * img = gtk_image_new_from_pixbuf(pb);
+  con->detachDrawHandler = 0;
 
-  // label
-  GtkWidget * label = gtk_label_new(rowText);
-  gtk_widget_set_halign(label, GTK_ALIGN_START);
+  if (con->tileSnap)
+  {
+    cairo_surface_destroy(con->tileSnap);
+    con->tileSnap = NULL;
+  }
 
-  // add img and label to box
-  gtk_box_pack_start(GTK_BOX(rowBox), img, false, false, 3);
-  gtk_box_pack_start(GTK_BOX(rowBox), label, false, false, 0);
+  if (screen && gtk_widget_get_parent(screen))
+  {
+    // (keep the screen alive while it's between parents)
+    g_object_ref(screen);
+    gtk_container_remove(GTK_CONTAINER(gtk_widget_get_parent(screen)), screen);
+    gtk_stack_add_named(GTK_STACK(app->displayStack), screen, con->name->str);
+    g_object_unref(screen);
+
+    // show it again if it's the one selected
+    if (con == app->selectedConnection)
+    {
+      gtk_widget_set_visible(screen, true);
+      gtk_stack_set_visible_child(GTK_STACK(app->displayStack), screen);
+      gtk_widget_grab_focus(screen);
+    }
+  }
 
-  gtk_widget_set_visible(img, true);
-  gtk_widget_set_visible(label, true);
-  gtk_widget_set_visible(rowBox, true);
+  gtk_widget_destroy(win);
 
-  // add box to connections listbox
-  gtk_list_box_insert(GTK_LIST_BOX(app->serverList), rowBox, idx);
-}
+  // back to the connection's own scaling
+  svConnectionApplyScale(con);
 
+  // (it may have a tile to go to, and the room it has changed)
+  svTileLayoutSoon();
+  svRemoteResizeSoon(con);
 
-/* read the config file and fill the connections listbox + glist */
-void svConfigRead ()
-{
-  GError * readError = NULL;
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Reattached connection '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+}
 
-  char * strIn = NULL;
 
-  // check and create any missing config folders
-  if (!svConfigCreateNew(true))
-  {
-    svLog("svConfigRead - Could not create new config dirs or file - quitting app", false);
-    exit(-1);
-  }
+/* handle a detached connection's window being closed (the session stays up, back in the main window) */
+gboolean svDetachDeleteEvent (GtkWidget * win, GdkEvent * event, gpointer data)
+{
+  svDetachEnd((Connection *)data);
 
-  // read config file contents into strIn
-  if (!g_file_get_contents(app->appConfigFile->str, &strIn, NULL, &readError))
-  {
-    GString * errStr = g_string_new(NULL);
+  // (already destroyed above)
+  return true;
+}
 
-    if (readError)
-      g_string_printf(errStr, "svConfigRead - Error opening config file\nError: %s", readError->message);
-    else
-      g_string_assign(errStr, "svConfigRead - Error opening config file - No error reported");
 
-    svLog(errStr->str, false);
-    g_string_free(errStr, true);
-  }
+/* handle a detached window's 'reattach' button */
+void svDetachReattachClicked (GtkButton * button, gpointer data)
+{
+  svDetachEnd((Connection *)data);
+}
 
-  if (readError)
-    g_error_free(readError);
 
-  // get out if strIn is null
-  if (!strIn)
-    return;
+/* handle a detached window's 'scale' checkbox (just for this window - the saved setting stays) */
+void svDetachScaleToggled (GtkToggleButton * check, gpointer data)
+{
+  Connection * con = (Connection *)data;
 
-  // create initial con object
-  Connection * con = g_new0(Connection, 1);
-  svInitConnObject(con);
+  con->detachScale = gtk_toggle_button_get_active(check);
+  svConnectionApplyScale(con);
 
-  char ** lines = g_strsplit(strIn, "\n", -1);  //  <<<--- do NOT make const char **
+  if (con->detachRate > 0)
+    svTileSnap(con);
+}
 
-  g_free(strIn);
 
-  GString * strLastGroup = g_string_new(NULL);
+/* redraw a detached window that's changed, at its own slower rate */
+gboolean svDetachTimer (gpointer data)
+{
+  Connection * con = (Connection *)data;
+  GtkWidget * screen = svConnectionScreen(con);
 
-  // process each line
-  for (char ** line = lines; *line != NULL; line++)
+  if (con->vncObj && con->lastActivity >= con->tileSnapTime)
   {
-    // process each line
+    svTileSnap(con);
+    gtk_widget_queue_draw(screen);
+  }
+  else if (con->helper)
+    gtk_widget_queue_draw(screen);
 
-    // split up property and value
-    char ** propAndVal = g_strsplit(*line, "=", 2);
+  return G_SOURCE_CONTINUE;
+}
 
-    // property and value must both be non-null
-    if (!propAndVal[0] || !propAndVal[1])
-    {
-      g_strfreev(propAndVal);
-      continue;
-    }
 
-    // trim whitespace (in-place)
-    g_strstrip(propAndVal[0]);
-    g_strstrip(propAndVal[1]);
+/* handle a detached window's 'updates' choice */
+void svDetachRateChanged (GtkComboBox * combo, gpointer data)
+{
+  Connection * con = (Connection *)data;
+  const guint rates[] = SV_DETACH_RATES;
+  const gint choice = gtk_combo_box_get_active(combo);
 
-    // assign prop and vals
-    GString * strProp = g_string_new(propAndVal[0]);
-    GString * strVal = g_string_new(propAndVal[1]);
+  if (choice < 0 || choice >= (gint)(sizeof(rates) / sizeof(rates[0])))
+    return;
 
-    g_strfreev(propAndVal);
+  con->detachRate = rates[choice];
 
-    //printf("Prop: %s, Val: %s\n", strProp->str, strVal->str);
+  if (con->detachSource > 0)
+  {
+    g_source_remove(con->detachSource);
+    con->detachSource = 0;
+  }
 
-    // ** start assigning values to properties **
+  // (a window going slower starts from a fresh copy)
+  if (con->detachRate > 0)
+  {
+    svTileSnap(con);
+    con->detachSource = g_timeout_add(con->detachRate, svDetachTimer, con);
+  }
 
-    // ===== app settings =====
+  gtk_widget_queue_draw(svConnectionScreen(con));
+}
 
-    // * serverListWidth *
-    if (strcmp(strProp->str, "hostlistwidth") == 0)
-    {
-      app->serverListWidth = atoi(strVal->str);
 
-      if (app->serverListWidth < 1)
-        app->serverListWidth = 120;
-    }
+/* move a connected connection's screen into a window of its own (the connection isn't touched) */
+void svDetachStart (Connection * con)
+{
+  GtkWidget * screen = svConnectionScreen(con);
 
-    // * showTooltips *
-    if (strcmp(strProp->str, "showtooltips") == 0)
-      app->showTooltips = svStringToBool(strVal->str);
+  if (con->detachWin || con->state != SV_STATE_CONNECTED || !screen)
+    return;
 
-    // * maximized *
-    if (strcmp(strProp->str, "maximized") == 0)
-      app->maximized = svStringToBool(strVal->str);
+  // (a tiled screen goes back to the stack first, and its tile is filled by something else)
+  svTileRemove(con);
+  svTileLayoutSoon();
 
-    // * log to file *
-    if (strcmp(strProp->str, "logtofile") == 0)
-      app->logToFile = svStringToBool(strVal->str);
+  if (!gtk_widget_get_parent(screen))
+    return;
 
-    // * debug mode *
-    if (strcmp(strProp->str, "debugmode") == 0)
-      app->debugMode = svStringToBool(strVal->str);
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Detaching connection '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-    // * scan wait time *
-    if (strcmp(strProp->str, "scantimeout") == 0)
-      app->scanTimeout = atoi(strVal->str);
+  GtkWidget * win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_default_size(GTK_WINDOW(win), SV_DETACH_WIDTH, SV_DETACH_HEIGHT);
 
-    // * vnc connect timeout *
-    if (strcmp(strProp->str, "vnctimeout") == 0)
-      app->vncConnectWaitTime = atoi(strVal->str);
+  // set window title
+  GString * titleStr = g_string_new(NULL);
+  g_string_printf(titleStr, "%s - SpiritVNC", con->name->str);
+  gtk_window_set_title(GTK_WINDOW(win), titleStr->str);
+  g_string_free(titleStr, true);
 
-    // * ssh command *
-    if (strcmp(strProp->str, "sshcommand") == 0)
-      g_string_assign(app->sshCommand, strVal->str);
+  // parent box
+  GtkWidget * boxParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+  gtk_container_add(GTK_CONTAINER(win), boxParent);
+
+  // scale checkbox and reattach button along the top
+  GtkWidget * bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 7);
+  gtk_container_set_border_width(GTK_CONTAINER(bar), 3);
+  gtk_box_pack_start(GTK_BOX(boxParent), bar, false, false, 0);
+
+  // (the window starts out like the connection, and then has its own settings)
+  con->detachScale = con->scale;
+  con->detachRate = 0;
+
+  GtkWidget * chkScale = gtk_check_button_new_with_label("Scale to window");
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkScale), con->detachScale);
+  svSetTooltip(chkScale, "Scales this connection's screen to fit this window");
+  gtk_box_pack_start(GTK_BOX(bar), chkScale, false, false, 0);
+  g_signal_connect(chkScale, "toggled", G_CALLBACK(svDetachScaleToggled), con);
+
+  GtkWidget * cboRate = gtk_combo_box_text_new();
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(cboRate), "Live updates");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(cboRate), "4 updates a second");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(cboRate), "1 update a second");
+  gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(cboRate), "1 update every 5 seconds");
+  gtk_combo_box_set_active(GTK_COMBO_BOX(cboRate), 0);
+  svSetTooltip(cboRate, "How often this window redraws the connection's screen (slower uses less CPU)");
+  gtk_box_pack_start(GTK_BOX(bar), cboRate, false, false, 0);
+  g_signal_connect(cboRate, "changed", G_CALLBACK(svDetachRateChanged), con);
+
+  GtkWidget * btnReattach = gtk_button_new_with_label("Reattach");
+  svSetTooltip(btnReattach, "Puts this connection back in the main window (closing this window does the same)");
+  gtk_box_pack_end(GTK_BOX(bar), btnReattach, false, false, 0);
+  g_signal_connect(btnReattach, "clicked", G_CALLBACK(svDetachReattachClicked), con);
+
+  // scrollable parent for the screen
+  GtkWidget * scroller = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroller), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_box_pack_start(GTK_BOX(boxParent), scroller, true, true, 0);
+  g_signal_connect(scroller, "size-allocate", G_CALLBACK(svHandleViewportResize), con);
+
+  // move the screen over (keeping it alive while it's between parents)
+  g_object_ref(screen);
+  gtk_container_remove(GTK_CONTAINER(gtk_widget_get_parent(screen)), screen);
+  gtk_container_add(GTK_CONTAINER(scroller), screen);
+  g_object_unref(screen);
+
+  con->detachWin = win;
+
+  // (a slowed window draws from a copy of the screen, as an unfocused tile does)
+  con->detachDrawHandler = g_signal_connect(screen, "draw", G_CALLBACK(svTileDraw), con);
+  svConnectionApplyScale(con);
+
+  g_signal_connect(win, "delete-event", G_CALLBACK(svDetachDeleteEvent), con);
 
-    // * ssh connect timeout *
-    if (strcmp(strProp->str, "sshtimeout") == 0)
-      app->sshConnectWaitTime = atoi(strVal->str);
+  gtk_widget_show_all(win);
+  gtk_widget_grab_focus(screen);
+}
 
-    // ===== individual connection settings =====
 
-    // * connName *
-    if (strcmp(strProp->str, "host") == 0)
-    {
-      // if there was a previous con object, add it
-      // to the connections GList
-      if (con->name && con->name->len > 0)
-      {
-        // create box, image and label for listbox row
-        svInsertHostListRow(con->name->str, -1, con);
+/* menu item handler - detach or reattach a connection's screen */
+void svHandleDetachMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+{
+  Connection * con = (Connection *)userData;
+  if (!con)
+    return;
 
-        app->addNewConnection = false;
-      }
+  if (con->detachWin)
+    svDetachEnd(con);
+  else
+    svDetachStart(con);
+}
 
-      // create new con object
-      con = g_new0(Connection, 1);
-      svInitConnObject(con);
 
-      // connection name
-      g_string_assign(con->name, strVal->str);
-    }
+/* whether a connection's screen is scaled where it's shown now (a tile or detached window has its own setting) */
+gboolean svConnectionScaled (const Connection * con)
+{
+  if (con->detachWin)
+    return con->detachScale;
 
-    // * connGroup *
-    if (strcmp(strProp->str, "group") == 0)
-    {
-      // add a separator if it's a new group
-      if (strcmp(strVal->str, strLastGroup->str) != 0)
-        svInsertHostListRow("", -1, NULL);
+  return con->tileBox ? con->tileScale : con->scale;
+}
 
-      g_string_assign(con->group, strVal->str);
-      g_string_assign(strLastGroup, strVal->str);
-    }
 
-    // * address *
-    if (strcmp(strProp->str, "address") == 0 || strcmp(strProp->str, "hostaddress") == 0)
-      g_string_assign(con->address, strVal->str);
+/* let a tiled connection take input only while its tile has the focus */
+void svTileApplyInput (Connection * con)
+{
+  if (con->vncObj)
+    vnc_display_set_read_only(VNC_DISPLAY(con->vncObj), con->viewOnly || con->tileMuted);
+}
 
-    // * type *
-    if (strcmp(strProp->str, "type") == 0)
-    {
-      if (strcmp(strVal->str, "0") == 0 || strcmp(strVal->str, "v") == 0)
-        con->type = SV_TYPE_VNC;
-      else if (strcmp(strVal->str, "1") == 0 || strcmp(strVal->str, "s") == 0)
-        con->type = SV_TYPE_VNC_OVER_SSH;
-      else
-        con->type = SV_TYPE_VNC;
-    }
 
-    // * vncPort *
-    if (strcmp(strProp->str, "vncport") == 0)
-      g_string_assign(con->vncPort, strVal->str);
+/* the size a tile's copy of its screen should be (fitted to the tile when it's scaled) */
+void svTileSnapSize (const Connection * con, gint * width, gint * height)
+{
+  *width = vnc_display_get_width(VNC_DISPLAY(con->vncObj));
+  *height = vnc_display_get_height(VNC_DISPLAY(con->vncObj));
+
+  const gint areaWidth = gtk_widget_get_allocated_width(con->vncObj);
+  const gint areaHeight = gtk_widget_get_allocated_height(con->vncObj);
 
-    // * vncPass *
-    if (strcmp(strProp->str, "vncpass") == 0)
-      g_string_assign(con->vncPass, strVal->str);
+  if (svConnectionScaled(con) && areaWidth > 0 && areaHeight > 0 && *width > 0 && *height > 0)
+  {
+    const gdouble scale = MIN((gdouble)areaWidth / *width, (gdouble)areaHeight / *height);
 
-    // * vncLoginUser *
-    if (strcmp(strProp->str, "vncloginuser") == 0)
-      g_string_assign(con->vncLoginUser, strVal->str);
+    *width = MAX(1, *width * scale);
+    *height = MAX(1, *height * scale);
+  }
+}
 
-    // * vncLoginPass *
-    if (strcmp(strProp->str, "vncloginpass") == 0)
-      g_string_assign(con->vncLoginPass, strVal->str);
 
-    // * scaling *
-    if (strcmp(strProp->str, "scale") == 0)
-      con->scale = svStringToBool(strVal->str);
+/* take a fresh (fitted) copy of a tile's screen for drawing between refreshes */
+void svTileSnap (Connection * con)
+{
+  if (con->tileSnap)
+  {
+    cairo_surface_destroy(con->tileSnap);
+    con->tileSnap = NULL;
+  }
 
-    // * showRemoteCursor *
-    if (strcmp(strProp->str, "showremotecursor") == 0)
-      con->showRemoteCursor = svStringToBool(strVal->str);
+  con->tileSnapTime = g_get_monotonic_time();
 
-    // * imageQuality *
-    if (strcmp(strProp->str, "quality") == 0)
-    {
-      if (strcmp(strVal->str, "0") == 0)
-        con->quality = SV_QUAL_LOW;
-      else if (strcmp(strVal->str, "1") == 0 || strcmp(strVal->str, "5") == 0)
-        con->quality = SV_QUAL_MEDIUM;
-      else if (strcmp(strVal->str, "2") == 0 || strcmp(strVal->str, "9") == 0)
-        con->quality = SV_QUAL_FULL;
-      else
-        con->quality = SV_QUAL_DEFAULT;
-    }
+  GdkPixbuf * pic = con->vncObj ? vnc_display_get_pixbuf(VNC_DISPLAY(con->vncObj)) : NULL;
+  if (!pic)
+    return;
 
-    // * lossy encoding *
-    if (strcmp(strProp->str, "lossyencoding") == 0)
-      con->lossyEncoding = svStringToBool(strVal->str);
+  gint width = 0;
+  gint height = 0;
+  svTileSnapSize(con, &width, &height);
 
-    // * sshPort *
-    if (strcmp(strProp->str, "sshport") == 0)
-      g_string_assign(con->sshPort, strVal->str);
+  // (shrunk and turned into a cairo surface once here, so drawing it is a plain copy
+  // however often the server updates)
+  if (width != gdk_pixbuf_get_width(pic) || height != gdk_pixbuf_get_height(pic))
+  {
+    GdkPixbuf * scaled = gdk_pixbuf_scale_simple(pic, width, height, GDK_INTERP_BILINEAR);
+    g_object_unref(pic);
+    pic = scaled;
 
-    // * sshPrivKeyfile *
-    if (strcmp(strProp->str, "sshkeyprivate") == 0)
-      g_string_assign(con->sshPrivKeyfile, strVal->str);
+    if (!pic)
+      return;
+  }
 
-    // * sshUser *
-    if (strcmp(strProp->str, "sshuser") == 0)
-      g_string_assign(con->sshUser, strVal->str);
+  con->tileSnap = gdk_cairo_surface_create_from_pixbuf(pic, 1, NULL);
+  g_object_unref(pic);
+}
 
-    // * f12Macro *
-    if (strcmp(strProp->str, "f12macro") == 0)
-      g_string_assign(con->f12Macro, strVal->str);
 
-    // * quicknote *
-    if (strcmp(strProp->str, "quicknote") == 0)
-      g_string_assign(con->quickNote, strVal->str);
+/* draw an unfocused tile's screen (or a slowed detached window's) from its last copy */
+/* (runs ahead of the vnc display's own drawing) */
+gboolean svTileDraw (GtkWidget * screen, cairo_t * cr, gpointer data)
+{
+  Connection * con = (Connection *)data;
 
-    // * custom command 1 enabled *
-    if (strcmp(strProp->str, "customcmd1enabled") == 0 || strcmp(strProp->str, "customcommand1enabled") == 0)
-      con->customCmd1Enabled = svStringToBool(strVal->str);
+  // the focused tile, a live window (and a viewer process's view, which only redraws when asked) draw live
+  if (!(con->tileMuted || (con->detachWin && con->detachRate > 0)) || !con->vncObj)
+    return false;
 
-    // * custom command 1 label *
-    if (strcmp(strProp->str, "customcmd1label") == 0 || strcmp(strProp->str, "customcommand1label") == 0)
-      g_string_assign(con->customCmd1Label, strVal->str);
+  // (the tile may have changed size since the last copy)
+  gint width = 0;
+  gint height = 0;
+  svTileSnapSize(con, &width, &height);
 
-    // * custom command 1 *
-    if (strcmp(strProp->str, "customcmd1") == 0 || strcmp(strProp->str, "customcommand1") == 0)
-      g_string_assign(con->customCmd1, strVal->str);
+  if (!con->tileSnap || cairo_image_surface_get_width(con->tileSnap) != width ||
+    cairo_image_surface_get_height(con->tileSnap) != height)
+    svTileSnap(con);
 
-    // * custom command 2 enabled *
-    if (strcmp(strProp->str, "customcmd2enabled") == 0 || strcmp(strProp->str, "customcommand2enabled") == 0)
-      con->customCmd2Enabled = svStringToBool(strVal->str);
+  if (!con->tileSnap)
+    return false;
 
-    // * custom command 2 label *
-    if (strcmp(strProp->str, "customcmd2label") == 0 || strcmp(strProp->str, "customcommand2label") == 0)
-      g_string_assign(con->customCmd2Label, strVal->str);
+  const gint areaWidth = gtk_widget_get_allocated_width(screen);
+  const gint areaHeight = gtk_widget_get_allocated_height(screen);
+  const gint snapWidth = cairo_image_surface_get_width(con->tileSnap);
+  const gint snapHeight = cairo_image_surface_get_height(con->tileSnap);
 
-    // * custom command 2 *
-    if (strcmp(strProp->str, "customcmd2") == 0 || strcmp(strProp->str, "customcommand2") == 0)
-      g_string_assign(con->customCmd2, strVal->str);
+  cairo_set_source_rgb(cr, 0, 0, 0);
+  cairo_paint(cr);
 
-    // * custom command 3 enabled *
-    if (strcmp(strProp->str, "customcmd3enabled") == 0 || strcmp(strProp->str, "customcommand3enabled") == 0)
-      con->customCmd3Enabled = svStringToBool(strVal->str);
+  // centered when scaled, like the vnc display does it
+  const gint x = svConnectionScaled(con) ? MAX(0, (areaWidth - snapWidth) / 2) : 0;
+  const gint y = svConnectionScaled(con) ? MAX(0, (areaHeight - snapHeight) / 2) : 0;
 
-    // * custom command 3 label *
-    if (strcmp(strProp->str, "customcmd3label") == 0 || strcmp(strProp->str, "customcommand3label") == 0)
-      g_string_assign(con->customCmd3Label, strVal->str);
+  cairo_set_source_surface(cr, con->tileSnap, x, y);
+  cairo_paint(cr);
 
-    // * custom command 3 *
-    if (strcmp(strProp->str, "customcmd3") == 0 || strcmp(strProp->str, "customcommand3") == 0)
-      g_string_assign(con->customCmd3, strVal->str);
+  return true;
+}
 
-    // * last connect time *
-    if (strcmp(strProp->str, "lastconnecttime") == 0)
-      g_string_assign(con->lastConnectTime, strVal->str);
 
-    // view-only / read-only
-    if (strcmp(strProp->str, "viewonly") == 0)
-      con->viewOnly = svStringToBool(strVal->str);
+/* refresh unfocused tiles that have changed, at the slower tile rate */
+gboolean svTileTimer (gpointer unused)
+{
+  for (GList * l = app->tiles; l; l = l->next)
+  {
+    Connection * con = l->data;
 
-    // free up gstrings
-    g_string_free(strProp, true);
-    g_string_free(strVal, true);
+    if (!con->tileMuted)
+      continue;
+
+    GtkWidget * screen = svConnectionScreen(con);
+
+    if (con->vncObj && con->lastActivity >= con->tileSnapTime)
+    {
+      svTileSnap(con);
+      gtk_widget_queue_draw(screen);
+    }
+    else if (con->helper)
+      gtk_widget_queue_draw(screen);
   }
 
-  // free up stuffz
-  g_string_free(strLastGroup, true);
-  g_strfreev(lines);
+  return G_SOURCE_CONTINUE;
+}
 
-  // add last con item, if not null
-  if (con && con->name->len > 0)
+
+/* show which tile has the focus, and give it (only) the keyboard and pointer */
+void svTileFocus (Connection * con)
+{
+  app->tileFocus = con;
+
+  for (GList * l = app->tiles; l; l = l->next)
   {
-    svInsertHostListRow(con->name->str, -1, con);
+    Connection * tileCon = l->data;
+    const gboolean muted = (tileCon != con);
 
-    app->addNewConnection = false;
+    GtkWidget * label = g_object_get_data(G_OBJECT(tileCon->tileBox), "label");
+    char * markup = g_markup_printf_escaped(muted ? "%s" : "<b>%s</b>", tileCon->name->str);  // <<<--- do NOT make const char *
+    gtk_label_set_markup(GTK_LABEL(label), markup);
+    g_free(markup);
+
+    if (tileCon->tileMuted == muted)
+      continue;
+
+    tileCon->tileMuted = muted;
+    svTileApplyInput(tileCon);
+
+    // (a tile going quiet starts from a fresh copy)
+    if (muted)
+      svTileSnap(tileCon);
+
+    gtk_widget_queue_draw(svConnectionScreen(tileCon));
   }
-  else
-    svFreeConnObject(con);
 
-  svInsertHostListRow("", -1, NULL);
+  if (con)
+    gtk_widget_grab_focus(svConnectionScreen(con));
+}
 
-  // set or unset hostlist item tooltips
-  svSetHostlistItemsTooltips();
+
+/* handle a click on an unfocused tile (the focused one's screen takes its own clicks) */
+gboolean svTileClicked (GtkWidget * eventBox, GdkEventButton * event, gpointer data)
+{
+  Connection * con = (Connection *)data;
+
+  if (con != app->tileFocus)
+    svRemoteSelect(con);
+
+  return true;
 }
 
 
-/* write the configuration file */
-void svConfigWrite ()
+/* handle a tile's 'scale' checkbox */
+void svTileScaleToggled (GtkToggleButton * check, gpointer data)
 {
-  // no re-entrance
-  static gboolean inConfigWrite = false;
+  Connection * con = (Connection *)data;
 
-  if (inConfigWrite)
-    return;
+  con->tileScale = gtk_toggle_button_get_active(check);
+  svConnectionApplyScale(con);
 
-  // set non-re-entrance flag
-  inConfigWrite = true;
+  if (con->tileMuted)
+    svTileSnap(con);
+}
 
-  // if it's not possible to create a config directory, get out
-  if (!svConfigCreateNew(false))
+
+/* put the tiles in the grid, in order, two or three across */
+void svTileArrange ()
+{
+  const guint cols = (app->tileCount == 9 ? 3 : 2);
+  guint i = 0;
+
+  for (GList * l = app->tiles; l; l = l->next, i++)
   {
-    svLog("svConfigWrite - Could not create new config dirs or file", false);
-    inConfigWrite = false;
-    return;
+    Connection * con = l->data;
+    GtkWidget * parent = gtk_widget_get_parent(con->tileBox);
+
+    if (parent)
+      gtk_container_remove(GTK_CONTAINER(parent), con->tileBox);
+
+    gtk_grid_attach(GTK_GRID(app->tileGrid), con->tileBox, i % cols, i / cols, 1, 1);
   }
 
-  GString * outStr = g_string_new(NULL);
+  gtk_widget_show_all(app->tileGrid);
+}
 
-  // header
-  g_string_append(outStr, "# SpiritVNC - GTK 3 version\n");
-  g_string_append(outStr, "# 2022-2026 Will Brokenbourgh - to God be the glory!\n");
-  g_string_append(outStr, "# Generated by app version "SV_APP_VERSION"\n#\n");
 
-  // config version
-  g_string_append(outStr, "configver=1.0\n");
+/* move a connected connection's screen from the display stack into a new tile */
+void svTileAdd (Connection * con)
+{
+  GtkWidget * screen = svConnectionScreen(con);
 
-  // --- app options ---
+  if (con->tileBox || !screen || gtk_widget_get_parent(screen) != app->displayStack)
+    return;
 
-  // list width
-  g_string_append_printf(outStr, "hostlistwidth=%i\n", app->serverListWidth);
+  con->tileScale = true;
+  con->tileMuted = true;
+  con->tileSnapTime = 0;
+
+  // name and scale checkbox over the screen
+  con->tileBox = g_object_ref_sink(gtk_box_new(GTK_ORIENTATION_VERTICAL, 0));
+  gtk_widget_set_hexpand(con->tileBox, true);
+  gtk_widget_set_vexpand(con->tileBox, true);
+
+  GtkWidget * bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 7);
+  gtk_container_set_border_width(GTK_CONTAINER(bar), 2);
+  gtk_box_pack_start(GTK_BOX(con->tileBox), bar, false, false, 0);
+
+  GtkWidget * label = gtk_label_new(con->name->str);
+  gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+  gtk_box_pack_start(GTK_BOX(bar), label, true, true, 0);
+  g_object_set_data(G_OBJECT(con->tileBox), "label", label);
+
+  GtkWidget * chkScale = gtk_check_button_new_with_label("Scale");
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(chkScale), true);
+  svSetTooltip(chkScale, "Scales this tile's screen to fit the tile");
+  gtk_box_pack_end(GTK_BOX(bar), chkScale, false, false, 0);
+  g_signal_connect(chkScale, "toggled", G_CALLBACK(svTileScaleToggled), con);
+
+  // an unscaled screen scrolls inside its tile
+  GtkWidget * scroller = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroller), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_box_pack_start(GTK_BOX(con->tileBox), scroller, true, true, 0);
+  g_signal_connect(scroller, "size-allocate", G_CALLBACK(svHandleViewportResize), con);
+
+  // (clicks the screen doesn't take - i.e. while its tile isn't focused - end up here)
+  GtkWidget * eventBox = gtk_event_box_new();
+  gtk_container_add(GTK_CONTAINER(scroller), eventBox);
+  g_signal_connect(eventBox, "button-press-event", G_CALLBACK(svTileClicked), con);
+
+  // move the screen over (keeping it alive while it's between parents)
+  g_object_ref(screen);
+  gtk_container_remove(GTK_CONTAINER(app->displayStack), screen);
+  gtk_container_add(GTK_CONTAINER(eventBox), screen);
+  g_object_unref(screen);
+
+  con->tileDrawHandler = g_signal_connect(screen, "draw", G_CALLBACK(svTileDraw), con);
+
+  svTileApplyInput(con);
+  svConnectionApplyScale(con);
+
+  app->tiles = g_list_append(app->tiles, con);
+}
 
-  // show tooltips
-  g_string_append_printf(outStr, "showtooltips=%i\n", svIntFromBool(app->showTooltips));
 
-  // log to file
-  g_string_append_printf(outStr, "logtofile=%i\n", svIntFromBool(app->logToFile));
+/* put a tiled connection's screen back in the display stack */
+void svTileRemove (Connection * con)
+{
+  if (!con->tileBox)
+    return;
 
-  // debug mode
-  g_string_append_printf(outStr, "debugmode=%i\n", svIntFromBool(app->debugMode));
+  GtkWidget * screen = svConnectionScreen(con);
 
-  // window maximized
-  g_string_append_printf(outStr, "maximized=%i\n", svIntFromBool(app->maximized));
+  if (screen)
+  {
+    g_signal_handler_disconnect(screen, con->tileDrawHandler);
 
-  // scan wait time
-  g_string_append_printf(outStr, "scantimeout=%i\n", app->scanTimeout);
+    g_object_ref(screen);
+    gtk_container_remove(GTK_CONTAINER(gtk_widget_get_parent(screen)), screen);
+    gtk_stack_add_named(GTK_STACK(app->displayStack), screen, con->name->str);
+    g_object_unref(screen);
+  }
 
-  // vnc connect timeout
-  g_string_append_printf(outStr, "vnctimeout=%i\n", app->vncConnectWaitTime);
+  GtkWidget * parent = gtk_widget_get_parent(con->tileBox);
 
-  // ssh command
-  g_string_append_printf(outStr, "sshcommand=%s\n", app->sshCommand->str);
+  if (parent)
+    gtk_container_remove(GTK_CONTAINER(parent), con->tileBox);
 
-  // ssh connect timeout
-  g_string_append_printf(outStr, "sshtimeout=%i\n", app->sshConnectWaitTime);
+  gtk_widget_destroy(con->tileBox);
+  g_object_unref(con->tileBox);
 
-  // space
-  g_string_append(outStr, "\n");
+  con->tileBox = NULL;
+  con->tileDrawHandler = 0;
+  con->tileMuted = false;
 
-  // --- per-connection settings ---
-  // go through connection list and add each connection's settings
-  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+  if (con->tileSnap)
+  {
+    cairo_surface_destroy(con->tileSnap);
+    con->tileSnap = NULL;
+  }
 
-  for (GList * l = rows; l; l = l->next)
+  app->tiles = g_list_remove(app->tiles, con);
+
+  if (app->tileFocus == con)
+    app->tileFocus = NULL;
+
+  // back to the connection's own settings
+  if (screen)
   {
-    GtkListBoxRow * row = l->data;
-    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+    svTileApplyInput(con);
+    svConnectionApplyScale(con);
+    svRemoteResizeSoon(con);
+  }
+}
 
-    const Connection * con = g_object_get_data(G_OBJECT(box), "con");
 
-    if (!con || con->name->len == 0 || con->type == SV_TYPE_VNC_REVERSE)
-      continue;
+/* order connections most recently viewed first */
+gint svTileCompareViewed (gconstpointer a, gconstpointer b)
+{
+  const gint64 viewedA = ((const Connection *)a)->lastViewed;
+  const gint64 viewedB = ((const Connection *)b)->lastViewed;
 
-    g_string_append_printf(outStr, "host=%s\n", con->name->str);
-    g_string_append_printf(outStr, "group=%s\n", con->group->str);
-    g_string_append_printf(outStr, "address=%s\n", con->address->str);
-    g_string_append_printf(outStr, "type=%i\n", con->type);
-    g_string_append_printf(outStr, "vncport=%s\n", con->vncPort->str);
-    g_string_append_printf(outStr, "vncpass=%s\n", con->vncPass->str);
-    g_string_append_printf(outStr, "vncloginuser=%s\n", con->vncLoginUser->str);
-    g_string_append_printf(outStr, "vncloginpass=%s\n", con->vncLoginPass->str);
-    g_string_append_printf(outStr, "scale=%i\n", svIntFromBool(con->scale));
-    g_string_append_printf(outStr, "lossyencoding=%i\n", svIntFromBool(con->lossyEncoding));
-    g_string_append_printf(outStr, "quality=%i\n", con->quality);
-    g_string_append_printf(outStr, "sshuser=%s\n", con->sshUser->str);
-    g_string_append_printf(outStr, "sshpass=%s\n", con->sshPass->str);
-    g_string_append_printf(outStr, "sshport=%s\n", con->sshPort->str);
-    g_string_append_printf(outStr, "sshkeyprivate=%s\n", con->sshPrivKeyfile->str);
-    g_string_append_printf(outStr, "f12macro=%s\n", con->f12Macro->str);
-    g_string_append_printf(outStr, "quicknote=%s\n", con->quickNote->str);
-    g_string_append_printf(outStr, "lastconnecttime=%s\n", con->lastConnectTime->str);
-    g_string_append_printf(outStr, "customcmd1enabled=%i\n", svIntFromBool(con->customCmd1Enabled));
-    g_string_append_printf(outStr, "customcmd1label=%s\n", con->customCmd1Label->str);
-    g_string_append_printf(outStr, "customcmd1=%s\n", con->customCmd1->str);
-    g_string_append_printf(outStr, "customcmd2enabled=%i\n", svIntFromBool(con->customCmd2Enabled));
-    g_string_append_printf(outStr, "customcmd2label=%s\n", con->customCmd2Label->str);
-    g_string_append_printf(outStr, "customcmd2=%s\n", con->customCmd2->str);
-    g_string_append_printf(outStr, "customcmd3enabled=%i\n", svIntFromBool(con->customCmd3Enabled));
-    g_string_append_printf(outStr, "customcmd3label=%s\n", con->customCmd3Label->str);
-    g_string_append_printf(outStr, "customcmd3=%s\n", con->customCmd3->str);
-    g_string_append_printf(outStr, "viewonly=%i\n", svIntFromBool(con->viewOnly));
+  return (viewedA < viewedB) - (viewedA > viewedB);
+}
 
-    // empty line after this connection
-    g_string_append(outStr, "\n");
-  }
 
-  // empty line at end of file
-  g_string_append(outStr, "\n");
+/* keep the tiles full of connected connections (most recently viewed first) */
+void svTileLayout ()
+{
+  if (app->tileCount == 0)
+    return;
 
-  // --- attempt to write config file out ---
-  if (!g_file_set_contents(app->appConfigFile->str, outStr->str, -1, NULL))
-    svLog("svConfigWrite - Error: SpiritVNC could not write config file", false);
+  // drop tiles whose connection has gone
+  GList * l = app->tiles;
 
-  g_list_free(rows);
-  g_string_free(outStr, true);
+  while (l)
+  {
+    GList * next = l->next;
+    Connection * con = l->data;
 
-  // set no-re-entrance flag
-  inConfigWrite = false;
-}
+    if (con->state != SV_STATE_CONNECTED || !svConnectionScreen(con))
+      svTileRemove(con);
 
+    l = next;
+  }
 
-/* sets a connection's icon in the connection list */
-void svSetIconFromConnectionName (const char * text, guint state)
-{
+  // fill free tiles with what's connected and showing nowhere else
+  GList * candidates = NULL;
   GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
 
-  // loop through each row
-  for (GList * l = rows; l != NULL; l = l->next)
+  for (l = rows; l; l = l->next)
   {
-    GtkWidget * row = GTK_WIDGET(l->data);
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
+    Connection * con = box ? g_object_get_data(G_OBJECT(box), "con") : NULL;
+    GtkWidget * screen = con ? svConnectionScreen(con) : NULL;
 
-    // get box that holds status image and label
-    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
-    if (!rowBox)
-      continue;
+    if (con && con->state == SV_STATE_CONNECTED && !con->tileBox && screen &&
+      gtk_widget_get_parent(screen) == app->displayStack)
+      candidates = g_list_prepend(candidates, con);
+  }
 
-    // get box's children
-    GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+  g_list_free(rows);
 
-    GtkWidget * img = (GtkWidget *)g_list_nth_data(boxChildren, 0);
-    GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+  candidates = g_list_sort(candidates, svTileCompareViewed);
 
-    g_list_free(boxChildren);
+  for (l = candidates; l && g_list_length(app->tiles) < app->tileCount; l = l->next)
+    svTileAdd(l->data);
 
-    // get label's text, if any
-    const char * lText = gtk_label_get_text(GTK_LABEL(label));
+  g_list_free(candidates);
 
-    if (!lText)
-      continue;
+  svTileArrange();
 
-    // if the label text matches, modify the icon
-    if (strcmp(lText, text) == 0)
-    {
-      if (img)
-      {
-        gtk_image_clear(GTK_IMAGE(img));
+  if (!app->tileFocus && app->tiles)
+    svTileFocus(g_list_find(app->tiles, app->selectedConnection) ? app->selectedConnection : app->tiles->data);
 
-        // image
-        GdkPixbuf * pb;
+  gtk_stack_set_visible_child(GTK_STACK(app->displayStack), app->tileGrid);
+}
 
-        switch (state)
-        {
-          case SV_STATE_DISCONNECTED:
-            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected.png", NULL);
-            break;
 
-          case SV_STATE_CONNECTED:
-            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/connected.png", NULL);
-            break;
+/* lay the tiles out again once the current change has settled */
+gboolean svTileLayoutIdle (gpointer unused)
+{
+  app->tileLayoutSource = 0;
 
-          case SV_STATE_WAITING:
-            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/connecting.png", NULL);
-            break;
+  svTileLayout();
 
-          case SV_STATE_TIMEOUT:
-            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/noconnect.png", NULL);
-            break;
+  return G_SOURCE_REMOVE;
+}
 
-          case SV_STATE_ERROR:
-            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/disconnected_error.png", NULL);
-            break;
 
-          default:
-            pb = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/blank.png", NULL);
-        }
+/* ask for the tiles to be laid out again (connections coming and going change them) */
+void svTileLayoutSoon ()
+{
+  if (app->tileCount > 0 && app->tileLayoutSource == 0)
+    app->tileLayoutSource = g_idle_add(svTileLayoutIdle, NULL);
+}
 
-        // set the icon
-        gtk_image_set_from_pixbuf(GTK_IMAGE(img), pb);
 
-      }
+/* show a connected connection in a tile (taking over the least recently viewed one if they're full), */
+/* and focus it */
+void svTileShow (Connection * con)
+{
+  if (!con->tileBox)
+  {
+    if (g_list_length(app->tiles) >= app->tileCount)
+    {
+      GList * byViewed = g_list_sort(g_list_copy(app->tiles), svTileCompareViewed);
+      svTileRemove(g_list_last(byViewed)->data);
+      g_list_free(byViewed);
+    }
+
+    svTileAdd(con);
 
+    // (not on show anywhere yet)
+    if (!con->tileBox)
       return;
-    }
+
+    svTileArrange();
   }
 
-  g_list_free(rows);
+  svTileFocus(con);
+
+  gtk_stack_set_visible_child(GTK_STACK(app->displayStack), app->tileGrid);
 }
 
 
-/* sets a connection's text in the connection list */
-void svSetTextFromConnectionName (const char * currentText, const char * newText)
+/* switch between one screen at a time (count 0) and 2, 4 or 9 tiles */
+void svTileSetCount (guint count)
 {
-  if (!currentText || !newText)
+  if (count == app->tileCount)
     return;
 
-  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+  app->tileCount = count;
 
-  // loop through each row
-  for (GList * l = rows; l != NULL; l = l->next)
+  if (count == 0)
   {
-    GtkWidget * row = GTK_WIDGET(l->data);
-
-    // get box that holds status image and label
-    GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+    while (app->tiles)
+      svTileRemove(app->tiles->data);
 
-    if (!rowBox)
-      continue;
+    if (app->tileSource > 0)
+    {
+      g_source_remove(app->tileSource);
+      app->tileSource = 0;
+    }
 
-    // get box's children
-    GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+    gtk_widget_set_visible(app->tileGrid, false);
 
-    GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+    // back to showing the selected connection by itself
+    svConnectionSwitch(app->selectedConnection);
 
-    g_list_free(boxChildren);
+    svLog("Tile view off", true);
+    return;
+  }
 
-    // get label's text, if any
-    const char * lText = gtk_label_get_text(GTK_LABEL(label));
+  if (!app->tileGrid)
+  {
+    app->tileGrid = gtk_grid_new();
+    gtk_grid_set_row_homogeneous(GTK_GRID(app->tileGrid), true);
+    gtk_grid_set_column_homogeneous(GTK_GRID(app->tileGrid), true);
+    gtk_grid_set_row_spacing(GTK_GRID(app->tileGrid), 3);
+    gtk_grid_set_column_spacing(GTK_GRID(app->tileGrid), 3);
+    gtk_widget_set_hexpand(app->tileGrid, true);
+    gtk_widget_set_vexpand(app->tileGrid, true);
+    gtk_stack_add_named(GTK_STACK(app->displayStack), app->tileGrid, "tiles");
+  }
 
-    if (!lText)
-      continue;
+  // fewer tiles than before drops the least recently viewed
+  if (g_list_length(app->tiles) > count)
+  {
+    GList * byViewed = g_list_sort(g_list_copy(app->tiles), svTileCompareViewed);
 
-    // if the label text matches, change to new text
-    if (strcmp(lText, currentText) == 0)
-    {
-      if (label)
-        gtk_label_set_label(GTK_LABEL(label), newText);
+    for (GList * l = g_list_nth(byViewed, count); l; l = l->next)
+      svTileRemove(l->data);
 
-      return;
-    }
+    g_list_free(byViewed);
   }
 
-  g_list_free(rows);
-}
+  gtk_widget_set_visible(app->tileGrid, true);
 
+  if (app->tileSource == 0)
+    app->tileSource = g_timeout_add(SV_TILE_REFRESH_MS, svTileTimer, NULL);
 
-/* closes all connections (typically when exiting program) */
-void svEndAllConnections ()
-{
-  // end all viewers
-  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
-
-  for (GList * l = rows; l; l = l->next)
-  {
-    GtkListBoxRow * row = l->data;
-    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+  svTileLayout();
 
-    const Connection * con = g_object_get_data(G_OBJECT(box), "con");
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Tile view of %u", count);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+}
 
-    if (con && con->state == SV_STATE_CONNECTED && con->vncObj)
-      vnc_display_close(VNC_DISPLAY(con->vncObj));
-  }
 
-  g_list_free(rows);
+/* menu item handler - pick a tile layout */
+void svHandleTileMenuItem (GtkCheckMenuItem * item, gpointer data)
+{
+  // (radio items toggle off too - only the one turning on counts)
+  if (gtk_check_menu_item_get_active(item))
+    svTileSetCount(GPOINTER_TO_UINT(data));
 }
 
 
-/* shut everything down and quit the app */
-void svDoQuit ()
+/* switch from one connection to another */
+/* (usually from a single click on the connection listbox) */
+void svConnectionSwitch (Connection * con)
 {
-  svEndAllConnections();
-
-  svConfigWrite();
+  // ***### DO NOT CHECK CON FOR NULL HERE!!! ###***
 
-  svLog("--- App ending ---", false);
+  // no re-entry
+  static gboolean inConnectionSwitch = false;
 
-  g_application_quit(G_APPLICATION(app->gApp));
-}
+  if (inConnectionSwitch)
+    return;
 
+  inConnectionSwitch = true;
 
-/*  find unused TCP port in 'ephemeral / temporary' range  */
-gint svFindFreeTcpPort ()
-{
-  gint nSock = 0;
-  struct sockaddr_in structSockAddress;
+  // disable tools menu items initially
+  svSetToolsMenuItems(false);
 
-  structSockAddress.sin_family = AF_INET;
-  structSockAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+  // the connection being left was viewed up until now
+  if (app->selectedConnection && app->selectedConnection != con)
+    app->selectedConnection->lastViewed = g_get_monotonic_time();
 
-  nSock = socket(AF_INET, SOCK_STREAM, 0);
+  // save previous quicknote before switching
+  svSavePreviousQuickNoteText(con);
 
-  if (nSock < 0)
+  // there's no connection here, blank quicknote stuffs
+  if (!con)
   {
-    svLog("svFindFreeTcpPort - ERROR - Cannot create socket for svFindFreeTCPPort", false);
-    return 0;
-  }
+    svPreviewHide(app->previewCon);
+    app->selectedConnection = NULL;
+    gtk_label_set_text(GTK_LABEL(app->quickNoteLabel), "-");
+    gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), "-");
+    svReconnectShowStatus(NULL);
+    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, "", -1);
+    gtk_text_buffer_set_text(app->quickNoteBuffer, "", -1);
 
-  // go through a range of startingLocalPort to + 99 to see if we can use for ssh forwarding
-  for (uint16_t nPort = 49152; nPort < 65534; nPort ++)
+    inConnectionSwitch = false;
+
+    return;
+  }
+  else
   {
-    structSockAddress.sin_port = htons((unsigned short)nPort);
+    // log
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Switching to connection '%s - %s'", con->name->str, con->address->str);
+    svLog(logStr->str, true);
+    g_string_free(logStr, true);
 
-    // don't clobber the listening port
-    if (nPort == 5500)
-      continue;
+    // fill quicknote label, last error text and quicknote text
+    gtk_label_set_text(GTK_LABEL(app->quickNoteLabel), con->name->str);
 
-    // if nothing is on this port and it's not the reverse vnc port, return the port number
-    if (bind(nSock, (const struct sockaddr *)&structSockAddress, sizeof(structSockAddress)) == 0)
+    if (con->lastConnectTime->len > 0)
     {
-      close(nSock);
-      return nPort;
+      GString * strTime = g_string_new(NULL);
+      g_string_printf(strTime, "Last connected: %s", con->lastConnectTime->str);
+      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), strTime->str);
+      g_string_free(strTime, true);
     }
-  }
+    else
+      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), "-");
 
-  close(nSock);
+    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, con->lastErrorMessage->str, -1);
 
-  return 0;
-}
+    gsize outLen = 0;
+    unsigned char * qNote = g_base64_decode(con->quickNote->str, &outLen);
+    gtk_text_buffer_set_text(app->quickNoteBuffer, (const char *)qNote, -1);
+    g_free(qNote);
 
+    // set selected connection to passed connection
+    app->selectedConnection = con;
+    con->lastViewed = g_get_monotonic_time();
 
-/* deal with server list clicks */
-gboolean svHandleConnectionListClicks (GtkWidget * widget, GdkEvent * event, void * data)
-{
-  GdkEventType type = gdk_event_get_event_type(event);
+    svReconnectShowStatus(con);
 
-  // if not a left or right button press, get out
-  if (type != GDK_BUTTON_PRESS && type != GDK_2BUTTON_PRESS)
-    return false;
+    // bring back a connection that was closed for being idle
+    if (con->state == SV_STATE_IDLE && app->idleReconnect)
+      svConnectionCreate(con);
+    // otherwise get a head start in case it's opened next
+    else
+      svWarmStart(con);
 
-  guint clickCount = 0;
-  guint button = 0;
+    // a connecting connection shows its last-known screen until the real one arrives
+    if (con->state == SV_STATE_WAITING)
+      svPreviewShow(con);
+    else
+      svPreviewHide(app->previewCon);
 
-  // set last button number
-  if (!gdk_event_get_button(event, &button))
-    return false;
+    // in tile view a connected connection gets (or already has) a tile, and the focus
+    if (app->tileCount > 0 && con->state == SV_STATE_CONNECTED && svConnectionScreen(con) && !con->detachWin)
+    {
+      svTileShow(con);
 
-  // set last click count
-  if (!gdk_event_get_click_count(event, &clickCount))
-    return false;
+      if (con->vncObj)
+        svClipPushLocal(con);
 
-  double x = 0;
-  double y = 0;
+      svSetToolsMenuItems(true);
+    }
+    // a detached connection just comes forward in its own window
+    else if (con->state == SV_STATE_CONNECTED && con->detachWin)
+    {
+      gtk_window_present(GTK_WINDOW(con->detachWin));
 
-  // get the row's internal name from the mouse's y position
-  if (!gdk_event_get_coords(event, &x, &y))
-    return false;
+      svSetToolsMenuItems(true);
+    }
+    // show vnc obj if it's connected
+    else if (con->state == SV_STATE_CONNECTED && con->vncObj)
+    {
+      // show vnc display
+      gtk_widget_set_visible(con->vncObj, true);
+      gtk_stack_set_visible_child(GTK_STACK(app->displayStack), con->vncObj);
+      // set keyboard focus
+      gtk_widget_set_can_focus(con->vncObj, true);
+      // tell the parent container that THIS is the focus child
+      gtk_container_set_focus_child(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
+      gtk_container_set_focus_child(GTK_CONTAINER(app->displayStack), con->vncObj);
 
-  // hide any active display if list is single-clicked
-  if (button != GDK_BUTTON_SECONDARY && clickCount == 1)
-  {
-    GtkWidget * currentDisplay = gtk_stack_get_visible_child(GTK_STACK(app->displayStack));
+      /* Attempt to focus the vnc display. Unfortunately we have to get a little 'creative'
+       * here and try two different ways (because the idle_add doesn't always work)
+       */
+
+      // try to focus the vnc display at idle time
+      g_idle_add((GSourceFunc)svFocusOnce, con->vncObj);
+      // try to focus the vnc display (again) after 300 milliseconds
+      g_timeout_add_once(300, (GSourceOnceFunc)gtk_widget_grab_focus, con->vncObj);
+
+      gtk_widget_grab_focus(con->vncObj);
+
+      // hand this connection the local clipboard if it syncs to the server
+      svClipPushLocal(con);
+
+      // set tools menu items
+      svSetToolsMenuItems(true);
 
-    if (currentDisplay)
-      gtk_widget_hide(currentDisplay);
+      // (the display area may have changed size since it was last shown)
+      svRemoteResizeSoon(con);
+    }
+    // (the tools reach a viewer process through its channel)
+    else if (con->state == SV_STATE_CONNECTED && con->helper)
+    {
+      svHelperShow(con);
+      svSetToolsMenuItems(true);
+      svRemoteResizeSoon(con);
+    }
   }
 
-  // get the clicked row
-  GtkListBoxRow * row = gtk_list_box_get_row_at_y(GTK_LIST_BOX(widget), y);
-  if (!row)
+  inConnectionSwitch = false;
+}
+
+
+/* attempts to connect the vnc obj to the server */
+void svConnectionOpen (Connection * con)
+{
+  // set image quality
+  switch (con->quality)
   {
-    //printf("DEBUG: row is null in svHandleConnectionListClicks\n");
-    return false;
+    case SV_QUAL_LOW:
+      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_LOW);
+      break;
+    case SV_QUAL_MEDIUM:
+      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_MEDIUM);
+      break;
+    case SV_QUAL_FULL:
+      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_FULL);
+      break;
+    default:
+      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_DEFAULT);
   }
 
-  // get box that holds status image and label
-  GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
-  if (!rowBox)
-    return false;
+  // set read-only
+  vnc_display_set_read_only(VNC_DISPLAY(con->vncObj), con->viewOnly);
 
-  // get connection from attached rowBox data
-  Connection * con = g_object_get_data(G_OBJECT(rowBox), "con");
+  // set lossy encoding
+  vnc_display_set_lossy_encoding(VNC_DISPLAY(con->vncObj), con->lossyEncoding);
 
-  // **### DON'T check con for null here!! ###**
+  // set scaling
+  vnc_display_set_scaling(VNC_DISPLAY(con->vncObj), con->scale);
+  vnc_display_set_keep_aspect_ratio(VNC_DISPLAY(con->vncObj), TRUE);
 
-  // do stuffs based on mouse button and number of clicks
-  if (button > 0 && clickCount > 0)
+  // initiate connection
+  switch (con->type)
   {
-    // single left-click
-    if (button == GDK_BUTTON_PRIMARY && clickCount == 1)
-      svConnectionSwitch(con);
-
-    // double left-click
-    if (button == GDK_BUTTON_PRIMARY && clickCount == 2)
-      svConnectionCreate(con);
+    case SV_TYPE_VNC:
+      // resolve (through the shared cache) and connect ourselves, then hand the socket to the vnc obj
+      svConnectDirect(con);
+      break;
 
-    // single right-click
-    if (button == GDK_BUTTON_SECONDARY && clickCount == 1)
-      svConnectionRightClick(con);
-  }
+    case SV_TYPE_VNC_REVERSE:
+      // connect vnc obj directly to remote host
+      vnc_display_open_fd(VNC_DISPLAY(con->vncObj), con->listenFd);
+      break;
 
-  return false;
-}
+    case SV_TYPE_VNC_REPEATER:
+      // connect to the repeater like a direct connection, then do its handshake before handing over
+      svConnectDirect(con);
+      break;
 
+    case SV_TYPE_VNC_OVER_SSH:
+    {
+      // set up local port string
+      GString * localPortStr = g_string_new(NULL);
+      g_string_printf(localPortStr, "%u", con->sshLocalPort);
 
-/* return the Connection * of the currently-selected connection listbox item */
-Connection * svGetSelectedConnectionListConnection ()
-{
-  // figure out which connection is selected
-  GtkListBoxRow * selectedRow = gtk_list_box_get_selected_row(GTK_LIST_BOX(app->serverList));
-  if (!selectedRow)
-    return NULL;
+      // connect vnc obj to local forwarded port
+      vnc_display_open_host(VNC_DISPLAY(con->vncObj), "127.0.0.1", localPortStr->str);
+      g_string_free(localPortStr, true);
+      break;
+    }
 
-  GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(selectedRow));
-  if (!rowBox)
-    return NULL;
+    default:
+      return;
+  }
 
-  return (Connection *)g_object_get_data(G_OBJECT(rowBox), "con");
+  // INFO - vnc display is added to the stack in 'svServerInitialized' method
 }
 
 
-/* menu item handler - send update request to currently-selected server */
-void svHandleRequestUpdateMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* show error message about null con fields */
+void svShowNullConFieldsDialog (gpointer unused)
 {
-  // get the connections glist item for this index
-  const Connection * con = svGetSelectedConnectionListConnection();
-
-  if (!con || con->name->len == 0)
-    return;
+  svShowMessageDialog("One more more connection properties were NULL or invalid when attempting a SSH connection");
 
-  vnc_display_request_update(VNC_DISPLAY(con->vncObj));
+  gtk_window_present(GTK_WINDOW(app->mainWin));
 }
 
 
-/* menu item handler - send Ctrl+Alt+Del to currently-selected server */
-void svHandleSendCADMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* show about window */
+void svShowAboutWindow ()
 {
-  // get the connections glist item for this index
-  const Connection * con = svGetSelectedConnectionListConnection();
-  if (!con || con->name->len == 0)
+  GdkPixbuf * aboutImage = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/spiritvnc.png", NULL);
+  if (!aboutImage)
     return;
 
-  guint keys[] = {
-    GDK_KEY_Control_L,
-    GDK_KEY_Alt_L,
-    GDK_KEY_Delete
-  };
-
-  vnc_display_send_keys(VNC_DISPLAY(con->vncObj), keys, sizeof(keys) / sizeof(keys[0]));
-}
-
+  GtkWidget * aboutDialog = gtk_about_dialog_new();
+  const char * authors[] = {"Will Brokenbourgh", NULL};
 
-/* menu item handler - send Ctrl+Shift+Esc to currently-selected server */
-void svHandleSendCSEMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
-{
-  // get the connections glist item for this index
-  const Connection * con = svGetSelectedConnectionListConnection();
+  // set about dialog properties
+  gtk_about_dialog_set_program_name(GTK_ABOUT_DIALOG(aboutDialog), "SpiritVNC-GTK");
+  gtk_about_dialog_set_logo(GTK_ABOUT_DIALOG(aboutDialog), aboutImage);
+  gtk_about_dialog_set_version(GTK_ABOUT_DIALOG(aboutDialog), SV_APP_VERSION);
+  gtk_about_dialog_set_authors(GTK_ABOUT_DIALOG(aboutDialog), authors);
+  //gtk_about_dialog_set_website(GTK_ABOUT_DIALOG(aboutDialog), "https://www.willbrokenbourgh.com/brainout/");
+  //gtk_about_dialog_set_website_label(GTK_ABOUT_DIALOG(aboutDialog), "Will Brokenbourgh");
+  gtk_about_dialog_set_license(GTK_ABOUT_DIALOG(aboutDialog), "SpiritVNC is released under a BSD 3-Clause license");
+  gtk_about_dialog_set_comments(GTK_ABOUT_DIALOG(aboutDialog), "A multi-connection VNC viewer for Unix-like, macOS and "
+    "Windows systems");
 
-  if (!con || con->name->len == 0)
-    return;
+  // set window properties
+  gtk_window_set_transient_for(GTK_WINDOW(aboutDialog), GTK_WINDOW(app->mainWin));
+  gtk_window_set_position(GTK_WINDOW(aboutDialog), GTK_WIN_POS_CENTER_ON_PARENT);
 
-  guint keys[] = {
-    GDK_KEY_Control_L,
-    GDK_KEY_Shift_L,
-    GDK_KEY_Escape
-  };
+  // show the dialog then destroy afterwards
+  gtk_dialog_run(GTK_DIALOG(aboutDialog));
+  gtk_widget_destroy(aboutDialog);
 
-  vnc_display_send_keys(VNC_DISPLAY(con->vncObj), keys, sizeof(keys) / sizeof(keys[0]));
+  // focus the main window when done
+  gtk_window_present(GTK_WINDOW(app->mainWin));
 }
 
 
-/* menu item handler - shows 'send keys' window */
-void svHandleSendEnteredKeystrokesMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* create ssh session and ssh forwarding */
+/* (run as a thread due to blocking) */
+gpointer svCreateSSHConnection (gpointer data)
 {
-  // get the connections glist item for this index
-  Connection * con = svGetSelectedConnectionListConnection();
-  if (!con || con->name->len == 0)
-    return;
-
-  // create output window
-  GtkWidget * sendKeysWin = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-  gtk_window_set_modal(GTK_WINDOW(sendKeysWin), true);
-  gtk_window_set_transient_for(GTK_WINDOW(sendKeysWin), GTK_WINDOW(app->mainWin));
-  gtk_window_set_position(GTK_WINDOW(sendKeysWin), GTK_WIN_POS_CENTER_ON_PARENT);
-  gtk_window_set_modal(GTK_WINDOW(sendKeysWin), true);
-  gtk_window_set_resizable(GTK_WINDOW(sendKeysWin), false);
+  Connection * con = (Connection *)data;
+  if (!con)
+    return NULL;
 
-  // set window title
-  GString * titleStr = g_string_new(NULL);
-  g_string_printf(titleStr, "Send keys to '%s' - SpiritVNC", con->name->str);
-  gtk_window_set_title(GTK_WINDOW(sendKeysWin), titleStr->str);
-  g_string_free(titleStr, true);
+  // log
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Creating new SSH connection for '%s - %s'", con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-  // parent box
-  GtkWidget * boxParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
-  gtk_container_set_border_width(GTK_CONTAINER(boxParent), 5);
-  gtk_container_add(GTK_CONTAINER(sendKeysWin), boxParent);
+  #ifdef _WIN32
+  // deal with annoying Windows terminal window issues
+  AllocConsole();
+  ShowWindow(GetConsoleWindow(), SW_HIDE);
+  #endif
 
-  // container grid
-  GtkWidget * grid = gtk_grid_new();
-  gtk_grid_set_column_homogeneous(GTK_GRID(grid), false);
-  gtk_container_set_border_width(GTK_CONTAINER(grid), 7);
-  gtk_grid_set_column_spacing(GTK_GRID(grid), 7);
-  gtk_grid_set_row_spacing(GTK_GRID(grid), 5);
+  // build the ssh check command
+  char * sshCheck[] = {
+    app->sshCommand->str,
+    NULL
+  };
 
-  // add grid to parent box
-  gtk_box_pack_start(GTK_BOX(boxParent), grid, false, false, 0);
+  // first check to see if the ssh command is working
+  GError * gSSHCheckError = NULL;
+  char * stdOut = NULL;
+  char * stdErr = NULL;
+  gint exitStatus = 0;
 
-  // out label
-  GtkWidget * lblIn = gtk_label_new("Enter or paste keys / text to send below");
-  gtk_widget_set_halign(lblIn, GTK_ALIGN_START);
-  gtk_grid_attach(GTK_GRID(grid), lblIn, 1, 1, 1, 1);
+  //for (gint i = 0; sshCheck[i] != NULL; i++)
+  //{
+    //printf("%s\n", sshCheck[i]);
+  //}
 
-  // scroller for textview
-  GtkWidget * scroll = gtk_scrolled_window_new(NULL, NULL);
-  gtk_widget_set_size_request(scroll, 500, 400);
+  gboolean checkResult = g_spawn_sync(NULL,         // Working directory (NULL uses current directory)
+                      sshCheck,      // Command to execute
+                      NULL,         // Environment variables
+                      G_SPAWN_DEFAULT, // Flags
+                      NULL,         // Child setup function
+                      NULL,         // User data for child setup
+                      &stdOut,         // Standard output (NULL ignores it)
+                      &stdErr,      // Standard error (NULL ignores it)
+                      &exitStatus, // Exit status
+                      &gSSHCheckError);
 
-  gtk_grid_attach(GTK_GRID(grid), scroll, 1, 3, 1, 1);
+  (void)checkResult;
 
-  // output textview
-  GtkWidget * textIn = gtk_text_view_new();
-  //gtk_text_view_set_editable(GTK_TEXT_VIEW(textOut), false);
-  gtk_text_view_set_monospace(GTK_TEXT_VIEW(textIn), true);
+  // deal with ssh command check failure
+  // I'm only interested in gSSHCheckError and I'm purposely ignoring checkResult and exitStatus
+  if (gSSHCheckError)
+  {
+    // problemos
+    //printf("ssh error - gError code: %i, gError message: %s\n", gSSHCheckError->code, gSSHCheckError->message);
+    //printf("ssh error - exitStatus: %i, stdErr: %s\n", exitStatus, stdErr);
 
-  // add textview to scroller
-  gtk_container_add(GTK_CONTAINER(scroll), textIn);
+    // log error
+    GString * errStr = g_string_new(NULL);
+    g_string_printf(errStr,
+      "SSH command not working for connection '%s - %s'\nError: %s\nCheck command or installation",
+      con->name->str, con->address->str, gSSHCheckError->message);
+    svLog(errStr->str, false);
 
-  // ------------------- set sendkeys data --------------
-  GHashTable * ht = g_hash_table_new(NULL, NULL);
-  if (ht)
-  {
-    g_hash_table_insert(ht, "type", SV_SENDKEYS_TYPE_ENTRY);
-    g_hash_table_insert(ht, "win", sendKeysWin);
-    g_hash_table_insert(ht, "textView", textIn);
-    g_hash_table_insert(ht, "con", con);
-  }
+    // set connection's last error message
+    g_string_assign(con->lastErrorMessage, errStr->str);
+    g_idle_add_once(svSetSSHLastErrorMessage, con);
+    g_string_free(errStr, true);
 
-  // ------------------- send / cancel buttons -------------------
-  GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    // set connection variables
+    con->sshContinue = false;
+    con->disconnectType = SV_DISC_SSH_ERROR;
+    con->state = SV_STATE_ERROR;
 
-  // send
-  GtkWidget * btnSend = gtk_button_new_with_label("Send");
-  gtk_widget_set_size_request(btnSend, 110, -1);
-  svSetTooltip(btnSend, "Click to send this text");
-  g_signal_connect(btnSend, "clicked", G_CALLBACK(svHandleSendEnteredKeystrokesButtons), ht);
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnSend, false, false, 3);
+    // set connection list row's icon
+    g_idle_add_once(svSetConnectionIconFromSSHError, con);
 
-  // cancel
-  GtkWidget * btnCancel = gtk_button_new_with_label("Cancel");
-  g_hash_table_insert(ht, "btnCancel", btnCancel);
-  gtk_widget_set_size_request(btnCancel, 110, -1);
-  svSetTooltip(btnCancel, "Click to close this window without sending");
-  g_signal_connect(btnCancel, "clicked", G_CALLBACK(svHandleSendEnteredKeystrokesButtons), ht);
-  gtk_box_pack_end(GTK_BOX(boxButtons), btnCancel, false, false, 3);
-  //
-  gtk_container_add(GTK_CONTAINER(boxParent), boxButtons);
+    g_free(stdOut);
+    g_free(stdErr);
 
-  // show everything
-  gtk_widget_show_all(sendKeysWin);
+    g_error_free(gSSHCheckError);
 
-  gtk_window_present(GTK_WINDOW(sendKeysWin));
-}
+    return NULL;
+  }
 
+  g_free(stdOut);
+  g_free(stdErr);
 
-/* menu item handler - run custom command */
-void svHandleCustomCommandMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
-{
-  const char * cmd = (const char *)userData;
-  if (!cmd)
-    return;
+  //if (gSSHCheckError)
+  //{
+    ////printf("DEBUG: svCreateSSHConnection - readError pointer = %p\n", (void *)gSSHCheckError);
+    //g_error_free(gSSHCheckError);
+  //}
 
-  GError * gError = NULL;
-  char * stdOut = NULL;
+  // --- looks like we're okay ---
 
-  // run the command synchronous, will block
-  if (!g_spawn_command_line_sync(cmd, &stdOut, NULL, NULL, &gError))
+  // check that all con fields are non-null
+  if (!con->sshUser || !con->address || con->sshPort->len == 0 ||
+      con->sshLocalPort == 0 || !con->vncPort || !con->sshPrivKeyfile)
   {
-    GtkWidget * dialog = gtk_message_dialog_new_with_markup(GTK_WINDOW(app->mainWin),
-                                      GTK_DIALOG_DESTROY_WITH_PARENT,
-                                      GTK_MESSAGE_ERROR,
-                                      GTK_BUTTONS_CLOSE,
-                                      "<b>Error running custom command</b>\n\n%s",
-                                      gError->message);
-    gtk_dialog_run(GTK_DIALOG(dialog));
-    gtk_widget_destroy(dialog);
-
-    gtk_window_present(GTK_WINDOW(app->mainWin));
+    g_idle_add_once(svShowNullConFieldsDialog, NULL);
+    return NULL;
+  }
 
-    if (gError)
-      g_error_free(gError);
+  GError * sshRunErr = NULL;
+  GPid pid = 0;
 
-     return;
-  }
-  else
-  {
-    // show command output if not null or empty
-    if (stdOut && stdOut[0] != '\0')
-    {
-      // create output window
-      GtkWidget * outWin = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-      gtk_window_set_modal(GTK_WINDOW(outWin), true);
+  // ** build the command string for our g_spawn_async_with_pipes call **
 
-      // set window title
-      gtk_window_set_title(GTK_WINDOW(outWin), "Custom command output - SpiritVNC");
-      gtk_window_set_modal(GTK_WINDOW(outWin), true);
-      gtk_window_set_resizable(GTK_WINDOW(outWin), false);
-      gtk_window_set_transient_for(GTK_WINDOW(outWin), GTK_WINDOW(app->mainWin));
-      gtk_window_set_position(GTK_WINDOW(outWin), GTK_WIN_POS_CENTER_ON_PARENT);
+  // build "user@host"
+  GString * tgt = g_string_new(NULL);
+  g_string_printf(tgt, "%s@%s", con->sshUser->str, con->address->str);
+  char * sshTargetString = tgt->str;
 
-      // parent box
-      GtkWidget * boxParent = gtk_box_new(GTK_ORIENTATION_VERTICAL, 7);
-      gtk_container_set_border_width(GTK_CONTAINER(boxParent), 5);
-      gtk_container_add(GTK_CONTAINER(outWin), boxParent);
+  // build "localPort:127.0.0.1:vncPort"
+  GString * fwd = g_string_new(NULL);
+  g_string_printf(fwd, "%i:127.0.0.1:%s", con->sshLocalPort, con->vncPort->str);
+  char * localForwardString = fwd->str;
 
-      // container grid
-      GtkWidget * grid = gtk_grid_new();
-      gtk_grid_set_column_homogeneous(GTK_GRID(grid), false);
-      gtk_container_set_border_width(GTK_CONTAINER(grid), 7);
-      gtk_grid_set_column_spacing(GTK_GRID(grid), 7);
-      gtk_grid_set_row_spacing(GTK_GRID(grid), 5);
+  // have ssh notice a dead server too, when there's a dead-peer timeout
+  // (otherwise it's left out, so a keepalive set in ssh_config still applies)
+  GString * alive = g_string_new(NULL);
+  g_string_printf(alive, "ServerAliveInterval=%u", MAX(con->liveTimeout / 3, 1));
 
-      // add grid to parent box
-      gtk_box_pack_start(GTK_BOX(boxParent), grid, false, false, 0);
+  // TODO: Include -i parameter only if there's a private key file set
 
-      // command label (to show command that was executed)
-      GtkWidget * lblCmd = gtk_label_new("");
-      gtk_widget_set_halign(lblCmd, GTK_ALIGN_START);
-      GString * cmdString = g_string_new(NULL);
-      g_string_printf(cmdString, "Command: '%s'", cmd);
-      gtk_label_set_text(GTK_LABEL(lblCmd), cmdString->str);
-      g_string_free(cmdString, true);
-      gtk_grid_attach(GTK_GRID(grid), lblCmd, 1, 2, 1, 1);
+  // build argv array for SSH
+  char * sshArgv[16];
+  gint nArg = 0;
+
+  sshArgv[nArg++] = app->sshCommand->str;  // "/usr/bin/ssh", etc
+  sshArgv[nArg++] = "-t";
+  sshArgv[nArg++] = "-t";
+  sshArgv[nArg++] = "-p";
+  sshArgv[nArg++] = con->sshPort->str;
+  sshArgv[nArg++] = "-o";
+  sshArgv[nArg++] = "ConnectTimeout=5";
+
+  if (con->liveTimeout > 0)
+  {
+    sshArgv[nArg++] = "-o";
+    sshArgv[nArg++] = alive->str;
+  }
 
-      // scroller for textview
-      GtkWidget * scroll = gtk_scrolled_window_new(NULL, NULL);
-      gtk_widget_set_size_request(scroll, 500, 400);
+  sshArgv[nArg++] = "-L";
+  sshArgv[nArg++] = localForwardString;
+  sshArgv[nArg++] = "-i";
+  sshArgv[nArg++] = con->sshPrivKeyfile->str;
+  sshArgv[nArg++] = sshTargetString;
+  sshArgv[nArg] = NULL;
 
-      gtk_grid_attach(GTK_GRID(grid), scroll, 1, 3, 1, 1);
+  //for (gint i = 0; sshArgv[i] != NULL; i++)
+  //{
+    //printf("%s\n", sshArgv[i]);
+  //}
 
-      // output textview
-      GtkWidget * textOut = gtk_text_view_new();
-      gtk_text_view_set_editable(GTK_TEXT_VIEW(textOut), false);
-      gtk_text_view_set_monospace(GTK_TEXT_VIEW(textOut), true);
+  // attempt to call the system's ssh client and open write stream
+  gboolean sshRunOkay = g_spawn_async_with_pipes(
+                  NULL,
+                  sshArgv,               // SSH command array
+                  NULL,
+                  G_SPAWN_DEFAULT, //G_SPAWN_DO_NOT_REAP_CHILD,
+                  NULL,
+                  NULL,
+                  &pid,
+                  &con->sshStdIn,
+                  NULL,
+                  NULL,
+                  &sshRunErr);
 
-      // set textview text
-      GtkTextBuffer * tb = gtk_text_view_get_buffer(GTK_TEXT_VIEW(textOut));
-      gtk_text_buffer_set_text(tb, stdOut, -1);
+  (void)sshRunOkay;
 
-      // add textview to scroller
-      gtk_container_add(GTK_CONTAINER(scroll), textOut);
+  // we only care about sshRunError, not sshRunOkay
+  if (sshRunErr || !con->sshStdIn)
+  {
+    // something -- happened - log the failure
+    GString * errStr = g_string_new(NULL);
+    g_string_printf(errStr, "SSH command failed for '%s - %s'", con->name->str, con->address->str);
+    svLog(errStr->str, false);
 
-      // ------------------- ok button -------------------
-      GtkWidget * boxButtons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    // set connection's last error message
+    g_string_assign(con->lastErrorMessage, errStr->str);
+    g_idle_add_once(svSetSSHLastErrorMessage, con);
+    g_string_free(errStr, true);
 
-      // okay
-      GtkWidget * btnOk = gtk_button_new_with_label("OK");
-      gtk_widget_set_size_request(btnOk, 110, -1);
-      g_signal_connect(btnOk, "clicked", G_CALLBACK(svHandleCommandOutputOk), outWin);
+    // set connection variables
+    con->sshContinue = false;
+    con->disconnectType = SV_DISC_SSH_ERROR;
+    con->state = SV_STATE_ERROR;
 
-      gtk_box_pack_end(GTK_BOX(boxButtons), btnOk, false, false, 3);
-      //
-      gtk_container_add(GTK_CONTAINER(boxParent), boxButtons);
+    // set connection list row icon
+    g_idle_add_once(svSetConnectionIconFromSSHError, con);
 
-      // show everything
-      gtk_widget_show_all(outWin);
+    // free up stuff
+    g_string_free(tgt, true);
+    g_string_free(fwd, true);
+    g_string_free(alive, true);
 
-      gtk_window_present(GTK_WINDOW(outWin));
-    }
+    g_error_free(sshRunErr);
 
-    if (stdOut)
-      g_free(stdOut);
+    return NULL;
   }
-}
 
+  // free up stuff
+  g_string_free(tgt, true);
+  g_string_free(fwd, true);
+  g_string_free(alive, true);
+
+  con->sshPid = pid;
 
-/* menu item handler - call connection start */
-void svHandleConnectMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
-{
-  Connection * con = (Connection *)userData;
-  if (!con)
-    return;
+  con->sshContinue = true;
 
-  svConnectionCreate(con);
+  return NULL;
 }
 
-
-/* menu item handler - call connection end */
-void svHandleDisconnectMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* handle mac menu bar 'quit' action */
+void svAppMenuAboutAction (GSimpleAction * action, GVariant * parameter, gpointer user_data)
 {
-  Connection * con = (Connection *)userData;
-  if (!con)
-    return;
-
-  svConnectionEnd(con);
+  svShowAboutWindow();
 }
 
 
-/* menu item handler - call connection editor */
-void svHandleEditMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* handle mac menu bar 'quit' action */
+void svAppMenuSettingsAction (GSimpleAction * action, GVariant * parameter, gpointer user_data)
 {
-  Connection * con = (Connection *)userData;
-  if (!con)
-    return;
-
-  svShowConnectionEditWindow(con);
+  svShowAppOptionsWindow();
 }
 
-/* menu item handler - call connection editor */
-void svHandleSyncClipboardMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* handle mac menu bar 'quit' action */
+void svAppMenuQuitAction (GSimpleAction * action, GVariant * parameter, gpointer user_data)
 {
-  const Connection * con = (Connection *)userData;
-  if (!con || !con->clipboard || con->clipboard->len < 1)
-    return;
-
-  // set local keyboard
-  GtkClipboard * cb = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
-  if (!cb)
-    return;
-
-  gtk_clipboard_set_text(cb, con->clipboard->str, -1);
+  svDoQuit();
+  g_application_quit(G_APPLICATION(user_data));
 }
 
 
-/* menu item handler - get right-clicked connection's f12 macro (NOT on clipboard!) */
-void svHandleF12GetMacroMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* finish a pending command-line screenshot - save it, or tell the caller why not */
+void svRemoteShotFinish (Connection * con, const char * error)
 {
-  const Connection * con = (Connection *)userData;
-
-  if (!con)
+  if (!con || !con->shotCmdLine)
     return;
 
-  g_string_assign(app->f12Storage, con->f12Macro->str);
-}
-
+  if (con->shotSource > 0)
+  {
+    g_source_remove(con->shotSource);
+    con->shotSource = 0;
+  }
 
-/* menu item handler - set right-clicked connection's f12 macro (NOT from clipboard!) */
-void svHandleF12PutMacroMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
-{
-  const Connection * con = (Connection *)userData;
-  if (!con)
-    return;
+  GApplicationCommandLine * cmdLine = con->shotCmdLine;
+  con->shotCmdLine = NULL;
 
-  gint res = -1;
+  GError * saveError = NULL;
 
-  // if there's an existing f12 macro, confirm overwriting first
-  if (con->f12Macro->len > 0)
+  if (!error && !svConnectionScreen(con))
+    error = "not connected";
+
+  if (!error)
   {
-    GtkWidget * dialog = gtk_message_dialog_new(GTK_WINDOW(app->mainWin),
-                                    GTK_DIALOG_DESTROY_WITH_PARENT,
-                                    GTK_MESSAGE_QUESTION,
-                                    GTK_BUTTONS_YES_NO,
-                                    "Are you sure you want to replace the existing F12 macro for '%s'?",
-                                    con->name->str);
-    res = gtk_dialog_run(GTK_DIALOG(dialog));
+    GdkPixbuf * pic = svConnectionPixbuf(con);
 
-    // destroy the dialog box
-    gtk_widget_destroy(dialog);
+    if (!pic)
+      error = "no screen image yet";
+    else
+    {
+      if (!gdk_pixbuf_save(pic, con->shotFile->str, "png", &saveError, "tEXt::Generator App", "spiritvncgtk", NULL))
+        error = saveError->message;
 
-    gtk_window_present(GTK_WINDOW(app->mainWin));
+      g_object_unref(pic);
+    }
   }
 
-  // only set f12 macro if user confirms 'ok' to overwriting or there's nothing to overwrite
-  if (res == GTK_RESPONSE_YES || con->f12Macro->len == 0)
+  // log
+  GString * logStr = g_string_new(NULL);
+
+  if (error)
   {
-    g_string_assign(con->f12Macro, app->f12Storage->str);
-    svConfigWrite();
+    g_string_printf(logStr, "Command-line screenshot of '%s' failed: %s", con->name->str, error);
+    g_application_command_line_printerr(cmdLine, "spiritvnc: screenshot of '%s' failed: %s\n", con->name->str, error);
+    g_application_command_line_set_exit_status(cmdLine, 1);
   }
-}
+  else
+    g_string_printf(logStr, "Command-line screenshot of '%s' saved to '%s'", con->name->str, con->shotFile->str);
 
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
 
-/* clean up connection object if deleted */
-void svFreeConnObject(Connection * con)
-{
-  if (!con)
-    return;
+  if (saveError)
+    g_error_free(saveError);
 
-  if (con->name)
-    g_string_free(con->name, true);
-  if (con->group)
-    g_string_free(con->group, true);
-  if (con->address)
-    g_string_free(con->address, true);
-  if (con->vncPort)
-    g_string_free(con->vncPort, true);
-  if (con->vncPass)
-    g_string_free(con->vncPass, true);
-  if (con->vncLoginUser)
-    g_string_free(con->vncLoginUser, true);
-  if (con->vncLoginPass)
-    g_string_free(con->vncLoginPass, true);
-  if (con->sshPort)
-    g_string_free(con->sshPort, true);
-  if (con->sshPrivKeyfile)
-    g_string_free(con->sshPrivKeyfile, true);
-  if (con->sshUser)
-    g_string_free(con->sshUser, true);
-  if (con->sshPass)
-    g_string_free(con->sshPass, true);
-  if (con->f12Macro)
-    g_string_free(con->f12Macro, true);
-  if (con->quickNote)
-    g_string_free(con->quickNote, true);
-  if (con->customCmd1Label)
-    g_string_free(con->customCmd1Label, true);
-  if (con->customCmd1)
-    g_string_free(con->customCmd1, true);
-  if (con->customCmd2Label)
-    g_string_free(con->customCmd2Label, true);
-  if (con->customCmd2)
-    g_string_free(con->customCmd2, true);
-  if (con->customCmd3Label)
-    g_string_free(con->customCmd3Label, true);
-  if (con->customCmd3)
-    g_string_free(con->customCmd3, true);
-  if (con->lastErrorMessage)
-    g_string_free(con->lastErrorMessage, true);
-  if (con->lastConnectTime)
-    g_string_free(con->lastConnectTime, true);
-  if (con->clipboard)
-    g_string_free(con->clipboard, true);
+  // our own command line (we were started for it) - main returns the status, and we quit once all are done
+  if (!g_application_command_line_get_is_remote(cmdLine))
+  {
+    if (error)
+      app->shotStatus = 1;
 
-  g_free(con);
+    app->shotsPending--;
+
+    if (app->shotOnly && app->shotsPending == 0)
+      g_idle_add_once((GSourceOnceFunc)svDoQuit, NULL);
+
+    g_application_release(G_APPLICATION(app->gApp));
+  }
+
+  // (the calling process exits once this goes away)
+  g_object_unref(cmdLine);
 }
 
 
-/* menu item handler - delete a connection */
-void svHandleDeleteMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
+/* take a pending command-line screenshot once the first screen update has settled */
+gboolean svRemoteShotSettle (gpointer data)
 {
-  Connection * con = (Connection *)userData;
+  Connection * con = (Connection *)data;
 
-  if (!con)
-    return;
+  con->shotSource = 0;
 
-  gint res = -1;
+  svRemoteShotFinish(con, NULL);
 
-  if (con->type != SV_TYPE_VNC_REVERSE)
-  {
-    GtkWidget * dialog = gtk_message_dialog_new(GTK_WINDOW(app->mainWin),
-                                    GTK_DIALOG_DESTROY_WITH_PARENT,
-                                    GTK_MESSAGE_QUESTION,
-                                    GTK_BUTTONS_YES_NO,
-                                    "Are you sure you want to delete '%s'?",
-                                    con->name->str);
-    res = gtk_dialog_run(GTK_DIALOG(dialog));
+  return G_SOURCE_REMOVE;
+}
 
-    // destroy the dialog box
-    gtk_widget_destroy(dialog);
 
-    gtk_window_present(GTK_WINDOW(app->mainWin));
-  }
+/* select a connection in the list and show it, as if the user had clicked it */
+void svRemoteSelect (Connection * con)
+{
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
 
-  if (res == GTK_RESPONSE_YES || con->type == SV_TYPE_VNC_REVERSE)
+  for (GList * l = rows; l; l = l->next)
   {
-    // get all connection listbox rows
-    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
 
-    // loop through each row
-    for (GList * l = rows; l != NULL; l = l->next)
+    if (box && g_object_get_data(G_OBJECT(box), "con") == con)
     {
-      GtkWidget * row = GTK_WIDGET(l->data);
+      gtk_list_box_select_row(GTK_LIST_BOX(app->serverList), GTK_LIST_BOX_ROW(l->data));
+      svConnectionSwitch(con);
+      break;
+    }
+  }
 
-      // get box that holds status image and label
-      GtkWidget * rowBox = gtk_bin_get_child(GTK_BIN(row));
+  g_list_free(rows);
+}
 
-      if (!rowBox)
-        continue;
 
-      // get box's children
-      GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(rowBox));
+/* command line - save a screenshot of a connection, connecting to it first if needed */
+/* (the caller waits until the file is written or the attempt fails) */
+void svRemoteScreenshot (GApplicationCommandLine * cmdLine, const char * name, const char * fileArg)
+{
+  Connection * con = svConnectionFromName(name);
 
-      GtkWidget * label = (GtkWidget *)g_list_nth_data(boxChildren, 1);
+  if (!con)
+  {
+    g_application_command_line_printerr(cmdLine, "spiritvnc: no connection named '%s'\n", name);
+    g_application_command_line_set_exit_status(cmdLine, 1);
+    return;
+  }
 
-      g_list_free(boxChildren);
+  // (relative paths are relative to the caller, not to us)
+  GFile * file = g_application_command_line_create_file_for_arg(cmdLine, fileArg);
+  char * path = g_file_get_path(file);  // <<<--- do NOT make const char *
+  g_object_unref(file);
 
-      if (label && GTK_IS_LABEL(label))
-      {
-        const char * text = gtk_label_get_text(GTK_LABEL(label));
+  if (!path)
+  {
+    g_application_command_line_printerr(cmdLine, "spiritvnc: can't save a screenshot to '%s'\n", fileArg);
+    g_application_command_line_set_exit_status(cmdLine, 1);
+    return;
+  }
 
-        // found matching row string
-        if (strcmp(text, con->name->str) == 0)
-        {
-          // destroy the child widget (will remove from container too)
-          if (row)
-            gtk_widget_destroy(row);
+  // a newer request for the same connection wins
+  svRemoteShotFinish(con, "replaced by a newer screenshot request");
 
-          // release and clean up connection resources
-          if (app->selectedConnection == con)
-            app->selectedConnection = NULL;
+  g_string_assign(con->shotFile, path);
+  g_free(path);
 
-          svFreeConnObject(con);
+  con->shotCmdLine = g_object_ref(cmdLine);
 
-          break;
-        }
-      }
-    }
+  // (a command line of our own has no process waiting on it, so we stay running for it instead)
+  if (!g_application_command_line_get_is_remote(cmdLine))
+  {
+    app->shotsPending++;
+    g_application_hold(G_APPLICATION(app->gApp));
+  }
 
-    // Free the list
-    g_list_free(rows);
+  if (con->state == SV_STATE_CONNECTED)
+    svRemoteShotFinish(con, NULL);
+  else
+  {
+    // the shot is taken shortly after the first screen update arrives
+    svConnectionCreate(con);
+
+    if (con->state != SV_STATE_WAITING)
+      svRemoteShotFinish(con, "couldn't start connecting");
   }
 }
 
 
-/* menu item handler - add new connection */
-void svHandleAddNewConnectionMenuItem (GtkMenuItem *, gpointer)
+/* make a connection name safe to use as a file name */
+GString * svBatchFileName (const char * name)
 {
-  app->addNewConnection = true;
+  GString * fileName = g_string_new(NULL);
 
-  svCheckForNewConnectionAdd();
+  for (const char * c = name; *c; c++)
+    g_string_append_c(fileName, (g_ascii_isalnum(*c) || *c == '-' || *c == '_' || *c == '.') ? *c : '_');
+
+  if (fileName->len == 0 || fileName->str[0] == '.')
+    g_string_prepend_c(fileName, '_');
+
+  g_string_append(fileName, ".png");
+
+  return fileName;
 }
 
 
-/* menu item handler - toggle fullscreen */
-void svHandleFullscreenMenuItem (GtkMenuItem *, gpointer)
+/* append a string to json text, quoted and escaped */
+void svJsonAppendString (GString * json, const char * str)
 {
-  // if fullscreen, unfullscreen and vice-versa
-  if (app->fullscreen)
-    gtk_window_unfullscreen(GTK_WINDOW(app->mainWin));
-  else
-    gtk_window_fullscreen(GTK_WINDOW(app->mainWin));
+  g_string_append_c(json, '"');
+
+  for (const unsigned char * c = (const unsigned char *)str; *c; c++)
+  {
+    if (*c == '"' || *c == '\\')
+      g_string_append_printf(json, "\\%c", *c);
+    else if (*c < 0x20)
+      g_string_append_printf(json, "\\u%04x", *c);
+    else
+      g_string_append_c(json, *c);
+  }
+
+  g_string_append_c(json, '"');
 }
 
 
-/* check for connected connections */
-gboolean svThereAreConnectedConnections ()
+/* batch mode - save a host's screen once its first full screen update is in, then disconnect */
+void svBatchShot (Connection * con)
 {
-  gboolean result = false;
+  BatchItem * item = con->batchItem;
 
-  // go through connection listbox and return correct connection
-  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+  item->screenTime = g_get_monotonic_time();
 
-  for (GList * l = rows; l; l = l->next)
+  GdkPixbuf * pic = con->vncObj ? vnc_display_get_pixbuf(VNC_DISPLAY(con->vncObj)) : NULL;
+
+  if (!pic)
+    g_string_assign(item->error, "no screen image");
+  else
   {
-    GtkListBoxRow * row = l->data;
-    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+    GString * fileName = svBatchFileName(con->name->str);
+    char * path = g_build_filename(app->batchOutDir->str, fileName->str, NULL);  // <<<--- do NOT make const char *
 
-    // if there's a connected connection, return true
-    const Connection * con = g_object_get_data(G_OBJECT(box), "con");
-    if (con && con->state == SV_STATE_CONNECTED)
+    GError * error = NULL;
+
+    if (gdk_pixbuf_save(pic, path, "png", &error, "tEXt::Generator App", "spiritvncgtk", NULL))
     {
-      result = true;
-      break;
+      g_string_assign(item->file, path);
+      item->okay = true;
+    }
+    else
+    {
+      g_string_printf(item->error, "saving '%s': %s", path, error->message);
+      g_error_free(error);
     }
-  }
 
-  g_list_free(rows);
+    g_free(path);
+    g_string_free(fileName, true);
+    g_object_unref(pic);
+  }
 
-  return result;
+  // the report entry is written once it's disconnected
+  svConnectionEnd(con);
 }
 
 
-/* scanMode - move to next connected connection on server list */
-gboolean svScanModeNextConnection (gpointer unused)
+/* batch mode - give up on a host that's taking too long */
+gboolean svBatchTimeout (gpointer data)
 {
-  // if there are no more connected connections, cancel scan mode
-  if (!svThereAreConnectedConnections())
+  Connection * con = (Connection *)data;
+  BatchItem * item = con->batchItem;
+
+  // it didn't even manage to disconnect, so stop waiting for it
+  if (item->timedOut)
   {
-    // cancel scan mode
-    svCancelScanMode(false);
+    item->timeoutSource = 0;
+    svBatchItemDone(con);
+    return G_SOURCE_REMOVE;
+  }
 
-    // tell user
-    svShowMessageDialog("There are no connected connections.\n\nScan mode terminated.");
+  item->timedOut = true;
 
-    gtk_window_present(GTK_WINDOW(app->mainWin));
+  if (item->error->len == 0)
+    g_string_assign(item->error, con->state == SV_STATE_CONNECTED ? "timed out waiting for the screen" :
+      "timed out connecting");
 
-    return G_SOURCE_REMOVE;
-  }
+  svConnectionEnd(con);
 
-  // see if there's a selected connection
-  gint selectedIndex = -1;
-  gboolean looped = false;
+  // (a few more seconds to hear the disconnect)
+  item->timeoutSource = g_timeout_add_seconds(5, svBatchTimeout, con);
 
-  GtkListBoxRow * selectedRow = gtk_list_box_get_selected_row(GTK_LIST_BOX(app->serverList));
+  return G_SOURCE_REMOVE;
+}
 
-  // set selectedIndex if there is a selected row
-  if (selectedRow)
-    selectedIndex = gtk_list_box_row_get_index(selectedRow);
 
-  // go through connection listbox and select the next connected connection
-  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+/* batch mode - note how far a host's first full screen update has got */
+void svBatchScreenProgress (Connection * con, guint x, guint y, guint width, guint height)
+{
+  BatchItem * item = con->batchItem;
 
-  for (GList * l = rows; l; l = l->next)
-  {
-    GtkListBoxRow * row = l->data;
-    gint rowIndex = gtk_list_box_row_get_index(row);;
-    GtkWidget * box = gtk_bin_get_child(GTK_BIN(row));
+  if (item->screenTime > 0 || !con->vncObj)
+    return;
 
-    // if this is a connected connection, process it
-    Connection * con = g_object_get_data(G_OBJECT(box), "con");
-    if (con && con->state == SV_STATE_CONNECTED)
-    {
-      // if nothing is selected, select the first connected connection
-      // in the list, otherwise select the next connected connection
-      if ((selectedIndex == -1) || (rowIndex > selectedIndex))
-      {
-        gtk_list_box_select_row(GTK_LIST_BOX(app->serverList), GTK_LIST_BOX_ROW(row));
-        svConnectionSwitch(con);
-        break;
-      }
-    }
+  const cairo_rectangle_int_t rect = { x, y, width, height };
+  cairo_region_union_rectangle(item->screenRegion, &rect);
 
-    // we've reached the end of the list, loop around
-    if (!l->next)
-    {
-      // get out if we've already looped, to prevent infinity loopage
-      if (looped)
-        break;
+  // the first update covers the whole screen, so once all of it has arrived we have it
+  // (rects can overlap, so it's the area covered that counts, not the sum of their sizes)
+  const cairo_rectangle_int_t full = { 0, 0, vnc_display_get_width(VNC_DISPLAY(con->vncObj)),
+    vnc_display_get_height(VNC_DISPLAY(con->vncObj)) };
+
+  if (full.width > 0 && full.height > 0 &&
+      cairo_region_contains_rectangle(item->screenRegion, &full) == CAIRO_REGION_OVERLAP_IN)
+    svBatchShot(con);
+}
+
+
+/* batch mode - start the next hosts, up to the parallel limit */
+void svBatchNext ()
+{
+  while (app->batchActive < app->batchParallel && !g_queue_is_empty(app->batchQueue))
+  {
+    Connection * con = g_queue_pop_head(app->batchQueue);
 
-      looped = true;
+    BatchItem * item = g_new0(BatchItem, 1);
+    item->error = g_string_new(NULL);
+    item->file = g_string_new(NULL);
+    item->screenRegion = cairo_region_create();
+    item->startTime = g_get_monotonic_time();
 
-      // reset selectedIndex so the first connected connection will be selected / switched to
-      selectedIndex = -1;
+    con->batchItem = item;
+    app->batchActive++;
 
-      // set our iterator to the first row glist element
-      l = g_list_first(rows);
+    // one try each, and nothing in the background
+    con->autoReconnect = false;
 
-      // if for some reason the first element is null, get out
-      if (!l)
-        break;
-    }
-  }
+    item->timeoutSource = g_timeout_add_seconds(app->batchTimeout, svBatchTimeout, con);
 
-  g_list_free(rows);
+    svConnectionCreate(con);
+  }
 
-  return G_SOURCE_CONTINUE;
+  // all done
+  if (app->batchActive == 0 && g_queue_is_empty(app->batchQueue))
+    svBatchFinish();
 }
 
 
-void svCancelScanMode (gboolean removeSource)
+/* batch mode - record a host's result once it's disconnected, and move on */
+void svBatchItemDone (Connection * con)
 {
-  // cancel scan mode
-  app->scanMode = false;
+  BatchItem * item = con->batchItem;
+  if (!item)
+    return;
 
-  // change listen mode tools menu item text
-  gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "scanMode")), "Enable sca_n mode");
+  con->batchItem = NULL;
 
-  // change listen toolbutton to 'enabled' image
-  if (app->listenImage)
+  if (item->timeoutSource > 0)
+    g_source_remove(item->timeoutSource);
+
+  if (!item->okay && item->error->len == 0)
+    g_string_assign(item->error, con->lastErrorMessage->len > 0 ? con->lastErrorMessage->str : svStateName(con->state));
+
+  // times are in ms from the start of this host's attempt (-1 if it never got there)
+  const gint64 now = g_get_monotonic_time();
+  const long connectMs = item->connectTime > 0 ? (long)((item->connectTime - item->startTime) / 1000) : -1;
+  const long screenMs = item->screenTime > 0 ? (long)((item->screenTime - item->startTime) / 1000) : -1;
+  const long lookupMs = con->resolveTime >= 0 ? (long)(con->resolveTime / 1000) : -1;
+  const long totalMs = (long)((now - item->startTime) / 1000);
+
+  if (app->batchJson)
   {
-    gtk_image_clear(GTK_IMAGE(app->scanImage));
-    gtk_image_set_from_resource(GTK_IMAGE(app->scanImage), "/com/spiritvnc/pngs/scan-disabled.png");
+    GString * json = app->batchReport;
+
+    g_string_append(json, app->batchDone > 0 ? ",\n  {\"name\": " : "  {\"name\": ");
+    svJsonAppendString(json, con->name->str);
+    g_string_append(json, ", \"address\": ");
+    svJsonAppendString(json, con->address->str);
+    g_string_append_printf(json, ", \"ok\": %s, \"lookup_ms\": %li, \"connect_ms\": %li, "
+      "\"screen_ms\": %li, \"total_ms\": %li, \"file\": ",
+      item->okay ? "true" : "false", lookupMs, connectMs, screenMs, totalMs);
+    svJsonAppendString(json, item->file->str);
+    g_string_append(json, ", \"error\": ");
+    svJsonAppendString(json, item->error->str);
+    g_string_append_c(json, '}');
   }
-
-  // remove timer source
-  if (app->scanTimerSource > 0)
+  else
   {
-    // only remove source if manually canceling scan mode
-    if (removeSource)
-      g_source_remove(app->scanTimerSource);
+    GString * fields[4] = { g_string_new(con->name->str), g_string_new(con->address->str),
+      g_string_new(item->file->str), g_string_new(item->error->str) };
 
-    app->scanTimerSource = 0;
+    // csv quoting - wrap in quotes and double any quotes inside
+    for (guint i = 0; i < 4; i++)
+    {
+      for (gssize at = fields[i]->len - 1; at >= 0; at--)
+        if (fields[i]->str[at] == '"')
+          g_string_insert_c(fields[i], at, '"');
+
+      g_string_prepend_c(fields[i], '"');
+      g_string_append_c(fields[i], '"');
+    }
+
+    g_string_append_printf(app->batchReport, "%s,%s,%s,%li,%li,%li,%li,%s,%s\n",
+      fields[0]->str, fields[1]->str, item->okay ? "ok" : "failed",
+      lookupMs, connectMs, screenMs, totalMs, fields[2]->str, fields[3]->str);
+
+    for (guint i = 0; i < 4; i++)
+      g_string_free(fields[i], true);
   }
+
+  // log
+  GString * logStr = g_string_new(NULL);
+
+  if (item->okay)
+    g_string_printf(logStr, "Batch: '%s' saved to '%s' (%li ms)", con->name->str, item->file->str, totalMs);
+  else
+  {
+    g_string_printf(logStr, "Batch: '%s' failed: %s", con->name->str, item->error->str);
+    app->batchFailed++;
+  }
+
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  g_string_free(item->error, true);
+  g_string_free(item->file, true);
+  cairo_region_destroy(item->screenRegion);
+  g_free(item);
+
+  app->batchDone++;
+  app->batchActive--;
+
+  // (from the main loop, since we're still inside this host's disconnect)
+  g_idle_add(svBatchNextIdle, NULL);
 }
 
 
-/* menu item handler - toggle scan mode */
-void svHandleScanModeMenuItem (GtkMenuItem * unused1, gpointer unused2)
+/* batch mode - start more hosts from the main loop */
+gboolean svBatchNextIdle (gpointer unused)
 {
-  // toggle scan mode
-  app->scanMode = !app->scanMode;
+  svBatchNext();
 
-  if (app->scanMode)
-  {
-    // start scan mode if there's any connected connections
-    if (svThereAreConnectedConnections())
-    {
-      // change listen mode tools menu item text
-      gtk_menu_item_set_label(GTK_MENU_ITEM(g_hash_table_lookup(app->toolsItems, "scanMode")), "Disable sca_n mode");
+  return G_SOURCE_REMOVE;
+}
 
-      // change listen toolbutton to 'enabled' image
-      if (app->listenImage)
-      {
-        gtk_image_clear(GTK_IMAGE(app->scanImage));
-        gtk_image_set_from_resource(GTK_IMAGE(app->scanImage), "/com/spiritvnc/pngs/scan-enabled.png");
-      }
 
-      // start scan timer
-      app->scanTimerSource = g_timeout_add_seconds(app->scanTimeout, svScanModeNextConnection, NULL);
-    }
-    else
-    {
-      // let user know there's no connected connections
-      svShowMessageDialog("There are no connected connections.\n\nScan mode not started.");
+/* batch mode - write the report and let the app exit */
+void svBatchFinish ()
+{
+  if (!app->batchCmdLine)
+    return;
 
-      gtk_window_present(GTK_WINDOW(app->mainWin));
+  GApplicationCommandLine * cmdLine = app->batchCmdLine;
+  app->batchCmdLine = NULL;
 
-      // cancel scan mode
-      svCancelScanMode(true);
+  if (app->batchJson)
+    g_string_append(app->batchReport, app->batchDone > 0 ? "\n]\n" : "]\n");
+
+  // report to a file, or to the caller's standard output
+  if (app->batchReportFile->len > 0)
+  {
+    GError * error = NULL;
+
+    if (!g_file_set_contents(app->batchReportFile->str, app->batchReport->str, app->batchReport->len, &error))
+    {
+      g_application_command_line_printerr(cmdLine, "spiritvnc: unable to write report '%s': %s\n",
+        app->batchReportFile->str, error->message);
+      app->batchStatus = 2;
+      g_error_free(error);
     }
   }
   else
-    // cancel scan mode
-    svCancelScanMode(true);
+    g_application_command_line_print(cmdLine, "%s", app->batchReport->str);
+
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Batch: finished, %u of %u hosts failed", app->batchFailed, app->batchDone);
+  svLog(logStr->str, false);
+  g_string_free(logStr, true);
+
+  // (main returns this - a running app's own command line always exits with zero)
+  if (app->batchFailed > 0 && app->batchStatus == 0)
+    app->batchStatus = 1;
+
+  g_object_unref(cmdLine);
+
+  g_application_release(G_APPLICATION(app->gApp));
 }
 
 
-/* menu item handler - do screenshot of current vnc connection */
-void svHandleScreenshotMenuItem (GtkMenuItem * unused1, gpointer unused2)
+/* set up what the connection code needs when there's no gui (batch runs and viewer processes) */
+void svHeadlessSetup ()
 {
-  const Connection * con = svGetSelectedConnectionListConnection();
-  if (!con)
-    return;
+  // the connection code expects a host list, a display stack and an error buffer,
+  // so give it ones that are never shown
+  app->serverList = g_object_ref_sink(gtk_list_box_new());
+  app->displayStack = g_object_ref_sink(gtk_stack_new());
+  app->quickNoteLastErrorBuffer = gtk_text_buffer_new(NULL);
 
-  // save screenshot to pixbuf
-  GdkPixbuf * pic = vnc_display_get_pixbuf(VNC_DISPLAY(con->vncObj));
+  svConfigRead();
 
-  // open save dialog
-  GtkWidget * dialog;
-  GtkFileChooser * chooser;
-  GtkFileChooserAction action = GTK_FILE_CHOOSER_ACTION_SAVE;
-  gint res;
+  // (whoever runs us opens and closes everything itself)
+  app->fbBudgetMB = 0;
+  app->idleMinutes = 0;
+  app->helperViewers = false;
+  app->savePreviews = false;
+}
 
-  // get the current time
-  GDateTime * now = g_date_time_new_now_local();
 
-  // format the time as a human-readable string
-  char * formattedTime = g_date_time_format(now, "%Y-%m-%d--%H-%M-%S");  // <<<--- do NOT make const char *
+/* batch mode - screenshot every configured host without showing any windows (a display is still needed) */
+/* (spiritvnc --batch [--group NAME]... [--parallel N] [--timeout SECS] [--out DIR] [--report FILE]) */
+gint svBatchCommandLine (GApplication * gApp, GApplicationCommandLine * cmdLine)
+{
+  gint argc = 0;
+  char ** argv = g_application_command_line_get_arguments(cmdLine, &argc);  // <<<--- do NOT make const char **
 
-  GString * existingFilename = g_string_new(NULL);
-  g_string_printf(existingFilename, "spiritvnc-screenshot-%s.png", formattedTime);
+  GPtrArray * groups = g_ptr_array_new_with_free_func(g_free);
+  char * outArg = NULL;  // <<<--- do NOT make const char *
+  char * reportArg = NULL;  // <<<--- do NOT make const char *
+  gboolean okay = true;
 
-  // free resources
-  g_free(formattedTime);
-  g_date_time_unref(now);
+  app->batchParallel = SV_BATCH_PARALLEL;
+  app->batchTimeout = SV_BATCH_TIMEOUT_SECS;
 
-  dialog = gtk_file_chooser_dialog_new("Save screenshot",
-                                        GTK_WINDOW(app->mainWin),
-                                        action,
-                                        "_Cancel",
-                                        GTK_RESPONSE_CANCEL,
-                                        "_Save",
-                                        GTK_RESPONSE_ACCEPT,
-                                        NULL);
-  chooser = GTK_FILE_CHOOSER(dialog);
+  for (gint i = 1; i < argc && okay; i++)
+  {
+    if (strcmp(argv[i], "--batch") == 0)
+      continue;
+    else if (strcmp(argv[i], "--group") == 0 && i + 1 < argc)
+      g_ptr_array_add(groups, g_strdup(argv[++i]));
+    else if (strcmp(argv[i], "--parallel") == 0 && i + 1 < argc)
+      app->batchParallel = CLAMP(atoi(argv[++i]), 1, 256);
+    else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+      app->batchTimeout = CLAMP(atoi(argv[++i]), 1, 3600);
+    else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc && !outArg)
+      outArg = g_strdup(argv[++i]);
+    else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc && !reportArg)
+      reportArg = g_strdup(argv[++i]);
+    else
+    {
+      g_application_command_line_printerr(cmdLine, "spiritvnc: unknown or incomplete option '%s'\n"
+        "Usage: spiritvnc --batch [--group NAME]... [--parallel N] [--timeout SECS] [--out DIR] [--report FILE]\n"
+        "(a report file ending in '.json' is written as JSON, anything else as CSV)\n"
+        "(nothing is shown, but an X11 or Wayland display is still needed - on a server, run it under "
+        "xvfb-run)\n", argv[i]);
+      okay = false;
+    }
+  }
 
-  gtk_file_chooser_set_do_overwrite_confirmation(chooser, true);
-  gtk_file_chooser_set_current_name(chooser, existingFilename->str);
-  g_string_free(existingFilename, true);
+  g_strfreev(argv);
 
-  res = gtk_dialog_run(GTK_DIALOG(dialog));
+  // (relative paths are relative to where we were started)
+  GFile * outFile = g_application_command_line_create_file_for_arg(cmdLine, outArg ? outArg : ".");
+  char * outPath = g_file_get_path(outFile);  // <<<--- do NOT make const char *
+  g_object_unref(outFile);
 
-  if (res == GTK_RESPONSE_ACCEPT)
+  app->batchOutDir = g_string_new(outPath);
+  app->batchReportFile = g_string_new(NULL);
+  g_free(outPath);
+
+  if (reportArg)
   {
-    char * filename = gtk_file_chooser_get_filename(chooser);  //  <<<--- do NOT make const char *
+    GFile * reportFile = g_application_command_line_create_file_for_arg(cmdLine, reportArg);
+    char * reportPath = g_file_get_path(reportFile);  // <<<--- do NOT make const char *
+    g_object_unref(reportFile);
 
-    gdk_pixbuf_save(pic, filename, "png", NULL, "tEXt::Generator App", "spiritvncgtk", NULL);
+    g_string_assign(app->batchReportFile, reportPath);
+    g_free(reportPath);
 
-    g_free(filename);
-    g_object_unref(pic);
+    app->batchJson = g_str_has_suffix(app->batchReportFile->str, ".json");
   }
 
-  // destroy dialog
-  gtk_widget_destroy(dialog);
+  g_free(outArg);
+  g_free(reportArg);
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
-}
+  if (okay && g_mkdir_with_parents(app->batchOutDir->str, 0755) != 0)
+  {
+    g_application_command_line_printerr(cmdLine, "spiritvnc: unable to create '%s'\n", app->batchOutDir->str);
+    okay = false;
+  }
 
+  if (!okay)
+  {
+    g_ptr_array_unref(groups);
+    return 2;
+  }
 
-void svHandleViewOnlyMenuItem (GtkMenuItem * gMenuItem, gpointer userData)
-{
-  if (!gMenuItem)
-    return;
+  svHeadlessSetup();
 
-  Connection * con = (Connection *)userData;
-  if (!con)
-    return;
+  // queue up every (matching) host
+  app->batchQueue = g_queue_new();
 
-  // get menu item's children
-  GList * children = gtk_container_get_children(GTK_CONTAINER(gMenuItem));
-  if (!children)
-    return;
+  GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
 
-  // parent box is first child
-  GtkWidget * parentBox = (GtkWidget *)g_list_nth_data(children, 0);
-  if (!parentBox)
-    return;
+  for (GList * l = rows; l; l = l->next)
+  {
+    GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
+    Connection * con = box ? g_object_get_data(G_OBJECT(box), "con") : NULL;
 
-  // now get parent box's childre
-  GList * boxChildren = gtk_container_get_children(GTK_CONTAINER(parentBox));
-  if (!boxChildren)
-    return;
+    if (!con || con->type == SV_TYPE_VNC_REVERSE)
+      continue;
 
-  // checkbox is first child
-  GtkWidget * checkBox = (GtkWidget *)g_list_nth_data(boxChildren, 0);
-  if (!checkBox)
-    return;
+    gboolean wanted = (groups->len == 0);
 
-  // toggle view-only
-  con->viewOnly = !con->viewOnly;
+    for (guint i = 0; i < groups->len && !wanted; i++)
+      wanted = (strcmp(con->group->str, g_ptr_array_index(groups, i)) == 0);
 
-  // set the viewer now if it's connected
-  if (con->state == SV_STATE_CONNECTED && con->vncObj)
-    vnc_display_set_read_only(VNC_DISPLAY(con->vncObj), con->viewOnly);
+    if (wanted)
+      g_queue_push_tail(app->batchQueue, con);
+  }
 
-  // set the checkbox's checked state
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(checkBox), con->viewOnly);
+  g_list_free(rows);
+  g_ptr_array_unref(groups);
 
-  svConfigWrite();
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Batch: %u hosts, %u at a time, saving to '%s'",
+    g_queue_get_length(app->batchQueue), app->batchParallel, app->batchOutDir->str);
+  svLog(logStr->str, false);
+  g_string_free(logStr, true);
 
-  // free lists
-  g_list_free(children);
-  g_list_free(boxChildren);
+  app->batchReport = g_string_new(app->batchJson ? "[\n" :
+    "name,address,result,lookup_ms,connect_ms,screen_ms,total_ms,file,error\n");
+
+  // keep running (and the caller waiting) until every host is done
+  app->batchCmdLine = g_object_ref(cmdLine);
+  g_application_hold(gApp);
+
+  svBatchNext();
+
+  return 0;
 }
 
 
-/* create connection right-click menu */
-void svConnectionRightClick (Connection * con)
+/* handle a command line - ours at startup, or one forwarded from a later launch */
+gint svHandleCommandLine (GApplication * gApp, GApplicationCommandLine * cmdLine, gpointer unused)
 {
-  if (!con)
-    return;
+  // a batch run never has a gui
+  if (app->batchMode)
+    return svBatchCommandLine(gApp, cmdLine);
 
-  // right-click menu
-  GtkWidget * rightMenu = gtk_menu_new();
+  // and neither does a viewer process
+  if (app->helperChild)
+    return svHelperChildCommandLine(gApp, cmdLine);
 
-  // connect menu item
-  if (con->state != SV_STATE_CONNECTED && con->state != SV_STATE_WAITING)
-  {
-    GtkWidget * connect = gtk_menu_item_new_with_label("Connect");
-    svSetTooltip(connect, "Attempts to start this connection to the remote host");
-    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(connect), true);
-    gtk_widget_set_sensitive(GTK_WIDGET(connect), true);
-    gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), connect);
-    g_signal_connect(connect, "activate", G_CALLBACK(svHandleConnectMenuItem), con);
-  }
+  // a cold start has no gui (or connections) yet
+  const gboolean coldStart = (app->mainWin == NULL);
 
-  // disconnect menu item
-  if (con->state == SV_STATE_CONNECTED)
-  {
-    GtkWidget * disconnect = gtk_menu_item_new_with_label("Disconnect");
-    svSetTooltip(disconnect, "Disconnects this connection from the remote host");
-    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(disconnect), true);
-    gtk_widget_set_sensitive(GTK_WIDGET(disconnect), true);
-    gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), disconnect);
-    g_signal_connect(disconnect, "activate", G_CALLBACK(svHandleDisconnectMenuItem), con);
-  }
+  if (coldStart)
+    g_application_activate(gApp);
 
-  // edit menu item
-  GtkWidget * edit = gtk_menu_item_new_with_label("Edit");
-  svSetTooltip(edit, "Opens this connection in the Edit Connection window");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(edit), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(edit), true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), edit);
-  g_signal_connect(edit, "activate", G_CALLBACK(svHandleEditMenuItem), con);
+  gint argc = 0;
+  char ** argv = g_application_command_line_get_arguments(cmdLine, &argc);  // <<<--- do NOT make const char **
 
-   // f12 macro section
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+  Connection * firstCon = NULL;
+  gboolean showWindow = true;
+  gboolean screenshots = false;
 
-  // view-only menu item
-  GtkWidget * viewOnly = gtk_menu_item_new_with_label("View only");
-  svSetTooltip(viewOnly, "Sets this connection to view-only (no mouse or keyboard events will be sent)");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(viewOnly), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(viewOnly), true);
-  // remove menu item's original child
-  GtkWidget * origChild = gtk_bin_get_child(GTK_BIN(viewOnly));
-  gtk_container_remove(GTK_CONTAINER(viewOnly), origChild);
-  // make a box to put our checkbox and label into
-  GtkWidget * childBox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
-  // checkbox
-  GtkWidget * viewOnlyCheckbox = gtk_check_button_new();
-  gtk_box_pack_start(GTK_BOX(childBox), viewOnlyCheckbox, false, false, 0);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(viewOnlyCheckbox), con->viewOnly);
-  // label
-  GtkWidget * viewOnlyLabel = gtk_label_new("View only");
-  gtk_box_pack_start(GTK_BOX(childBox), viewOnlyLabel, false, false, 0);
-  //
-  gtk_container_add(GTK_CONTAINER(viewOnly), childBox);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), viewOnly);
-  g_signal_connect(viewOnly, "activate", G_CALLBACK(svHandleViewOnlyMenuItem), con);
+  for (gint i = 1; i < argc; i++)
+  {
+    // * connect to one connection *
+    if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc)
+    {
+      Connection * con = svConnectionFromName(argv[++i]);
+
+      if (!con)
+      {
+        g_application_command_line_printerr(cmdLine, "spiritvnc: no connection named '%s'\n", argv[i]);
+        g_application_command_line_set_exit_status(cmdLine, 1);
+        continue;
+      }
 
- // f12 macro section
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+      svConnectionCreate(con);
 
-  // get f12 macro menu item
-  GtkWidget * getF12 = gtk_menu_item_new_with_label("Get F12 macro");
-  svSetTooltip(getF12, "Gets this connection's F12 macro so it can put into another connection's F12 macro");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(getF12), false);
-  gtk_widget_set_sensitive(GTK_WIDGET(getF12), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), getF12);
-  g_signal_connect(getF12, "activate", G_CALLBACK(svHandleF12GetMacroMenuItem), con);
+      if (!firstCon)
+        firstCon = con;
+    }
 
-  // only enable if this connection has f12 macro text
-  if (con->f12Macro->len > 0)
-    gtk_widget_set_sensitive(GTK_WIDGET(getF12), true);
+    // * connect to every connection in a group *
+    else if (strcmp(argv[i], "--connect-group") == 0 && i + 1 < argc)
+    {
+      const char * group = argv[++i];
+      gboolean found = false;
 
-  // put f12 macro menu item
-  GtkWidget * putF12 = gtk_menu_item_new_with_label("Put F12 macro");
-  svSetTooltip(putF12, "Puts a stored F12 macro into this connection's F12 macro");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(putF12), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(putF12), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), putF12);
-  g_signal_connect(putF12, "activate", G_CALLBACK(svHandleF12PutMacroMenuItem), con);
+      GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
 
-  // only enable when connected and there's something to 'put'
-  //if (con->state == SV_STATE_CONNECTED && app->f12Storage->len > 0)
-  if (app->f12Storage->len > 0)
-    gtk_widget_set_sensitive(GTK_WIDGET(putF12), true);
+      for (GList * l = rows; l; l = l->next)
+      {
+        GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
+        Connection * con = box ? g_object_get_data(G_OBJECT(box), "con") : NULL;
 
-  // delete section
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
+        if (!con || con->type == SV_TYPE_VNC_REVERSE || strcmp(con->group->str, group) != 0)
+          continue;
 
-  // delete menu item
-  GtkWidget * delete = gtk_menu_item_new_with_label("Delete...");
-  svSetTooltip(delete, "The app will ask you if you're sure you want to delete this connection");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(delete), true);
-  if (con->state != SV_STATE_CONNECTED && con->state != SV_STATE_WAITING)
-    gtk_widget_set_sensitive(GTK_WIDGET(delete), true);
-  else
-    gtk_widget_set_sensitive(GTK_WIDGET(delete), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), delete);
-  g_signal_connect(delete, "activate", G_CALLBACK(svHandleDeleteMenuItem), con);
+        svConnectionCreate(con);
+        found = true;
 
-  gboolean enableCustomCommands = false;
+        if (!firstCon)
+          firstCon = con;
+      }
 
-  // only display custom commands submenu if any subcommands are enabled and have a label
-  if ((con->customCmd1Enabled && con->customCmd1Label->len > 0) ||
-    (con->customCmd2Enabled && con->customCmd2Label->len > 0) ||
-    (con->customCmd3Enabled && con->customCmd3Label->len > 0))
-  {
-    enableCustomCommands = true;
+      g_list_free(rows);
+
+      if (!found)
+      {
+        g_application_command_line_printerr(cmdLine, "spiritvnc: no connections in group '%s'\n", group);
+        g_application_command_line_set_exit_status(cmdLine, 1);
+      }
+    }
+
+    // * screenshot a connection to a file *
+    else if (strcmp(argv[i], "--screenshot") == 0 && i + 2 < argc)
+    {
+      svRemoteScreenshot(cmdLine, argv[i + 1], argv[i + 2]);
+      i += 2;
+      screenshots = true;
+
+      // (scripts taking screenshots don't want the window popping up)
+      showWindow = false;
+    }
+
+    // * usage *
+    else
+    {
+      if (strcmp(argv[i], "--help") != 0 && strcmp(argv[i], "-h") != 0)
+      {
+        g_application_command_line_printerr(cmdLine, "spiritvnc: unknown or incomplete option '%s'\n", argv[i]);
+        g_application_command_line_set_exit_status(cmdLine, 1);
+      }
+
+      g_application_command_line_print(cmdLine,
+        "Usage: spiritvnc [--connect NAME]... [--connect-group GROUP]... [--screenshot NAME FILE]...\n"
+        "If SpiritVNC is already running, the request is handed to it.\n");
+      showWindow = false;
+      break;
+    }
   }
-  // custom commands submenu
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
 
-  // custom commands
-  GtkWidget * cc = gtk_menu_item_new_with_label("Custom commands");
-  svSetTooltip(cc, "Custom commands sub-menu");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cc), true);
-  gtk_widget_set_sensitive(GTK_WIDGET(cc), enableCustomCommands); //true);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), cc);
+  g_strfreev(argv);
 
-  // create submenu
-  GtkWidget * customCommands = gtk_menu_new();
+  // show the first connection asked for
+  if (firstCon)
+  {
+    svRemoteSelect(firstCon);
+    showWindow = true;
+  }
 
-  // attach submenu to custom commands item
-  gtk_menu_item_set_submenu(GTK_MENU_ITEM(cc), customCommands);
+  if (showWindow && app->mainWin)
+    gtk_window_present(GTK_WINDOW(app->mainWin));
 
-  if (con->customCmd1Enabled && enableCustomCommands)
+  // started only for screenshots - stay out of sight and quit when they're done
+  // (anything else asked of us since then means we're wanted, so we stay)
+  if (coldStart && screenshots && !showWindow)
   {
-    // custom command 1
-    GtkWidget * cmdLbl1 = gtk_menu_item_new_with_label(con->customCmd1Label->str);
-    svSetTooltip(cmdLbl1, "Runs custom command 1");
-    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cmdLbl1), true);
-    gtk_widget_set_sensitive(GTK_WIDGET(cmdLbl1), con->customCmd1Enabled);
-    gtk_menu_shell_append(GTK_MENU_SHELL(customCommands), cmdLbl1);
-    g_signal_connect(cmdLbl1, "activate", G_CALLBACK(svHandleCustomCommandMenuItem), con->customCmd1->str);
+    app->shotOnly = true;
+
+    if (app->mainWin)
+      gtk_widget_hide(app->mainWin);
+
+    if (app->shotsPending == 0)
+      g_idle_add_once((GSourceOnceFunc)svDoQuit, NULL);
   }
+  else if (showWindow)
+    app->shotOnly = false;
 
-  if (con->customCmd2Enabled && enableCustomCommands)
+  return g_application_command_line_get_exit_status(cmdLine);
+}
+
+
+/* handle app's activate event */
+static void svAppActivate (GtkApplication * gtkApp, gpointer userData)
+{
+  // launching again just brings us forward
+  if (app->mainWin)
   {
-    // custom command 2
-    GtkWidget * cmdLbl2 = gtk_menu_item_new_with_label(con->customCmd2Label->str);
-    svSetTooltip(cmdLbl2, "Runs custom command 2");
-    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cmdLbl2), true);
-    gtk_widget_set_sensitive(GTK_WIDGET(cmdLbl2), con->customCmd2Enabled);
-    gtk_menu_shell_append(GTK_MENU_SHELL(customCommands), cmdLbl2);
-    g_signal_connect(cmdLbl2, "activate", G_CALLBACK(svHandleCustomCommandMenuItem), con->customCmd2->str);
+    gtk_window_present(GTK_WINDOW(app->mainWin));
+    return;
   }
 
-  if (con->customCmd3Enabled && enableCustomCommands)
+  svCreateGUI(gtkApp);
+  svLog("--- App starting up ---", false);
+}
+
+
+/* return a short name for a connection state (for the control socket) */
+const char * svStateName (guint state)
+{
+  switch (state)
   {
-    // custom command 3
-    GtkWidget * cmdLbl3 = gtk_menu_item_new_with_label(con->customCmd3Label->str);
-    svSetTooltip(cmdLbl3, "Runs custom command 3");
-    gtk_menu_item_set_use_underline(GTK_MENU_ITEM(cmdLbl3), true);
-    gtk_widget_set_sensitive(GTK_WIDGET(cmdLbl3), con->customCmd3Enabled);
-    gtk_menu_shell_append(GTK_MENU_SHELL(customCommands), cmdLbl3);
-    g_signal_connect(cmdLbl3, "activate", G_CALLBACK(svHandleCustomCommandMenuItem), con->customCmd3->str);
+    case SV_STATE_WAITING:
+      return "connecting";
+    case SV_STATE_CONNECTED:
+      return "connected";
+    case SV_STATE_TIMEOUT:
+      return "timeout";
+    case SV_STATE_ERROR:
+      return "error";
+    case SV_STATE_EVICTED:
+      return "evicted";
+    case SV_STATE_IDLE:
+      return "idle";
+    default:
+      return "disconnected";
   }
-  //}
+}
 
-  // and all the rest, all on gilligan's island
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), gtk_separator_menu_item_new());
 
-  // sync clipboard item
-  GtkWidget * setClipboard = gtk_menu_item_new_with_label("Set my clipboard to this connection's clipboard");
-  svSetTooltip(setClipboard, "Sets this computer's clipboard to the contents of this connection's clipboard");
-  gtk_menu_item_set_use_underline(GTK_MENU_ITEM(setClipboard), true);
-  if (con->clipboard->len > 0)
-    gtk_widget_set_sensitive(GTK_WIDGET(setClipboard), true);
-  else
-    gtk_widget_set_sensitive(GTK_WIDGET(setClipboard), false);
-  gtk_menu_shell_append(GTK_MENU_SHELL(rightMenu), setClipboard);
-  g_signal_connect(setClipboard, "activate", G_CALLBACK(svHandleSyncClipboardMenuItem), con);
+/* return the connection state a short state name stands for (an error if it isn't one) */
+guint svStateFromName (const char * name)
+{
+  for (guint state = SV_STATE_DISCONNECTED; state <= SV_STATE_IDLE; state++)
+    if (strcmp(svStateName(state), name) == 0)
+      return state;
 
+  return SV_STATE_ERROR;
+}
 
-  // show all the thingz
-  gtk_widget_show_all(GTK_WIDGET(rightMenu));
 
-  // pop up the menu
-  gtk_menu_popup_at_pointer(GTK_MENU(rightMenu), NULL);
+/* queue text for a control client and start sending it */
+void svControlSend (ControlClient * client, const char * format, ...)
+{
+  if (!client || client->closed)
+    return;
+
+  va_list args;
+  va_start(args, format);
+  g_string_append_vprintf(client->outBuf, format, args);
+  va_end(args);
+
+  svControlFlush(client);
 }
 
 
-/* time out a connected connection if it doesn't initialize in time */
-/* (run as a thread) */
-gpointer svConnectionInitWaiter (void * data)
+/* reply to a control client's tagged request */
+/* (a '-' tag asks for no reply, for requests that are only ever fire-and-forget) */
+void svControlReply (ControlClient * client, const char * tag, gboolean okay, const char * text)
 {
-  Connection * con = (Connection *)data;
+  if (strcmp(tag, "-") == 0)
+    return;
 
-  if (!con)
-    return NULL;
+  svControlSend(client, "%s %s %s\n", tag, okay ? "ok" : "err", text ? text : "");
+}
 
-  // wait for vnc connection timeout
-  for (guint i = 0; i < app->vncConnectWaitTime; i++)
+
+/* send a control client's queued text (one write in flight at a time) */
+void svControlFlush (ControlClient * client)
+{
+  if (client->closed || client->writing)
+    return;
+
+  // (a client told goodbye goes once it's heard it)
+  if (client->outBuf->len == 0)
   {
-    // break out if connection becomes initialized
-    if (con->state != SV_STATE_WAITING)
-      break;
+    if (client->closeWhenSent)
+      svControlClientClose(client);
 
-    sleep(1);
+    return;
   }
 
-  // if the connection isn't actually initialized (fully connected), close it
-  if (con->state != SV_STATE_CONNECTED)
-  {
-    if (con->vncObj)
-      vnc_display_close(VNC_DISPLAY(con->vncObj));
+  // what's queued goes out together, and new text queues behind it
+  client->writing = client->outBuf;
+  client->outBuf = g_string_new(NULL);
 
-    // call server error handler directly
-    svServerError(NULL, "Viewer failed to initialize in time", con);
+  client->refs++;
+
+  GOutputStream * out = g_io_stream_get_output_stream(G_IO_STREAM(client->sockCon));
+
+  g_output_stream_write_all_async(out, client->writing->str, client->writing->len, G_PRIORITY_DEFAULT,
+    client->cancel, svControlWritten, client);
+}
+
+
+/* handle a control client write finishing */
+void svControlWritten (GObject * source, GAsyncResult * res, gpointer data)
+{
+  ControlClient * client = (ControlClient *)data;
+
+  GError * error = NULL;
+  const gboolean okay = g_output_stream_write_all_finish(G_OUTPUT_STREAM(source), res, NULL, &error);
+
+  g_string_free(client->writing, true);
+  client->writing = NULL;
+
+  if (!okay)
+  {
+    g_error_free(error);
+    svControlClientClose(client);
   }
+  else
+    svControlFlush(client);
 
-  return NULL;
+  svControlClientUnref(client);
 }
 
 
-/* handle vnc obj connection event */
-void svServerConnected (GtkWidget * vncObj)
+/* drop a control client's references, freeing it after the last one */
+void svControlClientUnref (ControlClient * client)
 {
-  Connection * con = svConnectionFromVNCObj(vncObj);
-  if (!con)
+  if (--client->refs > 0)
     return;
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Server connected (but not init'd) to '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  g_io_stream_close(G_IO_STREAM(client->sockCon), NULL, NULL);
 
-  // spawn initialize waiter thread
-  GThread * initWaiter G_GNUC_UNUSED = g_thread_new("init-waiter", svConnectionInitWaiter, con);
+  g_object_unref(client->in);
+  g_object_unref(client->sockCon);
+  g_object_unref(client->cancel);
+
+  g_string_free(client->outBuf, true);
+  g_string_free(client->inBuf, true);
+
+  g_free(client);
 }
 
 
-/* handle vnc obj disconnection event */
-void svServerDisconnected (GtkWidget * vncObj)
+/* remove a 'wait' request, cancelling its timeout */
+void svControlWaiterFree (ControlWaiter * waiter)
 {
-  Connection * con = svConnectionFromVNCObj(vncObj);
-  if (!con)
-    return;
+  app->controlWaiters = g_list_remove(app->controlWaiters, waiter);
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Server disconnected '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  // (a no-op if the screen wait is what finished)
+  if (waiter->matching)
+    svMatchWaitCancel(waiter->con, svControlMatched, waiter, NULL);
 
-  // if this is svnc, spawn ssh connection stop thread
-  if (con->type == SV_TYPE_VNC_OVER_SSH)
-    con->sshCloseThread = g_thread_new("ssh-closer", svSSHConnectionCloser, con);
+  if (waiter->timeoutSource > 0)
+    g_source_remove(waiter->timeoutSource);
 
-  // hide the vnc display widget
-  gtk_widget_set_visible(con->vncObj, false);
+  g_free(waiter->tag);
+  g_free(waiter);
+}
 
-  // remove the vnc display widget from the display stack
-  gtk_container_remove(GTK_CONTAINER(app->displayStack), con->vncObj);
 
-  con->vncObj = NULL;
+/* disconnect a control client (it's freed once any i/o in flight finishes) */
+void svControlClientClose (ControlClient * client)
+{
+  if (client->closed)
+    return;
 
-  // * set disconnect state and icon *
+  client->closed = true;
 
-  gboolean manualDisconnect = false;
+  app->controlClients = g_list_remove(app->controlClients, client);
 
-  // manual disconnect
-  if (con->state == SV_STATE_CONNECTED && con->disconnectType != SV_DISC_VNC_ERROR && con->disconnectType != SV_DISC_SSH_ERROR)
+  // nobody left to tell
+  GList * l = app->controlWaiters;
+
+  while (l)
   {
-    manualDisconnect = true;
-    con->state = SV_STATE_DISCONNECTED;
+    GList * next = l->next;
+    ControlWaiter * waiter = l->data;
+
+    if (waiter->client == client)
+      svControlWaiterFree(waiter);
+
+    l = next;
   }
-  // timeout disconnect
-  else if (con->state == SV_STATE_WAITING && con->disconnectType != SV_DISC_VNC_ERROR &&
-    con->disconnectType != SV_DISC_SSH_ERROR)
-    con->state = SV_STATE_TIMEOUT;
-  // error
-  else if (con->state == SV_STATE_ERROR || con->disconnectType == SV_DISC_VNC_ERROR || con->disconnectType == SV_DISC_SSH_ERROR)
-    con->state = SV_STATE_ERROR;
 
-  // set icon
-  svSetIconFromConnectionName(con->name->str, con->state);
+  g_cancellable_cancel(client->cancel);
 
-  // automatically delete listening connections on manual disconnect
-  if (con->type == SV_TYPE_VNC_REVERSE && manualDisconnect)
-    svHandleDeleteMenuItem(NULL, con);
+  if (client->onClose)
+    client->onClose(client);
 }
 
 
-/* handle vnc obj connection error event */
-void svServerError (VncConnection * conn, const char * message, void * data)
+/* handle a 'wait' request running out of time */
+gboolean svControlWaitTimeout (gpointer data)
 {
-  if (!message)
-    return;
+  ControlWaiter * waiter = (ControlWaiter *)data;
 
-  Connection * con = (Connection *)data;
-  if (!con)
-    return;
+  waiter->timeoutSource = 0;
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Server error '%s - %s': %s", con->name->str, con->address->str, message);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  svControlReply(waiter->client, waiter->tag, false, "timeout");
+  svControlWaiterFree(waiter);
 
-  // set state based on 'timeout' or 'timed out' string in error message
-  if (strstr(message, "timeout") || strstr(message, "timed out"))
-    con->state = SV_STATE_TIMEOUT;
-  else
-    con->state = SV_STATE_ERROR;
+  return G_SOURCE_REMOVE;
+}
 
-  svSetIconFromConnectionName(con->name->str, con->state);
 
-  // set connection's last error message
-  g_string_assign(con->lastErrorMessage, message);
+/* answer a control 'waitfor' request */
+void svControlMatched (Connection * con, const char * error, gint x, gint y, gpointer data)
+{
+  ControlWaiter * waiter = (ControlWaiter *)data;
 
-  // only show newly-connected server if the listitem is selected
-  const char * selectedRowText = svSelectedRowText();
+  if (error)
+    svControlReply(waiter->client, waiter->tag, false, error);
+  else
+  {
+    GString * posStr = g_string_new(NULL);
+    g_string_printf(posStr, "%i %i", x, y);
+    svControlReply(waiter->client, waiter->tag, true, posStr->str);
+    g_string_free(posStr, true);
+  }
 
-  if (selectedRowText && strcmp(con->name->str, selectedRowText) == 0)
-    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, con->lastErrorMessage->str, -1);
+  svControlWaiterFree(waiter);
 }
 
 
-/* handle vnc obj initialize event (fully connected) */
-void svServerInitialized (GtkWidget * vncObj)
+/* tell control clients about a connection's new state, and answer anyone waiting on it */
+/* (the state is passed in, since it's sometimes set on the connection just after) */
+void svControlNotifyState (Connection * con, guint state)
 {
-  Connection * con = svConnectionFromVNCObj(vncObj);
-  if (!con)
+  if (!con || con->controlState == state)
     return;
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Server initialized (fully connected) '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  con->controlState = state;
 
-  con->state = SV_STATE_CONNECTED;
-  svSetIconFromConnectionName(con->name->str, con->state);
+  // a viewer process is done once its one connection is (said from idle, once the error is known)
+  if (app->helperChild && state != SV_STATE_WAITING && state != SV_STATE_CONNECTED && app->helperEndSource == 0)
+    app->helperEndSource = g_idle_add(svHelperChildEnd, con);
 
-  // add the vnc obj to the display stack
-  gtk_stack_add_named(GTK_STACK(app->displayStack), vncObj, con->name->str);
+  if (!app->controlClients)
+    return;
 
-  // set last connected time
-  GDateTime * now = g_date_time_new_now_local();
+  char * quotedName = g_shell_quote(con->name->str);
 
-  char * nowStr = g_date_time_format(now, "%H:%M:%S--%Y-%m-%d");  // <<<--- do NOT make const char *
-  g_string_assign(con->lastConnectTime, nowStr);
-  g_free(nowStr);
+  for (GList * l = app->controlClients; l; l = l->next)
+  {
+    ControlClient * client = l->data;
 
-  // change listening display text and name to actual remote name, if available
-  if (con->type == SV_TYPE_VNC_REVERSE)
+    if (client->subscribed)
+      svControlSend(client, "* state %s %s\n", quotedName, svStateName(state));
+  }
+
+  g_free(quotedName);
+
+  // still connecting is the only state that keeps a 'wait' waiting
+  if (state == SV_STATE_WAITING)
+    return;
+
+  GList * l = app->controlWaiters;
+
+  while (l)
   {
-    const char * remoteName = vnc_display_get_name(VNC_DISPLAY(vncObj));
+    GList * next = l->next;
+    ControlWaiter * waiter = l->data;
 
-    if (remoteName && remoteName[0] != '\0')
+    // ('waitfor' requests hear about a disconnect from the screen wait itself)
+    if (waiter->con == con && !waiter->matching)
     {
-        // make time string
-        char * nowStrListen = g_date_time_format(now, "-%Y%m%d%H%M%S");  //  <<<--- do NOT make const char *
-        GString * fullRemoteName = g_string_new(remoteName);
-        g_string_append(fullRemoteName, nowStrListen);
-        g_free(nowStrListen);
+      if (state == SV_STATE_CONNECTED)
+        svControlReply(waiter->client, waiter->tag, true, "connected");
+      else
+      {
+        // say why, if we know
+        GString * reason = g_string_new(svStateName(state));
 
-      svSetTextFromConnectionName(con->name->str, fullRemoteName->str);
-      g_string_assign(con->name, fullRemoteName->str);
-      g_string_free(fullRemoteName, true);
+        if (con->lastErrorMessage->len > 0)
+        {
+          char * quotedError = g_shell_quote(con->lastErrorMessage->str);
+          g_string_append_printf(reason, " %s", quotedError);
+          g_free(quotedError);
+        }
+
+        svControlReply(waiter->client, waiter->tag, false, reason->str);
+        g_string_free(reason, true);
+      }
+
+      svControlWaiterFree(waiter);
     }
+
+    l = next;
   }
+}
 
-  g_date_time_unref(now);
 
-  // update tooltips info
-  svSetHostlistItemsTooltips();
+/* tell control clients that asked for frames about a shared screen opening, or a new frame in it */
+void svControlNotifyScreen (Connection * con, gboolean opened)
+{
+  if (!app->controlClients || !con->shm)
+    return;
 
-  // only show newly-connected server if the listitem is selected
-  const char * selectedRowText = svSelectedRowText();
+  char * quotedName = g_shell_quote(con->name->str);
 
-  if (selectedRowText && strcmp(con->name->str, selectedRowText) == 0)
+  for (GList * l = app->controlClients; l; l = l->next)
   {
-    // set 'last connected' label text
-    if (con->lastConnectTime->len > 0)
+    ControlClient * client = l->data;
+
+    if (!client->frames)
+      continue;
+
+    if (opened)
+      svControlSend(client, "* shm %s %s %u %u\n", quotedName, con->shm->name, con->shm->hdr->width,
+        con->shm->hdr->height);
+    else
+      svControlSend(client, "* frame %s %u\n", quotedName, con->shm->hdr->frame);
+  }
+
+  g_free(quotedName);
+}
+
+
+/* answer any control 'wait' requests for a connection that's going away */
+void svControlForget (Connection * con)
+{
+  GList * l = app->controlWaiters;
+
+  while (l)
+  {
+    GList * next = l->next;
+    ControlWaiter * waiter = l->data;
+
+    if (waiter->con == con)
     {
-      GString * strTime = g_string_new(NULL);
-      g_string_printf(strTime, "Last connected: %s", con->lastConnectTime->str);
-      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), strTime->str);
-      g_string_free(strTime, true);
+      svControlReply(waiter->client, waiter->tag, false, "deleted");
+      svControlWaiterFree(waiter);
     }
-    else
-      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), "-");
 
-    // show the remote server screen
-    gtk_widget_show(vncObj);
-    gtk_stack_set_visible_child(GTK_STACK(app->displayStack), vncObj);
+    l = next;
+  }
+}
 
-    // set keyboard focus
-    gtk_widget_set_can_focus(vncObj, true);
-    // tell the parent container that THIS is the focus child
-    gtk_container_set_focus_child(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
-    gtk_container_set_focus_child(GTK_CONTAINER(app->displayStack), vncObj);
 
-    /* Attempt to focus the vnc display. Unfortunately we have to get a little 'creative'
-     * here and try two different ways (because the idle_add doesn't always work)
-     */
+/* save a png of a connected connection's screen (false with errStr set if not) */
+gboolean svControlScreenshot (Connection * con, const char * path, GString * errStr)
+{
+  if (con->state != SV_STATE_CONNECTED || !svConnectionScreen(con))
+  {
+    g_string_assign(errStr, "not-connected");
+    return false;
+  }
 
-    // try to focus the vnc display at idle time
-    g_idle_add((GSourceFunc)svFocusOnce, vncObj);
-    // try to focus the vnc display (again) after 300 milliseconds
-    g_timeout_add_once(300, (GSourceOnceFunc)gtk_widget_grab_focus, vncObj);
+  GdkPixbuf * pic = svConnectionPixbuf(con);
 
-    gtk_widget_grab_focus(vncObj);
+  if (!pic)
+  {
+    g_string_assign(errStr, "no-screen");
+    return false;
+  }
 
-    // set tools menu items
-    svSetToolsMenuItems(true);
+  GError * error = NULL;
+  const gboolean okay = gdk_pixbuf_save(pic, path, "png", &error, "tEXt::Generator App", "spiritvncgtk", NULL);
+
+  g_object_unref(pic);
+
+  if (!okay)
+  {
+    char * quotedError = g_shell_quote(error->message);
+    g_string_printf(errStr, "save-failed %s", quotedError);
+    g_free(quotedError);
+    g_error_free(error);
   }
+
+  return okay;
 }
 
 
-/* handle vnc obj authentication event */
-void svServerAuthenticate (VncDisplay * display, GValueArray * credList)
+/* run one control request - '<tag> <command> [args]', shell-quoted */
+/* (every request is answered with '<tag> ok ...' or '<tag> err ...', */
+/* and anything slow answers later, so requests can be pipelined) */
+void svControlCommand (ControlClient * client, const char * line)
 {
-  const char ** data = g_new0(const char *, credList->n_values);
-  gsize outLen = 0;
-  gboolean hasUsername = false;
+  gint argc = 0;
+  char ** argv = NULL;  // <<<--- do NOT make const char **
 
-  Connection * con = svConnectionFromVNCObj(GTK_WIDGET(display));
+  GError * error = NULL;
 
-  // if connection is null, close the connection and get out
-  if (!con)
+  // (blank lines are ignored)
+  if (!g_shell_parse_argv(line, &argc, &argv, &error))
   {
-    vnc_display_close(display);
-    svLog("svServerAuthenticate - ERROR: con is null", false);
+    if (error->code != G_SHELL_ERROR_EMPTY_STRING)
+      svControlSend(client, "- err bad-request\n");
+
+    g_error_free(error);
     return;
   }
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Server authentication '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
+  const char * tag = argv[0];
+  const char * cmd = argc > 1 ? argv[1] : "";
 
-  // set vnc login username, if any
-  const char * loginUser = con->vncLoginUser->str;
+  // commands that don't need a connection
+  if (strcmp(cmd, "ping") == 0)
+    svControlReply(client, tag, true, "pong");
 
-  // decode vnc and login passwords, if any
-  unsigned char * vncPass = g_base64_decode(con->vncPass->str, &outLen);
-  unsigned char * loginPass = g_base64_decode(con->vncLoginPass->str, &outLen);
+  else if (strcmp(cmd, "subscribe") == 0)
+  {
+    client->subscribed = true;
+    svControlReply(client, tag, true, NULL);
+  }
 
-  // loop through requested credentials and set each
-  for (guint i = 0 ; i < credList->n_values ; i++)
+  else if (strcmp(cmd, "unsubscribe") == 0)
   {
-    GValue * cred = credList->values + i; //1;
+    client->subscribed = false;
+    client->frames = false;
+    svControlReply(client, tag, true, NULL);
+  }
 
-    switch (g_value_get_enum(cred))
+  // (state events, plus '* shm' when a shared screen opens and '* frame' for each new frame in it)
+  else if (strcmp(cmd, "subscribe-frames") == 0)
+  {
+    client->subscribed = true;
+    client->frames = true;
+    svControlReply(client, tag, true, NULL);
+  }
+
+  else if (strcmp(cmd, "list") == 0)
+  {
+    GList * rows = gtk_container_get_children(GTK_CONTAINER(app->serverList));
+    guint count = 0;
+
+    for (GList * l = rows; l; l = l->next)
     {
-      case VNC_DISPLAY_CREDENTIAL_USERNAME:
-        hasUsername = true;
-        data[i] = (char *)loginUser;
-        svLog("Credential 'Username'", true);
-        break;
-      case VNC_DISPLAY_CREDENTIAL_PASSWORD:
-      {
-        if (hasUsername)
-          data[i] = (char *)loginPass;
-        else
-          data[i] = (char *)vncPass;
-        svLog("Credential 'Password'", true);
-      }
-      break;
-      case VNC_DISPLAY_CREDENTIAL_CLIENTNAME:
-          data[i] = "spiritvncgtk";
-          svLog("Credential 'Client Name'", true);
-          break;
-      default:
-          break;
+      GtkWidget * box = gtk_bin_get_child(GTK_BIN(l->data));
+      Connection * con = box ? g_object_get_data(G_OBJECT(box), "con") : NULL;
+
+      if (!con)
+        continue;
+
+      char * quotedName = g_shell_quote(con->name->str);
+      char * quotedGroup = g_shell_quote(con->group->str);
+
+      svControlSend(client, "%s item %s %s %s\n", tag, quotedName, svStateName(con->state), quotedGroup);
+
+      g_free(quotedName);
+      g_free(quotedGroup);
+
+      count++;
     }
+
+    g_list_free(rows);
+
+    GString * countStr = g_string_new(NULL);
+    g_string_printf(countStr, "%u", count);
+    svControlReply(client, tag, true, countStr->str);
+    g_string_free(countStr, true);
   }
 
-  // loop through requested credentials and send data for each
-  for (guint i = 0 ; i < credList->n_values ; i++)
+  // everything else works on a named connection
+  else if (strcmp(cmd, "state") == 0 || strcmp(cmd, "connect") == 0 || strcmp(cmd, "disconnect") == 0 ||
+    strcmp(cmd, "wait") == 0 || strcmp(cmd, "keys") == 0 || strcmp(cmd, "screenshot") == 0 ||
+    strcmp(cmd, "waitfor") == 0 || strcmp(cmd, "export") == 0 || strcmp(cmd, "pointer") == 0 ||
+    strcmp(cmd, "key") == 0 || strcmp(cmd, "resize") == 0 || strcmp(cmd, "update") == 0)
   {
-    GValue * cred = credList->values + i; //1;
+    Connection * con = argc > 2 ? svConnectionFromName(argv[2]) : NULL;
 
-    if (data[i])
+    if (!con)
+      svControlReply(client, tag, false, argc > 2 ? "no-such-connection" : "missing-name");
+
+    // * state *
+    else if (strcmp(cmd, "state") == 0)
+      svControlReply(client, tag, true, svStateName(con->state));
+
+    // * export * (the shared memory segment name for the connection's screen)
+    else if (strcmp(cmd, "export") == 0)
+      svControlReply(client, tag, con->shm != NULL, con->shm ? con->shm->name : "not-shared");
+
+    // * connect * (answers right away - use 'wait' or 'subscribe' to hear how it went)
+    else if (strcmp(cmd, "connect") == 0)
     {
-      if (vnc_display_set_credential(VNC_DISPLAY(display), g_value_get_enum(cred), data[i]))
+      svConnectionCreate(con);
+      svControlReply(client, tag, true, svStateName(con->state));
+    }
+
+    // * disconnect *
+    else if (strcmp(cmd, "disconnect") == 0)
+    {
+      if (con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING)
+        svConnectionEnd(con);
+
+      svControlReply(client, tag, true, NULL);
+    }
+
+    // * wait [secs] * (answers once the connection is up, or has failed)
+    else if (strcmp(cmd, "wait") == 0)
+    {
+      if (con->state == SV_STATE_CONNECTED)
+        svControlReply(client, tag, true, "connected");
+      else if (con->state != SV_STATE_WAITING)
+        svControlReply(client, tag, false, svStateName(con->state));
+      else
       {
-        // log
-        g_string_printf(logStr, "Failed to set credential type '%d'", g_value_get_enum(cred));
-        svLog(logStr->str, false);
+        const gint secs = argc > 3 ? atoi(argv[3]) : SV_CONTROL_WAIT_SECS;
 
-        vnc_display_close(VNC_DISPLAY(display));
-        con->state = SV_STATE_DISCONNECTED;
+        ControlWaiter * waiter = g_new0(ControlWaiter, 1);
+        waiter->client = client;
+        waiter->con = con;
+        waiter->tag = g_strdup(tag);
+        waiter->timeoutSource = g_timeout_add_seconds(MAX(secs, 1), svControlWaitTimeout, waiter);
+
+        app->controlWaiters = g_list_prepend(app->controlWaiters, waiter);
       }
     }
-    else
+
+    // * keys TEXT * (f12 macro syntax, so '{ctrl+alt+Delete}' and '{wait 500}' work - answers once typing starts)
+    else if (strcmp(cmd, "keys") == 0)
     {
-      // log
-      g_string_printf(logStr, "Unsupported credential type '%d'", g_value_get_enum(cred));
-      svLog(logStr->str, false);
+      if (argc < 4)
+        svControlReply(client, tag, false, "missing-keys");
+      else if (con->state != SV_STATE_CONNECTED)
+        svControlReply(client, tag, false, "not-connected");
+      else if (con->macroSource > 0 || con->macroProgram)
+        svControlReply(client, tag, false, "busy");
+      else
+      {
+        GString * errStr = g_string_new(NULL);
+        GArray * program = svMacroCompile(argv[3], errStr);
 
-      vnc_display_close(VNC_DISPLAY(display));
-      con->state = SV_STATE_DISCONNECTED;
+        if (errStr->len > 0)
+          svControlReply(client, tag, false, "bad-keys");
+        else
+        {
+          svMacroPlayProgram(con, program);
+          svControlReply(client, tag, true, NULL);
+        }
+
+        g_array_unref(program);
+        g_string_free(errStr, true);
+      }
     }
-  }
 
-  g_string_free(logStr, true);
-  g_free(vncPass);
-  g_free(loginPass);
-  g_free(data);
-}
+    // * waitfor FILE [x,y] [secs] * (answers 'ok X Y' once the screen shows the image)
+    else if (strcmp(cmd, "waitfor") == 0)
+    {
+      gint fixedX = -1;
+      gint fixedY = -1;
+      gint secs = SV_MATCH_WAIT_SECS;
 
+      for (gint i = 4; i < argc; i++)
+      {
+        if (strchr(argv[i], ','))
+        {
+          if (sscanf(argv[i], "%d,%d", &fixedX, &fixedY) != 2 || fixedX < 0 || fixedY < 0)
+            fixedX = fixedY = -1;
+        }
+        else
+          secs = atoi(argv[i]);
+      }
 
-/* saves the last selected connection's quicknote text */
-/* (usually before switching to another connection) */
-void svSavePreviousQuickNoteText (const Connection * newConnection)
-{
-  // save previous quicknote before switching
-  Connection * prevCon = app->selectedConnection;
+      MatchTemplate * tmpl = NULL;
 
-  if (!prevCon || prevCon == newConnection)
-    return;
+      if (argc < 4 || !g_path_is_absolute(argv[3]))
+        svControlReply(client, tag, false, "need-absolute-path");
+      else if (con->state != SV_STATE_CONNECTED)
+        svControlReply(client, tag, false, "not-connected");
+      else if (!(tmpl = svMatchTemplateLoad(argv[3], fixedX, fixedY, NULL)))
+        svControlReply(client, tag, false, "bad-image");
+      else
+      {
+        ControlWaiter * waiter = g_new0(ControlWaiter, 1);
+        waiter->client = client;
+        waiter->con = con;
+        waiter->tag = g_strdup(tag);
+        waiter->matching = true;
 
-  if (!prevCon->name || prevCon->name->len == 0)
-    return;
+        app->controlWaiters = g_list_prepend(app->controlWaiters, waiter);
 
-  // quickNoteBuffer must exist
-  if (!app->quickNoteBuffer)
-    return;
+        svMatchWaitAdd(con, tmpl, MAX(secs, 1), svControlMatched, waiter);
+        svMatchTemplateUnref(tmpl);
+      }
+    }
 
-  // prevCon->quickNote must exist
-  if (!prevCon->quickNote)
-    return;
+    // * pointer X Y BUTTONMASK * (rfb button bits - 1 left, 2 middle, 4 right, 8/16 wheel)
+    else if (strcmp(cmd, "pointer") == 0)
+    {
+      if (argc < 6)
+        svControlReply(client, tag, false, "missing-args");
+      else if (con->state != SV_STATE_CONNECTED || !svConnectionScreen(con))
+        svControlReply(client, tag, false, "not-connected");
+      else
+      {
+        // (a viewer process does its own coalescing)
+        if (con->vncObj)
+          svPointerQueue(con, atoi(argv[3]), atoi(argv[4]), atoi(argv[5]));
+        else
+        {
+          GString * args = g_string_new(NULL);
+          g_string_printf(args, "%i %i %i", atoi(argv[3]), atoi(argv[4]), atoi(argv[5]));
+          svHelperSend(con, "pointer", args->str);
+          g_string_free(args, true);
+        }
 
-  GtkTextIter start;
-  GtkTextIter end;
+        svControlReply(client, tag, true, NULL);
+      }
+    }
+
+    // * key DOWN KEYVAL * (one gdk keyval going down (1) or up (0))
+    else if (strcmp(cmd, "key") == 0)
+    {
+      if (argc < 5)
+        svControlReply(client, tag, false, "missing-args");
+      else if (con->state != SV_STATE_CONNECTED || !svConnectionScreen(con))
+        svControlReply(client, tag, false, "not-connected");
+      else
+      {
+        const guint keyval = strtoul(argv[4], NULL, 10);
 
-  gtk_text_buffer_get_start_iter(app->quickNoteBuffer, &start);
-  gtk_text_buffer_get_end_iter(app->quickNoteBuffer, &end);
+        if (con->vncObj)
+          vnc_display_send_keys_ex(VNC_DISPLAY(con->vncObj), &keyval, 1,
+            atoi(argv[3]) ? VNC_DISPLAY_KEY_EVENT_PRESS : VNC_DISPLAY_KEY_EVENT_RELEASE);
+        else
+        {
+          GString * args = g_string_new(NULL);
+          g_string_printf(args, "%i %u", atoi(argv[3]) ? 1 : 0, keyval);
+          svHelperSend(con, "key", args->str);
+          g_string_free(args, true);
+        }
 
-  char * qText = gtk_text_buffer_get_text(app->quickNoteBuffer, &start, &end, false);
-  if (!qText)
-    return;
+        svControlReply(client, tag, true, NULL);
+      }
+    }
 
-  char * encoded = g_base64_encode((const unsigned char *)qText, strlen(qText));
-  g_string_assign(prevCon->quickNote, encoded);
+    // * resize W H * (asks the server for a desktop that size, if it can change it)
+    else if (strcmp(cmd, "resize") == 0)
+    {
+      const gint width = argc > 4 ? atoi(argv[3]) : 0;
+      const gint height = argc > 4 ? atoi(argv[4]) : 0;
 
-  g_free(encoded);
-  g_free(qText);
-}
+      if (width < SV_RESIZE_MIN || height < SV_RESIZE_MIN || width > SV_RESIZE_MAX || height > SV_RESIZE_MAX)
+        svControlReply(client, tag, false, "bad-size");
+      else if (con->state != SV_STATE_CONNECTED || !svConnectionScreen(con))
+        svControlReply(client, tag, false, "not-connected");
+      else
+      {
+        svRemoteResizeSend(con, width, height);
+        svControlReply(client, tag, true, NULL);
+      }
+    }
 
+    // * update * (asks the server to send the whole screen again)
+    else if (strcmp(cmd, "update") == 0)
+    {
+      if (con->state != SV_STATE_CONNECTED || !svConnectionScreen(con))
+        svControlReply(client, tag, false, "not-connected");
+      else
+      {
+        svConnectionRequestUpdate(con);
+        svControlReply(client, tag, true, NULL);
+      }
+    }
 
-/* handle vnc obj 'server cut / copy (clipboard) text' event */
-void svHandleServerClipboard (VncConnection * unused, const char * text, void * data)
-{
-  //printf("handle server clipboard\n");
+    // * screenshot FILE * (an absolute path, since we don't know the client's directory)
+    else if (strcmp(cmd, "screenshot") == 0)
+    {
+      GString * errStr = g_string_new(NULL);
 
-  if (!data || !text)
-    return;
+      if (argc < 4 || !g_path_is_absolute(argv[3]))
+        svControlReply(client, tag, false, "need-absolute-path");
+      else if (svControlScreenshot(con, argv[3], errStr))
+        svControlReply(client, tag, true, NULL);
+      else
+        svControlReply(client, tag, false, errStr->str);
 
-  if (strlen(text) < 1)
-    return;
+      g_string_free(errStr, true);
+    }
+  }
 
-  Connection * con = (Connection *)data;
+  else
+    svControlReply(client, tag, false, "unknown-command");
 
-  // store this server's clipboard text to this connection's clipboard string
-  g_string_assign(con->clipboard, text);
+  g_strfreev(argv);
 }
 
 
-/* handle key presses */
-/* NOTE: signal only fires from active VncDisplay */
-gboolean svHandleKeyboard (GtkWidget * widget, GdkEventKey * event, gpointer data)
+/* handle data (or the end) arriving from a control client, passing on each complete line */
+/* (read a chunk at a time, so a line that never ends can't make us buffer without limit) */
+void svControlDataRead (GObject * source, GAsyncResult * res, gpointer data)
 {
-  // get the selected connection
-  Connection * con = svGetSelectedConnectionListConnection();
-  if (!con)
-    return false;
+  ControlClient * client = (ControlClient *)data;
 
-  // f8 - connection actions
-  if (event->keyval == GDK_KEY_F8)
-  {
-    if (!con || con->name->len == 0 || con->state != SV_STATE_CONNECTED)
-      return false;
+  const gssize got = g_input_stream_read_finish(G_INPUT_STREAM(source), res, NULL);
 
-    svShowConnectionActionsWindow();
-    return true;
+  // gone or broken
+  if (got <= 0 || client->closed)
+  {
+    svControlClientClose(client);
+    svControlClientUnref(client);
+    return;
   }
 
-  // f10 - screenshot
-  if (event->keyval == GDK_KEY_F9)
-  {
-    if (!con || con->name->len == 0 || con->state != SV_STATE_CONNECTED)
-      return false;
+  g_string_append_len(client->inBuf, client->readBuf, got);
 
-    svHandleScreenshotMenuItem(NULL, NULL);
-    return true;
-  }
+  gboolean flooding = false;
+  char * newline = NULL;
 
-  // f11 - hide host list
-  if (event->keyval == GDK_KEY_F11)
+  while (!client->closed && (newline = memchr(client->inBuf->str, '\n', client->inBuf->len)))
   {
-    // get current list width
-    gint listWidth = gtk_paned_get_position(GTK_PANED(app->parent));
+    gsize len = newline - client->inBuf->str;
 
-    if (listWidth < 1)
-      // restore if hidden
-      gtk_paned_set_position(GTK_PANED(app->parent), app->serverListWidthLast);
-    else
+    if (len > SV_CONTROL_LINE_MAX)
     {
-      // store current hostlist width
-      app->serverListWidthLast = listWidth;
-
-      // hide list
-      gtk_paned_set_position(GTK_PANED(app->parent), 0);
+      flooding = true;
+      break;
     }
 
-    return true;
-  }
-
-  // f12 macro
-  if (event->keyval == GDK_KEY_F12)
-  {
-    if (!con || con->name->len == 0)
-      return false;
+    char * line = g_strndup(client->inBuf->str, len);  // <<<--- do NOT make const char *
+    g_string_erase(client->inBuf, 0, len + 1);
 
-    GHashTable * ht = g_hash_table_new(NULL, NULL);
+    // (crlf line ends too)
+    if (len > 0 && line[len - 1] == '\r')
+      line[len - 1] = '\0';
 
-    // set the obj properties for 'OTHER' type
-    g_hash_table_insert(ht, "type", (void *)SV_SENDKEYS_TYPE_OTHER);
-    g_hash_table_insert(ht, "win", NULL);
-    g_hash_table_insert(ht, "con", con);
-    g_hash_table_insert(ht, "textToSend", g_string_new(con->f12Macro->str));
+    client->onLine(client, line);
+    g_free(line);
+  }
 
-    // send the f12 macro
-    svHandleSendEnteredKeystrokesButtons(NULL, ht);
+  // (a request can close its own client - e.g. a viewer process's channel - so check)
+  if (client->closed)
+  {
+    svControlClientUnref(client);
+    return;
+  }
 
-    return true;  // stop further handling
+  // flooding us
+  if (flooding || client->inBuf->len > SV_CONTROL_LINE_MAX)
+  {
+    svControlClientClose(client);
+    svControlClientUnref(client);
+    return;
   }
 
-  return false;   // allow normal processing
+  // read holds on to the client's first reference
+  g_input_stream_read_async(client->in, client->readBuf, SV_CONTROL_READ_CHUNK, G_PRIORITY_DEFAULT,
+    client->cancel, svControlDataRead, client);
 }
 
 
-/* create and start a new connection */
-void svConnectionCreate (Connection * con)
+/* make a control client for a connected socket, and start reading its requests */
+ControlClient * svControlClientNew (GSocket * sock)
 {
-  //  get out if state is CONNECTED or WAITING
-  if (!con || con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING)
-    return;
-
-  GString * logStr = g_string_new(NULL);
-
-  // log
-  if (con->type != SV_TYPE_VNC_REVERSE)
-    g_string_printf(logStr, "Creating new connection for '%s - %s'", con->name->str, con->address->str);
-  else
-    g_string_printf(logStr, "Creating new listening connection");
-
-  // log
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  ControlClient * client = g_new0(ControlClient, 1);
+  client->sockCon = g_socket_connection_factory_create_connection(sock);
+  client->in = g_object_ref(g_io_stream_get_input_stream(G_IO_STREAM(client->sockCon)));
+  client->inBuf = g_string_new(NULL);
+  client->cancel = g_cancellable_new();
+  client->outBuf = g_string_new(NULL);
+  client->onLine = svControlCommand;
+  client->refs = 1;
+
+  g_input_stream_read_async(client->in, client->readBuf, SV_CONTROL_READ_CHUNK, G_PRIORITY_DEFAULT,
+    client->cancel, svControlDataRead, client);
+
+  return client;
+}
 
-  // create a new vnc obj
-  GtkWidget * vnc = vnc_display_new();
 
-  if (!vnc)
+/* handle connections to the control socket */
+gboolean svControlAccept (GSocket * sock, GIOCondition condition, gpointer data)
+{
+  // take everything that's waiting
+  while (true)
   {
-    svLog("svConnectionCreate - CRITICAL: Unable to create a new vnc object!", false);
-    return;
-  }
-
-  // clear error quicknote text
-  gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, "", -1);
-
-  // set this connection's vnc obj
-  con->vncObj = vnc;
+    GError * error = NULL;
+    GSocket * clientSock = g_socket_accept(sock, NULL, &error);
 
-  // connect vnc obj signals
-  g_signal_connect(con->vncObj, "vnc-initialized", G_CALLBACK(svServerInitialized), NULL);
-  g_signal_connect(con->vncObj, "vnc-connected", G_CALLBACK(svServerConnected), NULL);
-  g_signal_connect(con->vncObj, "vnc-disconnected", G_CALLBACK(svServerDisconnected), NULL);
-  g_signal_connect(con->vncObj, "vnc-auth-credential", G_CALLBACK(svServerAuthenticate), NULL);
-  g_signal_connect(con->vncObj, "vnc-error", G_CALLBACK(svServerError), con);
-  g_signal_connect(con->vncObj, "vnc-server-cut-text", G_CALLBACK(svHandleServerClipboard), con);
-  g_signal_connect(con->vncObj, "key-press-event", G_CALLBACK(svHandleKeyboard), con);
+    if (!clientSock)
+    {
+      if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+        svLog("Control socket accept failed", true);
 
-  // change connection list icon
-  svSetIconFromConnectionName(con->name->str, SV_STATE_WAITING);
+      g_error_free(error);
+      break;
+    }
 
-  // reset connection variables
-  con->state = SV_STATE_WAITING;
-  con->disconnectType = SV_DISC_NONE;
-  g_string_truncate(con->lastErrorMessage, 0);
+    if (g_list_length(app->controlClients) >= SV_CONTROL_CLIENTS_MAX)
+    {
+      svLog("Too many control socket clients, closing new one", true);
+      g_socket_close(clientSock, NULL);
+      g_object_unref(clientSock);
+      continue;
+    }
 
-  // process based on type
-  switch (con->type)
-  {
-    case SV_TYPE_VNC:
-    case SV_TYPE_VNC_REVERSE:
-    // just open the connection straight away
-    svConnectionOpen(con);
-    break;
+    ControlClient * client = svControlClientNew(clientSock);
 
-    case SV_TYPE_VNC_OVER_SSH:
-    // get a free local port to forward to
-    con->sshLocalPort = svFindFreeTcpPort();
+    g_object_unref(clientSock);
 
-    // spawn ssh-related threads (because they block)
-    con->sshThread = g_thread_new("ssh-runner", svCreateSSHConnection, con);
-    con->sshMonitorThread = g_thread_new("ssh-monitor", svSSHMonitor, con);
-    break;
+    app->controlClients = g_list_prepend(app->controlClients, client);
 
-    default:
-    return;
+    svControlSend(client, "* hello spiritvnc %s\n", SV_APP_VERSION);
   }
+
+  return G_SOURCE_CONTINUE;
 }
 
 
-/* set error message on ssh failure */
-void svSetSSHLastErrorMessage (gpointer data)
+/* open the control socket in the config dir, if enabled */
+void svControlStart ()
 {
-  const Connection * con = (Connection *)data;
-  if (!con)
+  if (!app->controlSocket || app->controlSock)
     return;
 
-  // get the buffer's end iter
-  GtkTextIter end;
-  gtk_text_buffer_get_end_iter(app->quickNoteLastErrorBuffer, &end);
-
-  // build new string
-  GString * newText = g_string_new(NULL);
-
-  // set the string to the latest error message
-  g_string_printf(newText, "%s\n- -\n", con->lastErrorMessage->str);
+  #ifdef _WIN32
+  svLog("The control socket isn't available on Windows", false);
+  #else
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
 
-  // insert the new error text at the end of the quicknote error area
-  gtk_text_buffer_insert(app->quickNoteLastErrorBuffer, &end, newText->str, -1);
+  if (app->controlPath->len >= sizeof(addr.sun_path))
+  {
+    svLog("Control socket path is too long, not starting it", false);
+    return;
+  }
 
-  g_string_free(newText, true);
-}
+  g_strlcpy(addr.sun_path, app->controlPath->str, sizeof(addr.sun_path));
 
+  gint fd = socket(AF_UNIX, SOCK_STREAM, 0);
 
-/* set error icon from ssh error */
-void svSetConnectionIconFromSSHError (gpointer data)
-{
-  const Connection * con = (Connection *)data;
-  if (!con)
+  if (fd < 0)
+  {
+    svLog("Unable to create control socket", false);
     return;
+  }
 
-  svSetIconFromConnectionName(con->name->str, SV_STATE_ERROR);
-}
-
-
-/* monitor ssh connection state and take appropriate action */
-gpointer svSSHMonitor (gpointer data)
-{
-  Connection * con = (Connection *)data;
-  if (!con)
-    return NULL;
+  // something already answering here is another instance's socket - leave it alone
+  gint probeFd = socket(AF_UNIX, SOCK_STREAM, 0);
 
-  // wait for ssh connection
-  for (guint i = 0; i < app->sshConnectWaitTime; i++)
+  if (probeFd >= 0)
   {
-    if (con->sshContinue)
-      break;
+    const gboolean inUse = (connect(probeFd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    close(probeFd);
 
-    sleep(1);
+    if (inUse)
+    {
+      GString * logStr = g_string_new(NULL);
+      g_string_printf(logStr, "Control socket '%s' is in use by another instance, not starting it", app->controlPath->str);
+      svLog(logStr->str, false);
+      g_string_free(logStr, true);
+      close(fd);
+      return;
+    }
   }
 
-  // deal with ssh connection timeout / failure
-  if (!con->sshContinue)
-  {
-    // set connection's last error message
-    g_string_assign(con->lastErrorMessage, "Could not connect to SSH server");
-    svLog(con->lastErrorMessage->str, false);
+  // (nothing's listening, so anything left here is stale)
+  unlink(app->controlPath->str);
 
-    // set last error message text view
-    g_idle_add_once(svSetSSHLastErrorMessage, con);
+  // only our user may connect
+  mode_t oldMask = umask(0077);
+  const gboolean okay = bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 && listen(fd, SV_CONTROL_CLIENTS_MAX) == 0;
+  umask(oldMask);
 
-    // set connection variables
-    con->sshContinue = false;
-    con->disconnectType = SV_DISC_SSH_ERROR;
-    con->state = SV_STATE_ERROR;
+  GString * logStr = g_string_new(NULL);
 
-    // set connection list row's icon
-    g_idle_add_once(svSetConnectionIconFromSSHError, con);
+  if (!okay)
+  {
+    g_string_printf(logStr, "Unable to listen on control socket '%s'", app->controlPath->str);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
+    close(fd);
+    return;
+  }
 
-    return NULL;
+  app->controlSock = g_socket_new_from_fd(fd, NULL);
+
+  if (!app->controlSock)
+  {
+    close(fd);
+    g_string_free(logStr, true);
+    return;
   }
 
-  // if all seems well, wait to show
-  for (guint i = 0; i < app->sshShowWaitTime; i++)
-    sleep(1);
+  g_socket_set_blocking(app->controlSock, false);
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Attempting SSH connection open '%s - %s'", con->name->str, con->address->str);
+  app->controlSource = g_socket_create_source(app->controlSock, G_IO_IN, NULL);
+  g_source_set_callback(app->controlSource, (GSourceFunc)svControlAccept, NULL, NULL);
+  g_source_attach(app->controlSource, g_main_context_default());
+
+  g_string_printf(logStr, "Control socket listening on '%s'", app->controlPath->str);
   svLog(logStr->str, true);
   g_string_free(logStr, true);
-
-  // attempt to connect to forwarded vnc
-  svConnectionOpen(con);
-
-  return NULL;
+  #endif
 }
 
 
-/* attempts to write closing commands to the ssh thread's stream */
-gpointer svSSHConnectionCloser (gpointer data)
+/* close the control socket and its clients */
+void svControlStop ()
 {
-  Connection * con = (Connection *)data;
-  if (!con || !con->sshStdIn)
-    return NULL;
+  while (app->controlClients)
+    svControlClientClose(app->controlClients->data);
 
-  // log
-  GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Attempting to close SSH connection '%s - %s'", con->name->str, con->address->str);
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  if (!app->controlSock)
+    return;
+
+  g_source_destroy(app->controlSource);
+  g_source_unref(app->controlSource);
+  app->controlSource = NULL;
 
-  // send 'exit' and 'exit' control-char sequence
-  write(con->sshStdIn, "\r\n", strlen("\r\n"));
-  write(con->sshStdIn, "exit\n\r\n", strlen("exit\n\r\n"));
-  write(con->sshStdIn, "~.\r\n", strlen("~.\r\n"));
+  g_socket_close(app->controlSock, NULL);
+  g_object_unref(app->controlSock);
+  app->controlSock = NULL;
 
-  // close stdin handle
-  close(con->sshStdIn);
+  unlink(app->controlPath->str);
+}
 
-  con->sshContinue = false;
 
-  return NULL;
+/* reap a finished viewer process */
+void svHelperReaped (GPid pid, gint status, gpointer unused)
+{
+  g_spawn_close_pid(pid);
 }
 
 
-/* ask connection to end */
-/* (ssh cleanup is performed in svServerDisconnected) */
-void svConnectionEnd (Connection * con)
+/* drop a viewer process's view of its shared screen */
+void svHelperUnmap (HelperProc * helper)
 {
-  if (!con)
+  #ifndef _WIN32
+  if (helper->hdr)
+    munmap(helper->hdr, helper->size);
+  #endif
+
+  helper->hdr = NULL;
+  helper->size = 0;
+  helper->pixels = NULL;
+  helper->width = 0;
+  helper->height = 0;
+  helper->stride = 0;
+}
+
+
+/* map the shared screen a viewer process just opened (read-only) */
+void svHelperMap (Connection * con, const char * segName)
+{
+  HelperProc * helper = con->helper;
+
+  svHelperUnmap(helper);
+
+  #ifndef _WIN32
+  gint fd = shm_open(segName, O_RDONLY, 0);
+  if (fd < 0)
     return;
 
-  // log
-  GString * logStr = g_string_new(NULL);
+  struct stat st;
 
-  if (con->type != SV_TYPE_VNC_REVERSE)
-    g_string_printf(logStr, "Ending connection '%s - %s'", con->name->str, con->address->str);
-  else
-    g_string_printf(logStr, "Ending listening connection '%s'", con->name->str);
+  if (fstat(fd, &st) != 0 || (gsize)st.st_size < sizeof(ShmHeader))
+  {
+    close(fd);
+    return;
+  }
 
-  svLog(logStr->str, true);
-  g_string_free(logStr, true);
+  void * mem = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
 
-  // close the vnc display connection
-  if (con->vncObj)
-    vnc_display_close(VNC_DISPLAY(con->vncObj));
+  if (mem == MAP_FAILED)
+    return;
 
-  // set tools menu items
-  svSetToolsMenuItems(false);
+  ShmHeader * hdr = (ShmHeader *)mem;
 
-  // clear connection clipboard
-  g_string_truncate(con->clipboard, 0);
-}
+  // (the child can still write the header, so read it once and keep what we checked)
+  const guint32 headerSize = hdr->headerSize;
+  const guint32 width = hdr->width;
+  const guint32 height = hdr->height;
+  const guint32 stride = hdr->stride;
 
+  // (only trust a segment that holds what it says it does)
+  if (hdr->magic != SV_SHM_MAGIC || hdr->version != SV_SHM_VERSION || hdr->format != SV_SHM_FORMAT_RGB24 ||
+    headerSize < sizeof(ShmHeader) || width == 0 || height == 0 || (guint64)stride < (guint64)width * 3 ||
+    (guint64)headerSize + (guint64)stride * height > (guint64)st.st_size)
+  {
+    munmap(mem, st.st_size);
+    return;
+  }
 
-/* set tools menu connection-related items state */
-void svSetToolsMenuItems(gboolean sState)
-{
-  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "requestUpdate")), sState);
-  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "send")), sState);
-  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "sendEnteredKeys")), sState);
-  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "sendCAD")), sState);
-  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "sendCSE")), sState);
-  gtk_widget_set_sensitive(GTK_WIDGET(g_hash_table_lookup(app->toolsItems, "screenshot")), sState);
+  helper->hdr = hdr;
+  helper->size = st.st_size;
+  helper->pixels = (const guchar *)mem + headerSize;
+  helper->width = width;
+  helper->height = height;
+  helper->stride = stride;
+
+  svConnectionApplyScale(con);
+  #endif
 }
 
 
-gboolean svFocusOnce (gpointer data)
+/* whether a viewer process's shared screen is up and still the shape it was when we mapped it */
+/* (anything else - a resize, or a child gone wrong - counts as gone until the next '* shm') */
+gboolean svHelperScreenLive (const HelperProc * helper)
 {
-  GtkWidget * w = GTK_WIDGET(data);
+  if (!helper || !helper->hdr)
+    return false;
 
-  if (GTK_IS_WIDGET(w))
-    gtk_widget_grab_focus(w);
+  const ShmHeader * hdr = helper->hdr;
 
-  return false;  // run once, then stop
+  return g_atomic_int_get(&hdr->live) != 0 && hdr->width == helper->width && hdr->height == helper->height &&
+    hdr->stride == helper->stride && (const guchar *)hdr + hdr->headerSize == helper->pixels;
 }
 
-/* switch from one connection to another */
-/* (usually from a single click on the connection listbox) */
-void svConnectionSwitch (Connection * con)
+
+/* draw a viewer process's screen straight from shared memory */
+/* (a frame that's being written just shows partly new until the next one) */
+gboolean svHelperDraw (GtkWidget * view, cairo_t * cr, gpointer data)
 {
-  // ***### DO NOT CHECK CON FOR NULL HERE!!! ###***
+  Connection * con = (Connection *)data;
+  HelperProc * helper = con->helper;
 
-  // no re-entry
-  static gboolean inConnectionSwitch = false;
+  cairo_set_source_rgb(cr, 0, 0, 0);
+  cairo_paint(cr);
 
-  if (inConnectionSwitch)
-    return;
+  if (!svHelperScreenLive(helper))
+    return true;
 
-  inConnectionSwitch = true;
+  // (only the geometry checked in svHelperMap is used - the child can rewrite the header)
+  GdkPixbuf * pic = gdk_pixbuf_new_from_data(helper->pixels, GDK_COLORSPACE_RGB, false, 8,
+    helper->width, helper->height, helper->stride, NULL, NULL);
 
-  // disable tools menu items initially
-  svSetToolsMenuItems(false);
+  const gint areaWidth = gtk_widget_get_allocated_width(view);
+  const gint areaHeight = gtk_widget_get_allocated_height(view);
 
-  // save previous quicknote before switching
-  svSavePreviousQuickNoteText(con);
+  // fit (and center) the screen when scaling, otherwise draw it as-is
+  helper->viewScale = 1.0;
+  helper->viewX = 0;
+  helper->viewY = 0;
 
-  // there's no connection here, blank quicknote stuffs
-  if (!con)
+  if (svConnectionScaled(con))
   {
-    app->selectedConnection = NULL;
-    gtk_label_set_text(GTK_LABEL(app->quickNoteLabel), "-");
-    gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), "-");
-    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, "", -1);
-    gtk_text_buffer_set_text(app->quickNoteBuffer, "", -1);
+    helper->viewScale = MIN((gdouble)areaWidth / helper->width, (gdouble)areaHeight / helper->height);
+    helper->viewX = MAX(0, (areaWidth - helper->width * helper->viewScale) / 2);
+    helper->viewY = MAX(0, (areaHeight - helper->height * helper->viewScale) / 2);
+  }
 
-    inConnectionSwitch = false;
+  cairo_save(cr);
+  cairo_translate(cr, helper->viewX, helper->viewY);
+  cairo_scale(cr, helper->viewScale, helper->viewScale);
+  gdk_cairo_set_source_pixbuf(cr, pic, 0, 0);
+  cairo_paint(cr);
+  cairo_restore(cr);
+
+  g_object_unref(pic);
+
+  return true;
+}
 
+
+/* send a line to a connection's viewer process, with the connection's name after the command */
+void svHelperSend (Connection * con, const char * cmd, const char * args)
+{
+  if (!con->helper)
     return;
-  }
-  else
-  {
-    // log
-    GString * logStr = g_string_new(NULL);
-    g_string_printf(logStr, "Switching to connection '%s - %s'", con->name->str, con->address->str);
-    svLog(logStr->str, true);
-    g_string_free(logStr, true);
 
-    // fill quicknote label, last error text and quicknote text
-    gtk_label_set_text(GTK_LABEL(app->quickNoteLabel), con->name->str);
+  char * quotedName = g_shell_quote(con->name->str);
+  svControlSend(con->helper->channel, "- %s %s %s\n", cmd, quotedName, args ? args : "");
+  g_free(quotedName);
+}
 
-    if (con->lastConnectTime->len > 0)
-    {
-      GString * strTime = g_string_new(NULL);
-      g_string_printf(strTime, "Last connected: %s", con->lastConnectTime->str);
-      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), strTime->str);
-      g_string_free(strTime, true);
-    }
-    else
-      gtk_label_set_text(GTK_LABEL(app->quickNoteLastConnected), "-");
 
-    gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, con->lastErrorMessage->str, -1);
+/* forward the pointer to a viewer process, in remote screen coordinates */
+void svHelperPointer (Connection * con, gdouble x, gdouble y)
+{
+  HelperProc * helper = con->helper;
 
-    gsize outLen = 0;
-    unsigned char * qNote = g_base64_decode(con->quickNote->str, &outLen);
-    gtk_text_buffer_set_text(app->quickNoteBuffer, (const char *)qNote, -1);
-    g_free(qNote);
+  if (!svHelperScreenLive(helper) || con->viewOnly || con->tileMuted || helper->viewScale <= 0)
+    return;
 
-    // set selected connection to passed connection
-    app->selectedConnection = con;
+  const gint remoteX = CLAMP((x - helper->viewX) / helper->viewScale, 0, (gint)helper->width - 1);
+  const gint remoteY = CLAMP((y - helper->viewY) / helper->viewScale, 0, (gint)helper->height - 1);
 
-    // show vnc obj if it's connected
-    if (con->state == SV_STATE_CONNECTED && con->vncObj)
-    {
-      // show vnc display
-      gtk_widget_set_visible(con->vncObj, true);
-      gtk_stack_set_visible_child(GTK_STACK(app->displayStack), con->vncObj);
-      // set keyboard focus
-      gtk_widget_set_can_focus(con->vncObj, true);
-      // tell the parent container that THIS is the focus child
-      gtk_container_set_focus_child(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
-      gtk_container_set_focus_child(GTK_CONTAINER(app->displayStack), con->vncObj);
+  GString * args = g_string_new(NULL);
+  g_string_printf(args, "%i %i %u", remoteX, remoteY, helper->buttonMask);
+  svHelperSend(con, "pointer", args->str);
+  g_string_free(args, true);
+}
 
-      /* Attempt to focus the vnc display. Unfortunately we have to get a little 'creative'
-       * here and try two different ways (because the idle_add doesn't always work)
-       */
 
-      // try to focus the vnc display at idle time
-      g_idle_add((GSourceFunc)svFocusOnce, con->vncObj);
-      // try to focus the vnc display (again) after 300 milliseconds
-      g_timeout_add_once(300, (GSourceOnceFunc)gtk_widget_grab_focus, con->vncObj);
+/* handle the pointer moving over a viewer process's screen */
+gboolean svHelperMotion (GtkWidget * view, GdkEventMotion * event, gpointer data)
+{
+  svHelperPointer((Connection *)data, event->x, event->y);
 
-      gtk_widget_grab_focus(con->vncObj);
+  return true;
+}
 
-      // set tools menu items
-      svSetToolsMenuItems(true);
-    }
+
+/* handle a button going down or up over a viewer process's screen */
+gboolean svHelperButton (GtkWidget * view, GdkEventButton * event, gpointer data)
+{
+  Connection * con = (Connection *)data;
+
+  // (an unfocused tile's click goes on to the tile)
+  if (!con->helper || con->tileMuted || event->button < 1 || event->button > 3)
+    return false;
+
+  // (gdk's buttons 1, 2 and 3 are rfb's left, middle and right - bits 1, 2 and 4)
+  const guint bit = (event->button == 1 ? 1 : event->button == 2 ? 2 : 4);
+
+  if (event->type == GDK_BUTTON_PRESS)
+  {
+    con->helper->buttonMask |= bit;
+    gtk_widget_grab_focus(view);
   }
+  else if (event->type == GDK_BUTTON_RELEASE)
+    con->helper->buttonMask &= ~bit;
+  else
+    return true;
 
-  inConnectionSwitch = false;
+  svHelperPointer(con, event->x, event->y);
+
+  return true;
 }
 
 
-/* attempts to connect the vnc obj to the server */
-void svConnectionOpen (Connection * con)
+/* handle the wheel over a viewer process's screen (a press and release of the wheel 'button') */
+gboolean svHelperScroll (GtkWidget * view, GdkEventScroll * event, gpointer data)
 {
-  // set image quality
-  switch (con->quality)
+  Connection * con = (Connection *)data;
+
+  if (!con->helper)
+    return false;
+
+  guint bit = 0;
+
+  switch (event->direction)
   {
-    case SV_QUAL_LOW:
-      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_LOW);
+    case GDK_SCROLL_UP:
+      bit = 8;
       break;
-    case SV_QUAL_MEDIUM:
-      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_MEDIUM);
+    case GDK_SCROLL_DOWN:
+      bit = 16;
       break;
-    case SV_QUAL_FULL:
-      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_FULL);
+    case GDK_SCROLL_LEFT:
+      bit = 32;
+      break;
+    case GDK_SCROLL_RIGHT:
+      bit = 64;
       break;
     default:
-      vnc_display_set_depth(VNC_DISPLAY(con->vncObj), VNC_DISPLAY_DEPTH_COLOR_DEFAULT);
+      return true;
   }
 
-  // set read-only
-  vnc_display_set_read_only(VNC_DISPLAY(con->vncObj), con->viewOnly);
-
-  // set lossy encoding
-  vnc_display_set_lossy_encoding(VNC_DISPLAY(con->vncObj), con->lossyEncoding);
+  con->helper->buttonMask |= bit;
+  svHelperPointer(con, event->x, event->y);
+  con->helper->buttonMask &= ~bit;
+  svHelperPointer(con, event->x, event->y);
 
-  // set scaling
-  vnc_display_set_scaling(VNC_DISPLAY(con->vncObj), con->scale);
-  vnc_display_set_keep_aspect_ratio(VNC_DISPLAY(con->vncObj), TRUE);
+  return true;
+}
 
-  // initiate connection
-  switch (con->type)
-  {
-    case SV_TYPE_VNC:
-      // connect vnc obj directly to remote host
-      vnc_display_open_host(VNC_DISPLAY(con->vncObj), con->address->str, con->vncPort->str);
-      break;
 
-    case SV_TYPE_VNC_REVERSE:
-      // connect vnc obj directly to remote host
-      vnc_display_open_fd(VNC_DISPLAY(con->vncObj), con->listenFd);
-      break;
+/* forward a key going down or up to a viewer process */
+gboolean svHelperKey (GtkWidget * view, GdkEventKey * event, gpointer data)
+{
+  Connection * con = (Connection *)data;
 
-    case SV_TYPE_VNC_OVER_SSH:
-    {
-      // set up local port string
-      GString * localPortStr = g_string_new(NULL);
-      g_string_printf(localPortStr, "%u", con->sshLocalPort);
+  if (!con->helper || con->viewOnly || con->tileMuted)
+    return false;
 
-      // connect vnc obj to local forwarded port
-      vnc_display_open_host(VNC_DISPLAY(con->vncObj), "127.0.0.1", localPortStr->str);
-      g_string_free(localPortStr, true);
-      break;
-    }
+  // (f8, f9, f11 and f12 are ours, as they are over a vnc display)
+  if (event->type == GDK_KEY_PRESS && svHandleKeyboard(view, event, con))
+    return true;
 
-    default:
-      return;
-  }
+  GString * args = g_string_new(NULL);
+  g_string_printf(args, "%i %u", event->type == GDK_KEY_PRESS ? 1 : 0, event->keyval);
+  svHelperSend(con, "key", args->str);
+  g_string_free(args, true);
 
-  // INFO - vnc display is added to the stack in 'svServerInitialized' method
+  return true;
 }
 
 
-/* show error message about null con fields */
-void svShowNullConFieldsDialog (gpointer unused)
+/* show a connected viewer process's screen */
+void svHelperShow (Connection * con)
 {
-  svShowMessageDialog("One more more connection properties were NULL or invalid when attempting a SSH connection");
+  GtkWidget * view = con->helper->view;
 
-  gtk_window_present(GTK_WINDOW(app->mainWin));
+  gtk_widget_set_visible(view, true);
+  gtk_stack_set_visible_child(GTK_STACK(app->displayStack), view);
+  gtk_container_set_focus_child(GTK_CONTAINER(app->displayStackScroller), app->displayStack);
+  gtk_widget_grab_focus(view);
 }
 
 
-/* show about window */
-void svShowAboutWindow ()
+/* a viewer process has its connection up */
+void svHelperConnected (Connection * con)
 {
-  GdkPixbuf * aboutImage = gdk_pixbuf_new_from_resource("/com/spiritvnc/pngs/spiritvnc.png", NULL);
-  if (!aboutImage)
+  if (con->state == SV_STATE_CONNECTED)
     return;
 
-  GtkWidget * aboutDialog = gtk_about_dialog_new();
-  const char * authors[] = {"Will Brokenbourgh", NULL};
+  con->state = SV_STATE_CONNECTED;
+  svSetIconFromConnectionName(con->name->str, con->state);
 
-  // set about dialog properties
-  gtk_about_dialog_set_program_name(GTK_ABOUT_DIALOG(aboutDialog), "SpiritVNC-GTK");
-  gtk_about_dialog_set_logo(GTK_ABOUT_DIALOG(aboutDialog), aboutImage);
-  gtk_about_dialog_set_version(GTK_ABOUT_DIALOG(aboutDialog), SV_APP_VERSION);
-  gtk_about_dialog_set_authors(GTK_ABOUT_DIALOG(aboutDialog), authors);
-  //gtk_about_dialog_set_website(GTK_ABOUT_DIALOG(aboutDialog), "https://www.willbrokenbourgh.com/brainout/");
-  //gtk_about_dialog_set_website_label(GTK_ABOUT_DIALOG(aboutDialog), "Will Brokenbourgh");
-  gtk_about_dialog_set_license(GTK_ABOUT_DIALOG(aboutDialog), "SpiritVNC is released under a BSD 3-Clause license");
-  gtk_about_dialog_set_comments(GTK_ABOUT_DIALOG(aboutDialog), "A multi-connection VNC viewer for Unix-like, macOS and "
-    "Windows systems");
+  // connected again, so start any future auto-reconnects from scratch
+  svReconnectCancel(con, true);
+
+  con->lastViewed = g_get_monotonic_time();
+
+  // set last connected time
+  GDateTime * now = g_date_time_new_now_local();
+  char * nowStr = g_date_time_format(now, "%H:%M:%S--%Y-%m-%d");  // <<<--- do NOT make const char *
+  g_string_assign(con->lastConnectTime, nowStr);
+  g_free(nowStr);
+  g_date_time_unref(now);
+
+  gtk_stack_add_named(GTK_STACK(app->displayStack), con->helper->view, con->name->str);
+
+  svSetHostlistItemsTooltips();
+
+  con->resizeWidth = 0;
+  con->resizeHeight = 0;
+  svRemoteResizeSoon(con);
+
+  if (con == app->selectedConnection)
+  {
+    svHelperShow(con);
+    svSetToolsMenuItems(true);
+  }
+}
+
+
+/* let go of a connection's viewer process (which ends its connection, if it hasn't already, */
+/* once it sees we've hung up) */
+void svHelperStop (Connection * con)
+{
+  HelperProc * helper = con->helper;
+  if (!helper)
+    return;
 
-  // set window properties
-  gtk_window_set_transient_for(GTK_WINDOW(aboutDialog), GTK_WINDOW(app->mainWin));
-  gtk_window_set_position(GTK_WINDOW(aboutDialog), GTK_WIN_POS_CENTER_ON_PARENT);
+  svTileRemove(con);
+  svDetachEnd(con);
+  svRemoteResizeCancel(con);
 
-  // show the dialog then destroy afterwards
-  gtk_dialog_run(GTK_DIALOG(aboutDialog));
-  gtk_widget_destroy(aboutDialog);
+  con->helper = NULL;
 
-  // focus the main window when done
-  gtk_window_present(GTK_WINDOW(app->mainWin));
+  helper->channel->con = NULL;
+  helper->channel->onClose = NULL;
+  svControlClientClose(helper->channel);
+
+  svHelperUnmap(helper);
+
+  if (gtk_widget_get_parent(helper->view))
+    gtk_container_remove(GTK_CONTAINER(app->displayStack), helper->view);
+
+  gtk_widget_destroy(helper->view);
+  g_object_unref(helper->view);
+
+  g_free(helper);
 }
 
 
-/* create ssh session and ssh forwarding */
-/* (run as a thread due to blocking) */
-gpointer svCreateSSHConnection (gpointer data)
+/* a connection's viewer process is done, one way or another */
+void svHelperGone (Connection * con, guint state, const char * error)
 {
-  Connection * con = (Connection *)data;
-  if (!con)
-    return NULL;
+  if (!con->helper)
+    return;
 
   // log
   GString * logStr = g_string_new(NULL);
-  g_string_printf(logStr, "Creating new SSH connection for '%s - %s'", con->name->str, con->address->str);
+  g_string_printf(logStr, "Viewer process for '%s - %s' finished (%s)", con->name->str, con->address->str,
+    svStateName(state));
   svLog(logStr->str, true);
   g_string_free(logStr, true);
 
-  #ifdef _WIN32
-  // deal with annoying Windows terminal window issues
-  AllocConsole();
-  ShowWindow(GetConsoleWindow(), SW_HIDE);
-  #endif
+  // nothing more will show up on its screen (as in svServerDisconnected)
+  svMacroStop(con);
+  svMatchWaitCancel(con, NULL, NULL, "disconnected");
+  svRemoteShotFinish(con, "disconnected before the screen arrived");
 
-  // build the ssh check command
-  char * sshCheck[] = {
-    app->sshCommand->str,
-    NULL
-  };
+  svHelperStop(con);
 
-  // first check to see if the ssh command is working
-  GError * gSSHCheckError = NULL;
-  char * stdOut = NULL;
-  char * stdErr = NULL;
-  gint exitStatus = 0;
+  if (error && error[0] != '\0')
+  {
+    g_string_assign(con->lastErrorMessage, error);
 
-  //for (gint i = 0; sshCheck[i] != NULL; i++)
-  //{
-    //printf("%s\n", sshCheck[i]);
-  //}
+    if (con == app->selectedConnection)
+      gtk_text_buffer_set_text(app->quickNoteLastErrorBuffer, error, -1);
+  }
 
-  gboolean checkResult = g_spawn_sync(NULL,         // Working directory (NULL uses current directory)
-                      sshCheck,      // Command to execute
-                      NULL,         // Environment variables
-                      G_SPAWN_DEFAULT, // Flags
-                      NULL,         // Child setup function
-                      NULL,         // User data for child setup
-                      &stdOut,         // Standard output (NULL ignores it)
-                      &stdErr,      // Standard error (NULL ignores it)
-                      &exitStatus, // Exit status
-                      &gSSHCheckError);
+  con->state = state;
+  svSetIconFromConnectionName(con->name->str, con->state);
 
-  (void)checkResult;
+  svSetHostlistItemsTooltips();
 
-  // deal with ssh command check failure
-  // I'm only interested in gSSHCheckError and I'm purposely ignoring checkResult and exitStatus
-  if (gSSHCheckError)
-  {
-    // problemos
-    //printf("ssh error - gError code: %i, gError message: %s\n", gSSHCheckError->code, gSSHCheckError->message);
-    //printf("ssh error - exitStatus: %i, stdErr: %s\n", exitStatus, stdErr);
+  // anything but a manual disconnect (or an eviction or idle close) gets retried, if enabled
+  if (con->autoReconnect && con->disconnectType != SV_DISC_MANUAL && state != SV_STATE_EVICTED &&
+    state != SV_STATE_IDLE)
+    svReconnectSchedule(con);
+}
 
-    // log error
-    GString * errStr = g_string_new(NULL);
-    g_string_printf(errStr,
-      "SSH command not working for connection '%s - %s'\nError: %s\nCheck command or installation",
-      con->name->str, con->address->str, gSSHCheckError->message);
-    svLog(errStr->str, false);
 
-    // set connection's last error message
-    g_string_assign(con->lastErrorMessage, errStr->str);
-    g_idle_add_once(svSetSSHLastErrorMessage, con);
-    g_string_free(errStr, true);
+/* handle a viewer process's channel closing without saying how its connection ended */
+void svHelperChannelClosed (ControlClient * channel)
+{
+  if (channel->con)
+    svHelperGone(channel->con, SV_STATE_ERROR, "The viewer process exited unexpectedly");
+}
 
-    // set connection variables
-    con->sshContinue = false;
-    con->disconnectType = SV_DISC_SSH_ERROR;
-    con->state = SV_STATE_ERROR;
 
-    // set connection list row's icon
-    g_idle_add_once(svSetConnectionIconFromSSHError, con);
+/* handle an event line from a connection's viewer process */
+void svHelperLine (ControlClient * channel, const char * line)
+{
+  Connection * con = channel->con;
 
-    g_free(stdOut);
-    g_free(stdErr);
+  gint argc = 0;
+  char ** argv = NULL;  // <<<--- do NOT make const char **
 
-    g_error_free(gSSHCheckError);
+  // (replies to our '-' tagged requests aren't sent, so everything here is an event)
+  if (!con || !con->helper || !g_shell_parse_argv(line, &argc, &argv, NULL))
+    return;
 
-    return NULL;
-  }
+  if (argc > 3 && strcmp(argv[0], "*") == 0)
+  {
+    // * state NAME STATE *
+    if (strcmp(argv[1], "state") == 0 && strcmp(argv[3], "connected") == 0)
+      svHelperConnected(con);
 
-  g_free(stdOut);
-  g_free(stdErr);
+    // * shm NAME SEGMENT W H *
+    else if (strcmp(argv[1], "shm") == 0)
+      svHelperMap(con, argv[3]);
 
-  //if (gSSHCheckError)
-  //{
-    ////printf("DEBUG: svCreateSSHConnection - readError pointer = %p\n", (void *)gSSHCheckError);
-    //g_error_free(gSSHCheckError);
-  //}
+    // * frame NAME N *
+    else if (strcmp(argv[1], "frame") == 0)
+    {
+      // (unfocused tiles and slowed windows redraw at their own slower rate)
+      if (gtk_widget_get_mapped(con->helper->view) && !con->tileMuted && !(con->detachWin && con->detachRate > 0))
+        gtk_widget_queue_draw(con->helper->view);
 
-  // --- looks like we're okay ---
+      // the shared screen changed, just as a vnc display's does (see svHandleServerActivity)
+      if (con->matchWaits)
+        svMatchSchedule(con);
 
-  // check that all con fields are non-null
-  if (!con->sshUser || !con->address || con->sshPort->len == 0 ||
-      con->sshLocalPort == 0 || !con->vncPort || !con->sshPrivKeyfile)
-  {
-    g_idle_add_once(svShowNullConFieldsDialog, NULL);
-    return NULL;
+      if (con->shotCmdLine && con->shotSource == 0 && con->state == SV_STATE_CONNECTED)
+        con->shotSource = g_timeout_add(SV_SHOT_SETTLE_MS, svRemoteShotSettle, con);
+    }
+
+    // * ended NAME STATE [ERROR] *
+    else if (strcmp(argv[1], "ended") == 0)
+      svHelperGone(con, svStateFromName(argv[3]), argc > 4 ? argv[4] : NULL);
   }
 
-  GError * sshRunErr = NULL;
-  GPid pid = 0;
+  g_strfreev(argv);
+}
 
-  // ** build the command string for our g_spawn_async_with_pipes call **
 
-  // build "user@host"
-  GString * tgt = g_string_new(NULL);
-  g_string_printf(tgt, "%s@%s", con->sshUser->str, con->address->str);
-  char * sshTargetString = tgt->str;
+/* start a connection in a viewer process of its own (false if one can't be started) */
+/* (the child runs 'spiritvnc --helper NAME' with one end of a socket pair as its stdin, */
+/* takes control socket requests on it, and shares its screen back through shared memory) */
+gboolean svHelperStart (Connection * con)
+{
+  #ifdef _WIN32
+  return false;
+  #else
+  gint fds[2];
 
-  // build "localPort:127.0.0.1:vncPort"
-  GString * fwd = g_string_new(NULL);
-  g_string_printf(fwd, "%i:127.0.0.1:%s", con->sshLocalPort, con->vncPort->str);
-  char * localForwardString = fwd->str;
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    return false;
 
-  // TODO: Include -i parameter only if there's a private key file set
+  // run the same program we are
+  char * selfPath = g_file_read_link("/proc/self/exe", NULL);  // <<<--- do NOT make const char *
 
-  // build argv array for SSH
-  char * sshArgv[] =
-  {
-    app->sshCommand->str,  // "/usr/bin/ssh", etc
-    "-t",
-    "-t",
-    "-p", con->sshPort->str,
-    "-o", "ConnectTimeout=5",
-    "-L", localForwardString,
-    "-i", con->sshPrivKeyfile->str,
-    sshTargetString,
-    NULL
-  };
+  if (!selfPath)
+    selfPath = g_strdup(app->selfPath->str);
 
-  //for (gint i = 0; sshArgv[i] != NULL; i++)
-  //{
-    //printf("%s\n", sshArgv[i]);
-  //}
+  char * argv[] = {selfPath, "--helper", con->name->str, NULL};
 
-  // attempt to call the system's ssh client and open write stream
-  gboolean sshRunOkay = g_spawn_async_with_pipes(
-                  NULL,
-                  sshArgv,               // SSH command array
-                  NULL,
-                  G_SPAWN_DEFAULT, //G_SPAWN_DO_NOT_REAP_CHILD,
-                  NULL,
-                  NULL,
-                  &pid,
-                  &con->sshStdIn,
-                  NULL,
-                  NULL,
-                  &sshRunErr);
+  GPid pid = 0;
+  GError * error = NULL;
 
-  (void)sshRunOkay;
+  const gboolean okay = g_spawn_async_with_fds(NULL, argv, NULL, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL,
+    &pid, fds[1], -1, -1, &error);
 
-  // we only care about sshRunError, not sshRunOkay
-  if (sshRunErr || !con->sshStdIn)
-  {
-    // something -- happened - log the failure
-    GString * errStr = g_string_new(NULL);
-    g_string_printf(errStr, "SSH command failed for '%s - %s'", con->name->str, con->address->str);
-    svLog(errStr->str, false);
+  g_free(selfPath);
+  close(fds[1]);
 
-    // set connection's last error message
-    g_string_assign(con->lastErrorMessage, errStr->str);
-    g_idle_add_once(svSetSSHLastErrorMessage, con);
-    g_string_free(errStr, true);
+  if (!okay)
+  {
+    GString * logStr = g_string_new(NULL);
+    g_string_printf(logStr, "Unable to start a viewer process for '%s': %s", con->name->str, error->message);
+    svLog(logStr->str, false);
+    g_string_free(logStr, true);
 
-    // set connection variables
-    con->sshContinue = false;
-    con->disconnectType = SV_DISC_SSH_ERROR;
-    con->state = SV_STATE_ERROR;
+    g_error_free(error);
+    close(fds[0]);
 
-    // set connection list row icon
-    g_idle_add_once(svSetConnectionIconFromSSHError, con);
+    return false;
+  }
 
-    // free up stuff
-    g_string_free(tgt, true);
-    g_string_free(fwd, true);
+  g_child_watch_add(pid, svHelperReaped, NULL);
 
-    g_error_free(sshRunErr);
+  GSocket * sock = g_socket_new_from_fd(fds[0], NULL);
 
-    return NULL;
+  if (!sock)
+  {
+    close(fds[0]);
+    return false;
   }
 
-  // free up stuff
-  g_string_free(tgt, true);
-  g_string_free(fwd, true);
+  HelperProc * helper = g_new0(HelperProc, 1);
+  helper->pid = pid;
 
-  con->sshPid = pid;
+  // (the channel isn't one of app->controlClients, so it only hears what we send it)
+  helper->channel = svControlClientNew(sock);
+  helper->channel->con = con;
+  helper->channel->onLine = svHelperLine;
+  helper->channel->onClose = svHelperChannelClosed;
 
-  con->sshContinue = true;
+  g_object_unref(sock);
 
-  return NULL;
+  helper->view = g_object_ref_sink(gtk_drawing_area_new());
+  gtk_widget_set_can_focus(helper->view, true);
+  gtk_widget_add_events(helper->view, GDK_POINTER_MOTION_MASK | GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK |
+    GDK_SCROLL_MASK | GDK_KEY_PRESS_MASK | GDK_KEY_RELEASE_MASK);
+
+  g_signal_connect(helper->view, "draw", G_CALLBACK(svHelperDraw), con);
+  g_signal_connect(helper->view, "motion-notify-event", G_CALLBACK(svHelperMotion), con);
+  g_signal_connect(helper->view, "button-press-event", G_CALLBACK(svHelperButton), con);
+  g_signal_connect(helper->view, "button-release-event", G_CALLBACK(svHelperButton), con);
+  g_signal_connect(helper->view, "scroll-event", G_CALLBACK(svHelperScroll), con);
+  g_signal_connect(helper->view, "key-press-event", G_CALLBACK(svHelperKey), con);
+  g_signal_connect(helper->view, "key-release-event", G_CALLBACK(svHelperKey), con);
+
+  con->helper = helper;
+
+  GString * logStr = g_string_new(NULL);
+  g_string_printf(logStr, "Started viewer process %i for '%s - %s'", (gint)pid, con->name->str, con->address->str);
+  svLog(logStr->str, true);
+  g_string_free(logStr, true);
+
+  return true;
+  #endif
 }
 
-/* handle mac menu bar 'quit' action */
-void svAppMenuAboutAction (GSimpleAction * action, GVariant * parameter, gpointer user_data)
+
+/* (viewer process) let the process end */
+void svHelperChildRelease ()
 {
-  svShowAboutWindow();
+  if (!app->helperHeld)
+    return;
+
+  app->helperHeld = false;
+  g_application_release(G_APPLICATION(app->gApp));
 }
 
 
-/* handle mac menu bar 'quit' action */
-void svAppMenuSettingsAction (GSimpleAction * action, GVariant * parameter, gpointer user_data)
+/* (viewer process) tell the parent how the connection ended, then hang up */
+gboolean svHelperChildEnd (gpointer data)
 {
-  svShowAppOptionsWindow();
+  Connection * con = (Connection *)data;
+
+  app->helperEndSource = 0;
+
+  if (!app->controlClients)
+  {
+    svHelperChildRelease();
+    return G_SOURCE_REMOVE;
+  }
+
+  char * quotedName = g_shell_quote(con->name->str);
+  char * quotedError = g_shell_quote(con->lastErrorMessage->str);
+
+  for (GList * l = app->controlClients; l; l = l->next)
+  {
+    ControlClient * client = l->data;
+
+    client->closeWhenSent = true;
+    svControlSend(client, "* ended %s %s %s\n", quotedName, svStateName(con->state), quotedError);
+  }
+
+  g_free(quotedName);
+  g_free(quotedError);
+
+  return G_SOURCE_REMOVE;
 }
 
-/* handle mac menu bar 'quit' action */
-void svAppMenuQuitAction (GSimpleAction * action, GVariant * parameter, gpointer user_data)
+
+/* (viewer process) the parent hung up, or we did after saying goodbye */
+void svHelperChildClosed (ControlClient * client)
 {
-  svDoQuit();
-  g_application_quit(G_APPLICATION(user_data));
+  Connection * con = client->con;
+
+  // close the connection properly first (ending it lets the process go)
+  if (con && (con->state == SV_STATE_CONNECTED || con->state == SV_STATE_WAITING))
+    svConnectionEnd(con);
+  else
+    svHelperChildRelease();
 }
 
 
-/* handle app's activate event */
-static void svAppActivate (GtkApplication * gtkApp, gpointer userData)
+/* (viewer process) handle 'spiritvnc --helper NAME', run by a parent instance */
+gint svHelperChildCommandLine (GApplication * gApp, GApplicationCommandLine * cmdLine)
 {
-  svCreateGUI(gtkApp);
-  svLog("--- App starting up ---", false);
+  gint argc = 0;
+  char ** argv = g_application_command_line_get_arguments(cmdLine, &argc);  // <<<--- do NOT make const char **
+
+  if (argc < 3)
+  {
+    g_application_command_line_printerr(cmdLine, "spiritvnc: --helper is only for spiritvnc's own use\n");
+    g_strfreev(argv);
+    return 2;
+  }
+
+  svHeadlessSetup();
+
+  // the parent draws what we share
+  app->shmExport = true;
+
+  Connection * con = svConnectionFromName(argv[2]);
+
+  if (!con || con->type == SV_TYPE_VNC_REVERSE)
+  {
+    g_application_command_line_printerr(cmdLine, "spiritvnc: no connection named '%s'\n", argv[2]);
+    g_strfreev(argv);
+    return 2;
+  }
+
+  g_strfreev(argv);
+
+  // (the parent decides about reconnecting)
+  con->autoReconnect = false;
+
+  // the parent talks to us over stdin
+  GSocket * sock = g_socket_new_from_fd(0, NULL);
+
+  if (!sock)
+  {
+    g_application_command_line_printerr(cmdLine, "spiritvnc: --helper needs a socket as stdin\n");
+    return 2;
+  }
+
+  ControlClient * client = svControlClientNew(sock);
+  client->con = con;
+  client->subscribed = true;
+  client->frames = true;
+  client->onClose = svHelperChildClosed;
+
+  g_object_unref(sock);
+
+  app->controlClients = g_list_prepend(app->controlClients, client);
+
+  // keep running until the connection is done
+  app->helperHeld = true;
+  g_application_hold(gApp);
+
+  svConnectionCreate(con);
+
+  return 0;
 }
 
 
@@ -5124,8 +13937,34 @@ gint main (gint argc, char ** argv)
   // initialize the app struct
   svInitAppVars();
 
+  // a batch run (or a viewer process) is a separate process of its own, not a request for the running one
+  for (gint i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--batch") == 0)
+      app->batchMode = true;
+    else if (i == 1 && strcmp(argv[i], "--helper") == 0)
+      app->helperChild = true;
+  }
+
+  // (a batch run shows nothing, but its vnc objs are still gtk widgets and need a display to exist -
+  // say so plainly instead of letting gtk abort on startup)
+  if (app->batchMode && !gtk_init_check(&argc, &argv))
+  {
+    fprintf(stderr, "spiritvnc: --batch needs an X11 or Wayland display - "
+      "on a server, run it under xvfb-run (or set DISPLAY)\n");
+    g_free(app);
+    return 2;
+  }
+
+  // (for starting viewer processes where /proc/self/exe isn't available)
+  char * selfPath = g_find_program_in_path(argv[0]);  // <<<--- do NOT make const char *
+  app->selfPath = g_string_new(selfPath ? selfPath : argv[0]);
+  g_free(selfPath);
+
   // set application stuffs
-  app->gApp = gtk_application_new ("org.will.brokenbourgh", G_APPLICATION_DEFAULT_FLAGS);
+  // (command lines from later launches are handed to the running instance)
+  app->gApp = gtk_application_new ("org.will.brokenbourgh", G_APPLICATION_HANDLES_COMMAND_LINE |
+    (app->batchMode || app->helperChild ? G_APPLICATION_NON_UNIQUE : 0));
   const GActionEntry app_actions[] = {
     {"about", svAppMenuAboutAction, NULL, NULL, NULL},
     {"preferences", svAppMenuSettingsAction, NULL, NULL, NULL},
@@ -5135,10 +13974,17 @@ gint main (gint argc, char ** argv)
   g_action_map_add_action_entries(G_ACTION_MAP(app->gApp), app_actions, G_N_ELEMENTS(app_actions), app->gApp);
 
   g_signal_connect(app->gApp, "activate", G_CALLBACK(svAppActivate), NULL);
+  g_signal_connect(app->gApp, "command-line", G_CALLBACK(svHandleCommandLine), NULL);
 
   // run our app
   gint status = g_application_run(G_APPLICATION(app->gApp), argc, argv);
 
+  // (a batch run decides its exit status after the main loop has started, and so do screenshots we started for)
+  if (app->batchMode && status == 0)
+    status = app->batchStatus;
+  else if (app->shotOnly && status == 0)
+    status = app->shotStatus;
+
   // unref after we're done
   g_object_unref(app->gApp);
 
@@ -40,12 +40,17 @@
 
 #ifdef _WIN32
 #include <winsock2.h>
+#include <ws2tcpip.h>
 #include <windows.h>
 #else
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 
 #include <unistd.h>
@@ -55,11 +60,253 @@
 
 #include <stdbool.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define SV_APP_VERSION "0.0.3"
 
+// f12 macro limits
+#define SV_MACRO_MAX_CHORD 6
+#define SV_MACRO_STEPS_PER_TICK 64
+
+// screen matching - shrink factor for the first pass, spots it keeps, slack around a
+// given position, allowed average difference per pixel, fastest re-check after an
+// update, and the default wait
+#define SV_MATCH_COARSE 4
+#define SV_MATCH_CANDIDATES 4
+#define SV_MATCH_SLACK 2
+#define SV_MATCH_MAX_DIFF 12
+#define SV_MATCH_MIN_MS 100
+#define SV_MATCH_WAIT_SECS 60
+
+// clipboard history limits
+#define SV_CLIP_HISTORY_MAX 20
+#define SV_CLIP_LAZY_BYTES 65536
+#define SV_CLIP_PREVIEW_CHARS 40
+
+// milliseconds between setting the remote clipboard and pressing the paste keys
+#define SV_PASTE_KEYS_DELAY 100
+
+// length of the rfb version banner ("RFB 003.008\n")
+#define SV_PROBE_BANNER_LEN 12
+
+// auto-reconnect backoff, in milliseconds
+#define SV_RECONNECT_BASE_MS 2000
+#define SV_RECONNECT_CAP_MS 300000
+
+// head start each racing connect attempt gets before the next address is tried (rfc 8305)
+#define SV_CONNECT_STAGGER_MS 250
+
+// pre-connecting - how long the pointer rests on a row first, and how long an unused socket is kept
+#define SV_WARM_HOVER_MS 400
+#define SV_WARM_HOLD_SECS 10
+
+// longest idle-disconnect time that can be set (a week, in minutes)
+#define SV_IDLE_MAX_MINUTES 10080
+
+// how long after the first screen update a command-line screenshot is taken
+#define SV_SHOT_SETTLE_MS 500
+
+// control socket limits, and how long a 'wait' waits by default
+#define SV_CONTROL_CLIENTS_MAX 16
+#define SV_CONTROL_LINE_MAX 65536
+#define SV_CONTROL_READ_CHUNK 4096
+#define SV_CONTROL_WAIT_SECS 60
+
+// batch mode defaults - hosts at a time, and how long each gets
+#define SV_BATCH_PARALLEL 8
+#define SV_BATCH_TIMEOUT_SECS 60
+
+// shared memory screen export - header magic ('SVFB') and layout version, changed-area
+// ring size, and how often batched changes are published
+#define SV_SHM_MAGIC 0x42465653
+#define SV_SHM_VERSION 1
+#define SV_SHM_RING 64
+#define SV_SHM_MIN_MS 50
+
+// how many times to try copying a frame from a viewer process's shared screen without it changing underneath
+#define SV_SHM_READ_TRIES 5
+
+// most remote addresses tracked for reverse connection rate limits
+#define SV_REVERSE_BUCKETS_MAX 4096
+
+// size of the zero-padded 'ID:nnnn' request sent to a vnc repeater
+#define SV_REPEATER_REQUEST_LEN 250
+
+// starting size of a detached connection window
+#define SV_DETACH_WIDTH 1024
+#define SV_DETACH_HEIGHT 768
+
+// how often a detached window can be set to redraw, in ms (0 is live)
+#define SV_DETACH_RATES { 0, 250, 1000, 5000 }
+
+// how often unfocused tiles are redrawn (the focused one is live)
+#define SV_TILE_REFRESH_MS 1000
+
+// remote desktop resizing - how long the viewing area must stay put first, and the sizes we'll ask for
+#define SV_RESIZE_DEBOUNCE_MS 500
+#define SV_RESIZE_MIN 200
+#define SV_RESIZE_MAX 8192
+
+// pointer motion coalescing - interval bounds and default (ms), and how often to time the link (s)
+#define SV_POINTER_MIN_MS 16
+#define SV_POINTER_MAX_MS 200
+#define SV_POINTER_DEFAULT_MS 33
+#define SV_POINTER_RTT_SECS 5
+
+// last-known screen previews - stored width and jpeg quality, tooltip width, how dim, how often kept (s)
+#define SV_PREVIEW_WIDTH 640
+#define SV_PREVIEW_QUALITY "70"
+#define SV_PREVIEW_TIP_WIDTH 240
+#define SV_PREVIEW_DIM 0.4
+#define SV_PREVIEW_SAVE_SECS 60
+
 // forward declarations
 typedef struct Connection Connection;
 typedef struct ToolsMenuItems ToolsMenuItems;
+typedef struct ControlClient ControlClient;
+typedef struct HelperProc HelperProc;
+
+// a reference image to look for on a connection's screen (gray, plus a shrunken copy)
+typedef struct MatchTemplate
+{
+  gint refs;
+  GString * path;
+  guchar * gray;
+  guint width;
+  guint height;
+  guchar * coarse;
+  guint cw;
+  guint ch;
+  gint fixedX;
+  gint fixedY;
+} MatchTemplate;
+
+// a connection's screen, ready for matching
+typedef struct MatchScreen
+{
+  guchar * gray;
+  guint width;
+  guint height;
+  guchar * coarse;
+  guint cw;
+  guint ch;
+} MatchScreen;
+
+// called when a screen wait ends (error is NULL if the image was found at x, y)
+typedef void (*MatchCallback) (Connection *, const char *, gint, gint, gpointer);
+
+// something waiting for a connection's screen to show an image
+typedef struct MatchWait
+{
+  Connection * con;
+  MatchTemplate * tmpl;
+  MatchCallback cb;
+  gpointer data;
+  guint timeoutSource;
+} MatchWait;
+
+// one step of a compiled f12 macro
+typedef struct MacroStep
+{
+  guint type;
+  guint keys[SV_MACRO_MAX_CHORD];
+  guint nKeys;
+  guint delay;
+  MatchTemplate * match;
+} MacroStep;
+
+// clipboard text shared by every history entry holding the same contents
+typedef struct ClipText
+{
+  GBytes * bytes;
+  guint hash;
+  guint refs;
+} ClipText;
+
+// one clipboard history entry
+typedef struct ClipEntry
+{
+  Connection * con;
+  ClipText * text;
+} ClipEntry;
+
+// one reachability probe in flight
+typedef struct ProbeJob
+{
+  Connection * con;
+  GSocketClient * client;
+  GSocketConnection * sockCon;
+  GCancellable * cancel;
+  guint16 port;
+  gint64 startTime;
+  gint64 rtt;
+  char banner[SV_PROBE_BANNER_LEN + 1];
+} ProbeJob;
+
+// one app-managed tcp connect in flight (direct vnc with a dead-peer timeout)
+typedef struct ConnectJob
+{
+  Connection * con;
+  guint16 port;
+  GList * addrs;
+  GList * next;
+  GSocketClient * client;
+  GCancellable * cancel;
+  guint attempts;
+  guint staggerSource;
+  gboolean done;
+  gboolean warm;
+  GString * lastError;
+} ConnectJob;
+
+// one listening socket for reverse connections
+typedef struct ListenSocket
+{
+  GSocket * sock;
+  GSource * source;
+  guint16 port;
+} ListenSocket;
+
+// per-address reverse connection allowance (token bucket)
+typedef struct RateBucket
+{
+  double tokens;
+  gint64 last;
+} RateBucket;
+
+// one vnc repeater handshake in flight
+typedef struct RepeaterJob
+{
+  Connection * con;
+  GSocketConnection * sockCon;
+  GCancellable * cancel;
+  char greeting[SV_PROBE_BANNER_LEN];
+  char request[SV_REPEATER_REQUEST_LEN];
+} RepeaterJob;
+
+// called with a host's addresses (NULL and an error message if the lookup failed)
+typedef void (*DnsCallback) (GList *, const char *, gint64, gpointer);
+
+// one shared host name lookup, cached until it expires
+typedef struct DnsEntry
+{
+  GString * host;
+  GList * addrs;
+  gint64 expires;
+  gint64 startTime;
+  gboolean pending;
+  GList * waiters;
+} DnsEntry;
+
+// someone waiting on a host name lookup
+typedef struct DnsWaiter
+{
+  DnsCallback callback;
+  gpointer data;
+  gint64 startTime;
+} DnsWaiter;
 
 // structs
 typedef struct Application
@@ -77,6 +324,7 @@ typedef struct Application
   GtkWidget * displayStack;
   GtkWidget * quickNoteLabel;
   GtkWidget * quickNoteLastConnected;
+  GtkWidget * quickNoteReconnect;
   GtkWidget * quickNoteLastError;
   GtkWidget * quickNoteView;
 
@@ -115,11 +363,102 @@ typedef struct Application
 
   //# flags, states and stuff
   gboolean listenMode;
-  guint listenPort;
-  GSocket * listenSocket;
-  GSource * listenSource;
+  GString * listenPorts;
+  guint listenBacklog;
+  GPtrArray * listeners;
+
+  // reverse connection admission
+  guint reverseMax;
+  guint reverseRatePerMin;
+  GString * reverseAllowText;
+  GPtrArray * reverseAllow;
+  GHashTable * reverseBuckets;
+  guint reverseCount;
+  guint reverseRejected;
   guint scanTimerSource;
 
+  // clipboard history
+  GQueue * clipHistory;
+  GHashTable * clipStore;
+  gsize clipBytes;
+  guint clipHistoryKB;
+
+  // reachability probes
+  guint probeInterval;
+  guint probeConcurrency;
+  gboolean probeReadBanner;
+  guint probeTimerSource;
+  GQueue * probeQueue;
+  guint probeActive;
+
+  // framebuffer memory budget
+  guint fbBudgetMB;
+
+  // shared host name lookups
+  GHashTable * dnsCache;
+  guint dnsCacheSecs;
+
+  // pre-connecting
+  gboolean preconnect;
+  Connection * warmHoverCon;
+  guint warmHoverSource;
+
+  // idle disconnect
+  guint idleMinutes;
+  gboolean idleReconnect;
+
+  // automation control socket
+  gboolean controlSocket;
+  GString * controlPath;
+  GSocket * controlSock;
+  GSource * controlSource;
+  GList * controlClients;
+  GList * controlWaiters;
+
+  // command-line screenshots taken by a process started just for them
+  gboolean shotOnly;
+  guint shotsPending;
+  gint shotStatus;
+
+  // headless batch mode
+  gboolean batchMode;
+  gboolean batchJson;
+  guint batchParallel;
+  guint batchTimeout;
+  guint batchActive;
+  guint batchDone;
+  guint batchFailed;
+  gint batchStatus;
+  GQueue * batchQueue;
+  GString * batchOutDir;
+  GString * batchReportFile;
+  GString * batchReport;
+  GApplicationCommandLine * batchCmdLine;
+
+  // shared memory screen export
+  gboolean shmExport;
+
+  // tile view (tiles is the tiled connections, in grid order)
+  guint tileCount;
+  GtkWidget * tileGrid;
+  GList * tiles;
+  Connection * tileFocus;
+  guint tileSource;
+  guint tileLayoutSource;
+
+  // viewer processes (helperChild is set in the process running one connection for another)
+  gboolean helperViewers;
+  gboolean helperChild;
+  gboolean helperHeld;
+  guint helperEndSource;
+  GString * selfPath;
+
+  // last-known screen previews (previewCon is the connection whose preview is showing)
+  gboolean savePreviews;
+  GString * previewDir;
+  GtkWidget * previewArea;
+  Connection * previewCon;
+
   // important paths
   GString * appConfigDir;
   GString * appConfigFile;
@@ -134,6 +473,61 @@ typedef struct Application
 
 App * app;
 
+// a changed area of a shared screen (frame is the header frame it arrived in)
+typedef struct ShmRect
+{
+  guint32 x;
+  guint32 y;
+  guint32 width;
+  guint32 height;
+  guint32 frame;
+} ShmRect;
+
+// the start of a shared screen segment, followed by height rows of stride bytes
+// (seq is odd while a frame is being written - readers retry if it changed or is odd;
+// live drops to zero when the segment is retired, e.g. on disconnect or resize)
+typedef struct ShmHeader
+{
+  guint32 magic;
+  guint32 version;
+  guint32 headerSize;
+  gint live;
+  guint32 width;
+  guint32 height;
+  guint32 stride;
+  guint32 format;
+  gint seq;
+  guint32 frame;
+  guint32 ringHead;
+  guint32 ringSize;
+  ShmRect ring[SV_SHM_RING];
+} ShmHeader;
+
+// our side of a shared screen
+typedef struct ShmExport
+{
+  char name[64];
+  ShmHeader * hdr;
+  guchar * pixels;
+  gsize size;
+  GArray * dirty;
+  guint source;
+} ShmExport;
+
+// one host's progress in a batch run (times are monotonic usecs, 0 if not reached)
+typedef struct BatchItem
+{
+  gint64 startTime;
+  gint64 connectTime;
+  gint64 screenTime;
+  cairo_region_t * screenRegion;
+  guint timeoutSource;
+  gboolean timedOut;
+  gboolean okay;
+  GString * file;
+  GString * error;
+} BatchItem;
+
 typedef struct Connection
 {
   GString * name;
@@ -149,11 +543,19 @@ typedef struct Connection
   gboolean lossyEncoding;
   gboolean showRemoteCursor;
   guint quality;
+  guint clipboardSync;
+  guint pasteMode;
+  GString * pasteKeys;
+  gboolean autoReconnect;
+  guint reconnectMaxTries;
+  guint liveTimeout;
+  gint idleMinutes;
   GString * sshUser;
   GString * sshPass;
   GString * sshPort;
   GString * sshPrivKeyfile;
   GString * f12Macro;
+  GArray * f12Program;
   GString * quickNote;
   gboolean customCmd1Enabled;
   GString * customCmd1Label;
@@ -177,26 +579,143 @@ typedef struct Connection
   gboolean sshContinue;
   GPid sshPid;
   gint sshStdIn;
-  GString * clipboard;
+  GBytes * clipLastSent;
   GtkWidget * settingsWin;
   gint listenFd;
   gboolean viewOnly;
+  GArray * macroProgram;
+  guint macroStep;
+  guint macroSource;
+  guint probeState;
+  gint64 probeRtt;
+  GString * probeVersion;
+  GString * probeTime;
+  ProbeJob * probeJob;
+  gboolean probeQueued;
+  guint reconnectTries;
+  guint reconnectSource;
+  gint64 reconnectAt;
+  ConnectJob * connectJob;
+  guint watchdogSource;
+  gint64 lastActivity;
+  gsize fbBytes;
+  gint64 lastViewed;
+  gint64 resolveTime;
+  ConnectJob * warmJob;
+  GSocketConnection * warmSock;
+  guint warmSource;
+  GString * repeaterId;
+  RepeaterJob * repeaterJob;
+  GString * shotFile;
+  GApplicationCommandLine * shotCmdLine;
+  guint shotSource;
+  guint controlState;
+  BatchItem * batchItem;
+  GList * matchWaits;
+  guint matchSource;
+  gint64 matchLast;
+  ShmExport * shm;
+  HelperProc * helper;
+  GtkWidget * detachWin;
+  gboolean detachScale;
+  guint detachRate;
+  guint detachSource;
+  gulong detachDrawHandler;
+  GtkWidget * tileBox;
+  gboolean tileScale;
+  gboolean tileMuted;
+  cairo_surface_t * tileSnap;
+  gint64 tileSnapTime;
+  gulong tileDrawHandler;
+  gboolean remoteResize;
+  guint resizeSource;
+  guint resizeWidth;
+  guint resizeHeight;
+  gboolean coalescePointer;
+  gint pointerX;
+  gint pointerY;
+  guint pointerMask;
+  gboolean pointerPending;
+  guint pointerSource;
+  gint64 rttEstimate;
+  gint64 rttProbeSent;
+  gint64 rttProbeLast;
+  GdkPixbuf * preview;
+  GdkPixbuf * previewTip;
+  gboolean previewLoaded;
+  gint64 previewSaved;
 } Connection;
 
+// what a control client does with each line it sends, and when it goes away
+typedef void (*ControlLineFunc) (ControlClient *, const char *);
+typedef void (*ControlCloseFunc) (ControlClient *);
+
+// one client of the automation control socket
+typedef struct ControlClient
+{
+  GSocketConnection * sockCon;
+  GInputStream * in;
+  GString * inBuf;
+  char readBuf[SV_CONTROL_READ_CHUNK];
+  GCancellable * cancel;
+  GString * outBuf;
+  GString * writing;
+  gboolean subscribed;
+  gboolean frames;
+  gboolean closeWhenSent;
+  gboolean closed;
+  gint refs;
+  Connection * con;
+  ControlLineFunc onLine;
+  ControlCloseFunc onClose;
+} ControlClient;
+
+// a connection running in a viewer process of its own, drawn from the screen it shares
+// (view* is where and how big the screen was last drawn, for mapping the pointer back)
+typedef struct HelperProc
+{
+  GPid pid;
+  ControlClient * channel;
+  GtkWidget * view;
+  ShmHeader * hdr;
+  gsize size;
+  const guchar * pixels;
+  guint width;
+  guint height;
+  guint stride;
+  gdouble viewScale;
+  gdouble viewX;
+  gdouble viewY;
+  guint buttonMask;
+} HelperProc;
+
+// a control client waiting for a connection to finish connecting
+typedef struct ControlWaiter
+{
+  ControlClient * client;
+  Connection * con;
+  char * tag;
+  guint timeoutSource;
+  gboolean matching;
+} ControlWaiter;
+
 enum ConnectionState
 {
   SV_STATE_DISCONNECTED = 0,
   SV_STATE_WAITING,
   SV_STATE_CONNECTED,
   SV_STATE_TIMEOUT,
-  SV_STATE_ERROR
+  SV_STATE_ERROR,
+  SV_STATE_EVICTED,
+  SV_STATE_IDLE
 };
 
 enum ConnectionType
 {
   SV_TYPE_VNC = 0,
   SV_TYPE_VNC_OVER_SSH,
-  SV_TYPE_VNC_REVERSE
+  SV_TYPE_VNC_REVERSE,
+  SV_TYPE_VNC_REPEATER
 };
 
 enum ConnectionQuality
@@ -213,7 +732,10 @@ enum ConnectionDisconnectType
   SV_DISC_MANUAL,
   SV_DISC_TIMEOUT,
   SV_DISC_VNC_ERROR,
-  SV_DISC_SSH_ERROR
+  SV_DISC_SSH_ERROR,
+  SV_DISC_STALE,
+  SV_DISC_EVICTED,
+  SV_DISC_IDLE
 };
 
 enum SendKeysObjectType
@@ -222,6 +744,39 @@ enum SendKeysObjectType
   SV_SENDKEYS_TYPE_OTHER
 };
 
+enum ClipboardSync
+{
+  SV_CLIP_SYNC_MANUAL = 0,
+  SV_CLIP_SYNC_FROM_SERVER,
+  SV_CLIP_SYNC_TO_SERVER,
+  SV_CLIP_SYNC_BOTH
+};
+
+enum ProbeState
+{
+  SV_PROBE_UNKNOWN = 0,
+  SV_PROBE_REACHABLE,
+  SV_PROBE_UNREACHABLE
+};
+
+enum PasteMode
+{
+  SV_PASTE_KEYSTROKES = 0,
+  SV_PASTE_CLIPBOARD
+};
+
+enum ShmFormat
+{
+  SV_SHM_FORMAT_RGB24 = 1
+};
+
+enum MacroStepType
+{
+  SV_MACRO_KEYS = 0,
+  SV_MACRO_WAIT,
+  SV_MACRO_WAITFOR
+};
+
 /* functions */
 void svDoQuit ();
 void svCancelScanMode (gboolean);
@@ -247,6 +802,8 @@ void svHandleConnectionSettingsButtons (GtkButton *, gpointer);
 gboolean svHandleConnectionListClicks (GtkWidget *, GdkEvent *, void *);
 void svHandleConnectionSSHPrivKey (GtkButton *, gpointer);
 void svHandleDeleteMenuItem (GtkMenuItem *, gpointer);
+void svHandleLocalClipboardChange (GtkClipboard *, GdkEvent *, gpointer);
+void svHandleProbeHostsMenuItem (GtkMenuItem *, gpointer);
 void svHandleFullscreenMenuItem (GtkMenuItem *, gpointer);
 void svHandleRequestUpdateMenuItem (GtkMenuItem *, gpointer);
 void svHandleScanModeMenuItem (GtkMenuItem *, gpointer);
@@ -259,6 +816,134 @@ void svInitAppVars ();
 void svInitConnObject (Connection *);
 void svInsertHostListRow (const char *, gint, Connection *);
 void svLog (const char *, gboolean);
+GArray * svMacroCompile (const char *, GString *);
+void svMacroPlay (Connection *);
+void svMacroPlayProgram (Connection *, GArray *);
+void svMacroStop (Connection *);
+gboolean svPasteViaClipboard (Connection *, const char *);
+void svProbeAll ();
+void svReconnectCancel (Connection *, gboolean);
+void svReconnectSchedule (Connection *);
+void svReconnectShowStatus (const Connection *);
+void svConnectDirectCancel (Connection *, gboolean);
+void svWatchdogStop (Connection *);
+void svFbBudgetEnforce ();
+gboolean svIdleTimer (gpointer);
+void svDnsResolve (const char *, DnsCallback, gpointer);
+void svConnectDirectDone (GObject *, GAsyncResult *, gpointer);
+gboolean svConnectDirectStagger (gpointer);
+void svConnectDirectAttach (Connection *, GSocketConnection *);
+void svWarmHold (Connection *, GSocketConnection *);
+void svWarmDrop (Connection *);
+void svWarmStart (Connection *);
+gboolean svHandleConnectionListMotion (GtkWidget *, GdkEventMotion *, gpointer);
+gboolean svHandleConnectionListLeave (GtkWidget *, GdkEventCrossing *, gpointer);
+Connection * svConnectionFromName (const char *);
+gboolean svListenIsPort (guint16);
+void svListenClose (gpointer);
+gboolean svListenParsePorts (const char *, GArray *);
+GString * svReverseUniqueName (const char *);
+gboolean svReverseParseAllow (const char *, GPtrArray *);
+gboolean svReverseAllowSet ();
+void svReverseBucketsTrim (const char *, gint64, double);
+void svReverseShowRejected ();
+void svRepeaterStart (Connection *, GSocketConnection *);
+void svRemoteShotFinish (Connection *, const char *);
+gboolean svRemoteShotSettle (gpointer);
+gint svHandleCommandLine (GApplication *, GApplicationCommandLine *, gpointer);
+const char * svStateName (guint);
+void svControlFlush (ControlClient *);
+void svControlWritten (GObject *, GAsyncResult *, gpointer);
+void svControlClientClose (ControlClient *);
+void svControlClientUnref (ControlClient *);
+void svControlNotifyState (Connection *, guint);
+void svControlNotifyScreen (Connection *, gboolean);
+void svControlCommand (ControlClient *, const char *);
+ControlClient * svControlClientNew (GSocket *);
+guint svStateFromName (const char *);
+void svHeadlessSetup ();
+gboolean svHelperStart (Connection *);
+void svHelperStop (Connection *);
+void svHelperShow (Connection *);
+void svHelperSend (Connection *, const char *, const char *);
+gboolean svHelperScreenLive (const HelperProc *);
+gboolean svHelperChildEnd (gpointer);
+gint svHelperChildCommandLine (GApplication *, GApplicationCommandLine *);
+GtkWidget * svConnectionScreen (const Connection *);
+GdkPixbuf * svConnectionPixbuf (const Connection *);
+void svConnectionSendKeys (Connection *, const guint *, guint);
+void svConnectionRequestUpdate (Connection *);
+void svConnectionApplyScale (Connection *);
+void svDetachStart (Connection *);
+void svDetachEnd (Connection *);
+gboolean svDetachTimer (gpointer);
+void svHandleDetachMenuItem (GtkMenuItem *, gpointer);
+gboolean svConnectionScaled (const Connection *);
+void svTileLayoutSoon ();
+void svTileRemove (Connection *);
+void svTileShow (Connection *);
+void svTileSnap (Connection *);
+gboolean svTileDraw (GtkWidget *, cairo_t *, gpointer);
+void svRemoteSelect (Connection *);
+void svHandleTileMenuItem (GtkCheckMenuItem *, gpointer);
+gint svSocketDupFd (GSocket *);
+void svRemoteResizeSend (Connection *, guint, guint);
+void svRemoteResizeSoon (Connection *);
+void svRemoteResizeCancel (Connection *);
+void svHandleViewportResize (GtkWidget *, GdkRectangle *, gpointer);
+void svPointerQueue (Connection *, gint, gint, guint);
+void svPointerCancel (Connection *);
+gboolean svPointerOwned (const Connection *);
+gboolean svPointerPosition (GtkWidget *, gdouble, gdouble, gint *, gint *);
+gboolean svHandlePointerMotion (GtkWidget *, GdkEventMotion *, gpointer);
+gboolean svHandlePointerButton (GtkWidget *, GdkEvent *, gpointer);
+void svPreviewSave (Connection *);
+void svPreviewForget (Connection *);
+void svPreviewRename (const Connection *, const char *);
+void svPreviewDelete (Connection *);
+void svPreviewDeleteAll ();
+gboolean svPreviewTimer (gpointer);
+gboolean svPreviewDraw (GtkWidget *, cairo_t *, gpointer);
+void svPreviewShow (Connection *);
+void svPreviewHide (Connection *);
+gboolean svHandleHostListTooltip (GtkWidget *, gint, gint, gboolean, GtkTooltip *, gpointer);
+void svControlForget (Connection *);
+void svControlStart ();
+void svControlStop ();
+void svBatchNext ();
+gboolean svBatchNextIdle (gpointer);
+void svBatchItemDone (Connection *);
+void svBatchFinish ();
+void svBatchScreenProgress (Connection *, guint, guint, guint, guint);
+gint svBatchCommandLine (GApplication *, GApplicationCommandLine *);
+MatchTemplate * svMatchTemplateLoad (const char *, gint, gint, GString *);
+void svMatchTemplateUnref (MatchTemplate *);
+void svMatchWaitAdd (Connection *, MatchTemplate *, guint, MatchCallback, gpointer);
+void svMatchWaitCancel (Connection *, MatchCallback, gpointer, const char *);
+void svMatchSchedule (Connection *);
+void svMacroMatched (Connection *, const char *, gint, gint, gpointer);
+void svMacroStepClear (gpointer);
+void svControlMatched (Connection *, const char *, gint, gint, gpointer);
+void svShmDirty (Connection *, guint, guint, guint, guint);
+gboolean svShmOpen (Connection *, guint, guint);
+void svShmClose (Connection *);
+void svShmExportAll ();
+GdkPixbuf * svProbeBadge (GdkPixbuf *, const Connection *);
+void svProbeCancel (Connection *);
+void svProbeSchedule ();
+void svProbeStartNext ();
+void svSetF12Macro (Connection *, const char *);
+void svClipHistoryAdd (Connection *, const char *);
+void svClipHistoryRemove (const Connection *);
+void svClipHistoryTrim (const ClipEntry *);
+GBytes * svClipLatest (const Connection *);
+void svClipPushLocal (Connection *);
+void svClipRequestLocal (Connection *, gboolean);
+void svClipSetLocal (GBytes *);
+char * svClipToLatin1 (const char *);
+gboolean svClipTextEqual (gconstpointer, gconstpointer);
+guint svClipTextHash (gconstpointer);
+GString * svClipPreview (GBytes *);
 void svConnectionOpen (Connection *);
 void svToLower (char *);
 void svSavePreviousQuickNoteText (const Connection *);
@@ -270,7 +955,7 @@ void svSetTooltip(GtkWidget *, const char *);
 void svSetMenuItemTooltips ();
 void svShowAboutWindow ();
 void svShowAppOptionsWindow ();
-void svShowConnectionActionsWindow ();
+void svShowConnectionActionsWindow (Connection *);
 void svShowMessageDialog (const char *);
 gpointer svSSHConnectionCloser (gpointer);
 void svStartConnection (Connection *);